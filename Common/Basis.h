@@ -43,10 +43,13 @@ class UVNBasis : public IBasis
 {
 private:
     bool invertUp = false;
+protected:
+    //called by every setter that changes the basis, so the owners see the changes made through the base class
+    virtual void OnBasisChanged(){}
 public:
     virtual ~UVNBasis(){}
     virtual void UpdateMatrix() const;
-    void SetInvertUp(bool InvertUp){invertUp = InvertUp;}
+    void SetInvertUp(bool InvertUp);
     bool GetInvertUp() const {return invertUp;}
 	void SetDir(const D3DXVECTOR3 &Dir);
     void SetPos(const D3DXVECTOR3 &Pos);    
@@ -31,9 +31,10 @@ private:
     BOOL isFlying;
     mutable D3DXMATRIX invertMatrix;
     D3DXMATRIX projMatrix;
+    D3DXMATRIX prevViewMatrix;
     float speed;
 public:
-    EyeCamera():isFlying(false), angles(0,0), speed(1.0f){}
+    EyeCamera():isFlying(false), angles(0,0), speed(1.0f){D3DXMatrixIdentity(&prevViewMatrix);}
     float GetSpeed() const {return speed;} 
     void SetSpeed(float Speed) {speed = Speed;}
     BOOL IsFlying() const {return isFlying;}
@@ -47,6 +48,10 @@ public:
     virtual const D3DXMATRIX &GetProjMatrix() const { return projMatrix; }
 	virtual const D3DXMATRIX &GetViewMatrix() const;
 	virtual void Invalidate(float Tf);
+    //matrices of the last frame stored by StorePrevViewMatrix, used for the reprojection
+    void StorePrevViewMatrix() {prevViewMatrix = GetViewMatrix();}
+    const D3DXMATRIX &GetPrevViewMatrix() const {return prevViewMatrix;}
+    D3DXMATRIX GetPrevViewProjMatrix() const {return prevViewMatrix * projMatrix;}
 };
 
 class TargetCamera : public ICamera
@@ -0,0 +1,37 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#pragma once
+#include <CpuRendering/Math.h>
+#include <CpuRendering/Image.h>
+#include <CpuRendering/ThreadPool.h>
+#include <CpuRendering/Upsampling.h>
+#include <CpuRendering/DepthPyramid.h>
+#include <CpuRendering/Deinterleave.h>
+#include <CpuRendering/TileClassification.h>
+#include <CpuRendering/NormalDepthCodec.h>
+#include <CpuRendering/NormalReconstruction.h>
+#include <CpuRendering/AOEngine.h>
+#include <CpuRendering/SSAO.h>
+#include <CpuRendering/HBAO.h>
+#include <CpuRendering/SSAOSimd.h>
+#include <CpuRendering/TemporalSSAO.h>
+#include <CpuRendering/MultiScaleSSAO.h>
+#include <CpuRendering/EdgeSavingBlur.h>
+#include <CpuRendering/LinearBlur.h>
+#include <CpuRendering/GaussianBlur.h>
+#include <CpuRendering/SummedAreaTable.h>
+#include <CpuRendering/Mesh.h>
+#include <CpuRendering/Rasterizer.h>
+#include <CpuRendering/CameraPath.h>
+#include <CpuRendering/Lighting.h>
+#include <CpuRendering/ImageIO.h>
+#include <CpuRendering/Stopwatch.h>
+#include <CpuRendering/OutputQueue.h>
+#include <CpuRendering/BatchAO.h>
+#include <CpuRendering/Platform.h>
+#include <CpuRendering/RenderFarm.h>
@@ -0,0 +1,32 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#pragma once
+#include <Exception.h>
+#include <CpuRendering/Image.h>
+
+namespace CpuRendering
+{
+
+struct SSAOParams;
+
+//Ambient occlusion technique of the CPU backend. All techniques take the normal/depth buffer and SSAOParams
+//(projection, occlusion radius, harshness as the intensity, random offsets) and write visibility^2 as SSAOv3.ps does,
+//so they can be swapped behind the same blur and lighting
+class IAOEngine
+{
+protected:
+    IAOEngine(){}
+public:
+    virtual ~IAOEngine(){}
+    virtual const char *GetName() const = 0;
+    //depth fetches (bilinear taps) the technique makes per pixel
+    virtual int GetDepthFetchesCount(const SSAOParams &Params) const = 0;
+    virtual void Compute(const NormalDepthImage &NormalDepth, const SSAOParams &Params, OcclusionImage &Occlusion) const throw (Exception) = 0;
+};
+
+}
@@ -0,0 +1,92 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#pragma once
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <functional>
+#include <CpuRendering/Image.h>
+#include <CpuRendering/ThreadPool.h>
+#include <CpuRendering/Mesh.h>
+#include <CpuRendering/CameraPath.h>
+#include <CpuRendering/Rasterizer.h>
+#include <CpuRendering/SSAO.h>
+#include <CpuRendering/EdgeSavingBlur.h>
+
+namespace CpuRendering
+{
+
+//Passes of every view, the projection of the ssao params is the one of all the views
+struct BatchAOParams
+{
+    int width = 1280, height = 720;
+    SSAOParams ssao;
+    EdgeSavingBlurParams blur;
+    bool useBlur = true;
+};
+
+enum BatchSplit
+{
+    //one view per worker with the single threaded passes, for more views than threads
+    BATCH_SPLIT_VIEWS,
+    //views one after another, the passes of a view are split to tiles on the pool
+    BATCH_SPLIT_TILES
+};
+
+struct BatchAOCounters
+{
+    size_t views = 0;
+    double seconds = 0.0;
+    //summed over the views, so they add up to about seconds * threads for BATCH_SPLIT_VIEWS
+    double prepassSeconds = 0.0, ssaoSeconds = 0.0, blurSeconds = 0.0;
+    double GetViewsPerSecond() const {return (seconds > 0.0) ? views / seconds : 0.0;}
+};
+
+//Prepass, SSAO and edge saving blur of many views of one mesh. The mesh and the params are shared read only,
+//every view in flight takes a scratch set of the passes and their buffers from a pool, so the buffers are allocated
+//once per worker and reused by the next Render calls. The occlusion of every view is a new image handed to Output,
+//which may keep it, e.g. pass it to an OutputQueue
+class BatchAORenderer
+{
+public:
+    //called on the worker threads, in no particular view order for BATCH_SPLIT_VIEWS
+    typedef std::function<void(size_t ViewIndex, const std::shared_ptr<OcclusionImage> &Occlusion)> ViewCallback;
+private:
+    struct Scratch
+    {
+        NormalDepthRasterizer rasterizer;
+        SSAOEngine ssao;
+        EdgeSavingBlurEngine blur;
+        NormalDepthImage normalDepth;
+        double prepassSeconds = 0.0, ssaoSeconds = 0.0, blurSeconds = 0.0;
+    };
+    typedef std::unique_ptr<Scratch> ScratchPtr;
+    ThreadPool *pool = NULL;
+    std::mutex scratchMutex;
+    //free sets, all of them are back when Render returns
+    std::vector<ScratchPtr> scratchPool;
+    size_t scratchCount = 0;
+    BatchAOCounters counters;
+    ScratchPtr AcquireScratch();
+    void ReleaseScratch(ScratchPtr &Set);
+    static void RenderView(const MeshView &Mesh, const Matrix &View, const BatchAOParams &Params, Scratch &Set, ThreadPool *ViewPool,
+                           OcclusionImage &Occlusion);
+public:
+    BatchAORenderer(const BatchAORenderer &) = delete;
+    BatchAORenderer &operator= (const BatchAORenderer &) = delete;
+    BatchAORenderer(){}
+    BatchAORenderer(ThreadPool *Pool) : pool(Pool){}
+    void SetThreadPool(ThreadPool *Pool){pool = Pool;}
+    void Render(const MeshView &Mesh, const CameraPath &Views, const BatchAOParams &Params, BatchSplit Split,
+                const ViewCallback &Output) throw (Exception);
+    //of the last Render
+    const BatchAOCounters &GetCounters() const {return counters;}
+    size_t GetScratchCount() const {return scratchCount;}
+};
+
+}
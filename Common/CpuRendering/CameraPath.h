@@ -0,0 +1,33 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#pragma once
+#include <string>
+#include <vector>
+#include <Exception.h>
+#include <CpuRendering/Math.h>
+
+namespace CpuRendering
+{
+
+//Camera path recorded by the demo (F2), one view matrix per frame
+typedef std::vector<Matrix> CameraPath;
+
+//Text file, 16 numbers of the row major view matrix per line
+void SaveCameraPath(const std::string &FileName, const CameraPath &Path) throw (Exception);
+CameraPath LoadCameraPath(const std::string &FileName) throw (Exception);
+
+//View matrix of Camera::EyeCamera in the flying mode
+Matrix CreateEyeCameraView(const Float3 &Pos, const Float3 &Dir);
+//View matrix of Camera::TargetCamera
+Matrix CreateTargetCameraView(const Float3 &Pos, const Float3 &Target, const Float3 &Up = Float3(0.0f, 1.0f, 0.0f));
+
+//Text file of camera poses, one view per line: "eye px py pz dx dy dz", "target px py pz tx ty tz [ux uy uz]"
+//or 16 numbers of a view matrix as in the camera path files. Lines starting with # are skipped
+CameraPath LoadCameraPoses(const std::string &FileName) throw (Exception);
+
+}
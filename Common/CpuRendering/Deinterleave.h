@@ -0,0 +1,82 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#pragma once
+#include <vector>
+#include <CpuRendering/Image.h>
+#include <CpuRendering/ThreadPool.h>
+#include <CpuRendering/DepthPyramid.h>
+
+namespace CpuRendering
+{
+
+//Layer i + j * DeinterleaveFactor holds the pixels (DeinterleaveFactor * x + i, DeinterleaveFactor * y + j),
+//so every pixel of a layer has the same rotation of the 4x4 random offsets tile.
+//Same constant as in SSAOv3.ps, Deinterleave.ps, Reinterleave.ps and the size of the random offsets texture
+const int DeinterleaveFactor = 4;
+const int DeinterleavedLayersCount = DeinterleaveFactor * DeinterleaveFactor;
+
+//Depth (.w of the normal/depth buffer) split to DeinterleavedLayersCount quarter by quarter layers.
+//Layers are of ceil(width / 4) x ceil(height / 4), texels past the right and bottom edges of
+//the source repeat its last column and row. Mirrors Deinterleave.ps, which stores the layers
+//in an atlas of 4 x 4 layers
+class DeinterleavedDepth
+{
+private:
+    std::vector<DepthImage> layers;
+    int width = 0, height = 0;
+public:
+    void Build(const NormalDepthImage &NormalDepth, ThreadPool *Pool = NULL) throw (Exception);
+    const DepthImage &GetLayer(int Layer) const {return layers[Layer];}
+    int GetLayerWidth() const {return (width + DeinterleaveFactor - 1) / DeinterleaveFactor;}
+    int GetLayerHeight() const {return (height + DeinterleaveFactor - 1) / DeinterleaveFactor;}
+    //size of the source normal/depth buffer
+    int GetWidth() const {return width;}
+    int GetHeight() const {return height;}
+};
+
+//Depth sampler of ComputeSSAOVisibility for the pixels of one layer: taps read the layer instead of
+//the full resolution buffer, the bilinear fetch is clamped to the layer texels as in the atlas of SSAOv3.ps.
+//Runs for every tap, so the mapping to the layer texels is a single multiply-add per axis
+class LayerDepthSampler
+{
+private:
+    const DepthImage &layer;
+    float scaleX, scaleY, biasX, biasY;
+    float maxX, maxY;
+public:
+    LayerDepthSampler(const DeinterleavedDepth &Depth, int Layer);
+    const DepthImage &GetLayer() const {return layer;}
+    //tap position in the layer texels, TexCoord is of the full resolution buffer
+    Float2 GetLayerTexel(const Float2 &TexCoord) const
+    {
+        float x = TexCoord.x * scaleX + biasX, y = TexCoord.y * scaleY + biasY;
+
+        x = (x < 0.0f) ? 0.0f : ((x > maxX) ? maxX : x);
+        y = (y < 0.0f) ? 0.0f : ((y > maxY) ? maxY : y);
+
+        return Float2(x, y);
+    }
+    float Sample(const Float2 &TexCoord, const Float2 &OriginTexCoord) const
+    {
+        Float2 texel = GetLayerTexel(TexCoord);
+
+        //texel is clamped to [0, max], so the truncation is floor and x0 + 1 only has to be clamped from above
+        int x0 = (int)texel.x, y0 = (int)texel.y;
+        int x1 = (x0 < layer.GetWidth() - 1) ? x0 + 1 : x0;
+        float fracX = texel.x - x0, fracY = texel.y - y0;
+
+        const float *row0 = layer.GetRow(y0);
+        const float *row1 = layer.GetRow((y0 < layer.GetHeight() - 1) ? y0 + 1 : y0);
+
+        float top = row0[x0] + (row0[x1] - row0[x0]) * fracX;
+        float bottom = row1[x0] + (row1[x1] - row1[x0]) * fracX;
+
+        return top + (bottom - top) * fracY;
+    }
+};
+}
@@ -0,0 +1,67 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#pragma once
+#include <vector>
+#include <CpuRendering/Image.h>
+#include <CpuRendering/ThreadPool.h>
+
+namespace CpuRendering
+{
+
+typedef Image<float> DepthImage;
+
+//Taps closer than 2^(DepthPyramidLogMaxOffset + 1) = 16 pixels read level 0, every next octave of the distance
+//goes one level down. Same constants as in SSAOv3.ps and Application
+const int DepthPyramidLogMaxOffset = 3;
+const int DepthPyramidMaxLevelsCount = 5;
+
+//Mip chain of the view space depth (.w of the normal/depth buffer), built once per frame as in
+//"Scalable Ambient Obscurance" (McGuire et al.). Level n texel takes one texel of its 2x2 block of level n - 1
+//picked by the rotated grid pattern, so levels keep real depths instead of averages that create
+//false surfaces on the edges. Mirrors DepthPyramid.ps
+class DepthPyramid
+{
+private:
+    std::vector<DepthImage> depth;
+public:
+    //LevelsCount is clamped to the full mip chain of the size
+    void Build(const NormalDepthImage &NormalDepth, int LevelsCount = DepthPyramidMaxLevelsCount, ThreadPool *Pool = NULL) throw (Exception);
+    int GetLevelsCount() const {return (int)depth.size();}
+    const DepthImage &GetDepth(int Level) const {return depth[Level];}
+};
+
+//floor(log2(ScreenRadius)) - DepthPyramidLogMaxOffset clamped to [0, LevelsCount - 1], ScreenRadius in level 0 pixels.
+//Takes the squared radius and compares it with the squared octave bounds, sqrt and log2 per tap cost as much as the fetch
+int GetDepthPyramidLevel(float ScreenRadiusSq, int LevelsCount);
+
+float SampleDepthLinear(const DepthImage &Depth, const Float2 &TexCoord);
+
+//Depth sampler of ComputeSSAOVisibility reading the pyramid level chosen by the screen space distance of the tap
+class PyramidDepthSampler
+{
+private:
+    const DepthPyramid &pyramid;
+    float width, height;
+public:
+    PyramidDepthSampler(const DepthPyramid &Pyramid) : pyramid(Pyramid),
+                                                       width((float)Pyramid.GetDepth(0).GetWidth()),
+                                                       height((float)Pyramid.GetDepth(0).GetHeight()){}
+    int GetLevel(const Float2 &TexCoord, const Float2 &OriginTexCoord) const
+    {
+        float dx = (TexCoord.x - OriginTexCoord.x) * width;
+        float dy = (TexCoord.y - OriginTexCoord.y) * height;
+
+        return GetDepthPyramidLevel(dx * dx + dy * dy, pyramid.GetLevelsCount());
+    }
+    float Sample(const Float2 &TexCoord, const Float2 &OriginTexCoord) const
+    {
+        return SampleDepthLinear(pyramid.GetDepth(GetLevel(TexCoord, OriginTexCoord)), TexCoord);
+    }
+};
+
+}
@@ -0,0 +1,117 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#pragma once
+#include <vector>
+#include <math.h>
+#include <CpuRendering/Image.h>
+#include <CpuRendering/ThreadPool.h>
+
+namespace CpuRendering
+{
+
+typedef std::vector<float> BlurKernel;
+
+//PostProcess::Blur::GetGaussianKernel, the deviation of -1 takes the radius
+BlurKernel CreateGaussianBlurKernel(int Radius, float Deviation = -1.0f);
+
+//Blur::GetIteratedKernel, Kernel convolved with itself Iterations times
+BlurKernel CreateIteratedBlurKernel(const BlurKernel &Kernel, int Iterations);
+
+//Inputs of EdgeSavingBlur.ps. Taps whose normal or depth differ too much from the ones of the center pixel
+//are dropped, the weights of the rest are normalized
+struct EdgeSavingBlurParams
+{
+    //2 * radius + 1 weights, Application sets the gaussian kernel of radius 5
+    BlurKernel kernel;
+    float minNormalDot = 0.8f;
+    float maxDepthDifference = 0.2f;
+    //pairs of the vertical and the horizontal passes, PostProcess::Blur::Draw order
+    int iterations = 1;
+    EdgeSavingBlurParams() : kernel(CreateGaussianBlurKernel(5)){}
+};
+
+inline int GetBlurRadius(const EdgeSavingBlurParams &Params) {return (int)Params.kernel.size() / 2;}
+
+//Tap loop of EdgeSavingBlur.ps for the pixel (X, Y). Source(x, y) returns the input of the pass at the image
+//coordinates, taps are clamped to the image as the clamp sampler does
+template<class TSource>
+float EdgeSavingBlurPixel(const NormalDepthImage &NormalDepth, const EdgeSavingBlurParams &Params, bool Vertical, int X, int Y, const TSource &Source)
+{
+    const Float4 &center = NormalDepth.At(X, Y);
+    Float3 normal = Normalize(center.Xyz());
+
+    int radius = GetBlurRadius(Params);
+    int last = ((Vertical) ? NormalDepth.GetHeight() : NormalDepth.GetWidth()) - 1;
+
+    float totalWeight = 0.0f, total = 0.0f;
+
+    for(int i = -radius; i <= radius; i++){
+
+        int tap = ((Vertical) ? Y : X) + i;
+        tap = (tap < 0) ? 0 : ((tap > last) ? last : tap);
+
+        int tapX = (Vertical) ? X : tap, tapY = (Vertical) ? tap : Y;
+        const Float4 &tapNormalDepth = NormalDepth.At(tapX, tapY);
+
+        if(Dot(Normalize(tapNormalDepth.Xyz()), normal) < Params.minNormalDot || fabsf(tapNormalDepth.w - center.w) > Params.maxDepthDifference)
+            continue;
+
+        float weight = Params.kernel[i + radius];
+        totalWeight += weight;
+        total += Source(tapX, tapY) * weight;
+    }
+
+    return total / totalWeight;
+}
+
+//One full screen pass of EdgeSavingBlur.ps
+void EdgeSavingBlurPass(const OcclusionImage &Source, const NormalDepthImage &NormalDepth, const EdgeSavingBlurParams &Params, bool Vertical,
+                        OcclusionImage &Destination, ThreadPool *Pool = NULL) throw (Exception);
+
+//PostProcess::Blur::Draw with EdgeSavingBlur.ps: every iteration blurs Occlusion vertically to Intermediate
+//and Intermediate horizontally back to Occlusion
+void EdgeSavingBlur(OcclusionImage &Occlusion, const NormalDepthImage &NormalDepth, const EdgeSavingBlurParams &Params,
+                    OcclusionImage &Intermediate, ThreadPool *Pool = NULL) throw (Exception);
+
+//EdgeSavingBlur with the same result, for the bulk of the screen. The normals are normalized once per call and
+//the vertical pass runs on the transposed images, so every pass reads the rows sequentially and takes bands of them
+class EdgeSavingBlurEngine
+{
+private:
+    ThreadPool *pool = NULL;
+    //normalized normal and depth, straight and transposed
+    NormalDepthImage guide, transposedGuide;
+    OcclusionImage transposed, transposedBlurred, intermediate;
+    void BlurRows(const OcclusionImage &Source, const NormalDepthImage &Guide, const EdgeSavingBlurParams &Params, OcclusionImage &Destination) const;
+public:
+    EdgeSavingBlurEngine(){}
+    EdgeSavingBlurEngine(ThreadPool *Pool) : pool(Pool){}
+    void SetThreadPool(ThreadPool *Pool){pool = Pool;}
+    void Blur(OcclusionImage &Occlusion, const NormalDepthImage &NormalDepth, const EdgeSavingBlurParams &Params) throw (Exception);
+};
+
+//Destination(y, x) = Source(x, y), by square blocks that fit the L1 cache
+template<class TPixel>
+void TransposeImage(const Image<TPixel> &Source, Image<TPixel> &Destination, ThreadPool *Pool = NULL)
+{
+    const int blockSize = 32;
+
+    if(!Destination.IsSameSize(Source.GetHeight(), Source.GetWidth()))
+        Destination.Init(Source.GetHeight(), Source.GetWidth());
+
+    ForEachTile(Pool, SplitToTiles(Source.GetWidth(), Source.GetHeight(), blockSize), [&](const Tile &Region)
+    {
+        for(int x = Region.left; x < Region.right; x++){
+            TPixel *dst = Destination.GetRow(x);
+            for(int y = Region.top; y < Region.bottom; y++)
+                dst[y] = Source.At(x, y);
+        }
+    });
+}
+
+}
@@ -0,0 +1,69 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#pragma once
+#include <CpuRendering/Image.h>
+#include <CpuRendering/ThreadPool.h>
+#include <CpuRendering/EdgeSavingBlur.h>
+
+namespace CpuRendering
+{
+
+//Third order recursive gaussian of Young and van Vliet, w[n] = b * x[n] + a1 * w[n - 1] + a2 * w[n - 2] + a3 * w[n - 3]
+//forward and the same backward. Boundary maps the differences of the last 3 forward values from the clamped border
+//value to the ones of the backward values past the border, so the clamp addressing holds on both ends
+struct RecursiveGaussianCoefficients
+{
+    float b = 1.0f;
+    float a[3];
+    float boundary[3][3];
+    RecursiveGaussianCoefficients();
+};
+
+//Sigma from 0.5, the cost per pixel does not depend on it
+RecursiveGaussianCoefficients GetRecursiveGaussianCoefficients(float Sigma) throw (Exception);
+
+//Filters the columns, 4 of them at once with SSE, Destination may be Source
+void RecursiveGaussianColumns(const OcclusionImage &Source, const RecursiveGaussianCoefficients &Coefficients, OcclusionImage &Destination,
+                              ThreadPool *Pool = NULL) throw (Exception);
+
+enum GaussianBlurMethod
+{
+    GAUSSIAN_BLUR_FIR,
+    GAUSSIAN_BLUR_RECURSIVE
+};
+
+//Gaussian blur of the CPU post process path with the PostProcess::Blur interface. FIR takes the kernel of SetKernel
+//with a point fetch per tap, the recursive filter takes the deviation of SetDeviation whatever the radius is.
+//The rows are filtered as the columns of the transposed image
+class GaussianBlur
+{
+private:
+    ThreadPool *pool = NULL;
+    GaussianBlurMethod method = GAUSSIAN_BLUR_FIR;
+    size_t blurIterations = 1;
+    BlurKernel kernel;
+    float deviation = 0.0f;
+    RecursiveGaussianCoefficients coefficients;
+    OcclusionImage tmp1, transposed;
+public:
+    GaussianBlur(){}
+    GaussianBlur(ThreadPool *Pool) : pool(Pool){}
+    void SetThreadPool(ThreadPool *Pool){pool = Pool;}
+    void SetMethod(GaussianBlurMethod Method){method = Method;}
+    GaussianBlurMethod GetMethod() const {return method;}
+    void SetBlurIterationsCount(size_t BlurIterations){blurIterations = BlurIterations;}
+    size_t GetIterationsCount() const {return blurIterations;}
+    //FIR only, the recursive filter keeps its deviation
+    void SetKernel(const BlurKernel &Kernel) throw (Exception);
+    //exp(-x ^ 2 / (2 * Deviation ^ 2)) for both methods, FIR kernel is cut at 3 deviations
+    void SetDeviation(float Deviation) throw (Exception);
+    float GetDeviation() const {return deviation;}
+    void Draw(OcclusionImage &Occlusion) throw (Exception);
+};
+
+}
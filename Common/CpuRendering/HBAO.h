@@ -0,0 +1,54 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#pragma once
+#include <CpuRendering/SSAO.h>
+
+namespace CpuRendering
+{
+
+//Same defaults as the HBAO.ps variables created by Application
+struct HBAOParams
+{
+    int directionsCount = 4;
+    int stepsCount = 3;
+    //sine of the angle above the tangent plane a horizon has to rise to occlude,
+    //hides the self occlusion of tessellated surfaces
+    float angleBias = 0.1f;
+};
+
+//CPU implementation of HBAO.ps, horizon based ambient occlusion (Bavoil, Sainz, Dimitrov 2008)
+//with the tangent plane taken from the stored normal.
+//Screen space directions rotated by the random offsets texture are marched within the projected occlusion radius,
+//every sample that raises the horizon of its direction adds the rise of the horizon sine weighted by the distance falloff.
+//Takes directionsCount * stepsCount depth fetches per pixel against the kernel size of SSAOEngine
+class HBAOEngine : public IAOEngine
+{
+private:
+    ThreadPool *pool = NULL;
+    int tileSize = 32;
+    bool useDepthPyramid = false;
+    HBAOParams hbaoParams;
+public:
+    HBAOEngine(){}
+    HBAOEngine(ThreadPool *Pool, const HBAOParams &Params = HBAOParams(), int TileSize = 32) : pool(Pool), tileSize(TileSize), hbaoParams(Params){}
+    void SetThreadPool(ThreadPool *Pool){pool = Pool;}
+    void SetTileSize(int TileSize){tileSize = TileSize;}
+    int GetTileSize() const {return tileSize;}
+    void SetHBAOParams(const HBAOParams &Params){hbaoParams = Params;}
+    const HBAOParams &GetHBAOParams() const {return hbaoParams;}
+    void SetDepthPyramidMode(bool Use){useDepthPyramid = Use;}
+    bool GetDepthPyramidMode() const {return useDepthPyramid;}
+    virtual const char *GetName() const {return "HBAO";}
+    virtual int GetDepthFetchesCount(const SSAOParams &Params) const {return hbaoParams.directionsCount * hbaoParams.stepsCount;}
+    virtual void Compute(const NormalDepthImage &NormalDepth, const SSAOParams &Params, OcclusionImage &Occlusion) const throw (Exception);
+    //1 - harshness * occlusion saturated, Compute writes its square. Pyramid is optional
+    static float ComputeVisibility(const NormalDepthImage &NormalDepth, const SSAOParams &Params, const HBAOParams &HbaoParams,
+                                   int X, int Y, const DepthPyramid *Pyramid = NULL);
+};
+
+}
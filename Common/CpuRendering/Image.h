@@ -0,0 +1,82 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#pragma once
+#include <vector>
+#include <Exception.h>
+#include <CpuRendering/Math.h>
+
+namespace CpuRendering
+{
+
+DECLARE_EXCEPTION(CpuRenderingException);
+
+template<class TPixel>
+class Image
+{
+private:
+    int width = 0, height = 0;
+    std::vector<TPixel> pixels;
+public:
+    typedef TPixel PixelType;
+    Image(){}
+    Image(int Width, int Height, const TPixel &Value = TPixel()) {Init(Width, Height, Value);}
+    void Init(int Width, int Height, const TPixel &Value = TPixel())
+    {
+        width = Width;
+        height = Height;
+        pixels.assign((size_t)Width * Height, Value);
+    }
+    int GetWidth() const {return width;}
+    int GetHeight() const {return height;}
+    bool IsSameSize(int Width, int Height) const {return width == Width && height == Height;}
+    template<class TOtherPixel>
+    bool IsSameSize(const Image<TOtherPixel> &Other) const {return IsSameSize(Other.GetWidth(), Other.GetHeight());}
+    TPixel &At(int X, int Y) {return pixels[(size_t)Y * width + X];}
+    const TPixel &At(int X, int Y) const {return pixels[(size_t)Y * width + X];}
+    const TPixel &AtClamped(int X, int Y) const
+    {
+        X = X < 0 ? 0 : (X >= width ? width - 1 : X);
+        Y = Y < 0 ? 0 : (Y >= height ? height - 1 : Y);
+        return At(X, Y);
+    }
+    TPixel *GetRow(int Y) {return &pixels[(size_t)Y * width];}
+    const TPixel *GetRow(int Y) const {return &pixels[(size_t)Y * width];}
+    TPixel *GetData() {return pixels.data();}
+    const TPixel *GetData() const {return pixels.data();}
+};
+
+//Bilinear fetch with clamp addressing as the D3D11_FILTER_MIN_MAG_MIP_LINEAR sampler does, TexCoord in [0, 1].
+//Channel returns the filtered value of a pixel
+template<class TPixel, class TChannel>
+float SampleLinear(const Image<TPixel> &Source, const Float2 &TexCoord, const TChannel &Channel)
+{
+    float tx = TexCoord.x * Source.GetWidth() - 0.5f;
+    float ty = TexCoord.y * Source.GetHeight() - 0.5f;
+
+    float fx0 = floorf(tx), fy0 = floorf(ty);
+    float fracX = tx - fx0, fracY = ty - fy0;
+    int x0 = (int)fx0, y0 = (int)fy0;
+
+    float v00 = Channel(Source.AtClamped(x0, y0));
+    float v10 = Channel(Source.AtClamped(x0 + 1, y0));
+    float v01 = Channel(Source.AtClamped(x0, y0 + 1));
+    float v11 = Channel(Source.AtClamped(x0 + 1, y0 + 1));
+
+    float top = v00 + (v10 - v00) * fracX;
+    float bottom = v01 + (v11 - v01) * fracX;
+
+    return top + (bottom - top) * fracY;
+}
+
+//xyz - view space normal, w - view space depth, same layout as ndRt
+typedef Image<Float4> NormalDepthImage;
+typedef Image<float> OcclusionImage;
+//rgb of the lit back buffer, not clamped
+typedef Image<Float3> ColorImage;
+
+}
@@ -0,0 +1,24 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#pragma once
+#include <string>
+#include <CpuRendering/Image.h>
+
+namespace CpuRendering
+{
+
+//Portable float map, "Pf" for the occlusion and "PF" for the color, little endian rows from the bottom up
+void SavePFM(const std::string &FileName, const OcclusionImage &Source) throw (Exception);
+void SavePFM(const std::string &FileName, const ColorImage &Source) throw (Exception);
+
+//8 bit grayscale or RGB PNG of the values clamped to [0, 1], as the UNORM back buffer stores them.
+//The zlib stream is made of stored blocks, so no compression library is needed
+void SavePNG(const std::string &FileName, const OcclusionImage &Source) throw (Exception);
+void SavePNG(const std::string &FileName, const ColorImage &Source) throw (Exception);
+
+}
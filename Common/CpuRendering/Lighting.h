@@ -0,0 +1,37 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#pragma once
+#include <CpuRendering/Image.h>
+#include <CpuRendering/ThreadPool.h>
+
+namespace CpuRendering
+{
+
+//Constants of PointLightSSAO.ps: PointLight::Material and the subset material Application sets for the hall
+struct PointLightParams
+{
+    Float3 pos;
+    Float4 ambient = {1.0f, 1.0f, 1.0f, 1.0f};
+    Float4 diffuse = {1.0f, 1.0f, 1.0f, 1.0f};
+    Float4 specular = {1.0f, 1.0f, 1.0f, 1.0f};
+    float intencity = 0.5f;
+    float fadeDistance = 12.0f;
+    float range = 12.0f;
+    Float4 materialAmbient = {0.5f, 0.5f, 0.5f, 1.0f};
+    Float4 materialDiffuse = {0.5f, 0.5f, 0.5f, 1.0f};
+    //w is the power
+    Float4 materialSpecularWithPower = {0.1f, 0.1f, 0.1f, 1.0f};
+};
+
+//ProcessPixel of PointLightSSAO.ps without the color texture and the bent normals. The position and the normal come from
+//the prepass instead of the vertex shader, so the pixel is lit in the view space, with the light moved there by View.
+//Occlusion is optional and of the normal/depth size, the background stays black
+void ShadePointLight(const NormalDepthImage &NormalDepth, const OcclusionImage *Occlusion, const Matrix &View, const Matrix &InvProj,
+                     const PointLightParams &Params, ColorImage &Color, ThreadPool *Pool = NULL) throw (Exception);
+
+}
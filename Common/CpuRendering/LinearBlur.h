@@ -0,0 +1,51 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#pragma once
+#include <vector>
+#include <CpuRendering/Image.h>
+#include <CpuRendering/ThreadPool.h>
+#include <CpuRendering/EdgeSavingBlur.h>
+
+namespace CpuRendering
+{
+
+//Same as Blur::MaxTapsCount, size of the taps array of BlurCommon.fxh
+const int MaxLinearBlurTaps = 32;
+
+//Subtexel precision of the D3D11 bilinear filter, the fraction between texels is rounded to 1 / 256
+const int HardwareSubtexelBits = 8;
+
+//Two neighbour taps of a blur kernel merged to one bilinear fetch, mirrors Blur::GetLinearTaps.
+//The fetch at offset returns the texels first and first + 1 weighted by firstWeight and weight - firstWeight
+struct LinearBlurTap
+{
+    float offset = 0.0f, weight = 0.0f;
+    int first = 0;
+    float firstWeight = 0.0f;
+};
+
+typedef std::vector<LinearBlurTap> LinearBlurKernel;
+
+//The center weight is halved between the pairs (0, 1) and (-1, 0), so the kernel of radius R takes
+//2 * ((R + 2) / 2) fetches instead of 2 * R + 1
+LinearBlurKernel CreateLinearBlurKernel(const BlurKernel &Kernel) throw (Exception);
+
+//Blur.ps with the discrete kernel, every tap is a point fetch
+void GaussianBlurPass(const OcclusionImage &Source, const BlurKernel &Kernel, bool Vertical, OcclusionImage &Destination,
+                      ThreadPool *Pool = NULL) throw (Exception);
+
+//Blur.ps with the merged taps, the fetches are emulated with SubtexelBits of the fraction, 0 - exact
+void LinearBlurPass(const OcclusionImage &Source, const BlurKernel &Kernel, bool Vertical, int SubtexelBits, OcclusionImage &Destination,
+                    ThreadPool *Pool = NULL) throw (Exception);
+
+//EdgeSavingBlur.ps with the merged taps. Both texels of a tap are tested, a tap straddling an edge falls back
+//to the point fetch of its accepted texel, so the result is the one of EdgeSavingBlurPass up to the subtexel rounding
+void EdgeSavingLinearBlurPass(const OcclusionImage &Source, const NormalDepthImage &NormalDepth, const EdgeSavingBlurParams &Params, bool Vertical,
+                              int SubtexelBits, OcclusionImage &Destination, ThreadPool *Pool = NULL) throw (Exception);
+
+}
@@ -0,0 +1,138 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#pragma once
+#include <math.h>
+
+namespace CpuRendering
+{
+
+//Minimal HLSL-like vector math. Kept free of D3DX so the CPU backend builds without the DirectX SDK.
+
+struct Float2
+{
+    float x = 0.0f, y = 0.0f;
+    Float2(){}
+    Float2(float X, float Y) : x(X), y(Y){}
+    Float2 operator + (const Float2 &V) const {return {x + V.x, y + V.y};}
+    Float2 operator - (const Float2 &V) const {return {x - V.x, y - V.y};}
+    Float2 operator * (float S) const {return {x * S, y * S};}
+};
+
+struct Float3
+{
+    float x = 0.0f, y = 0.0f, z = 0.0f;
+    Float3(){}
+    Float3(float X, float Y, float Z) : x(X), y(Y), z(Z){}
+    Float3 operator + (const Float3 &V) const {return {x + V.x, y + V.y, z + V.z};}
+    Float3 operator - (const Float3 &V) const {return {x - V.x, y - V.y, z - V.z};}
+    Float3 operator - () const {return {-x, -y, -z};}
+    Float3 operator * (float S) const {return {x * S, y * S, z * S};}
+    Float3 operator / (float S) const {return {x / S, y / S, z / S};}
+    Float3 &operator += (const Float3 &V) {x += V.x; y += V.y; z += V.z; return *this;}
+    Float3 &operator *= (float S) {x *= S; y *= S; z *= S; return *this;}
+};
+
+struct Float4
+{
+    float x = 0.0f, y = 0.0f, z = 0.0f, w = 0.0f;
+    Float4(){}
+    Float4(float X, float Y, float Z, float W) : x(X), y(Y), z(Z), w(W){}
+    Float4(const Float3 &V, float W) : x(V.x), y(V.y), z(V.z), w(W){}
+    Float3 Xyz() const {return {x, y, z};}
+    Float4 operator + (const Float4 &V) const {return {x + V.x, y + V.y, z + V.z, w + V.w};}
+    Float4 operator - (const Float4 &V) const {return {x - V.x, y - V.y, z - V.z, w - V.w};}
+    Float4 operator * (float S) const {return {x * S, y * S, z * S, w * S};}
+};
+
+//Row-major storage with row-vector multiplication, the same layout as D3DXMATRIX,
+//so mul(v, M) in the shaders corresponds to Transform(v, M) here.
+struct Matrix
+{
+    float m[4][4];
+    Matrix()
+    {
+        for(int r = 0; r < 4; r++)
+            for(int c = 0; c < 4; c++)
+                m[r][c] = (r == c) ? 1.0f : 0.0f;
+    }
+    explicit Matrix(const float *Data)
+    {
+        for(int i = 0; i < 16; i++)
+            m[i / 4][i % 4] = Data[i];
+    }
+};
+
+inline float Dot(const Float3 &A, const Float3 &B)
+{
+    return A.x * B.x + A.y * B.y + A.z * B.z;
+}
+
+inline Float3 Cross(const Float3 &A, const Float3 &B)
+{
+    return {A.y * B.z - A.z * B.y, A.z * B.x - A.x * B.z, A.x * B.y - A.y * B.x};
+}
+
+inline float Length(const Float3 &V)
+{
+    return sqrtf(Dot(V, V));
+}
+
+inline Float3 Normalize(const Float3 &V)
+{
+    return V * (1.0f / Length(V));
+}
+
+inline Float3 Reflect(const Float3 &I, const Float3 &N)
+{
+    return I - N * (2.0f * Dot(I, N));
+}
+
+inline float Saturate(float Val)
+{
+    return Val < 0.0f ? 0.0f : (Val > 1.0f ? 1.0f : Val);
+}
+
+//HLSL sign(), returns 0 for 0
+inline float Sign(float Val)
+{
+    return Val > 0.0f ? 1.0f : (Val < 0.0f ? -1.0f : 0.0f);
+}
+
+inline float Lerp(float A, float B, float Factor)
+{
+    return A + (B - A) * Factor;
+}
+
+inline Float4 Transform(const Float4 &V, const Matrix &M)
+{
+    Float4 out;
+    out.x = V.x * M.m[0][0] + V.y * M.m[1][0] + V.z * M.m[2][0] + V.w * M.m[3][0];
+    out.y = V.x * M.m[0][1] + V.y * M.m[1][1] + V.z * M.m[2][1] + V.w * M.m[3][1];
+    out.z = V.x * M.m[0][2] + V.y * M.m[1][2] + V.z * M.m[2][2] + V.w * M.m[3][2];
+    out.w = V.x * M.m[0][3] + V.y * M.m[1][3] + V.z * M.m[2][3] + V.w * M.m[3][3];
+    return out;
+}
+
+inline Matrix Mul(const Matrix &A, const Matrix &B)
+{
+    Matrix out;
+    for(int r = 0; r < 4; r++)
+        for(int c = 0; c < 4; c++)
+            out.m[r][c] = A.m[r][0] * B.m[0][c] + A.m[r][1] * B.m[1][c] + A.m[r][2] * B.m[2][c] + A.m[r][3] * B.m[3][c];
+    return out;
+}
+
+Matrix Inverse(const Matrix &M);
+
+Matrix Transpose(const Matrix &M);
+
+Matrix PerspectiveFovLH(float FOV, float NearZ, float FarZ, float AspectRatio);
+
+Matrix LookAtLH(const Float3 &Eye, const Float3 &At, const Float3 &Up);
+
+}
@@ -0,0 +1,64 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#pragma once
+#include <vector>
+#include <string>
+#include <CpuRendering/Image.h>
+#include <CpuRendering/Platform.h>
+
+namespace CpuRendering
+{
+
+//Same layout as ColladaVertex and the input of NormalVDepthV.vs
+struct MeshVertex
+{
+    Float3 pos, normal;
+    Float2 tc;
+};
+
+//Indexed triangle list, the CPU copy of the vertex and index buffers of a mesh
+struct TriangleMesh
+{
+    std::vector<MeshVertex> vertices;
+    std::vector<unsigned int> indices;
+    size_t GetTrianglesCount() const {return indices.size() / 3;}
+    //appends Mesh with its indices shifted past the vertices of this one
+    void Append(const TriangleMesh &Mesh);
+};
+
+//Vertices and indices of a TriangleMesh or of a mapped mesh cache, the passes read the mesh through it
+struct MeshView
+{
+    const MeshVertex *vertices = NULL;
+    const unsigned int *indices = NULL;
+    size_t verticesCount = 0, indicesCount = 0;
+    MeshView(){}
+    MeshView(const TriangleMesh &Mesh) : vertices(Mesh.vertices.data()), indices(Mesh.indices.data()),
+                                         verticesCount(Mesh.vertices.size()), indicesCount(Mesh.indices.size()){}
+    size_t GetTrianglesCount() const {return indicesCount / 3;}
+};
+
+//Meshes::ColladaBinaryMesh::Load without the D3D buffers, all subsets are merged to one triangle list.
+//The counts of the file are 32 bit, as the Win32 build of the demo writes size_t
+TriangleMesh LoadColladaBinaryMesh(const std::string &FileName) throw (Exception);
+
+//Mesh cache of the render farm: a header of the 32 bit counts, the vertices and the indices as they are in memory,
+//so the workers map the file and draw from it without a copy. The layout is of the machine that writes the file
+void SaveMeshCache(const std::string &FileName, const MeshView &Mesh) throw (Exception);
+
+class MappedMeshCache
+{
+private:
+    MappedFile file;
+    MeshView mesh;
+public:
+    void Open(const std::string &FileName) throw (Exception);
+    const MeshView &GetMesh() const {return mesh;}
+};
+
+}
@@ -0,0 +1,84 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#pragma once
+#include <CpuRendering/SSAO.h>
+
+namespace CpuRendering
+{
+
+//Layers of the multi-scale SSAO, the same count as MultiScaleCombine.ps combines
+const int MultiScaleLayersCount = 3;
+
+struct MultiScaleLayer
+{
+    //over SSAOParams::occlusionRadius
+    float radiusScale = 1.0f;
+    //1, 2 or 4, not less than the one of the previous layer
+    int resolutionScale = 1;
+    //every sampleStep sample of the kernel is taken, the sampleStep variable of SSAOv3.ps
+    int sampleStep = 1;
+};
+
+//Same constants as in MultiScaleCombine.ps
+enum MultiScaleCombine
+{
+    //the most occluding layer wins, the scales do not darken the creases twice
+    MULTI_SCALE_COMBINE_MAX_OCCLUSION,
+    //layers occlude independently, contact shadows darken the large scale occlusion
+    MULTI_SCALE_COMBINE_MULTIPLY
+};
+
+//Layers of x0.25 (contact shadows), x1 and x4 of the radius. Each takes every second kernel sample, the contact layer
+//at full resolution, the other two at quarter resolution. The default has to cost less than the single scale SSAO
+//of the full kernel, the contact layer alone takes about 3/4 of it
+struct MultiScaleParams
+{
+    MultiScaleLayer layers[MultiScaleLayersCount];
+    MultiScaleCombine combine = MULTI_SCALE_COMBINE_MULTIPLY;
+    MultiScaleParams()
+    {
+        const float radiusScales[MultiScaleLayersCount] = {0.25f, 1.0f, 4.0f};
+        const int resolutionScales[MultiScaleLayersCount] = {1, 4, 4};
+        const int sampleSteps[MultiScaleLayersCount] = {2, 2, 2};
+
+        for(int l = 0; l < MultiScaleLayersCount; l++){
+            layers[l].radiusScale = radiusScales[l];
+            layers[l].resolutionScale = resolutionScales[l];
+            layers[l].sampleStep = sampleSteps[l];
+        }
+    }
+};
+
+//Visibility^2 of the layers combined by the rule, min of the squares is the square of the min
+float CombineMultiScale(float A, float B, MultiScaleCombine Combine);
+
+//Every layer is SSAO of the normal/depth buffer downsampled to the layer resolution with the radius and
+//the kernel subset of the layer. Layers are combined from the coarsest one: the combined occlusion is brought
+//to the resolution of the next layer by the joint bilateral upsampling and combined with it per pixel,
+//so only one upsampling runs at full resolution. Mirrors the multi-scale mode of Application
+class MultiScaleSSAOEngine : public IAOEngine
+{
+private:
+    ThreadPool *pool = NULL;
+    int tileSize = 32;
+    MultiScaleParams multiScaleParams;
+public:
+    MultiScaleSSAOEngine(){}
+    MultiScaleSSAOEngine(ThreadPool *Pool, int TileSize = 32) : pool(Pool), tileSize(TileSize){}
+    void SetThreadPool(ThreadPool *Pool){pool = Pool;}
+    void SetMultiScaleParams(const MultiScaleParams &Params) throw (Exception);
+    const MultiScaleParams &GetMultiScaleParams() const {return multiScaleParams;}
+    virtual const char *GetName() const {return "Multi-scale SSAO";}
+    //per full resolution pixel, rounded up
+    virtual int GetDepthFetchesCount(const SSAOParams &Params) const;
+    virtual void Compute(const NormalDepthImage &NormalDepth, const SSAOParams &Params, OcclusionImage &Occlusion) const throw (Exception);
+    //SSAO of one layer, LayerNormalDepth is of the layer resolution, Params are of the base radius and the full kernel
+    void ComputeLayer(const NormalDepthImage &LayerNormalDepth, const SSAOParams &Params, int Layer, OcclusionImage &Occlusion) const throw (Exception);
+};
+
+}
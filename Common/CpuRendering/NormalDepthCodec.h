@@ -0,0 +1,66 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#pragma once
+#include <CpuRendering/Image.h>
+#include <CpuRendering/ThreadPool.h>
+
+namespace CpuRendering
+{
+
+//Packed normal/depth texel, the layout of DXGI_FORMAT_R16G16B16A16_UNORM ndRt.
+//normalX, normalY - octahedral view space normal, depthHigh, depthLow - linear view space depth
+//over PackedMaxDepth in 1/65535 steps and the fraction of the step. All zero is the background.
+//Mirrors NormalDepthCodec.fxh
+struct PackedNormalDepth
+{
+    unsigned short normalX = 0, normalY = 0;
+    unsigned short depthHigh = 0, depthLow = 0;
+};
+
+//16 bit depth leaves depthLow zero, so both precisions decode the same way
+enum DepthPrecision
+{
+    DEPTH_PRECISION_16,
+    DEPTH_PRECISION_32
+};
+
+//Packed bent normal texel, the layout of DXGI_FORMAT_R8G8_UNORM bentNormalRt: octahedral view space direction
+struct PackedBentNormal
+{
+    unsigned char x = 0, y = 0;
+};
+
+//far plane of the demo camera, depths past it are clamped
+const float PackedMaxDepth = 1000.0f;
+
+typedef Image<PackedNormalDepth> PackedNormalDepthImage;
+//AO and blur targets, DXGI_FORMAT_R8_UNORM
+typedef Image<unsigned char> PackedOcclusionImage;
+typedef Image<PackedBentNormal> PackedBentNormalImage;
+
+//Octahedral mapping of a unit vector to [0, 1]^2 (Meyer et al. 2010)
+Float2 EncodeOctahedral(const Float3 &Normal);
+Float3 DecodeOctahedral(const Float2 &Encoded);
+
+PackedNormalDepth EncodeNormalDepth(const Float4 &NormalDepth, DepthPrecision Precision = DEPTH_PRECISION_32);
+Float4 DecodeNormalDepth(const PackedNormalDepth &Packed);
+
+inline unsigned char EncodeOcclusion(float Occlusion) {return (unsigned char)(Saturate(Occlusion) * 255.0f + 0.5f);}
+inline float DecodeOcclusion(unsigned char Packed) {return Packed * (1.0f / 255.0f);}
+
+PackedBentNormal EncodeBentNormal(const Float3 &BentNormal);
+Float3 DecodeBentNormal(const PackedBentNormal &Packed);
+
+void PackNormalDepth(const NormalDepthImage &NormalDepth, DepthPrecision Precision, PackedNormalDepthImage &Packed, ThreadPool *Pool = NULL) throw (Exception);
+void UnpackNormalDepth(const PackedNormalDepthImage &Packed, NormalDepthImage &NormalDepth, ThreadPool *Pool = NULL) throw (Exception);
+void PackOcclusion(const OcclusionImage &Occlusion, PackedOcclusionImage &Packed, ThreadPool *Pool = NULL) throw (Exception);
+void UnpackOcclusion(const PackedOcclusionImage &Packed, OcclusionImage &Occlusion, ThreadPool *Pool = NULL) throw (Exception);
+void PackBentNormals(const Image<Float3> &BentNormals, PackedBentNormalImage &Packed, ThreadPool *Pool = NULL) throw (Exception);
+void UnpackBentNormals(const PackedBentNormalImage &Packed, Image<Float3> &BentNormals, ThreadPool *Pool = NULL) throw (Exception);
+
+}
@@ -0,0 +1,43 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#pragma once
+#include <CpuRendering/Image.h>
+#include <CpuRendering/ThreadPool.h>
+#include <CpuRendering/DepthPyramid.h>
+
+namespace CpuRendering
+{
+
+//View space normal from the view space positions of the neighbour pixels, the input of the depth only prepass.
+//The normal is cross(dx, dy) of the position differences along the screen axes, the methods differ in the
+//neighbour every axis takes
+enum NormalReconstruction
+{
+    //right and bottom neighbours, what ddx and ddy of the position give in a pixel shader
+    NORMAL_RECONSTRUCTION_SIMPLE,
+    //neighbour of the closer depth on every axis
+    NORMAL_RECONSTRUCTION_NEAREST,
+    //side of the axis whose two pixels extrapolate the depth of the center better, keeps the normals
+    //of the pixels next to the creases and silhouettes on their own plane. Mirrors NormalReconstruction.fxh
+    NORMAL_RECONSTRUCTION_BEST_OF_NEIGHBOURS
+};
+
+//view space position of the pixel center, background depth gives the zero vector
+Float3 GetViewPosition(const DepthImage &Depth, const Matrix &InvProj, int X, int Y);
+
+//Normal facing the camera, (0, 0, -1) if all neighbours of an axis are background
+Float3 ReconstructNormal(const DepthImage &Depth, const Matrix &InvProj, int X, int Y, NormalReconstruction Method);
+
+//Normal/depth buffer of the depth, background stays (1, 1, 1, 0) as in the buffer of the normal/depth prepass
+void ReconstructNormals(const DepthImage &Depth, const Matrix &InvProj, NormalReconstruction Method,
+                        NormalDepthImage &NormalDepth, ThreadPool *Pool = NULL) throw (Exception);
+
+//.w of the normal/depth buffer, what the depth only prepass writes
+void ExtractDepth(const NormalDepthImage &NormalDepth, DepthImage &Depth, ThreadPool *Pool = NULL) throw (Exception);
+
+}
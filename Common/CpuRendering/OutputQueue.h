@@ -0,0 +1,48 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#pragma once
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+#include <Exception.h>
+
+namespace CpuRendering
+{
+
+//Jobs run in the push order on a writer thread of its own, so the render workers do not wait for the disk.
+//Push blocks while MaxPendingJobs are waiting, that bounds the memory of the images in flight.
+//The first exception of a job is rethrown by Finish, the jobs after it are dropped
+class OutputQueue
+{
+public:
+    typedef std::function<void()> Job;
+private:
+    std::deque<Job> jobs;
+    std::thread writer;
+    std::mutex mutex;
+    std::condition_variable jobsCondition, spaceCondition;
+    size_t maxPendingJobs = 0;
+    size_t doneJobs = 0;
+    bool finishing = false;
+    std::exception_ptr jobException;
+    void WriterLoop();
+public:
+    OutputQueue(const OutputQueue &) = delete;
+    OutputQueue &operator= (const OutputQueue &) = delete;
+    OutputQueue(size_t MaxPendingJobs = 16);
+    ~OutputQueue();
+    void Push(const Job &NewJob) throw (Exception);
+    //waits for the pushed jobs, the queue takes no jobs after it
+    void Finish();
+    size_t GetDoneJobsCount();
+};
+
+}
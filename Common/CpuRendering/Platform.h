@@ -0,0 +1,83 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#pragma once
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <Exception.h>
+
+//OS services of the render farm for Win32 and POSIX, the OS headers stay in Platform.cpp
+namespace CpuRendering
+{
+
+//Read only view of a whole file, the pages are shared by all the processes that map it
+class MappedFile
+{
+private:
+    const void *data = NULL;
+    size_t size = 0;
+    intptr_t file = -1, mapping = -1;
+public:
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator= (const MappedFile &) = delete;
+    MappedFile(){}
+    ~MappedFile(){Close();}
+    void Open(const std::string &FileName) throw (Exception);
+    void Close();
+    const void *GetData() const {return data;}
+    size_t GetSize() const {return size;}
+};
+
+//Blocking TCP stream socket
+class Socket
+{
+private:
+    intptr_t handle = -1;
+public:
+    Socket(const Socket &) = delete;
+    Socket &operator= (const Socket &) = delete;
+    Socket(){}
+    Socket(Socket &&Other) : handle(Other.handle){Other.handle = -1;}
+    Socket &operator= (Socket &&Other);
+    ~Socket(){Close();}
+    //on 127.0.0.1, Port 0 takes any free port
+    void Listen(unsigned short Port = 0) throw (Exception);
+    unsigned short GetPort() const throw (Exception);
+    //false if no connection came in TimeoutMs
+    bool Accept(int TimeoutMs, Socket &Connection) throw (Exception);
+    void Connect(const std::string &Host, unsigned short Port) throw (Exception);
+    void SendAll(const void *Data, size_t Size) throw (Exception);
+    //throws if the peer closes the connection or dies before Size bytes came
+    void ReceiveAll(void *Data, size_t Size) throw (Exception);
+    bool IsOpen() const {return handle != -1;}
+    void Close();
+};
+
+class ChildProcess
+{
+private:
+    intptr_t handle = -1;
+public:
+    ChildProcess(const ChildProcess &) = delete;
+    ChildProcess &operator= (const ChildProcess &) = delete;
+    ChildProcess(){}
+    ~ChildProcess(){Kill();}
+    //Arguments[0] is the executable
+    void Start(const std::vector<std::string> &Arguments) throw (Exception);
+    //exit code of the process, -1 if it was killed by a signal or is not started
+    int Wait();
+    void Kill();
+    bool IsStarted() const {return handle != -1;}
+};
+
+std::string GetExecutablePath() throw (Exception);
+
+//ends the process at once, without the destructors and the buffered output, as a crash would
+void ExitImmediately(int ExitCode);
+
+}
@@ -0,0 +1,109 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#pragma once
+#include <vector>
+#include <stdint.h>
+#include <CpuRendering/Image.h>
+#include <CpuRendering/ThreadPool.h>
+#include <CpuRendering/Mesh.h>
+
+namespace CpuRendering
+{
+
+//Constants of NormalVDepthV.vs, SSAODrawer::BeginDraw sets them for PASS_DRAW_DEPTH
+struct PrepassTransforms
+{
+    Matrix worldViewProj, worldInvTransView, worldView;
+};
+
+PrepassTransforms CreatePrepassTransforms(const Matrix &World, const Matrix &View, const Matrix &Proj);
+
+struct RasterizerCounters
+{
+    size_t triangles = 0;
+    //outside of the view frustum or covering no pixel center
+    size_t culled = 0;
+    //split by the near, the far or the guard band planes
+    size_t clipped = 0;
+    //triangle references of all bins
+    size_t binned = 0;
+};
+
+//NormalVDepthV prepass without a GPU, with the D3D11 rules the demo draws by: the near and the far planes clip,
+//pixel centers are covered by the top-left rule on the 8 bit subpixel grid, the depth test is LESS and both windings
+//are drawn (NotCull state). Chunks of triangles are set up and binned to the screen tiles in parallel, then the tiles
+//are rasterized in parallel and keep the draw order. The edge functions are exact 64 bit integers, tested for 4 pixels
+//at once with SSE2, the attributes are interpolated 4 pixels at once with the perspective correction
+class NormalDepthRasterizer
+{
+public:
+    static const int TileSize = 64;
+    //triangles of one setup and binning task
+    static const int ChunkSize = 4096;
+    //|x| and |y| of the clip space over w, farther vertices are clipped, so the edge functions fit 64 bits
+    static const int GuardBand = 256;
+private:
+    struct ClipVertex
+    {
+        Float4 pos;
+        Float3 normal;
+        float viewZ = 0.0f;
+        //planes of the clip space the vertex is outside of
+        unsigned int outCode = 0;
+        //snapped screen position and 1 / w, valid inside of the clipping planes
+        int64_t screenX = 0, screenY = 0;
+        float invW = 0.0f;
+    };
+    enum Attribute
+    {
+        ATTRIBUTE_DEPTH,
+        ATTRIBUTE_INV_W,
+        ATTRIBUTE_NORMAL_X,
+        ATTRIBUTE_NORMAL_Y,
+        ATTRIBUTE_NORMAL_Z,
+        ATTRIBUTE_VIEW_Z,
+        ATTRIBUTES_COUNT
+    };
+    struct RasterTriangle
+    {
+        //snapped vertices in 1/256 of a pixel, clockwise on the screen
+        int64_t x[3], y[3];
+        //-1 for the edges that are neither top nor left, their pixel centers are not covered
+        int64_t bias[3];
+        //pixels of the viewport, inclusive
+        int minX, minY, maxX, maxY;
+        //vertex 0 in pixels, the value there and the screen gradients of z/w and of the attributes over w
+        float originX, originY;
+        float planes[ATTRIBUTES_COUNT][3];
+    };
+    ThreadPool *pool = NULL;
+    int width = 0, height = 0, depthStride = 0;
+    int tilesX = 0, tilesY = 0;
+    std::vector<float> depth;
+    std::vector<ClipVertex> vertices;
+    //triangles and bins of every chunk, bins keep the triangles of a chunk that overlap a tile
+    std::vector<std::vector<RasterTriangle> > triangles;
+    std::vector<std::vector<std::vector<uint32_t> > > bins;
+    std::vector<RasterizerCounters> chunkCounters;
+    RasterizerCounters counters;
+    void ProjectVertex(ClipVertex &Vertex) const;
+    void SetupTriangle(const ClipVertex &A, const ClipVertex &B, const ClipVertex &C, size_t Chunk);
+    void AddTriangle(const ClipVertex &A, const ClipVertex &B, const ClipVertex &C, size_t Chunk);
+    void RasterizeTile(int TileX, int TileY, NormalDepthImage &NormalDepth);
+public:
+    NormalDepthRasterizer(){}
+    NormalDepthRasterizer(ThreadPool *Pool) : pool(Pool){}
+    void SetThreadPool(ThreadPool *Pool){pool = Pool;}
+    //RenderPass of ndRt: the normal/depth is (1, 1, 1, 0) and the depth buffer is 1
+    void Clear(int Width, int Height, NormalDepthImage &NormalDepth) throw (Exception);
+    void Draw(const MeshView &Mesh, const PrepassTransforms &Transforms, NormalDepthImage &NormalDepth) throw (Exception);
+    //of the last Draw
+    const RasterizerCounters &GetCounters() const {return counters;}
+};
+
+}
@@ -0,0 +1,72 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#pragma once
+#include <vector>
+#include <string>
+#include <CpuRendering/Image.h>
+#include <CpuRendering/ThreadPool.h>
+#include <CpuRendering/Mesh.h>
+#include <CpuRendering/CameraPath.h>
+#include <CpuRendering/BatchAO.h>
+
+namespace CpuRendering
+{
+
+//SSAO and edge saving blur of Region of the view only, with the same values the full screen passes give there.
+//SSAO is computed for Region grown by the blur radius per iteration, every blur pass shrinks it back by the radius.
+//Occlusion and Intermediate are full screen images, only the pixels of the grown region are written
+void RenderAOTile(const NormalDepthImage &NormalDepth, const BatchAOParams &Params, const Tile &Region, OcclusionImage &Occlusion,
+                  OcclusionImage &Intermediate, ThreadPool *Pool = NULL) throw (Exception);
+
+struct RenderFarmParams
+{
+    //0 - one job per view, otherwise square tiles of the view
+    int tileSize = 0;
+    //a job whose workers were lost that many times fails the render
+    int maxAttempts = 3;
+    int connectTimeoutMs = 30000;
+};
+
+struct RenderFarmCounters
+{
+    size_t views = 0, jobs = 0;
+    //jobs handed out again after their worker was lost
+    size_t requeued = 0;
+    size_t connectedWorkers = 0, lostWorkers = 0;
+    //R8 AO tiles received
+    size_t resultBytes = 0;
+    double seconds = 0.0;
+    double GetViewsPerSecond() const {return (seconds > 0.0) ? views / seconds : 0.0;}
+};
+
+//Coordinator of the render farm processes on localhost. It starts a worker process per command, hands out the frame
+//or tile jobs over TCP and puts the returned tiles together. A worker lost mid-job (crashed, killed, disconnected)
+//puts its job back to the queue for the rest of the workers. The messages are in the byte order of the machine.
+//Tiles come back as R8 like ssaoRt keeps the AO, so the result matches BatchAORenderer within the R8 rounding
+class RenderFarmCoordinator
+{
+public:
+    //called on the connection threads when all the tiles of a view are in
+    typedef BatchAORenderer::ViewCallback ViewCallback;
+private:
+    RenderFarmCounters counters;
+public:
+    //every command is the executable and its arguments, the port of the coordinator is appended as the last argument
+    void Render(const CameraPath &Views, int Width, int Height, const RenderFarmParams &Params,
+                const std::vector<std::vector<std::string> > &WorkerCommands, const ViewCallback &Output) throw (Exception);
+    //of the last Render
+    const RenderFarmCounters &GetCounters() const {return counters;}
+};
+
+//Worker side: connects to the coordinator on Port of localhost and renders its jobs until it says to quit.
+//The prepass of the last view is kept for its next tiles. With CrashAfterJobs the process ends without a reply
+//when that job comes, to test the re-queueing
+void RunRenderFarmWorker(unsigned short Port, const MeshView &Mesh, const BatchAOParams &Params, ThreadPool *Pool = NULL,
+                         int CrashAfterJobs = 0) throw (Exception);
+
+}
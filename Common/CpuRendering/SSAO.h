@@ -0,0 +1,216 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#pragma once
+#include <vector>
+#include <CpuRendering/Math.h>
+#include <CpuRendering/Image.h>
+#include <CpuRendering/ThreadPool.h>
+#include <CpuRendering/Upsampling.h>
+#include <CpuRendering/DepthPyramid.h>
+#include <CpuRendering/Deinterleave.h>
+#include <CpuRendering/TileClassification.h>
+#include <CpuRendering/AOEngine.h>
+
+namespace CpuRendering
+{
+
+typedef std::vector<Float4> KernelStorage;
+
+//rgb in [0, 1], the same values the R8G8B8A8_UNORM random offsets texture holds
+typedef Image<Float3> RandomOffsetsImage;
+
+//view space unit bent normals, the normal of the surface for the background and the fully occluded pixels
+typedef Image<Float3> BentNormalImage;
+
+//rand() based generator, the kernel SSAOv3.ps used before the low discrepancy ones
+KernelStorage CreateKernel(size_t KernelSize);
+
+enum KernelSequence
+{
+    KERNEL_SEQUENCE_RANDOM,
+    //(i + 0.5) / N, radical inverses in bases 2 and 3
+    KERNEL_SEQUENCE_HAMMERSLEY,
+    //radical inverses in bases 2, 3 and 5, any prefix of the kernel is well distributed
+    KERNEL_SEQUENCE_HALTON
+};
+
+//Points of the sequence mapped to the cosine weighted hemisphere around +z,
+//lengths are spread over [0.1, 0.9] by the square of the third dimension of the sequence.
+//Deterministic for the low discrepancy sequences
+KernelStorage CreateKernel(size_t KernelSize, KernelSequence Sequence);
+
+//Sample counts SSAOv3.ps is compiled for (SAMPLES_COUNT define)
+template<int SamplesCount>
+struct IsSupportedSamplesCount
+{
+    static const bool value = SamplesCount == 4 || SamplesCount == 8 || SamplesCount == 16 || SamplesCount == 32 || SamplesCount == 64;
+};
+
+//Kernel of the "kernel" variable of the SSAOv3.ps permutation compiled with SAMPLES_COUNT = SamplesCount
+template<int SamplesCount>
+KernelStorage CreateKernel(KernelSequence Sequence = KERNEL_SEQUENCE_HAMMERSLEY)
+{
+    static_assert(IsSupportedSamplesCount<SamplesCount>::value, "SSAO samples count must be 4, 8, 16, 32 or 64");
+
+    return CreateKernel(SamplesCount, Sequence);
+}
+
+//Same generator as used for the random offsets texture, Bytes receives RGBA texels
+RandomOffsetsImage CreateRandomOffsets(int Width, int Height, std::vector<unsigned char> *Bytes = NULL);
+
+RandomOffsetsImage RandomOffsetsFromBytes(int Width, int Height, const unsigned char *Bytes);
+
+//Inputs of every AO technique, the kernel is used by SSAOEngine only
+struct SSAOParams
+{
+    KernelStorage kernel;
+    RandomOffsetsImage randomOffsets;
+    Matrix proj, invProj;
+    float occlusionRadius = 0.8f;
+    float harshness = 1.5f;
+};
+
+//CPU implementation of ProcessPixel from SSAOv3.ps.
+//The screen is split to tiles which are shaded by the thread pool.
+//Texture fetches mirror the shader samplers: the normal/depth buffer is read with
+//bilinear filtering and clamp addressing, the random offsets with point filtering and wrap addressing.
+//Result differs from the GPU one only by the fixed point precision of hardware bilinear filtering
+//(8 bit weights), that is below 1/255 for pixels whose samples do not straddle a depth discontinuity.
+//With resolution scale 2 or 4 occlusion is computed for the downsampled normal/depth buffer
+//and brought back to the full resolution by the joint bilateral upsampling, as SSAODrawer does.
+//With the depth pyramid taps read the depth from the pyramid level chosen by their screen space distance.
+//In the deinterleaved mode pixels are shaded layer by layer and their taps read the depth of their layer,
+//the depth pyramid is not used then.
+//With the adaptive sampling the buffer is classified by 8x8 tiles first, skipped tiles get the visibility of 1,
+//reduced ones are shaded with the subset of every reducedSampleStep kernel sample
+class SSAOEngine : public IAOEngine
+{
+private:
+    ThreadPool *pool = NULL;
+    int tileSize = 32;
+    int resolutionScale = 1;
+    bool useDepthPyramid = false;
+    bool deinterleaved = false;
+    bool adaptiveSampling = false;
+    TileClassificationParams classificationParams;
+    BilateralUpsampleParams upsampleParams;
+    void ComputeTiles(const NormalDepthImage &NormalDepth, const SSAOParams &Params, OcclusionImage &Occlusion) const throw (Exception);
+    void ComputeDeinterleaved(const NormalDepthImage &NormalDepth, const SSAOParams &Params, OcclusionImage &Occlusion,
+                              const TileClassification *Classification) const throw (Exception);
+    void ComputeClassified(const NormalDepthImage &NormalDepth, const SSAOParams &Params, OcclusionImage &Occlusion,
+                           const TileClassification &Classification, const DepthPyramid *Pyramid) const;
+    void CheckParams(const SSAOParams &Params) const throw (Exception);
+public:
+    SSAOEngine(){}
+    SSAOEngine(ThreadPool *Pool, int TileSize = 32) : pool(Pool), tileSize(TileSize){}
+    void SetThreadPool(ThreadPool *Pool){pool = Pool;}
+    void SetTileSize(int TileSize){tileSize = TileSize;}
+    int GetTileSize() const {return tileSize;}
+    //1 - full, 2 - half, 4 - quarter resolution
+    void SetResolutionScale(int Scale) throw (Exception);
+    int GetResolutionScale() const {return resolutionScale;}
+    void SetUpsampleParams(const BilateralUpsampleParams &Params){upsampleParams = Params;}
+    const BilateralUpsampleParams &GetUpsampleParams() const {return upsampleParams;}
+    //pyramid is built for every Compute call from the normal/depth buffer occlusion is computed for.
+    //It cuts the modelled cache misses at every radius, but at the default radius 0.8 the build and the per tap
+    //level selection outweigh them and the pass is slower than the flat lookup, see the pyramid benchmark
+    void SetDepthPyramidMode(bool Use){useDepthPyramid = Use;}
+    bool GetDepthPyramidMode() const {return useDepthPyramid;}
+    //needs random offsets of DeinterleaveFactor x DeinterleaveFactor
+    void SetDeinterleavedMode(bool Deinterleaved){deinterleaved = Deinterleaved;}
+    bool GetDeinterleavedMode() const {return deinterleaved;}
+    //classification is built for every Compute call from the normal/depth buffer occlusion is computed for
+    void SetAdaptiveSampling(bool Use, const TileClassificationParams &Params = TileClassificationParams()){adaptiveSampling = Use; classificationParams = Params;}
+    bool GetAdaptiveSampling() const {return adaptiveSampling;}
+    const TileClassificationParams &GetTileClassificationParams() const {return classificationParams;}
+    virtual const char *GetName() const {return "SSAO";}
+    virtual int GetDepthFetchesCount(const SSAOParams &Params) const {return (int)Params.kernel.size();}
+    virtual void Compute(const NormalDepthImage &NormalDepth, const SSAOParams &Params, OcclusionImage &Occlusion) const throw (Exception);
+    //Occlusion and the average unoccluded direction of the same taps, the BENT_NORMALS permutation of SSAOv3.ps.
+    //Full resolution, interleaved and non adaptive modes only
+    void ComputeWithBentNormals(const NormalDepthImage &NormalDepth, const SSAOParams &Params, OcclusionImage &Occlusion,
+                                BentNormalImage &BentNormals) const throw (Exception);
+    //Pyramid is optional, taps read NormalDepth if it is NULL
+    static void ComputeTile(const NormalDepthImage &NormalDepth, const SSAOParams &Params, const Tile &Region, OcclusionImage &Occlusion, const DepthPyramid *Pyramid = NULL);
+    static float ComputePixel(const NormalDepthImage &NormalDepth, const SSAOParams &Params, int X, int Y, const DepthPyramid *Pyramid = NULL);
+    //1 - totalOcclusion / samplesCount, the value ComputePixel squares
+    static float ComputeVisibility(const NormalDepthImage &NormalDepth, const SSAOParams &Params, int X, int Y, const DepthPyramid *Pyramid = NULL);
+};
+
+//Bilinear fetch of the .w channel with clamp addressing, TexCoord in [0, 1]
+float SampleDepthLinear(const NormalDepthImage &NormalDepth, const Float2 &TexCoord);
+
+//Depth sampler of ComputeSSAOVisibility reading the full resolution normal/depth buffer
+class FlatDepthSampler
+{
+private:
+    const NormalDepthImage &normalDepth;
+public:
+    FlatDepthSampler(const NormalDepthImage &NormalDepth) : normalDepth(NormalDepth){}
+    float Sample(const Float2 &TexCoord, const Float2 &OriginTexCoord) const {return SampleDepthLinear(normalDepth, TexCoord);}
+};
+
+//ProcessPixel loop of SSAOv3.ps without the final pow. TDepthSampler provides
+//float Sample(const Float2 &TexCoord, const Float2 &OriginTexCoord) const, OriginTexCoord is the shaded pixel center.
+//BentNormal is optional, it receives the view space bent normal of the BENT_NORMALS permutation
+template<class TDepthSampler>
+float ComputeSSAOVisibility(const NormalDepthImage &NormalDepth, const SSAOParams &Params, int X, int Y, const TDepthSampler &Sampler,
+                            Float3 *BentNormal = NULL)
+{
+    const Float4 &normalDepthData = NormalDepth.At(X, Y);
+
+    Float3 normalV = Normalize(normalDepthData.Xyz());
+
+    Float2 originTc((X + 0.5f) / NormalDepth.GetWidth(), (Y + 0.5f) / NormalDepth.GetHeight());
+
+    //eyeRayN is the interpolated NDC position of the screen quad
+    Float4 eyeRayN(2.0f * originTc.x - 1.0f, 1.0f - 2.0f * originTc.y, 1.0f, 1.0f);
+
+    Float3 viewRay = Transform(eyeRayN, Params.invProj).Xyz() * normalDepthData.w;
+
+    const RandomOffsetsImage &rnd = Params.randomOffsets;
+    Float3 offset = Normalize(rnd.At(X % rnd.GetWidth(), Y % rnd.GetHeight()) * 2.0f - Float3(1.0f, 1.0f, 1.0f));
+
+    float totalOcclusion = 0.0f;
+    Float3 bentSum;
+
+    for(const Float4 &k : Params.kernel){
+
+        Float3 samplingRayL = Reflect(k.Xyz(), offset);
+        samplingRayL *= Sign(Dot(samplingRayL, normalV));
+
+        Float3 samplingPosV = viewRay + samplingRayL * Params.occlusionRadius;
+
+        Float4 samplingPosH = Transform(Float4(samplingPosV, 1.0f), Params.proj);
+        samplingPosH.x /= samplingPosH.w;
+        samplingPosH.y /= samplingPosH.w;
+
+        Float2 samplingTc(0.5f * samplingPosH.x + 0.5f, -0.5f * samplingPosH.y + 0.5f);
+
+        float sampledDepth = Sampler.Sample(samplingTc, originTc);
+
+        float sampleOcclusion = 0.0f;
+        if(sampledDepth - samplingPosV.z < 0.0f)
+            sampleOcclusion = (1.0f - Saturate(fabsf(viewRay.z - sampledDepth) / Params.occlusionRadius)) * Params.harshness;
+
+        totalOcclusion += sampleOcclusion;
+
+        //unoccluded part of the tap direction, the taps keep their kernel lengths
+        if(BentNormal != NULL)
+            bentSum += samplingRayL * (1.0f - Saturate(sampleOcclusion));
+    }
+
+    if(BentNormal != NULL){
+        float bentLength = Length(bentSum);
+        *BentNormal = (bentLength > 1e-4f) ? bentSum / bentLength : normalV;
+    }
+
+    return 1.0f - totalOcclusion / Params.kernel.size();
+}
+
+}
@@ -0,0 +1,79 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#pragma once
+#include <vector>
+#include <string>
+#include <CpuRendering/SSAO.h>
+
+namespace CpuRendering
+{
+
+enum SimdLevel
+{
+    SIMD_SCALAR,
+    SIMD_SSE41,
+    SIMD_AVX2
+};
+
+SimdLevel GetSupportedSimdLevel();
+
+std::string GetSimdLevelName(SimdLevel Level);
+
+//Structure of arrays copy of the normal/depth buffer, normals are stored normalized
+class NormalDepthPlanes
+{
+private:
+    int width = 0, height = 0;
+    std::vector<float> nx, ny, nz, depth;
+public:
+    void Init(const NormalDepthImage &NormalDepth);
+    int GetWidth() const {return width;}
+    int GetHeight() const {return height;}
+    const float *GetNormalsX() const {return nx.data();}
+    const float *GetNormalsY() const {return ny.data();}
+    const float *GetNormalsZ() const {return nz.data();}
+    const float *GetDepths() const {return depth.data();}
+};
+
+//Data shared by the SSAOv3.ps loop implementations
+struct SimdSSAOContext
+{
+    const NormalDepthPlanes *planes = NULL;
+    const SSAOParams *params = NULL;
+    //normalize(2 * rnd - 1) for every texel of the random offsets tile
+    std::vector<Float3> offsets;
+    OcclusionImage *occlusion = NULL;
+};
+
+float ComputeSSAOPixelScalar(const SimdSSAOContext &Context, int X, int Y);
+
+typedef void (*SimdSSAOFunction)(const SimdSSAOContext &Context, const Tile &Region);
+
+void ComputeSSAOTileScalar(const SimdSSAOContext &Context, const Tile &Region);
+void ComputeSSAOTileSSE41(const SimdSSAOContext &Context, const Tile &Region);
+void ComputeSSAOTileAVX2(const SimdSSAOContext &Context, const Tile &Region);
+
+//Same algorithm as SSAOEngine but vectorized over 4 (SSE4.1) or 8 (AVX2) pixels of a row
+class SimdSSAOEngine
+{
+private:
+    ThreadPool *pool = NULL;
+    int tileSize = 32;
+    SimdLevel level = SIMD_SCALAR;
+public:
+    SimdSSAOEngine() : level(GetSupportedSimdLevel()){}
+    SimdSSAOEngine(ThreadPool *Pool) : pool(Pool), level(GetSupportedSimdLevel()){}
+    void SetThreadPool(ThreadPool *Pool){pool = Pool;}
+    void SetTileSize(int TileSize){tileSize = TileSize;}
+    //levels the CPU does not support are lowered to the best supported one
+    void SetSimdLevel(SimdLevel Level);
+    SimdLevel GetSimdLevel() const {return level;}
+    void Compute(const NormalDepthPlanes &Planes, const SSAOParams &Params, OcclusionImage &Occlusion) const throw (Exception);
+};
+
+}
@@ -0,0 +1,43 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#pragma once
+
+//Intrinsics kernels of SimdSSAOEngine. Their translation units are built for the instruction set,
+//so this header and the kernels include no engine headers: an inline function compiled there
+//could be the copy the linker keeps for the whole program and run on a CPU without the extension
+
+namespace CpuRendering
+{
+
+//Plain copy of the SSAOv3.ps loop inputs
+struct SimdSSAOKernelData
+{
+    const float *normalsX, *normalsY, *normalsZ, *depths;
+    int width, height;
+    //row major 4x4 matrices
+    const float *proj, *invProj;
+    //xyzw of every kernel sample
+    const float *kernel;
+    int kernelSize;
+    //xyz of normalize(2 * rnd - 1) of every texel of the random offsets tile
+    const float *offsets;
+    int rndWidth, rndHeight;
+    float occlusionRadius, harshness;
+    //width floats per row
+    float *occlusion;
+};
+
+//Occlusion of the whole vectors of every row of [Left, Right) x [Top, Bottom), the last (Right - Left) % lanes
+//pixels of the rows are left to the caller. Both kernels do the mul and add sequence of the scalar path, no FMA
+void ComputeSSAOVectorsSSE41(const SimdSSAOKernelData &Data, int Left, int Top, int Right, int Bottom);
+void ComputeSSAOVectorsAVX2(const SimdSSAOKernelData &Data, int Left, int Top, int Right, int Bottom);
+
+const int SSE41Lanes = 4;
+const int AVX2Lanes = 8;
+
+}
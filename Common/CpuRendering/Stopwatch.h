@@ -0,0 +1,54 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#pragma once
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <chrono>
+#endif
+
+namespace CpuRendering
+{
+
+//Wall clock time of the CPU passes, QueryPerformanceCounter on Windows
+class Stopwatch
+{
+private:
+#if defined(_WIN32)
+    LONGLONG start = 0, ticksPerSecond = 0;
+#else
+    std::chrono::steady_clock::time_point start;
+#endif
+public:
+    Stopwatch(){Restart();}
+    void Restart()
+    {
+#if defined(_WIN32)
+        QueryPerformanceFrequency(reinterpret_cast<LARGE_INTEGER*>(&ticksPerSecond));
+        QueryPerformanceCounter(reinterpret_cast<LARGE_INTEGER*>(&start));
+#else
+        start = std::chrono::steady_clock::now();
+#endif
+    }
+    double GetSeconds() const
+    {
+#if defined(_WIN32)
+        LONGLONG now;
+        QueryPerformanceCounter(reinterpret_cast<LARGE_INTEGER*>(&now));
+        return (double)(now - start) / (double)ticksPerSecond;
+#else
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+#endif
+    }
+};
+
+}
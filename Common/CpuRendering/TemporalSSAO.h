@@ -0,0 +1,67 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#pragma once
+#include <CpuRendering/SSAO.h>
+
+namespace CpuRendering
+{
+
+//Kernel is split to this count of interleaved subsets, frame N takes samples i with i % count == N % count.
+//History keeps the visibility of every subset in its own channel
+const int TemporalSubsetsCount = 4;
+
+//Marks a history channel that has no value yet
+const float TemporalHistoryEmpty = -1000.0f;
+
+//Same constants as in TemporalSSAO.ps
+struct TemporalParams
+{
+    //reprojected depth may differ from the previous frame one by this part of the depth
+    float depthThreshold = 0.05f;
+    //min cosine between the reprojected and the previous frame normals
+    float normalThreshold = 0.9f;
+};
+
+//x, y, z, w - visibility of the subsets 0, 1, 2, 3
+typedef Image<Float4> TemporalHistoryImage;
+
+KernelStorage GetKernelSubset(const KernelStorage &Kernel, int Subset, int SubsetsCount = TemporalSubsetsCount);
+
+//CPU implementation of the temporal SSAO of SSAODrawer. Every frame evaluates one kernel subset,
+//the other subsets are taken from the history reprojected with the previous frame view matrix.
+//History of a pixel is rejected when the previous frame depth or normal at the reprojected
+//position disagrees with the current surface. With a static camera the result is equal
+//to the full kernel SSAO after TemporalSubsetsCount frames.
+class TemporalSSAOEngine
+{
+private:
+    ThreadPool *pool = NULL;
+    int tileSize = 32;
+    TemporalParams temporalParams;
+    TemporalHistoryImage history, prevHistory;
+    NormalDepthImage prevNormalDepth;
+    Matrix prevView;
+    int frameIndex = 0;
+    bool hasHistory = false;
+    float historyAcceptance = 0.0f;
+public:
+    TemporalSSAOEngine(){}
+    TemporalSSAOEngine(ThreadPool *Pool, int TileSize = 32) : pool(Pool), tileSize(TileSize){}
+    void SetThreadPool(ThreadPool *Pool){pool = Pool;}
+    void SetTemporalParams(const TemporalParams &Params){temporalParams = Params;}
+    const TemporalParams &GetTemporalParams() const {return temporalParams;}
+    //drops the history, e.g. on a camera cut or a resolution change
+    void Reset();
+    int GetFrameIndex() const {return frameIndex;}
+    //part of the pixels which took the history in the last frame
+    float GetHistoryAcceptance() const {return historyAcceptance;}
+    //NormalDepth is drawn with the View matrix, Params.kernel is the full kernel
+    void Compute(const NormalDepthImage &NormalDepth, const Matrix &View, const SSAOParams &Params, OcclusionImage &Occlusion) throw (Exception);
+};
+
+}
@@ -0,0 +1,83 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#pragma once
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <exception>
+
+namespace CpuRendering
+{
+
+struct Tile
+{
+    int left = 0, top = 0, right = 0, bottom = 0;
+    Tile(){}
+    Tile(int Left, int Top, int Right, int Bottom) : left(Left), top(Top), right(Right), bottom(Bottom){}
+    int GetWidth() const {return right - left;}
+    int GetHeight() const {return bottom - top;}
+};
+
+typedef std::vector<Tile> TilesStorage;
+
+TilesStorage SplitToTiles(int Width, int Height, int TileSize);
+//full width bands of RowsCount rows
+TilesStorage SplitToRows(int Width, int Height, int RowsCount);
+
+class ThreadPool
+{
+public:
+    typedef std::function<void(size_t TaskIndex)> Task;
+private:
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wakeUpCondition, doneCondition;
+    const Task *task = NULL;
+    size_t tasksCount = 0;
+    std::atomic<size_t> nextTask;
+    size_t busyWorkers = 0;
+    unsigned int generation = 0;
+    bool stopping = false;
+    std::exception_ptr taskException;
+    void WorkerLoop();
+    void RunTasks();
+public:
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator= (const ThreadPool &) = delete;
+    ThreadPool(){nextTask = 0;}
+    ~ThreadPool(){Release();}
+    //0 - one thread per hardware core, the calling thread is counted as one of them
+    void Init(size_t ThreadsCount = 0);
+    void Release();
+    size_t GetThreadsCount() const {return workers.size() + 1;}
+    //blocks until all tasks are done, rethrows the first exception raised by a task
+    void Execute(size_t TasksCount, const Task &Function);
+    template<class TFunction>
+    void ExecuteForTiles(const TilesStorage &Tiles, const TFunction &Function)
+    {
+        Execute(Tiles.size(), [&](size_t Index){Function(Tiles[Index]);});
+    }
+};
+
+//runs Function for every tile on the pool, or on the calling thread if Pool is NULL
+template<class TFunction>
+void ForEachTile(ThreadPool *Pool, const TilesStorage &Tiles, const TFunction &Function)
+{
+    if(Pool == NULL){
+        for(const Tile &tile : Tiles)
+            Function(tile);
+        return;
+    }
+
+    Pool->ExecuteForTiles(Tiles, Function);
+}
+
+}
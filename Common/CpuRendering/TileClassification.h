@@ -0,0 +1,91 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#pragma once
+#include <vector>
+#include <CpuRendering/Image.h>
+#include <CpuRendering/ThreadPool.h>
+
+namespace CpuRendering
+{
+
+struct SSAOParams;
+
+//Same constants as in TileClassification.ps and SSAOv3.ps
+const int TileClassificationTileSize = 8;
+
+//Skipped tiles are background or so far that the projected occlusion radius is below a texel, their visibility is 1.
+//Reduced tiles are flat and take every ReducedSampleStep sample of the kernel, the rest take the whole kernel
+enum TileClass
+{
+    TILE_CLASS_SKIPPED,
+    TILE_CLASS_REDUCED,
+    TILE_CLASS_FULL,
+    TILE_CLASSES_COUNT
+};
+
+struct TileClassificationParams
+{
+    //in pixels, at the nearest depth of the tile
+    float minScreenRadius = 1.0f;
+    //1 - length of the mean normal of the tile
+    float maxFlatNormalVariance = 0.01f;
+    //over the occlusion radius, larger depth ranges are silhouettes or grazing surfaces
+    float maxFlatDepthRange = 0.5f;
+    int reducedSampleStep = 4;
+};
+
+//Depth bounds and normal variance of the surface pixels of a tile, zero max depth is the background tile
+struct TileStats
+{
+    float minDepth = 0.0f, maxDepth = 0.0f;
+    float normalVariance = 0.0f;
+};
+
+struct TileClassificationCounters
+{
+    size_t tiles[TILE_CLASSES_COUNT];
+    size_t pixels[TILE_CLASSES_COUNT];
+    //kernel samples taken by the shaded tiles and by the whole screen without the classification
+    size_t samples = 0, fullSamples = 0;
+    TileClassificationCounters()
+    {
+        for(int c = 0; c < TILE_CLASSES_COUNT; c++)
+            tiles[c] = pixels[c] = 0;
+    }
+};
+
+//Per tile classification of the normal/depth buffer for the adaptive SSAO sampling, mirrors TileClassification.ps.
+//Lists keep the tiles of every class, so the AO pass goes over the shaded ones only
+class TileClassification
+{
+private:
+    int tilesX = 0, tilesY = 0;
+    std::vector<TileStats> stats;
+    std::vector<TileClass> classes;
+    TilesStorage lists[TILE_CLASSES_COUNT];
+    int reducedSampleStep = 1;
+public:
+    void Build(const NormalDepthImage &NormalDepth, const SSAOParams &Params, const TileClassificationParams &ClassificationParams,
+               ThreadPool *Pool = NULL) throw (Exception);
+    int GetTilesX() const {return tilesX;}
+    int GetTilesY() const {return tilesY;}
+    const TileStats &GetStats(int TileX, int TileY) const {return stats[(size_t)TileY * tilesX + TileX];}
+    TileClass GetClass(int TileX, int TileY) const {return classes[(size_t)TileY * tilesX + TileX];}
+    const TilesStorage &GetTiles(TileClass Class) const {return lists[Class];}
+    int GetReducedSampleStep() const {return reducedSampleStep;}
+    TileClassificationCounters GetCounters(int KernelSize) const;
+};
+
+TileStats GetTileStats(const NormalDepthImage &NormalDepth, const Tile &Region);
+
+//in pixels, the occlusion radius at Depth projected to the normal/depth buffer of Height rows
+float GetProjectedRadius(const SSAOParams &Params, float Depth, int Height);
+
+TileClass ClassifyTile(const TileStats &Stats, const SSAOParams &Params, const TileClassificationParams &ClassificationParams, int Height);
+
+}
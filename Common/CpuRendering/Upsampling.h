@@ -0,0 +1,42 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#pragma once
+#include <CpuRendering/Image.h>
+#include <CpuRendering/ThreadPool.h>
+
+namespace CpuRendering
+{
+
+//Depth and normal sensitivity of the joint bilateral upsampling, the same constants as in BilateralUpsample.ps
+struct BilateralUpsampleParams
+{
+    //depth difference over the depth of the full resolution pixel the weight falls e times over,
+    //a texel across an edge is farther by many of them and drops out
+    float depthTolerance = 0.05f;
+    float normalPower = 8.0f;
+};
+
+//Size of the low resolution buffer for the 1, 1/2 and 1/4 resolution scales, rounded up
+inline int GetScaledSize(int Size, int Scale) {return (Size + Scale - 1) / Scale;}
+
+//Each texel of the result takes the nearest to the camera sample of its Scale x Scale block,
+//background pixels (zero depth) are taken only if the whole block is background.
+//Mirrors DownsampleNormalDepth.ps
+void DownsampleNormalDepth(const NormalDepthImage &NormalDepth, int Scale, NormalDepthImage &Downsampled, ThreadPool *Pool = NULL) throw (Exception);
+
+//Joint bilateral upsampling of the low resolution occlusion guided by the full resolution normals and depths.
+//Bilinear weights of the four nearest low resolution texels are multiplied by the depth and normal similarity,
+//the depth weight stops at the edges. Mirrors BilateralUpsample.ps
+void BilateralUpsample(const OcclusionImage &LowOcclusion,
+                       const NormalDepthImage &LowNormalDepth,
+                       const NormalDepthImage &NormalDepth,
+                       OcclusionImage &Occlusion,
+                       const BilateralUpsampleParams &Params = BilateralUpsampleParams(),
+                       ThreadPool *Pool = NULL) throw (Exception);
+
+}
@@ -7,12 +7,15 @@
 
 #pragma once
 #include <D3DHeaders.h>
+#include <RenderBackend.h>
 
 class DeviceKeeper
 {
 private:
 	static ID3D11Device* device;
 	static ID3D11DeviceContext* context;
+    static RenderBackend::IRenderDevice* renderDevice;
+    static RenderBackend::IRenderContext* renderContext;
     static ID3D11RenderTargetView* renderTargetView;
 	static ID3D11DepthStencilView* depthStencilView;
     static IDXGISwapChain* swapChain;
@@ -22,6 +25,11 @@ public:
     static ID3D11Device *GetDevice(){ return device; }
 	static void SetDeviceContext(ID3D11DeviceContext *Context){ context = Context; }	
 	static ID3D11DeviceContext*GetDeviceContext(){ return context; }
+    //backend of the engine calls, D3D forwarding one or recording one of the null device
+    static void SetRenderDevice(RenderBackend::IRenderDevice *RenderDevice){ renderDevice = RenderDevice; }
+    static RenderBackend::IRenderDevice *GetRenderDevice(){ return renderDevice; }
+    static void SetRenderContext(RenderBackend::IRenderContext *RenderContext){ renderContext = RenderContext; }
+    static RenderBackend::IRenderContext *GetRenderContext(){ return renderContext; }
     static void SetRenderTargetView(ID3D11RenderTargetView* RenderTargetView) {renderTargetView = RenderTargetView;} 
     static ID3D11RenderTargetView* GetRenderTargetView() {return renderTargetView;} 
     static void SetDepthStencilView(ID3D11DepthStencilView* DepthStencilView) {depthStencilView = DepthStencilView;} 
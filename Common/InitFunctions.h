@@ -40,4 +40,7 @@ struct D3DData
 };
 
 D3DData InitD3D(const D3DParams &Params) throw (Exception);
+//D3D11 null driver creates the objects and draws nothing, so the engine runs without a GPU.
+//There is no swap chain, the render target view is the one of an offscreen back buffer
+D3DData InitNullD3D(LONG ClientWidth, LONG ClientHeight) throw (Exception);
 void ChangeResolution(D3DData &Data, LONG NewWidth, LONG NewHeight) throw (Exception);
@@ -68,12 +68,27 @@ public:
 
 class Blur : public Effect
 {
+public:
+    typedef std::vector<float> KernelStorage;
 protected:
     Texture::RenderTarget tmp1, orig;    
     size_t blurIterations = 1;
+    //kernel of one iteration, the taps may hold the kernel of all of them
+    KernelStorage kernel;
+    bool fuseIterations = false, iterationsFused = false;
+    void UpdateTaps() throw (Exception);
 public:    
-    typedef std::vector<float> KernelStorage;
+    //x - offset of the bilinear tap in texels, y - its weight, z - offset of its first texel, w - weight of the first texel
+    typedef std::vector<D3DXVECTOR4> TapsStorage;
+    //size of the taps array of BlurCommon.fxh, kernels up to the radius of 31
+    static const INT MaxTapsCount = 32;
     static KernelStorage GetGaussianKernel(INT Radius, FLOAT Deviation = -1);
+    //neighbour taps merged to the fetches of the linear sampler, the center weight is halved between
+    //the pairs (-1, 0) and (0, 1), so the kernel of radius 5 takes 6 fetches instead of 11
+    static TapsStorage GetLinearTaps(const KernelStorage &Kernel) throw (Exception);
+    //Kernel convolved with itself Iterations times, the single pass of radius Iterations * R
+    //gives the result of Iterations passes of radius R away from the borders
+    static KernelStorage GetIteratedKernel(const KernelStorage &Kernel, size_t Iterations);
     Blur() : blurIterations(0){}
     virtual ~Blur(){}    
     virtual void Init(const std::wstring &VertexShaderPath,
@@ -81,13 +96,55 @@ public:
                      const ScreenSpaceQuad *Quad,
                      const Texture::RenderTarget DataRenderTarget,
                      size_t BlurIterations = 1,
-                     const KernelStorage &Kernel = KernelStorage()) throw (Exception);
+                     const KernelStorage &Kernel = KernelStorage(),
+                     const Shaders::ShaderMacros &Macros = Shaders::ShaderMacros()) throw (Exception);
     virtual void Draw() const;
     size_t GetIterationsCount() const {return blurIterations;}
     void SetDataRenderTarget(const Texture::RenderTarget &NewDataRenderTarget){orig = NewDataRenderTarget;}
-    void SetBlurIterationsCount(size_t BlurIterations) {blurIterations = BlurIterations;}
+    void SetBlurIterationsCount(size_t BlurIterations) throw (Exception);
+    //Draw takes one vertical and one horizontal pass of the iterated kernel while it fits the taps array.
+    //Linear blurs only, the edge saving blur is not a convolution and keeps the iterations
+    void SetIterationsFusion(bool Fuse) throw (Exception);
+    bool IsIterationsFused() const {return iterationsFused;}
+    void OnResolutionChanged() throw (Exception);
+    void SetKernel(const KernelStorage &Kernel) throw (Exception);
+};
+
+//Box filter of the AO by the summed area table, the table is built in log2(width) + log2(height) passes
+//and every pixel takes 4 of its texels whatever the box size is. The table is the fixed point uint2 of
+//the AO and the depth, pixel shaders have no doubles and the wrapped uint differences of the box stay exact
+class BoxFilter : public Effect
+{
+protected:
+    Texture::RenderTarget orig;
+    //ping-pong of the recursive doubling passes
+    Texture::RenderTarget sat[2];
+    mutable Shaders::PixelShader convertPs, buildPs;
+    ID3D11ShaderResourceView *normalDepthSrv = NULL;
+    INT boxRadius = 4;
+    FLOAT depthTolerance = 0.0f;
+public:
+    //box sums of the depth stay below 2^32 up to the depth of 1000 in SATCommon.fxh
+    static const INT MaxBoxRadius = 64;
+    BoxFilter(){}
+    virtual ~BoxFilter(){}
+    virtual void Init(const std::wstring &VertexShaderPath,
+                      const std::wstring &BuildShaderPath,
+                      const std::wstring &FilterShaderPath,
+                      const ScreenSpaceQuad *Quad,
+                      const Texture::RenderTarget DataRenderTarget,
+                      INT BoxRadius = 4,
+                      const Shaders::ShaderMacros &Macros = Shaders::ShaderMacros()) throw (Exception);
+    virtual void Draw() const;
+    void SetDataRenderTarget(const Texture::RenderTarget &NewDataRenderTarget){orig = NewDataRenderTarget;}
+    //normal/depth or depth target of the prepass, the macro DEPTH_ONLY selects the last one
+    void SetNormalDepth(ID3D11ShaderResourceView *NormalDepthSrv){normalDepthSrv = NormalDepthSrv;}
+    INT GetBoxRadius() const {return boxRadius;}
+    void SetBoxRadius(INT BoxRadius) throw (Exception);
+    //0 disables the edge weight, otherwise pixels away from the mean depth of the box by Tolerance keep their own AO
+    void SetDepthTolerance(FLOAT Tolerance) throw (Exception);
+    FLOAT GetDepthTolerance() const {return depthTolerance;}
     void OnResolutionChanged() throw (Exception);
-    void SetKernel(const KernelStorage &Kernel);
 };
 
 class RenderPass
@@ -101,9 +158,12 @@ public:
     RenderPass &operator= (const RenderPass&) = delete;
     RenderPass(ID3D11RenderTargetView *Rtv);
     RenderPass(ID3D11RenderTargetView *Rtv, ID3D11DepthStencilView *Dsv);
+    //Dsv can be NULL, e.g. for render targets smaller than the back buffer
     RenderPass(ID3D11RenderTargetView *Rtv, ID3D11DepthStencilView *Dsv, const D3D11_VIEWPORT &Viewport);
     RenderPass(ID3D11RenderTargetView *Rtv, FLOAT Color[4]);
     RenderPass(ID3D11RenderTargetView *Rtv, ID3D11DepthStencilView *Dsv, const D3D11_VIEWPORT &Viewport, FLOAT Color[4]);
+    //multiple render targets of the same size, every target is cleared to (1, 1, 1, 0)
+    RenderPass(const std::vector<ID3D11RenderTargetView*> &Rtvs, ID3D11DepthStencilView *Dsv, const D3D11_VIEWPORT &Viewport);
     ~RenderPass();
 };
 
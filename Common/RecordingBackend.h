@@ -0,0 +1,205 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#pragma once
+#include <map>
+#include <string>
+#include <vector>
+#include <RenderBackend.h>
+
+namespace RenderBackend
+{
+
+enum CommandType
+{
+    COMMAND_CREATE_BUFFER,
+    COMMAND_CREATE_TEXTURE,
+    COMMAND_CREATE_VIEW,
+    COMMAND_CREATE_STATE,
+    COMMAND_CREATE_SHADER,
+    COMMAND_CREATE_INPUT_LAYOUT,
+    COMMAND_CLEAR,
+    COMMAND_MAP,
+    COMMAND_UNMAP,
+    COMMAND_UPDATE_SUBRESOURCE,
+    COMMAND_COPY_RESOURCE,
+    COMMAND_GENERATE_MIPS,
+    COMMAND_SET_INPUT_LAYOUT,
+    COMMAND_SET_VERTEX_BUFFERS,
+    COMMAND_SET_INDEX_BUFFER,
+    COMMAND_SET_TOPOLOGY,
+    COMMAND_SET_SHADER,
+    COMMAND_SET_SHADER_RESOURCES,
+    COMMAND_SET_CONSTANT_BUFFERS,
+    COMMAND_SET_SAMPLERS,
+    COMMAND_SET_RASTERIZER_STATE,
+    COMMAND_SET_VIEWPORTS,
+    COMMAND_SET_RENDER_TARGETS,
+    COMMAND_SET_BLEND_STATE,
+    COMMAND_SET_DEPTH_STENCIL_STATE,
+    COMMAND_DRAW,
+    COMMAND_DRAW_INDEXED,
+    COMMAND_BEGIN_EVENT,
+    COMMAND_END_EVENT,
+    COMMAND_PRESENT,
+    COMMANDS_COUNT
+};
+
+enum ShaderStage
+{
+    SHADER_STAGE_NONE,
+    SHADER_STAGE_VERTEX,
+    SHADER_STAGE_HULL,
+    SHADER_STAGE_DOMAIN,
+    SHADER_STAGE_GEOMETRY,
+    SHADER_STAGE_PIXEL
+};
+
+//Count is the bound objects of the binds, the vertices or indices of the draws, the texels of the textures
+//and the event name index of COMMAND_BEGIN_EVENT. Bytes are the uploaded ones of the maps and the updates, the size of the created buffers
+struct Command
+{
+    UINT16 type = COMMAND_PRESENT;
+    UINT16 stage = SHADER_STAGE_NONE;
+    UINT count = 0;
+    UINT bytes = 0;
+    Command(){}
+    Command(CommandType Type, UINT Count, UINT Bytes, ShaderStage Stage)
+        :type((UINT16)Type), stage((UINT16)Stage), count(Count), bytes(Bytes)
+    {}
+};
+
+struct CommandLogCounters
+{
+    size_t calls[COMMANDS_COUNT];
+    //vertices and indices of the draws
+    UINT64 elements = 0;
+    UINT64 uploadedBytes = 0;
+    UINT64 createdBufferBytes = 0;
+    CommandLogCounters()
+    {
+        for(int c = 0; c < COMMANDS_COUNT; c++)
+            calls[c] = 0;
+    }
+    size_t GetDrawCalls() const {return calls[COMMAND_DRAW] + calls[COMMAND_DRAW_INDEXED];}
+    //pipeline state changes from COMMAND_SET_INPUT_LAYOUT to COMMAND_SET_DEPTH_STENCIL_STATE
+    size_t GetBindCalls() const;
+    size_t GetCallsCount() const;
+};
+
+//Calls of the recording backend, a frame ends with its COMMAND_PRESENT. Frames before the first present hold the loading
+class CommandLog
+{
+private:
+    std::vector<Command> commands;
+    std::vector<size_t> frameStarts;
+    std::vector<std::wstring> eventNames;
+    CommandLogCounters GetCounters(size_t First, size_t Last) const;
+public:
+    CommandLog(){Clear();}
+    void Record(CommandType Type, UINT Count = 1, UINT Bytes = 0, ShaderStage Stage = SHADER_STAGE_NONE);
+    void RecordBeginEvent(const std::wstring &Name);
+    void Clear();
+    const std::vector<Command> &GetCommands() const {return commands;}
+    //presented frames, the commands after the last present are not counted
+    size_t GetFramesCount() const {return frameStarts.size() - 1;}
+    CommandLogCounters GetFrameCounters(size_t Frame) const;
+    //commands inside the events of Name of the frame, the nested events included
+    CommandLogCounters GetFrameEventCounters(size_t Frame, const std::wstring &Name) const;
+    size_t GetFrameEventsCount(size_t Frame, const std::wstring &Name) const;
+    CommandLogCounters GetCounters() const {return GetCounters(0, commands.size());}
+    static const char *GetCommandName(CommandType Type);
+};
+
+//Records the created objects and forwards the calls to the device, the D3D11 null driver one keeps GPU-less runs
+class RecordingRenderDevice : public IRenderDevice
+{
+private:
+    IRenderDevice *device;
+    CommandLog *log;
+public:
+    RecordingRenderDevice(IRenderDevice *Device, CommandLog *Log) : device(Device), log(Log){}
+    virtual HRESULT CreateBuffer(const D3D11_BUFFER_DESC *Desc, const D3D11_SUBRESOURCE_DATA *InitialData, ID3D11Buffer **Buffer);
+    virtual HRESULT CreateTexture2D(const D3D11_TEXTURE2D_DESC *Desc, const D3D11_SUBRESOURCE_DATA *InitialData, ID3D11Texture2D **Texture);
+    virtual HRESULT CreateShaderResourceView(ID3D11Resource *Resource, const D3D11_SHADER_RESOURCE_VIEW_DESC *Desc, ID3D11ShaderResourceView **View);
+    virtual HRESULT CreateRenderTargetView(ID3D11Resource *Resource, const D3D11_RENDER_TARGET_VIEW_DESC *Desc, ID3D11RenderTargetView **View);
+    virtual HRESULT CreateSamplerState(const D3D11_SAMPLER_DESC *Desc, ID3D11SamplerState **State);
+    virtual HRESULT CreateRasterizerState(const D3D11_RASTERIZER_DESC *Desc, ID3D11RasterizerState **State);
+    virtual HRESULT CreateDepthStencilState(const D3D11_DEPTH_STENCIL_DESC *Desc, ID3D11DepthStencilState **State);
+    virtual HRESULT CreateBlendState(const D3D11_BLEND_DESC *Desc, ID3D11BlendState **State);
+    virtual HRESULT CreateInputLayout(const D3D11_INPUT_ELEMENT_DESC *Elements, UINT ElementsCount,
+                                      const void *Bytecode, SIZE_T BytecodeLength, ID3D11InputLayout **Layout);
+    virtual HRESULT CreateVertexShader(const void *Bytecode, SIZE_T BytecodeLength, ID3D11ClassLinkage *Linkage, ID3D11VertexShader **Shader);
+    virtual HRESULT CreatePixelShader(const void *Bytecode, SIZE_T BytecodeLength, ID3D11ClassLinkage *Linkage, ID3D11PixelShader **Shader);
+    virtual HRESULT CreateHullShader(const void *Bytecode, SIZE_T BytecodeLength, ID3D11ClassLinkage *Linkage, ID3D11HullShader **Shader);
+    virtual HRESULT CreateDomainShader(const void *Bytecode, SIZE_T BytecodeLength, ID3D11ClassLinkage *Linkage, ID3D11DomainShader **Shader);
+    virtual HRESULT CreateGeometryShader(const void *Bytecode, SIZE_T BytecodeLength, ID3D11ClassLinkage *Linkage, ID3D11GeometryShader **Shader);
+    virtual HRESULT CreateGeometryShaderWithStreamOutput(const void *Bytecode, SIZE_T BytecodeLength,
+                                                         const D3D11_SO_DECLARATION_ENTRY *Declaration, UINT EntriesCount,
+                                                         const UINT *BufferStrides, UINT StridesCount, UINT RasterizedStream,
+                                                         ID3D11ClassLinkage *Linkage, ID3D11GeometryShader **Shader);
+};
+
+//Records the calls and forwards them to the context. Without the context it is the null backend:
+//maps get the scratch memory of the resource, the viewports are kept for RSGetViewports and the rest is dropped
+class RecordingRenderContext : public IRenderContext
+{
+private:
+    typedef std::pair<ID3D11Resource*, UINT> SubresourceKey;
+    typedef std::map<SubresourceKey, std::vector<char> > ScratchStorage;
+    IRenderContext *context;
+    CommandLog *log;
+    ScratchStorage scratch;
+    std::vector<D3D11_VIEWPORT> viewports;
+public:
+    RecordingRenderContext(IRenderContext *Context, CommandLog *Log) : context(Context), log(Log){}
+    virtual void ClearRenderTargetView(ID3D11RenderTargetView *View, const FLOAT Color[4]);
+    virtual void ClearDepthStencilView(ID3D11DepthStencilView *View, UINT ClearFlags, FLOAT Depth, UINT8 Stencil);
+    virtual HRESULT Map(ID3D11Resource *Resource, UINT Subresource, D3D11_MAP MapType, UINT MapFlags, D3D11_MAPPED_SUBRESOURCE *MappedResource);
+    virtual void Unmap(ID3D11Resource *Resource, UINT Subresource);
+    virtual void UpdateSubresource(ID3D11Resource *Resource, UINT Subresource, const D3D11_BOX *Box,
+                                   const void *Data, UINT RowPitch, UINT DepthPitch);
+    virtual void CopyResource(ID3D11Resource *Destination, ID3D11Resource *Source);
+    virtual void GenerateMips(ID3D11ShaderResourceView *View);
+    virtual void IASetInputLayout(ID3D11InputLayout *Layout);
+    virtual void IASetVertexBuffers(UINT StartSlot, UINT BuffersCount, ID3D11Buffer *const *Buffers, const UINT *Strides, const UINT *Offsets);
+    virtual void IASetIndexBuffer(ID3D11Buffer *Buffer, DXGI_FORMAT Format, UINT Offset);
+    virtual void IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY Topology);
+    virtual void VSSetShader(ID3D11VertexShader *Shader, ID3D11ClassInstance *const *ClassInstances, UINT ClassInstancesCount);
+    virtual void VSSetShaderResources(UINT StartSlot, UINT ViewsCount, ID3D11ShaderResourceView *const *Views);
+    virtual void VSSetConstantBuffers(UINT StartSlot, UINT BuffersCount, ID3D11Buffer *const *Buffers);
+    virtual void VSSetSamplers(UINT StartSlot, UINT SamplersCount, ID3D11SamplerState *const *Samplers);
+    virtual void HSSetShader(ID3D11HullShader *Shader, ID3D11ClassInstance *const *ClassInstances, UINT ClassInstancesCount);
+    virtual void HSSetShaderResources(UINT StartSlot, UINT ViewsCount, ID3D11ShaderResourceView *const *Views);
+    virtual void HSSetConstantBuffers(UINT StartSlot, UINT BuffersCount, ID3D11Buffer *const *Buffers);
+    virtual void HSSetSamplers(UINT StartSlot, UINT SamplersCount, ID3D11SamplerState *const *Samplers);
+    virtual void DSSetShader(ID3D11DomainShader *Shader, ID3D11ClassInstance *const *ClassInstances, UINT ClassInstancesCount);
+    virtual void DSSetShaderResources(UINT StartSlot, UINT ViewsCount, ID3D11ShaderResourceView *const *Views);
+    virtual void DSSetConstantBuffers(UINT StartSlot, UINT BuffersCount, ID3D11Buffer *const *Buffers);
+    virtual void DSSetSamplers(UINT StartSlot, UINT SamplersCount, ID3D11SamplerState *const *Samplers);
+    virtual void GSSetShader(ID3D11GeometryShader *Shader, ID3D11ClassInstance *const *ClassInstances, UINT ClassInstancesCount);
+    virtual void GSSetShaderResources(UINT StartSlot, UINT ViewsCount, ID3D11ShaderResourceView *const *Views);
+    virtual void GSSetConstantBuffers(UINT StartSlot, UINT BuffersCount, ID3D11Buffer *const *Buffers);
+    virtual void GSSetSamplers(UINT StartSlot, UINT SamplersCount, ID3D11SamplerState *const *Samplers);
+    virtual void PSSetShader(ID3D11PixelShader *Shader, ID3D11ClassInstance *const *ClassInstances, UINT ClassInstancesCount);
+    virtual void PSSetShaderResources(UINT StartSlot, UINT ViewsCount, ID3D11ShaderResourceView *const *Views);
+    virtual void PSSetConstantBuffers(UINT StartSlot, UINT BuffersCount, ID3D11Buffer *const *Buffers);
+    virtual void PSSetSamplers(UINT StartSlot, UINT SamplersCount, ID3D11SamplerState *const *Samplers);
+    virtual void RSSetState(ID3D11RasterizerState *State);
+    virtual void RSSetViewports(UINT ViewportsCount, const D3D11_VIEWPORT *Viewports);
+    virtual void RSGetViewports(UINT *ViewportsCount, D3D11_VIEWPORT *Viewports);
+    virtual void OMSetRenderTargets(UINT ViewsCount, ID3D11RenderTargetView *const *Views, ID3D11DepthStencilView *DepthStencilView);
+    virtual void OMSetBlendState(ID3D11BlendState *State, const FLOAT BlendFactor[4], UINT SampleMask);
+    virtual void OMSetDepthStencilState(ID3D11DepthStencilState *State, UINT StencilRef);
+    virtual void Draw(UINT VertexCount, UINT StartVertex);
+    virtual void DrawIndexed(UINT IndexCount, UINT StartIndex, INT BaseVertex);
+    virtual void BeginEvent(LPCWSTR Name);
+    virtual void EndEvent();
+    virtual HRESULT Present(UINT SyncInterval, UINT Flags);
+};
+
+}
@@ -0,0 +1,172 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#pragma once
+#include <D3DHeaders.h>
+
+namespace RenderBackend
+{
+
+//Device calls of the engine, the signatures are the ones of ID3D11Device, so the backend is swapped behind DeviceKeeper
+class IRenderDevice
+{
+public:
+    virtual ~IRenderDevice(){}
+    virtual HRESULT CreateBuffer(const D3D11_BUFFER_DESC *Desc, const D3D11_SUBRESOURCE_DATA *InitialData, ID3D11Buffer **Buffer) = 0;
+    virtual HRESULT CreateTexture2D(const D3D11_TEXTURE2D_DESC *Desc, const D3D11_SUBRESOURCE_DATA *InitialData, ID3D11Texture2D **Texture) = 0;
+    virtual HRESULT CreateShaderResourceView(ID3D11Resource *Resource, const D3D11_SHADER_RESOURCE_VIEW_DESC *Desc, ID3D11ShaderResourceView **View) = 0;
+    virtual HRESULT CreateRenderTargetView(ID3D11Resource *Resource, const D3D11_RENDER_TARGET_VIEW_DESC *Desc, ID3D11RenderTargetView **View) = 0;
+    virtual HRESULT CreateSamplerState(const D3D11_SAMPLER_DESC *Desc, ID3D11SamplerState **State) = 0;
+    virtual HRESULT CreateRasterizerState(const D3D11_RASTERIZER_DESC *Desc, ID3D11RasterizerState **State) = 0;
+    virtual HRESULT CreateDepthStencilState(const D3D11_DEPTH_STENCIL_DESC *Desc, ID3D11DepthStencilState **State) = 0;
+    virtual HRESULT CreateBlendState(const D3D11_BLEND_DESC *Desc, ID3D11BlendState **State) = 0;
+    virtual HRESULT CreateInputLayout(const D3D11_INPUT_ELEMENT_DESC *Elements, UINT ElementsCount,
+                                      const void *Bytecode, SIZE_T BytecodeLength, ID3D11InputLayout **Layout) = 0;
+    virtual HRESULT CreateVertexShader(const void *Bytecode, SIZE_T BytecodeLength, ID3D11ClassLinkage *Linkage, ID3D11VertexShader **Shader) = 0;
+    virtual HRESULT CreatePixelShader(const void *Bytecode, SIZE_T BytecodeLength, ID3D11ClassLinkage *Linkage, ID3D11PixelShader **Shader) = 0;
+    virtual HRESULT CreateHullShader(const void *Bytecode, SIZE_T BytecodeLength, ID3D11ClassLinkage *Linkage, ID3D11HullShader **Shader) = 0;
+    virtual HRESULT CreateDomainShader(const void *Bytecode, SIZE_T BytecodeLength, ID3D11ClassLinkage *Linkage, ID3D11DomainShader **Shader) = 0;
+    virtual HRESULT CreateGeometryShader(const void *Bytecode, SIZE_T BytecodeLength, ID3D11ClassLinkage *Linkage, ID3D11GeometryShader **Shader) = 0;
+    virtual HRESULT CreateGeometryShaderWithStreamOutput(const void *Bytecode, SIZE_T BytecodeLength,
+                                                         const D3D11_SO_DECLARATION_ENTRY *Declaration, UINT EntriesCount,
+                                                         const UINT *BufferStrides, UINT StridesCount, UINT RasterizedStream,
+                                                         ID3D11ClassLinkage *Linkage, ID3D11GeometryShader **Shader) = 0;
+};
+
+//Context calls of the engine with the signatures of ID3D11DeviceContext, Present of the swap chain ends the frame
+class IRenderContext
+{
+public:
+    virtual ~IRenderContext(){}
+    virtual void ClearRenderTargetView(ID3D11RenderTargetView *View, const FLOAT Color[4]) = 0;
+    virtual void ClearDepthStencilView(ID3D11DepthStencilView *View, UINT ClearFlags, FLOAT Depth, UINT8 Stencil) = 0;
+    virtual HRESULT Map(ID3D11Resource *Resource, UINT Subresource, D3D11_MAP MapType, UINT MapFlags, D3D11_MAPPED_SUBRESOURCE *MappedResource) = 0;
+    virtual void Unmap(ID3D11Resource *Resource, UINT Subresource) = 0;
+    virtual void UpdateSubresource(ID3D11Resource *Resource, UINT Subresource, const D3D11_BOX *Box,
+                                   const void *Data, UINT RowPitch, UINT DepthPitch) = 0;
+    virtual void CopyResource(ID3D11Resource *Destination, ID3D11Resource *Source) = 0;
+    virtual void GenerateMips(ID3D11ShaderResourceView *View) = 0;
+    virtual void IASetInputLayout(ID3D11InputLayout *Layout) = 0;
+    virtual void IASetVertexBuffers(UINT StartSlot, UINT BuffersCount, ID3D11Buffer *const *Buffers, const UINT *Strides, const UINT *Offsets) = 0;
+    virtual void IASetIndexBuffer(ID3D11Buffer *Buffer, DXGI_FORMAT Format, UINT Offset) = 0;
+    virtual void IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY Topology) = 0;
+    virtual void VSSetShader(ID3D11VertexShader *Shader, ID3D11ClassInstance *const *ClassInstances, UINT ClassInstancesCount) = 0;
+    virtual void VSSetShaderResources(UINT StartSlot, UINT ViewsCount, ID3D11ShaderResourceView *const *Views) = 0;
+    virtual void VSSetConstantBuffers(UINT StartSlot, UINT BuffersCount, ID3D11Buffer *const *Buffers) = 0;
+    virtual void VSSetSamplers(UINT StartSlot, UINT SamplersCount, ID3D11SamplerState *const *Samplers) = 0;
+    virtual void HSSetShader(ID3D11HullShader *Shader, ID3D11ClassInstance *const *ClassInstances, UINT ClassInstancesCount) = 0;
+    virtual void HSSetShaderResources(UINT StartSlot, UINT ViewsCount, ID3D11ShaderResourceView *const *Views) = 0;
+    virtual void HSSetConstantBuffers(UINT StartSlot, UINT BuffersCount, ID3D11Buffer *const *Buffers) = 0;
+    virtual void HSSetSamplers(UINT StartSlot, UINT SamplersCount, ID3D11SamplerState *const *Samplers) = 0;
+    virtual void DSSetShader(ID3D11DomainShader *Shader, ID3D11ClassInstance *const *ClassInstances, UINT ClassInstancesCount) = 0;
+    virtual void DSSetShaderResources(UINT StartSlot, UINT ViewsCount, ID3D11ShaderResourceView *const *Views) = 0;
+    virtual void DSSetConstantBuffers(UINT StartSlot, UINT BuffersCount, ID3D11Buffer *const *Buffers) = 0;
+    virtual void DSSetSamplers(UINT StartSlot, UINT SamplersCount, ID3D11SamplerState *const *Samplers) = 0;
+    virtual void GSSetShader(ID3D11GeometryShader *Shader, ID3D11ClassInstance *const *ClassInstances, UINT ClassInstancesCount) = 0;
+    virtual void GSSetShaderResources(UINT StartSlot, UINT ViewsCount, ID3D11ShaderResourceView *const *Views) = 0;
+    virtual void GSSetConstantBuffers(UINT StartSlot, UINT BuffersCount, ID3D11Buffer *const *Buffers) = 0;
+    virtual void GSSetSamplers(UINT StartSlot, UINT SamplersCount, ID3D11SamplerState *const *Samplers) = 0;
+    virtual void PSSetShader(ID3D11PixelShader *Shader, ID3D11ClassInstance *const *ClassInstances, UINT ClassInstancesCount) = 0;
+    virtual void PSSetShaderResources(UINT StartSlot, UINT ViewsCount, ID3D11ShaderResourceView *const *Views) = 0;
+    virtual void PSSetConstantBuffers(UINT StartSlot, UINT BuffersCount, ID3D11Buffer *const *Buffers) = 0;
+    virtual void PSSetSamplers(UINT StartSlot, UINT SamplersCount, ID3D11SamplerState *const *Samplers) = 0;
+    virtual void RSSetState(ID3D11RasterizerState *State) = 0;
+    virtual void RSSetViewports(UINT ViewportsCount, const D3D11_VIEWPORT *Viewports) = 0;
+    virtual void RSGetViewports(UINT *ViewportsCount, D3D11_VIEWPORT *Viewports) = 0;
+    virtual void OMSetRenderTargets(UINT ViewsCount, ID3D11RenderTargetView *const *Views, ID3D11DepthStencilView *DepthStencilView) = 0;
+    virtual void OMSetBlendState(ID3D11BlendState *State, const FLOAT BlendFactor[4], UINT SampleMask) = 0;
+    virtual void OMSetDepthStencilState(ID3D11DepthStencilState *State, UINT StencilRef) = 0;
+    virtual void Draw(UINT VertexCount, UINT StartVertex) = 0;
+    virtual void DrawIndexed(UINT IndexCount, UINT StartIndex, INT BaseVertex) = 0;
+    //markers of ID3DUserDefinedAnnotation, the events can be nested
+    virtual void BeginEvent(LPCWSTR Name) = 0;
+    virtual void EndEvent() = 0;
+    virtual HRESULT Present(UINT SyncInterval, UINT Flags) = 0;
+};
+
+//Forwards to the device, does not own it
+class D3DRenderDevice : public IRenderDevice
+{
+private:
+    ID3D11Device *device;
+public:
+    D3DRenderDevice(ID3D11Device *Device) : device(Device){}
+    virtual HRESULT CreateBuffer(const D3D11_BUFFER_DESC *Desc, const D3D11_SUBRESOURCE_DATA *InitialData, ID3D11Buffer **Buffer);
+    virtual HRESULT CreateTexture2D(const D3D11_TEXTURE2D_DESC *Desc, const D3D11_SUBRESOURCE_DATA *InitialData, ID3D11Texture2D **Texture);
+    virtual HRESULT CreateShaderResourceView(ID3D11Resource *Resource, const D3D11_SHADER_RESOURCE_VIEW_DESC *Desc, ID3D11ShaderResourceView **View);
+    virtual HRESULT CreateRenderTargetView(ID3D11Resource *Resource, const D3D11_RENDER_TARGET_VIEW_DESC *Desc, ID3D11RenderTargetView **View);
+    virtual HRESULT CreateSamplerState(const D3D11_SAMPLER_DESC *Desc, ID3D11SamplerState **State);
+    virtual HRESULT CreateRasterizerState(const D3D11_RASTERIZER_DESC *Desc, ID3D11RasterizerState **State);
+    virtual HRESULT CreateDepthStencilState(const D3D11_DEPTH_STENCIL_DESC *Desc, ID3D11DepthStencilState **State);
+    virtual HRESULT CreateBlendState(const D3D11_BLEND_DESC *Desc, ID3D11BlendState **State);
+    virtual HRESULT CreateInputLayout(const D3D11_INPUT_ELEMENT_DESC *Elements, UINT ElementsCount,
+                                      const void *Bytecode, SIZE_T BytecodeLength, ID3D11InputLayout **Layout);
+    virtual HRESULT CreateVertexShader(const void *Bytecode, SIZE_T BytecodeLength, ID3D11ClassLinkage *Linkage, ID3D11VertexShader **Shader);
+    virtual HRESULT CreatePixelShader(const void *Bytecode, SIZE_T BytecodeLength, ID3D11ClassLinkage *Linkage, ID3D11PixelShader **Shader);
+    virtual HRESULT CreateHullShader(const void *Bytecode, SIZE_T BytecodeLength, ID3D11ClassLinkage *Linkage, ID3D11HullShader **Shader);
+    virtual HRESULT CreateDomainShader(const void *Bytecode, SIZE_T BytecodeLength, ID3D11ClassLinkage *Linkage, ID3D11DomainShader **Shader);
+    virtual HRESULT CreateGeometryShader(const void *Bytecode, SIZE_T BytecodeLength, ID3D11ClassLinkage *Linkage, ID3D11GeometryShader **Shader);
+    virtual HRESULT CreateGeometryShaderWithStreamOutput(const void *Bytecode, SIZE_T BytecodeLength,
+                                                         const D3D11_SO_DECLARATION_ENTRY *Declaration, UINT EntriesCount,
+                                                         const UINT *BufferStrides, UINT StridesCount, UINT RasterizedStream,
+                                                         ID3D11ClassLinkage *Linkage, ID3D11GeometryShader **Shader);
+};
+
+//Forwards to the context and presents the swap chain of DeviceKeeper, does not own them
+class D3DRenderContext : public IRenderContext
+{
+private:
+    ID3D11DeviceContext *context;
+public:
+    D3DRenderContext(ID3D11DeviceContext *Context) : context(Context){}
+    virtual void ClearRenderTargetView(ID3D11RenderTargetView *View, const FLOAT Color[4]);
+    virtual void ClearDepthStencilView(ID3D11DepthStencilView *View, UINT ClearFlags, FLOAT Depth, UINT8 Stencil);
+    virtual HRESULT Map(ID3D11Resource *Resource, UINT Subresource, D3D11_MAP MapType, UINT MapFlags, D3D11_MAPPED_SUBRESOURCE *MappedResource);
+    virtual void Unmap(ID3D11Resource *Resource, UINT Subresource);
+    virtual void UpdateSubresource(ID3D11Resource *Resource, UINT Subresource, const D3D11_BOX *Box,
+                                   const void *Data, UINT RowPitch, UINT DepthPitch);
+    virtual void CopyResource(ID3D11Resource *Destination, ID3D11Resource *Source);
+    virtual void GenerateMips(ID3D11ShaderResourceView *View);
+    virtual void IASetInputLayout(ID3D11InputLayout *Layout);
+    virtual void IASetVertexBuffers(UINT StartSlot, UINT BuffersCount, ID3D11Buffer *const *Buffers, const UINT *Strides, const UINT *Offsets);
+    virtual void IASetIndexBuffer(ID3D11Buffer *Buffer, DXGI_FORMAT Format, UINT Offset);
+    virtual void IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY Topology);
+    virtual void VSSetShader(ID3D11VertexShader *Shader, ID3D11ClassInstance *const *ClassInstances, UINT ClassInstancesCount);
+    virtual void VSSetShaderResources(UINT StartSlot, UINT ViewsCount, ID3D11ShaderResourceView *const *Views);
+    virtual void VSSetConstantBuffers(UINT StartSlot, UINT BuffersCount, ID3D11Buffer *const *Buffers);
+    virtual void VSSetSamplers(UINT StartSlot, UINT SamplersCount, ID3D11SamplerState *const *Samplers);
+    virtual void HSSetShader(ID3D11HullShader *Shader, ID3D11ClassInstance *const *ClassInstances, UINT ClassInstancesCount);
+    virtual void HSSetShaderResources(UINT StartSlot, UINT ViewsCount, ID3D11ShaderResourceView *const *Views);
+    virtual void HSSetConstantBuffers(UINT StartSlot, UINT BuffersCount, ID3D11Buffer *const *Buffers);
+    virtual void HSSetSamplers(UINT StartSlot, UINT SamplersCount, ID3D11SamplerState *const *Samplers);
+    virtual void DSSetShader(ID3D11DomainShader *Shader, ID3D11ClassInstance *const *ClassInstances, UINT ClassInstancesCount);
+    virtual void DSSetShaderResources(UINT StartSlot, UINT ViewsCount, ID3D11ShaderResourceView *const *Views);
+    virtual void DSSetConstantBuffers(UINT StartSlot, UINT BuffersCount, ID3D11Buffer *const *Buffers);
+    virtual void DSSetSamplers(UINT StartSlot, UINT SamplersCount, ID3D11SamplerState *const *Samplers);
+    virtual void GSSetShader(ID3D11GeometryShader *Shader, ID3D11ClassInstance *const *ClassInstances, UINT ClassInstancesCount);
+    virtual void GSSetShaderResources(UINT StartSlot, UINT ViewsCount, ID3D11ShaderResourceView *const *Views);
+    virtual void GSSetConstantBuffers(UINT StartSlot, UINT BuffersCount, ID3D11Buffer *const *Buffers);
+    virtual void GSSetSamplers(UINT StartSlot, UINT SamplersCount, ID3D11SamplerState *const *Samplers);
+    virtual void PSSetShader(ID3D11PixelShader *Shader, ID3D11ClassInstance *const *ClassInstances, UINT ClassInstancesCount);
+    virtual void PSSetShaderResources(UINT StartSlot, UINT ViewsCount, ID3D11ShaderResourceView *const *Views);
+    virtual void PSSetConstantBuffers(UINT StartSlot, UINT BuffersCount, ID3D11Buffer *const *Buffers);
+    virtual void PSSetSamplers(UINT StartSlot, UINT SamplersCount, ID3D11SamplerState *const *Samplers);
+    virtual void RSSetState(ID3D11RasterizerState *State);
+    virtual void RSSetViewports(UINT ViewportsCount, const D3D11_VIEWPORT *Viewports);
+    virtual void RSGetViewports(UINT *ViewportsCount, D3D11_VIEWPORT *Viewports);
+    virtual void OMSetRenderTargets(UINT ViewsCount, ID3D11RenderTargetView *const *Views, ID3D11DepthStencilView *DepthStencilView);
+    virtual void OMSetBlendState(ID3D11BlendState *State, const FLOAT BlendFactor[4], UINT SampleMask);
+    virtual void OMSetDepthStencilState(ID3D11DepthStencilState *State, UINT StencilRef);
+    virtual void Draw(UINT VertexCount, UINT StartVertex);
+    virtual void DrawIndexed(UINT IndexCount, UINT StartIndex, INT BaseVertex);
+    //the D3D11.0 context has no annotations, the markers are for the recording backend
+    virtual void BeginEvent(LPCWSTR Name){}
+    virtual void EndEvent(){}
+    virtual HRESULT Present(UINT SyncInterval, UINT Flags);
+};
+
+}
@@ -34,11 +34,16 @@ class IObject
 private:
     typedef std::map<UINT, Meshes::MaterialData> MaterialsStorage;
     MaterialsStorage materials;
+    UINT version = 0;
+protected:
+    void IncrementVersion() {version++;}
 public:
     void SetMaterial(UINT Subest, const Meshes::MaterialData &Material);
     bool FindMaterial(UINT Subest, Meshes::MaterialData &Material) const;
     virtual ~IObject(){}
     virtual const D3DXMATRIX &GetWorldMatrix() const = 0;
+    //bumped by every transform change
+    UINT GetVersion() const {return version;}
 };
 
 class IMeshDrawManager
@@ -75,6 +80,7 @@ private:
                       const Camera::ICamera *Camera)> ProcessFunction;
     MeshesToDrawingManagersStorage meshesToDrawingManagers;
     ObjectsToMeshesStorage objectsToMeshes;
+    UINT version = 0;
     void ForEachSpecificObject(const ObjectsGroup &SpecificObjects, const Camera::ICamera * Camera, ProcessFunction Function);
     void ForEachSpecificMesh(const MeshesGroup &SpecificMeshes, const Camera::ICamera * Camera, ProcessFunction Function);
 public:
@@ -86,6 +92,9 @@ public:
     void Draw(const Camera::ICamera * Camera, IMeshDrawManager* CommonManager = NULL);
     void Draw(const ObjectsGroup &SpecificObjects, const Camera::ICamera * Camera, IMeshDrawManager* CommonManager = NULL);
     void Draw(const MeshesGroup &SpecificMeshes, const Camera::ICamera *Camera, IMeshDrawManager *CommonManager = NULL);
+    //Changes on every object or mesh change and on every transform change of the objects,
+    //grows monotonically, so equal versions mean the same scene
+    UINT GetSceneVersion() const;
 };
 
 template<class TVector, class TRotation = TVector>
@@ -104,6 +113,7 @@ public:
         if(scalling != NewScalling){
             scalling = NewScalling;
             CalculateMatrix();
+            IncrementVersion();
         }
     }
     virtual const TVector &GetScalling() const {return scalling;}
@@ -112,6 +122,7 @@ public:
         if(rotation != NewRotation){
             rotation = NewRotation;
             CalculateMatrix();
+            IncrementVersion();
         }
     }
     virtual const TRotation &GetRotation() const {return rotation;}
@@ -120,6 +131,7 @@ public:
         if(position != NewPos){
             position = NewPos;
             CalculateMatrix();
+            IncrementVersion();
         }
     }
     virtual const TVector &GetPos() const { return position; }
@@ -139,6 +151,8 @@ class UVNBasisObject : public Scene::IObject, public Basis::UVNBasis
 {
 private:
     const D3DXMATRIX &GetMatrix() const {return UVNBasis::GetMatrix();}
+protected:
+    virtual void OnBasisChanged() {IncrementVersion();}
 public:
     virtual const D3DXMATRIX &GetWorldMatrix() const { return UVNBasis::GetMatrix();}
 };
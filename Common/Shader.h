@@ -26,6 +26,8 @@ typedef INT RegisterType;
 
 typedef std::vector<D3D11_INPUT_ELEMENT_DESC> VertexMetadata;
 typedef std::vector<D3D11_SO_DECLARATION_ENTRY> StreamOutMetadata;
+//name -> definition of the preprocessor macros a shader permutation is compiled with
+typedef std::map<std::string, std::string> ShaderMacros;
 
 class Shader
 {
@@ -129,7 +131,7 @@ public:
     PixelShader &operator= (const PixelShader &Val);
 	virtual ~PixelShader();
 	PixelShader() : ps(NULL){}
-	void Load(const std::wstring &FileName, const std::string &EntryPoint) throw (Exception);
+	void Load(const std::wstring &FileName, const std::string &EntryPoint, const ShaderMacros &Macros = ShaderMacros()) throw (Exception);
 };
 
 class VertexShader final : public Shader
@@ -9,6 +9,7 @@
 #include <Exception.h>
 #include <windows.h>
 #include <functional>
+#include <vector>
 #include <Vector2Fwd.h>
 
 struct ID3D11ShaderResourceView;
@@ -73,5 +74,33 @@ public:
     ID3D11ShaderResourceView *GetShaderResourceView() const {return srv;}
 };
 
+//Render target with a mip chain that is filled level by level by the render passes (no GENERATE_MIPS).
+//Every level has its own RTV and SRV, so a pass can read level n - 1 while writing level n
+class RenderTargetMips
+{
+private:
+    std::vector<ID3D11RenderTargetView*> rtv;
+    std::vector<ID3D11ShaderResourceView*> mipSrv;
+    ID3D11ShaderResourceView *srv;
+    USHORT width, height;
+    DXGI_FORMAT format;
+    void Construct(const RenderTargetMips &Val);
+    void Release();
+public:
+    RenderTargetMips(const RenderTargetMips&);
+    RenderTargetMips &operator= (const RenderTargetMips&);
+    RenderTargetMips();
+    virtual ~RenderTargetMips();
+    USHORT GetWidth(UINT MipLevel = 0) const;
+    USHORT GetHeight(UINT MipLevel = 0) const;
+    DXGI_FORMAT GetFormat() const {return format;}
+    UINT GetMipLevelsCount() const {return rtv.size();}
+    //0 or a count above the full mip chain of the size creates the full chain
+    void Init(DXGI_FORMAT Format, USHORT Width, USHORT Height, UINT MipLevelsCnt) throw (Exception);
+    ID3D11RenderTargetView *GetRenderTargetView(UINT MipLevel) const throw (Exception);
+    //view of the whole mip chain
+    ID3D11ShaderResourceView *GetShaderResourceView() const {return srv;}
+    ID3D11ShaderResourceView *GetShaderResourceView(UINT MipLevel) const throw (Exception);
+};
 
 }
\ No newline at end of file
@@ -119,7 +119,7 @@ inline ID3D11SamplerState* CreateSamplerState(const SamplerStateDescription &Des
     samplerDesc.MaxLOD = Description.maxLOD;
 
     ID3D11SamplerState *state;
-    HR(DeviceKeeper::GetDevice()->CreateSamplerState(&samplerDesc, &state));
+    HR(DeviceKeeper::GetRenderDevice()->CreateSamplerState(&samplerDesc, &state));
 
     return state;
 }
@@ -138,7 +138,7 @@ ID3D11Buffer* CreateBuffer(const std::vector<TData> &Data,
 
     D3D11_SUBRESOURCE_DATA initData = {};
     initData.pSysMem = &Data[0];
-    HR(DeviceKeeper::GetDevice()->CreateBuffer(&bd, &initData, &buffer));
+    HR(DeviceKeeper::GetRenderDevice()->CreateBuffer(&bd, &initData, &buffer));
 
     return buffer;
 }
@@ -155,7 +155,7 @@ inline ID3D11Buffer* CreateBuffer(size_t BufferSize,
     bufferDesc.CPUAccessFlags = CPUAccessFlags;
 
     ID3D11Buffer *buffer;
-    HR(DeviceKeeper::GetDevice()->CreateBuffer(&bufferDesc, NULL, &buffer));
+    HR(DeviceKeeper::GetRenderDevice()->CreateBuffer(&bufferDesc, NULL, &buffer));
 
     return buffer;
 }
@@ -174,7 +174,7 @@ inline ID3D11Buffer* CreateBuffer(const VertexArray &Array,
 
     D3D11_SUBRESOURCE_DATA initData = {};
     initData.pSysMem = Array.GetRawData();
-    HR(DeviceKeeper::GetDevice()->CreateBuffer(&bufferDesc, &initData, &buffer));
+    HR(DeviceKeeper::GetRenderDevice()->CreateBuffer(&bufferDesc, &initData, &buffer));
 
     return buffer;
 }
@@ -100,18 +100,32 @@ static void Rotate(const D3DXVECTOR3 &Axis, FLOAT Angle, D3DXVECTOR3 &Dir, D3DXV
 
 void UVNBasis::SetDir(const D3DXVECTOR3 &NewDir)
 {
-    if(Dir() != NewDir)
-        SetNeedUpdate();
+    if(Dir() == NewDir)
+        return;
 
     Dir() = NewDir;
+    SetNeedUpdate();
+    OnBasisChanged();
 }
 
 void UVNBasis::SetPos(const D3DXVECTOR3 &NewPos)
 {
-    if(Pos() != NewPos)
-        SetNeedUpdate();
+    if(Pos() == NewPos)
+        return;
 
     Pos() = NewPos;
+    SetNeedUpdate();
+    OnBasisChanged();
+}
+
+void UVNBasis::SetInvertUp(bool InvertUp)
+{
+    if(invertUp == InvertUp)
+        return;
+
+    invertUp = InvertUp;
+    SetNeedUpdate();
+    OnBasisChanged();
 }
 
 void UVNBasis::UpdateMatrix() const
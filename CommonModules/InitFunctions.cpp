@@ -161,6 +161,71 @@ D3DData InitD3D(const D3DParams &Params) throw (Exception)
 	return data;
 }
 
+D3DData InitNullD3D(LONG ClientWidth, LONG ClientHeight) throw (Exception)
+{
+    D3DData data;
+
+    D3D_FEATURE_LEVEL featureLevel;
+
+    HRESULT hr = D3D11CreateDevice(
+        NULL,
+        D3D_DRIVER_TYPE_NULL,
+        0,
+        0,
+        0, 0,
+        D3D11_SDK_VERSION,
+        &data.device,
+        &featureLevel,
+        &data.context);
+
+    if (FAILED(hr))
+        throw Exception("D3D11CreateDevice of the null driver Failed");
+
+    if (featureLevel < D3D_FEATURE_LEVEL_11_0)
+        throw Exception("Direct3D Feature Level 11 unsupported");
+
+    data.swapChain = NULL;
+    data.msaaQuality = 1;
+
+    D3D11_TEXTURE2D_DESC textureDesc = {};
+    textureDesc.Width = ClientWidth;
+    textureDesc.Height = ClientHeight;
+    textureDesc.MipLevels = 1;
+    textureDesc.ArraySize = 1;
+    textureDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    textureDesc.SampleDesc.Count = 1;
+    textureDesc.Usage = D3D11_USAGE_DEFAULT;
+    textureDesc.BindFlags = D3D11_BIND_RENDER_TARGET;
+
+    ID3D11Texture2D* backBufferPtr;
+    HR(data.device->CreateTexture2D(&textureDesc, 0, &backBufferPtr));
+
+    Utils::AutoCOM<ID3D11Texture2D> backBuffer = backBufferPtr;
+    HR(data.device->CreateRenderTargetView(backBuffer, 0, &data.renderTargetView));
+
+    textureDesc.Format = DXGI_FORMAT_D24_UNORM_S8_UINT;
+    textureDesc.BindFlags = D3D11_BIND_DEPTH_STENCIL;
+
+    ID3D11Texture2D* depthStencilBufferPtr;
+    HR(data.device->CreateTexture2D(&textureDesc, 0, &depthStencilBufferPtr));
+
+    Utils::AutoCOM<ID3D11Texture2D> depthStencilBuffer = depthStencilBufferPtr;
+    HR(data.device->CreateDepthStencilView(depthStencilBuffer, NULL, &data.depthStencilView));
+
+    data.context->OMSetRenderTargets(1, &data.renderTargetView, data.depthStencilView);
+
+    data.screenViewport.TopLeftX = 0;
+    data.screenViewport.TopLeftY = 0;
+    data.screenViewport.Width = static_cast<float>(ClientWidth);
+    data.screenViewport.Height = static_cast<float>(ClientHeight);
+    data.screenViewport.MinDepth = 0.0f;
+    data.screenViewport.MaxDepth = 1.0f;
+
+    data.context->RSSetViewports(1, &data.screenViewport);
+
+    return data;
+}
+
 void ChangeResolution(D3DData &Data, LONG NewWidth, LONG NewHeight) throw (Exception)
 {
     ID3D11RenderTargetView* nullRTV = NULL;
@@ -545,7 +545,7 @@ void OBJMesh::Load(const std::string &FileName) throw (Exception)
 	D3D11_SUBRESOURCE_DATA vInitData;
     memset(&vInitData, 0, sizeof(D3D11_SUBRESOURCE_DATA));
 	vInitData.pSysMem = &vertices[0];
-	HR(DeviceKeeper::GetDevice()->CreateBuffer(&vbd, &vInitData, &vertexBuffer));
+	HR(DeviceKeeper::GetRenderDevice()->CreateBuffer(&vbd, &vInitData, &vertexBuffer));
 
 	D3D11_BUFFER_DESC ibd;
 	ibd.Usage = D3D11_USAGE_DEFAULT;
@@ -557,7 +557,7 @@ void OBJMesh::Load(const std::string &FileName) throw (Exception)
 	D3D11_SUBRESOURCE_DATA iInitData;
     memset(&iInitData, 0, sizeof(D3D11_SUBRESOURCE_DATA));
 	iInitData.pSysMem = &indices[0];
-	HR(DeviceKeeper::GetDevice()->CreateBuffer(&ibd, &iInitData, &indexBuffer));
+	HR(DeviceKeeper::GetRenderDevice()->CreateBuffer(&ibd, &iInitData, &indexBuffer));
 }
 
 void OBJMesh::Release()
@@ -582,15 +582,15 @@ void OBJMesh::Draw(INT SubsetNumber) const throw (Exception)
 	UINT stride = sizeof(OBJVertex);
 	UINT offset = 0;
 
-	DeviceKeeper::GetDeviceContext()->IASetVertexBuffers(0, 1, &vertexBuffer, &stride, &offset);
-	DeviceKeeper::GetDeviceContext()->IASetIndexBuffer(indexBuffer, DXGI_FORMAT_R32_UINT, 0);
-    DeviceKeeper::GetDeviceContext()->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	DeviceKeeper::GetRenderContext()->IASetVertexBuffers(0, 1, &vertexBuffer, &stride, &offset);
+	DeviceKeeper::GetRenderContext()->IASetIndexBuffer(indexBuffer, DXGI_FORMAT_R32_UINT, 0);
+    DeviceKeeper::GetRenderContext()->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
 	if (SubsetNumber == -1){
 		SubsetsStorage::const_iterator ci;
 		for (ci = subsets.begin(); ci != subsets.end(); ++ci){
 			const SubsetData &subset = *ci;
-			DeviceKeeper::GetDeviceContext()->DrawIndexed(subset.indicesCnt, subset.startIndex, 0);
+			DeviceKeeper::GetRenderContext()->DrawIndexed(subset.indicesCnt, subset.startIndex, 0);
 		}
 	}
 	else{
@@ -598,7 +598,7 @@ void OBJMesh::Draw(INT SubsetNumber) const throw (Exception)
 			throw MeshException("Invalid subset number");
 
 		const SubsetData &subset = subsets[SubsetNumber];
-		DeviceKeeper::GetDeviceContext()->DrawIndexed(subset.indicesCnt, subset.startIndex, 0);
+		DeviceKeeper::GetRenderContext()->DrawIndexed(subset.indicesCnt, subset.startIndex, 0);
 	}
 }
 
@@ -693,7 +693,7 @@ void ColladaBinaryMesh::Load(const std::string &FilePath) throw (Exception)
 
             D3D11_SUBRESOURCE_DATA vInitData = {};            
 	        vInitData.pSysMem = &vertices[0];
-	        HR(DeviceKeeper::GetDevice()->CreateBuffer(&vbd, &vInitData, &newSubset.vertexBuffer));
+	        HR(DeviceKeeper::GetRenderDevice()->CreateBuffer(&vbd, &vInitData, &newSubset.vertexBuffer));
 
             D3D11_BUFFER_DESC ibd = {};
 	        ibd.Usage = D3D11_USAGE_DEFAULT;
@@ -702,7 +702,7 @@ void ColladaBinaryMesh::Load(const std::string &FilePath) throw (Exception)
 
             D3D11_SUBRESOURCE_DATA iInitData = {};            
 	        iInitData.pSysMem = &indices[0];
-	        HR(DeviceKeeper::GetDevice()->CreateBuffer(&ibd, &iInitData, &newSubset.indexBuffer));
+	        HR(DeviceKeeper::GetRenderDevice()->CreateBuffer(&ibd, &iInitData, &newSubset.indexBuffer));
 
             subsets.push_back(newSubset);
         }                
@@ -711,7 +711,7 @@ void ColladaBinaryMesh::Load(const std::string &FilePath) throw (Exception)
 
 void ColladaBinaryMesh::Draw(INT SubsetNumber) const throw (Exception)
 {    
-    DeviceKeeper::GetDeviceContext()->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    DeviceKeeper::GetRenderContext()->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
     if(SubsetNumber == -1){
         SubsetsStorage::const_iterator ci;
@@ -719,10 +719,10 @@ void ColladaBinaryMesh::Draw(INT SubsetNumber) const throw (Exception)
             const SubsetData &subset = *ci;
 
             UINT offset = 0, stride = sizeof(ColladaVertex);
-            DeviceKeeper::GetDeviceContext()->IASetVertexBuffers(0, 1, &subset.vertexBuffer, &stride, &offset);
-	        DeviceKeeper::GetDeviceContext()->IASetIndexBuffer(subset.indexBuffer, DXGI_FORMAT_R32_UINT, 0);
+            DeviceKeeper::GetRenderContext()->IASetVertexBuffers(0, 1, &subset.vertexBuffer, &stride, &offset);
+	        DeviceKeeper::GetRenderContext()->IASetIndexBuffer(subset.indexBuffer, DXGI_FORMAT_R32_UINT, 0);
 
-            DeviceKeeper::GetDeviceContext()->DrawIndexed(subset.verticesCnt, 0, 0);
+            DeviceKeeper::GetRenderContext()->DrawIndexed(subset.verticesCnt, 0, 0);
         }
     }else{
         if (SubsetNumber < 0 || SubsetNumber >= subsets.size())
@@ -731,10 +731,10 @@ void ColladaBinaryMesh::Draw(INT SubsetNumber) const throw (Exception)
 		const SubsetData &subset = subsets[SubsetNumber];
 
         UINT offset = 0, stride = sizeof(ColladaVertex);
-        DeviceKeeper::GetDeviceContext()->IASetVertexBuffers(0, 1, &subset.vertexBuffer, &stride, &offset);
-	    DeviceKeeper::GetDeviceContext()->IASetIndexBuffer(subset.indexBuffer, DXGI_FORMAT_R32_UINT, 0);
+        DeviceKeeper::GetRenderContext()->IASetVertexBuffers(0, 1, &subset.vertexBuffer, &stride, &offset);
+	    DeviceKeeper::GetRenderContext()->IASetIndexBuffer(subset.indexBuffer, DXGI_FORMAT_R32_UINT, 0);
 
-        DeviceKeeper::GetDeviceContext()->DrawIndexed(subset.verticesCnt, 0, 0);
+        DeviceKeeper::GetRenderContext()->DrawIndexed(subset.verticesCnt, 0, 0);
 
     }
 }
@@ -814,11 +814,11 @@ void SimpleCone::Draw(INT SubsetNumber) const throw (Exception)
 
     UINT offset = 0, vertexSize = vertices.GetVertixSize();
 
-    DeviceKeeper::GetDeviceContext()->IASetVertexBuffers(0, 1, &vertexBuffer, &vertexSize, &offset);
-    DeviceKeeper::GetDeviceContext()->IASetIndexBuffer(indexBuffer, DXGI_FORMAT_R32_UINT, 0);
-    DeviceKeeper::GetDeviceContext()->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    DeviceKeeper::GetRenderContext()->IASetVertexBuffers(0, 1, &vertexBuffer, &vertexSize, &offset);
+    DeviceKeeper::GetRenderContext()->IASetIndexBuffer(indexBuffer, DXGI_FORMAT_R32_UINT, 0);
+    DeviceKeeper::GetRenderContext()->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
-    DeviceKeeper::GetDeviceContext()->DrawIndexed(indices.size(), 0, 0);
+    DeviceKeeper::GetRenderContext()->DrawIndexed(indices.size(), 0, 0);
 }
 
 const MaterialData &SimpleCone::GetSubsetMaterial(INT SubsetNumber) const throw (Exception)
@@ -911,11 +911,11 @@ void SimpleSphere::Draw(INT SubsetNumber) const throw (Exception)
 
     UINT offset = 0, vertexSize = vertices.GetVertixSize();
 
-    DeviceKeeper::GetDeviceContext()->IASetVertexBuffers(0, 1, &vertexBuffer, &vertexSize, &offset);
-    DeviceKeeper::GetDeviceContext()->IASetIndexBuffer(indexBuffer, DXGI_FORMAT_R32_UINT, 0);
-    DeviceKeeper::GetDeviceContext()->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    DeviceKeeper::GetRenderContext()->IASetVertexBuffers(0, 1, &vertexBuffer, &vertexSize, &offset);
+    DeviceKeeper::GetRenderContext()->IASetIndexBuffer(indexBuffer, DXGI_FORMAT_R32_UINT, 0);
+    DeviceKeeper::GetRenderContext()->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
-    DeviceKeeper::GetDeviceContext()->DrawIndexed(indices.size(), 0, 0);
+    DeviceKeeper::GetRenderContext()->DrawIndexed(indices.size(), 0, 0);
 }
 
 const MaterialData &SimpleSphere::GetSubsetMaterial(INT SubsetNumber) const throw (Exception)
@@ -973,10 +973,10 @@ void Triangle::Draw(INT SubsetNumber) const throw (Exception)
 
     UINT offset = 0;
 
-    DeviceKeeper::GetDeviceContext()->IASetVertexBuffers(0, 1, &vertexBuffer, &vertexSize, &offset);
-    DeviceKeeper::GetDeviceContext()->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    DeviceKeeper::GetRenderContext()->IASetVertexBuffers(0, 1, &vertexBuffer, &vertexSize, &offset);
+    DeviceKeeper::GetRenderContext()->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
-    DeviceKeeper::GetDeviceContext()->Draw(3, 0);
+    DeviceKeeper::GetRenderContext()->Draw(3, 0);
 }
 
 const MaterialData &Triangle::GetSubsetMaterial(INT SubsetNumber) const throw (Exception)
@@ -1053,11 +1053,11 @@ void Fan::Draw(INT SubsetNumber) const throw (Exception)
 
     UINT offset = 0, vertexSize = vertices.GetVertixSize();
 
-    DeviceKeeper::GetDeviceContext()->IASetVertexBuffers(0, 1, &vertexBuffer, &vertexSize, &offset);
-    DeviceKeeper::GetDeviceContext()->IASetIndexBuffer(indexBuffer, DXGI_FORMAT_R32_UINT, 0);
-    DeviceKeeper::GetDeviceContext()->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    DeviceKeeper::GetRenderContext()->IASetVertexBuffers(0, 1, &vertexBuffer, &vertexSize, &offset);
+    DeviceKeeper::GetRenderContext()->IASetIndexBuffer(indexBuffer, DXGI_FORMAT_R32_UINT, 0);
+    DeviceKeeper::GetRenderContext()->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
-    DeviceKeeper::GetDeviceContext()->DrawIndexed(indices.size(), 0, 0);
+    DeviceKeeper::GetRenderContext()->DrawIndexed(indices.size(), 0, 0);
 }
 
 const Meshes::MaterialData &Fan::GetSubsetMaterial(INT SubsetNumber) const throw (Exception)
@@ -1173,11 +1173,11 @@ void Torus::Draw(INT SubsetNumber) const throw (Exception)
 
     UINT offset = 0, vertexSize = vertices.GetVertixSize();
 
-    DeviceKeeper::GetDeviceContext()->IASetVertexBuffers(0, 1, &vertexBuffer, &vertexSize, &offset);
-    DeviceKeeper::GetDeviceContext()->IASetIndexBuffer(indexBuffer, DXGI_FORMAT_R32_UINT, 0);
-    DeviceKeeper::GetDeviceContext()->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    DeviceKeeper::GetRenderContext()->IASetVertexBuffers(0, 1, &vertexBuffer, &vertexSize, &offset);
+    DeviceKeeper::GetRenderContext()->IASetIndexBuffer(indexBuffer, DXGI_FORMAT_R32_UINT, 0);
+    DeviceKeeper::GetRenderContext()->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
-    DeviceKeeper::GetDeviceContext()->DrawIndexed(indices.size(), 0, 0);
+    DeviceKeeper::GetRenderContext()->DrawIndexed(indices.size(), 0, 0);
 }
 
 const Meshes::MaterialData &Torus::GetSubsetMaterial(INT SubsetNumber) const throw (Exception)
@@ -1226,22 +1226,22 @@ void CustomMesh::Release()
 
 void CustomMesh::Draw(INT SubsetNumber) const throw(Exception)
 {
-    DeviceKeeper::GetDeviceContext()->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    DeviceKeeper::GetRenderContext()->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
     UINT offset = 0;
-    DeviceKeeper::GetDeviceContext()->IASetVertexBuffers(0, 1, &vertexBuffer, &vertexSize, &offset);
-    DeviceKeeper::GetDeviceContext()->IASetIndexBuffer(indexBuffer, DXGI_FORMAT_R32_UINT, 0);
+    DeviceKeeper::GetRenderContext()->IASetVertexBuffers(0, 1, &vertexBuffer, &vertexSize, &offset);
+    DeviceKeeper::GetRenderContext()->IASetIndexBuffer(indexBuffer, DXGI_FORMAT_R32_UINT, 0);
 
     if(SubsetNumber == -1){
         for(const SubsetData &subset : subsets)
-            DeviceKeeper::GetDeviceContext()->DrawIndexed(subset.indicesCnt, subset.startIndex, 0);
+            DeviceKeeper::GetRenderContext()->DrawIndexed(subset.indicesCnt, subset.startIndex, 0);
     }else{
         if (SubsetNumber < 0 || SubsetNumber >= subsets.size())
             throw MeshException("Invalid subset number");
 
         const SubsetData &subset = subsets[SubsetNumber];
 
-        DeviceKeeper::GetDeviceContext()->DrawIndexed(subset.indicesCnt, subset.startIndex, 0);
+        DeviceKeeper::GetRenderContext()->DrawIndexed(subset.indicesCnt, subset.startIndex, 0);
 
     }
 }
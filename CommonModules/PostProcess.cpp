@@ -17,56 +17,135 @@ void Blur::Init(const std::wstring &VertexShaderPath,
                      const ScreenSpaceQuad *Quad,
                      const Texture::RenderTarget DataRenderTarget,
                      size_t BlurIterations,
-                     const KernelStorage &Kernel) throw (Exception)
+                     const KernelStorage &Kernel,
+                     const Shaders::ShaderMacros &Macros) throw (Exception)
 {
     orig = DataRenderTarget;
     quad = Quad;
     blurIterations = BlurIterations;
 
-    tmp1.Init(DXGI_FORMAT_R32G32B32A32_FLOAT);    
+    //intermediate of the separable passes holds the same data as the blurred target
+    tmp1.Init(DataRenderTarget.GetFormat());
 
     vs.Load(VertexShaderPath, "ProcessVertex", Quad->GetVertexMetadata());
-    ps.Load(PixelShaderPath, "ProcessPixel");
+    ps.Load(PixelShaderPath, "ProcessPixel", Macros);
 
     ps.CreateSamplerState(0, Utils::DirectX::SamplerStateDescription(D3D11_FILTER_MIN_MAG_LINEAR_MIP_POINT, D3D11_TEXTURE_ADDRESS_CLAMP));
     
-    if(!Kernel.size()){
+    ps.CreateVariable("taps", 0, 0, TapsStorage(MaxTapsCount, D3DXVECTOR4(0.0f, 0.0f, 0.0f, 0.0f)));
+    ps.CreateVariable("texFactors", 0, 1, D3DXVECTOR2(1.0f / (float)orig.GetWidth(), 1.0f / (float)orig.GetHeight()));
+    ps.CreateVariable<INT>("tapsCount", 0, 2, 0);
+    ps.CreateVariable<FLOAT>("padding", 0, 3, 0.0f);
+    ps.CreateVariable<INT>("isVertical", 1, 0, 1);
+    ps.CreateVariable("padding2", 1, 1, D3DXVECTOR3());
+
+    if(!Kernel.size())
+        SetKernel({0.05f, 0.05f, 0.1f, 0.1f, 0.1f, 0.2f, 0.1f, 0.1f, 0.1f, 0.05f, 0.05f});
+    else
+        SetKernel(Kernel);
+}
 
-        const INT samplesCount = 11;
+void Blur::SetKernel(const KernelStorage &Kernel) throw (Exception)
+{
+    kernel = Kernel;
+    UpdateTaps();
+}
 
-        float weights[] = {0.05f, 0.05f, 0.1f, 0.1f, 0.1f, 0.2f, 0.1f, 0.1f, 0.1f, 0.05f, 0.05f};
-    
-        D3DXVECTOR4 weightsData[samplesCount];
-        for(int i = 0; i < samplesCount; i++)
-            weightsData[i].x = weights[i];
+void Blur::SetBlurIterationsCount(size_t BlurIterations) throw (Exception)
+{
+    blurIterations = BlurIterations;
+
+    if(kernel.size())
+        UpdateTaps();
+}
+
+void Blur::SetIterationsFusion(bool Fuse) throw (Exception)
+{
+    fuseIterations = Fuse;
+
+    if(kernel.size())
+        UpdateTaps();
+}
 
-        ps.CreateVariable("weights", 0, 0, weightsData);
-    }else{
-        std::vector<D3DXVECTOR4> weightsData;
+void Blur::UpdateTaps() throw (Exception)
+{
+    TapsStorage taps = GetLinearTaps(kernel);
+    iterationsFused = false;
+
+    if(fuseIterations && blurIterations > 1){
 
-        for(float w : Kernel)
-            weightsData.push_back({w, 0.0f, 0.0f, 0.0f});
+        KernelStorage iteratedKernel = GetIteratedKernel(kernel, blurIterations);
 
-        ps.CreateVariable("weights", 0, 0, weightsData);
+        //wider kernels keep the iterations of the single one
+        if((INT)iteratedKernel.size() / 2 < MaxTapsCount){
+            taps = GetLinearTaps(iteratedKernel);
+            iterationsFused = true;
+        }
     }
 
-    ps.CreateVariable("texFactors", 0, 1, D3DXVECTOR2(1.0f / (float)orig.GetWidth(), 1.0f / (float)orig.GetHeight()));
-    ps.CreateVariable("padding", 0, 2, D3DXVECTOR2());
-    ps.CreateVariable<INT>("isVertical", 1, 0, 1);
-    ps.CreateVariable("padding2", 1, 1, D3DXVECTOR3());
-    
+    INT tapsCount = (INT)taps.size();
+
+    //the variable keeps the size of the whole array
+    taps.resize(MaxTapsCount, D3DXVECTOR4(0.0f, 0.0f, 0.0f, 0.0f));
+
+    ps.UpdateVariable("taps", taps);
+    ps.UpdateVariable("tapsCount", tapsCount);
     ps.ApplyVariables();
 }
 
-void Blur::SetKernel(const KernelStorage &Kernel)
+Blur::TapsStorage Blur::GetLinearTaps(const KernelStorage &Kernel) throw (Exception)
 {
-    std::vector<D3DXVECTOR4> weightsData;
+    if(Kernel.size() % 2 == 0)
+        throw PostProcessException("Blur kernel size must be odd");
 
-    for(float w : Kernel)
-        weightsData.push_back({w, 0.0f, 0.0f, 0.0f});
+    INT radius = (INT)Kernel.size() / 2;
 
-    ps.UpdateVariable("weights", weightsData);
-    ps.ApplyVariables();
+    auto weight = [&](INT Offset) -> FLOAT
+    {
+        if(Offset < -radius || Offset > radius)
+            return 0.0f;
+
+        return (Offset == 0) ? Kernel[radius] * 0.5f : Kernel[Offset + radius];
+    };
+
+    //the fetch at First + SecondWeight / (FirstWeight + SecondWeight) returns both texels with their weights
+    auto merge = [](INT First, FLOAT FirstWeight, FLOAT SecondWeight) -> D3DXVECTOR4
+    {
+        FLOAT sum = FirstWeight + SecondWeight;
+        FLOAT offset = First + ((sum > 0.0f) ? SecondWeight / sum : 0.0f);
+
+        return D3DXVECTOR4(offset, sum, (FLOAT)First, FirstWeight);
+    };
+
+    TapsStorage taps;
+
+    for(INT i = 0; i <= radius; i += 2){
+        taps.push_back(merge(-i - 1, weight(-i - 1), weight(-i)));
+        taps.push_back(merge(i, weight(i), weight(i + 1)));
+    }
+
+    if((INT)taps.size() > MaxTapsCount)
+        throw PostProcessException("Blur kernel is too wide for the taps array");
+
+    return taps;
+}
+
+Blur::KernelStorage Blur::GetIteratedKernel(const KernelStorage &Kernel, size_t Iterations)
+{
+    KernelStorage outData = Kernel;
+
+    for(size_t i = 1; i < Iterations; i++){
+
+        KernelStorage convolved(outData.size() + Kernel.size() - 1, 0.0f);
+
+        for(size_t a = 0; a < outData.size(); a++)
+            for(size_t b = 0; b < Kernel.size(); b++)
+                convolved[a + b] += outData[a] * Kernel[b];
+
+        outData = convolved;
+    }
+
+    return outData;
 }
 
 Blur::KernelStorage Blur::GetGaussianKernel(INT Radius, FLOAT Deviation)
@@ -93,8 +172,11 @@ Blur::KernelStorage Blur::GetGaussianKernel(INT Radius, FLOAT Deviation)
 void Blur::Draw() const
 {    
     vs.Apply();
+
+    //the taps hold the kernel of all iterations
+    size_t passesCount = (iterationsFused) ? 1 : blurIterations;
     
-    for(size_t i = 0; i < blurIterations; i++)
+    for(size_t i = 0; i < passesCount; i++)
     {
         {        
             PostProcess::RenderPass pass(tmp1.GetRenderTargetView());
@@ -138,6 +220,126 @@ void Blur::OnResolutionChanged() throw (Exception)
     tmp1 = newTmp1;
 }
 
+void BoxFilter::Init(const std::wstring &VertexShaderPath,
+                     const std::wstring &BuildShaderPath,
+                     const std::wstring &FilterShaderPath,
+                     const ScreenSpaceQuad *Quad,
+                     const Texture::RenderTarget DataRenderTarget,
+                     INT BoxRadius,
+                     const Shaders::ShaderMacros &Macros) throw (Exception)
+{
+    orig = DataRenderTarget;
+    quad = Quad;
+
+    for(Texture::RenderTarget &table : sat)
+        table.Init(DXGI_FORMAT_R32G32_UINT);
+
+    vs.Load(VertexShaderPath, "ProcessVertex", Quad->GetVertexMetadata());
+
+    Shaders::ShaderMacros convertMacros = Macros;
+    convertMacros["CONVERT"] = "1";
+
+    convertPs.Load(BuildShaderPath, "ProcessPixel", convertMacros);
+    buildPs.Load(BuildShaderPath, "ProcessPixel", Macros);
+    ps.Load(FilterShaderPath, "ProcessPixel", Macros);
+
+    buildPs.CreateVariable<INT>("stepX", 0, 0, 0);
+    buildPs.CreateVariable<INT>("stepY", 0, 1, 0);
+    buildPs.CreateVariable("padding", 0, 2, D3DXVECTOR2());
+
+    ps.CreateVariable<INT>("boxRadius", 0, 0, 0);
+    ps.CreateVariable<FLOAT>("depthTolerance", 0, 1, 0.0f);
+    ps.CreateVariable("padding", 0, 2, D3DXVECTOR2());
+
+    SetBoxRadius(BoxRadius);
+}
+
+void BoxFilter::SetBoxRadius(INT BoxRadius) throw (Exception)
+{
+    if(BoxRadius < 1 || BoxRadius > MaxBoxRadius)
+        throw PostProcessException("Box filter radius is out of range");
+
+    boxRadius = BoxRadius;
+
+    ps.UpdateVariable("boxRadius", boxRadius);
+    ps.ApplyVariables();
+}
+
+void BoxFilter::SetDepthTolerance(FLOAT Tolerance) throw (Exception)
+{
+    if(Tolerance < 0.0f)
+        throw PostProcessException("Box filter depth tolerance must not be negative");
+
+    depthTolerance = Tolerance;
+
+    ps.UpdateVariable("depthTolerance", depthTolerance);
+    ps.ApplyVariables();
+}
+
+void BoxFilter::Draw() const
+{
+    vs.Apply();
+
+    INT current = 0;
+
+    {
+        PostProcess::RenderPass pass(sat[current].GetRenderTargetView());
+
+        convertPs.SetResource(1, orig.GetSahderResourceView());
+        convertPs.SetResource(2, normalDepthSrv);
+        convertPs.Apply();
+
+        quad->Draw();
+
+        convertPs.SetResource(1, NULL);
+        convertPs.SetResource(2, NULL);
+    }
+
+    //prefix sums of the rows, then of the columns, every pass doubles the summed span
+    INT sizes[] = {(INT)sat[0].GetWidth(), (INT)sat[0].GetHeight()};
+
+    for(INT axis = 0; axis < 2; axis++)
+        for(INT step = 1; step < sizes[axis]; step *= 2){
+
+            PostProcess::RenderPass pass(sat[1 - current].GetRenderTargetView());
+
+            buildPs.UpdateVariable("stepX", (axis == 0) ? step : 0);
+            buildPs.UpdateVariable("stepY", (axis == 1) ? step : 0);
+            buildPs.ApplyVariables();
+
+            buildPs.SetResource(0, sat[current].GetSahderResourceView());
+            buildPs.Apply();
+
+            quad->Draw();
+
+            buildPs.SetResource(0, NULL);
+
+            current = 1 - current;
+        }
+
+    {
+        PostProcess::RenderPass pass(orig.GetRenderTargetView());
+
+        ps.SetResource(0, sat[current].GetSahderResourceView());
+        ps.Apply();
+
+        quad->Draw();
+
+        ps.SetResource(0, NULL);
+    }
+}
+
+void BoxFilter::OnResolutionChanged() throw (Exception)
+{
+    for(Texture::RenderTarget &table : sat){
+
+        Texture::RenderTarget newTable;
+        newTable.Init(table.GetFormat(), (USHORT)CommonParams::GetScreenWidth(), (USHORT)CommonParams::GetScreenHeight());
+
+        table = newTable;
+    }
+}
+
 void ScreenSpaceQuad::Release()
 {
    ReleaseCOM(vb);
@@ -171,7 +373,7 @@ void DefaultScreenQuad::Init() throw (Exception)
     memset(&vertexData, 0, sizeof(D3D11_SUBRESOURCE_DATA));
     vertexData.pSysMem = &vertices[0];	
 
-    HR(DeviceKeeper::GetDevice()->CreateBuffer(&vertexBufferDesc, &vertexData, &vb));
+    HR(DeviceKeeper::GetRenderDevice()->CreateBuffer(&vertexBufferDesc, &vertexData, &vb));
 
     UINT indices[] = {0,1,2,2,3,0};
     
@@ -186,7 +388,7 @@ void DefaultScreenQuad::Init() throw (Exception)
     indicesData.pSysMem = indices;	
 
     try{
-        HR(DeviceKeeper::GetDevice()->CreateBuffer(&indexBufferDesc, &indicesData, &ib));
+        HR(DeviceKeeper::GetRenderDevice()->CreateBuffer(&indexBufferDesc, &indicesData, &ib));
     }catch(const Exception &ex){
         ReleaseCOM(vb);
         throw ex;
@@ -223,12 +425,12 @@ void ScreenSpaceQuad::DrawQuad(INT VertexSize) const
     UINT stride = VertexSize;
 	UINT offset = 0;
 
-	DeviceKeeper::GetDeviceContext()->IASetVertexBuffers(0, 1, &vb, &stride, &offset);
-	DeviceKeeper::GetDeviceContext()->IASetIndexBuffer(ib, DXGI_FORMAT_R32_UINT, 0);
+	DeviceKeeper::GetRenderContext()->IASetVertexBuffers(0, 1, &vb, &stride, &offset);
+	DeviceKeeper::GetRenderContext()->IASetIndexBuffer(ib, DXGI_FORMAT_R32_UINT, 0);
 
-    DeviceKeeper::GetDeviceContext()->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    DeviceKeeper::GetRenderContext()->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
-    DeviceKeeper::GetDeviceContext()->DrawIndexed(6, 0, 0);
+    DeviceKeeper::GetRenderContext()->DrawIndexed(6, 0, 0);
 }
 
 DefaultScreenQuad::DefaultScreenQuad(DefaultScreenQuad &Val)
@@ -250,10 +452,12 @@ void DefaultScreenQuad::Draw(INT SubsetNumber) const throw (Exception)
 
 static void SetRenderTarget(float Color[4], ID3D11DepthStencilView *Dsv, ID3D11RenderTargetView *Rtv)
 {
-    DeviceKeeper::GetDeviceContext()->OMSetRenderTargets(1, &Rtv, Dsv);
+    DeviceKeeper::GetRenderContext()->OMSetRenderTargets(1, &Rtv, Dsv);
     
-    DeviceKeeper::GetDeviceContext()->ClearRenderTargetView(Rtv, Color);			
-    DeviceKeeper::GetDeviceContext()->ClearDepthStencilView(Dsv, D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.0f, 0);
+    DeviceKeeper::GetRenderContext()->ClearRenderTargetView(Rtv, Color);			
+
+    if(Dsv != NULL)
+        DeviceKeeper::GetRenderContext()->ClearDepthStencilView(Dsv, D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.0f, 0);
 }
 
 void RenderPass::SetViewport(const D3D11_VIEWPORT &NewViewport)
@@ -261,10 +465,10 @@ void RenderPass::SetViewport(const D3D11_VIEWPORT &NewViewport)
     oldViewport = new D3D11_VIEWPORT();
 
     UINT viewportsCnt = 1;
-    DeviceKeeper::GetDeviceContext()->RSGetViewports(&viewportsCnt, oldViewport);
+    DeviceKeeper::GetRenderContext()->RSGetViewports(&viewportsCnt, oldViewport);
 
     newViewport = new D3D11_VIEWPORT(NewViewport);
-    DeviceKeeper::GetDeviceContext()->RSSetViewports(1, newViewport);
+    DeviceKeeper::GetRenderContext()->RSSetViewports(1, newViewport);
 }
 
 RenderPass::RenderPass(ID3D11RenderTargetView *Rtv)
@@ -309,14 +513,37 @@ RenderPass::RenderPass(ID3D11RenderTargetView *Rtv, ID3D11DepthStencilView *Dsv,
     SetViewport(Viewport);
 }
 
+RenderPass::RenderPass(const std::vector<ID3D11RenderTargetView*> &Rtvs, ID3D11DepthStencilView *Dsv, const D3D11_VIEWPORT &Viewport)
+{
+    dsv = Dsv;
+
+    float color[4];
+    color[0] = 1;//Red
+    color[1] = 1;//Green
+    color[2] = 1;//Blue
+    color[3] = 0;//Alpha
+
+    DeviceKeeper::GetRenderContext()->OMSetRenderTargets(Rtvs.size(), Rtvs.data(), dsv);
+
+    for(ID3D11RenderTargetView *rtv : Rtvs)
+        DeviceKeeper::GetRenderContext()->ClearRenderTargetView(rtv, color);
+
+    if(dsv != NULL)
+        DeviceKeeper::GetRenderContext()->ClearDepthStencilView(dsv, D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.0f, 0);
+
+    SetViewport(Viewport);
+}
+
 RenderPass::~RenderPass()
 {
     ID3D11RenderTargetView *rtv = DeviceKeeper::GetRenderTargetView();
-    DeviceKeeper::GetDeviceContext()->OMSetRenderTargets(1, &rtv, DeviceKeeper::GetDepthStencilView());
-    DeviceKeeper::GetDeviceContext()->ClearDepthStencilView(dsv, D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.0f, 0);
+    DeviceKeeper::GetRenderContext()->OMSetRenderTargets(1, &rtv, DeviceKeeper::GetDepthStencilView());
+
+    if(dsv != NULL)
+        DeviceKeeper::GetRenderContext()->ClearDepthStencilView(dsv, D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.0f, 0);
 
     if(newViewport != NULL){
-        DeviceKeeper::GetDeviceContext()->RSSetViewports(1, oldViewport);
+        DeviceKeeper::GetRenderContext()->RSSetViewports(1, oldViewport);
         delete oldViewport;
         delete newViewport;
     }
@@ -0,0 +1,694 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include <RecordingBackend.h>
+#include <algorithm>
+
+namespace RenderBackend
+{
+
+//widest texel of DXGI_FORMAT, the scratch rows of the textures take it
+static const UINT MaxTexelSize = 16;
+
+static UINT GetMipSize(UINT Size, UINT MipLevel)
+{
+    UINT mipSize = Size >> MipLevel;
+    return (mipSize > 0) ? mipSize : 1;
+}
+
+static bool IsBuffer(ID3D11Resource *Resource)
+{
+    D3D11_RESOURCE_DIMENSION dimension;
+    Resource->GetType(&dimension);
+
+    return dimension == D3D11_RESOURCE_DIMENSION_BUFFER;
+}
+
+//Buffers are one row of ByteWidth, the rows of Texture2D are MaxTexelSize texels as the real pitch is up to the driver
+static bool GetSubresourceLayout(ID3D11Resource *Resource, UINT Subresource, UINT &RowPitch, UINT &RowsCount)
+{
+    D3D11_RESOURCE_DIMENSION dimension;
+    Resource->GetType(&dimension);
+
+    if(dimension == D3D11_RESOURCE_DIMENSION_BUFFER){
+        D3D11_BUFFER_DESC desc;
+        static_cast<ID3D11Buffer*>(Resource)->GetDesc(&desc);
+
+        RowPitch = desc.ByteWidth;
+        RowsCount = 1;
+        return true;
+    }
+
+    if(dimension == D3D11_RESOURCE_DIMENSION_TEXTURE2D){
+        D3D11_TEXTURE2D_DESC desc;
+        static_cast<ID3D11Texture2D*>(Resource)->GetDesc(&desc);
+
+        UINT mipLevel = Subresource % desc.MipLevels;
+        RowPitch = GetMipSize(desc.Width, mipLevel) * MaxTexelSize;
+        RowsCount = GetMipSize(desc.Height, mipLevel);
+        return true;
+    }
+
+    return false;
+}
+
+size_t CommandLogCounters::GetBindCalls() const
+{
+    size_t count = 0;
+
+    for(int c = COMMAND_SET_INPUT_LAYOUT; c <= COMMAND_SET_DEPTH_STENCIL_STATE; c++)
+        count += calls[c];
+
+    return count;
+}
+
+size_t CommandLogCounters::GetCallsCount() const
+{
+    size_t count = 0;
+
+    for(int c = 0; c < COMMANDS_COUNT; c++)
+        count += calls[c];
+
+    return count;
+}
+
+void CommandLog::Record(CommandType Type, UINT Count, UINT Bytes, ShaderStage Stage)
+{
+    commands.push_back(Command(Type, Count, Bytes, Stage));
+
+    if(Type == COMMAND_PRESENT)
+        frameStarts.push_back(commands.size());
+}
+
+void CommandLog::RecordBeginEvent(const std::wstring &Name)
+{
+    size_t index = std::find(eventNames.begin(), eventNames.end(), Name) - eventNames.begin();
+
+    if(index == eventNames.size())
+        eventNames.push_back(Name);
+
+    Record(COMMAND_BEGIN_EVENT, (UINT)index);
+}
+
+void CommandLog::Clear()
+{
+    commands.clear();
+    frameStarts.assign(1, 0);
+    eventNames.clear();
+}
+
+static void CountCommand(const Command &Cmd, CommandLogCounters &Counters)
+{
+    Counters.calls[Cmd.type]++;
+
+    if(Cmd.type == COMMAND_DRAW || Cmd.type == COMMAND_DRAW_INDEXED)
+        Counters.elements += Cmd.count;
+    else if(Cmd.type == COMMAND_MAP || Cmd.type == COMMAND_UPDATE_SUBRESOURCE)
+        Counters.uploadedBytes += Cmd.bytes;
+    else if(Cmd.type == COMMAND_CREATE_BUFFER)
+        Counters.createdBufferBytes += Cmd.bytes;
+}
+
+CommandLogCounters CommandLog::GetCounters(size_t First, size_t Last) const
+{
+    CommandLogCounters counters;
+
+    for(size_t c = First; c < Last; c++)
+        CountCommand(commands[c], counters);
+
+    return counters;
+}
+
+CommandLogCounters CommandLog::GetFrameCounters(size_t Frame) const
+{
+    if(Frame >= GetFramesCount())
+        return CommandLogCounters();
+
+    return GetCounters(frameStarts[Frame], frameStarts[Frame + 1]);
+}
+
+CommandLogCounters CommandLog::GetFrameEventCounters(size_t Frame, const std::wstring &Name) const
+{
+    CommandLogCounters counters;
+
+    if(Frame >= GetFramesCount())
+        return counters;
+
+    size_t nameIndex = std::find(eventNames.begin(), eventNames.end(), Name) - eventNames.begin();
+
+    //depth of the events below the outermost one of Name, zero is outside of it
+    size_t depth = 0;
+
+    for(size_t c = frameStarts[Frame]; c < frameStarts[Frame + 1]; c++){
+        const Command &command = commands[c];
+
+        if(depth == 0){
+            if(command.type == COMMAND_BEGIN_EVENT && command.count == nameIndex)
+                depth = 1;
+            continue;
+        }
+
+        if(command.type == COMMAND_BEGIN_EVENT)
+            depth++;
+        else if(command.type == COMMAND_END_EVENT && --depth == 0)
+            continue;
+
+        CountCommand(command, counters);
+    }
+
+    return counters;
+}
+
+size_t CommandLog::GetFrameEventsCount(size_t Frame, const std::wstring &Name) const
+{
+    if(Frame >= GetFramesCount())
+        return 0;
+
+    size_t nameIndex = std::find(eventNames.begin(), eventNames.end(), Name) - eventNames.begin();
+    size_t count = 0;
+
+    for(size_t c = frameStarts[Frame]; c < frameStarts[Frame + 1]; c++)
+        if(commands[c].type == COMMAND_BEGIN_EVENT && commands[c].count == nameIndex)
+            count++;
+
+    return count;
+}
+
+const char *CommandLog::GetCommandName(CommandType Type)
+{
+    static const char *names[COMMANDS_COUNT] = {
+        "CreateBuffer",
+        "CreateTexture",
+        "CreateView",
+        "CreateState",
+        "CreateShader",
+        "CreateInputLayout",
+        "Clear",
+        "Map",
+        "Unmap",
+        "UpdateSubresource",
+        "CopyResource",
+        "GenerateMips",
+        "SetInputLayout",
+        "SetVertexBuffers",
+        "SetIndexBuffer",
+        "SetTopology",
+        "SetShader",
+        "SetShaderResources",
+        "SetConstantBuffers",
+        "SetSamplers",
+        "SetRasterizerState",
+        "SetViewports",
+        "SetRenderTargets",
+        "SetBlendState",
+        "SetDepthStencilState",
+        "Draw",
+        "DrawIndexed",
+        "BeginEvent",
+        "EndEvent",
+        "Present"
+    };
+
+    return (Type >= 0 && Type < COMMANDS_COUNT) ? names[Type] : "Unknown";
+}
+
+HRESULT RecordingRenderDevice::CreateBuffer(const D3D11_BUFFER_DESC *Desc, const D3D11_SUBRESOURCE_DATA *InitialData, ID3D11Buffer **Buffer)
+{
+    log->Record(COMMAND_CREATE_BUFFER, 1, Desc->ByteWidth);
+    return device->CreateBuffer(Desc, InitialData, Buffer);
+}
+
+HRESULT RecordingRenderDevice::CreateTexture2D(const D3D11_TEXTURE2D_DESC *Desc, const D3D11_SUBRESOURCE_DATA *InitialData, ID3D11Texture2D **Texture)
+{
+    log->Record(COMMAND_CREATE_TEXTURE, Desc->Width * Desc->Height * Desc->ArraySize);
+    return device->CreateTexture2D(Desc, InitialData, Texture);
+}
+
+HRESULT RecordingRenderDevice::CreateShaderResourceView(ID3D11Resource *Resource, const D3D11_SHADER_RESOURCE_VIEW_DESC *Desc, ID3D11ShaderResourceView **View)
+{
+    log->Record(COMMAND_CREATE_VIEW);
+    return device->CreateShaderResourceView(Resource, Desc, View);
+}
+
+HRESULT RecordingRenderDevice::CreateRenderTargetView(ID3D11Resource *Resource, const D3D11_RENDER_TARGET_VIEW_DESC *Desc, ID3D11RenderTargetView **View)
+{
+    log->Record(COMMAND_CREATE_VIEW);
+    return device->CreateRenderTargetView(Resource, Desc, View);
+}
+
+HRESULT RecordingRenderDevice::CreateSamplerState(const D3D11_SAMPLER_DESC *Desc, ID3D11SamplerState **State)
+{
+    log->Record(COMMAND_CREATE_STATE);
+    return device->CreateSamplerState(Desc, State);
+}
+
+HRESULT RecordingRenderDevice::CreateRasterizerState(const D3D11_RASTERIZER_DESC *Desc, ID3D11RasterizerState **State)
+{
+    log->Record(COMMAND_CREATE_STATE);
+    return device->CreateRasterizerState(Desc, State);
+}
+
+HRESULT RecordingRenderDevice::CreateDepthStencilState(const D3D11_DEPTH_STENCIL_DESC *Desc, ID3D11DepthStencilState **State)
+{
+    log->Record(COMMAND_CREATE_STATE);
+    return device->CreateDepthStencilState(Desc, State);
+}
+
+HRESULT RecordingRenderDevice::CreateBlendState(const D3D11_BLEND_DESC *Desc, ID3D11BlendState **State)
+{
+    log->Record(COMMAND_CREATE_STATE);
+    return device->CreateBlendState(Desc, State);
+}
+
+HRESULT RecordingRenderDevice::CreateInputLayout(const D3D11_INPUT_ELEMENT_DESC *Elements, UINT ElementsCount,
+                                                 const void *Bytecode, SIZE_T BytecodeLength, ID3D11InputLayout **Layout)
+{
+    log->Record(COMMAND_CREATE_INPUT_LAYOUT, ElementsCount);
+    return device->CreateInputLayout(Elements, ElementsCount, Bytecode, BytecodeLength, Layout);
+}
+
+HRESULT RecordingRenderDevice::CreateVertexShader(const void *Bytecode, SIZE_T BytecodeLength, ID3D11ClassLinkage *Linkage, ID3D11VertexShader **Shader)
+{
+    log->Record(COMMAND_CREATE_SHADER, 1, 0, SHADER_STAGE_VERTEX);
+    return device->CreateVertexShader(Bytecode, BytecodeLength, Linkage, Shader);
+}
+
+HRESULT RecordingRenderDevice::CreatePixelShader(const void *Bytecode, SIZE_T BytecodeLength, ID3D11ClassLinkage *Linkage, ID3D11PixelShader **Shader)
+{
+    log->Record(COMMAND_CREATE_SHADER, 1, 0, SHADER_STAGE_PIXEL);
+    return device->CreatePixelShader(Bytecode, BytecodeLength, Linkage, Shader);
+}
+
+HRESULT RecordingRenderDevice::CreateHullShader(const void *Bytecode, SIZE_T BytecodeLength, ID3D11ClassLinkage *Linkage, ID3D11HullShader **Shader)
+{
+    log->Record(COMMAND_CREATE_SHADER, 1, 0, SHADER_STAGE_HULL);
+    return device->CreateHullShader(Bytecode, BytecodeLength, Linkage, Shader);
+}
+
+HRESULT RecordingRenderDevice::CreateDomainShader(const void *Bytecode, SIZE_T BytecodeLength, ID3D11ClassLinkage *Linkage, ID3D11DomainShader **Shader)
+{
+    log->Record(COMMAND_CREATE_SHADER, 1, 0, SHADER_STAGE_DOMAIN);
+    return device->CreateDomainShader(Bytecode, BytecodeLength, Linkage, Shader);
+}
+
+HRESULT RecordingRenderDevice::CreateGeometryShader(const void *Bytecode, SIZE_T BytecodeLength, ID3D11ClassLinkage *Linkage, ID3D11GeometryShader **Shader)
+{
+    log->Record(COMMAND_CREATE_SHADER, 1, 0, SHADER_STAGE_GEOMETRY);
+    return device->CreateGeometryShader(Bytecode, BytecodeLength, Linkage, Shader);
+}
+
+HRESULT RecordingRenderDevice::CreateGeometryShaderWithStreamOutput(const void *Bytecode, SIZE_T BytecodeLength,
+                                                                    const D3D11_SO_DECLARATION_ENTRY *Declaration, UINT EntriesCount,
+                                                                    const UINT *BufferStrides, UINT StridesCount, UINT RasterizedStream,
+                                                                    ID3D11ClassLinkage *Linkage, ID3D11GeometryShader **Shader)
+{
+    log->Record(COMMAND_CREATE_SHADER, 1, 0, SHADER_STAGE_GEOMETRY);
+    return device->CreateGeometryShaderWithStreamOutput(Bytecode, BytecodeLength, Declaration, EntriesCount,
+                                                        BufferStrides, StridesCount, RasterizedStream, Linkage, Shader);
+}
+
+void RecordingRenderContext::ClearRenderTargetView(ID3D11RenderTargetView *View, const FLOAT Color[4])
+{
+    log->Record(COMMAND_CLEAR);
+
+    if(context)
+        context->ClearRenderTargetView(View, Color);
+}
+
+void RecordingRenderContext::ClearDepthStencilView(ID3D11DepthStencilView *View, UINT ClearFlags, FLOAT Depth, UINT8 Stencil)
+{
+    log->Record(COMMAND_CLEAR);
+
+    if(context)
+        context->ClearDepthStencilView(View, ClearFlags, Depth, Stencil);
+}
+
+HRESULT RecordingRenderContext::Map(ID3D11Resource *Resource, UINT Subresource, D3D11_MAP MapType, UINT MapFlags, D3D11_MAPPED_SUBRESOURCE *MappedResource)
+{
+    UINT rowPitch = 0, rowsCount = 0;
+    bool isLayoutKnown = GetSubresourceLayout(Resource, Subresource, rowPitch, rowsCount);
+
+    if(context){
+        HRESULT hr = context->Map(Resource, Subresource, MapType, MapFlags, MappedResource);
+        if(FAILED(hr))
+            return hr;
+
+        if(isLayoutKnown && !IsBuffer(Resource))
+            rowPitch = MappedResource->RowPitch;
+    }else{
+        //the null backend maps the buffers and Texture2D only
+        if(!isLayoutKnown)
+            return E_NOTIMPL;
+
+        //the memory is kept for the next maps of the subresource
+        std::vector<char> &memory = scratch[SubresourceKey(Resource, Subresource)];
+        memory.resize((size_t)rowPitch * rowsCount);
+
+        MappedResource->pData = &memory[0];
+        MappedResource->RowPitch = rowPitch;
+        MappedResource->DepthPitch = rowPitch * rowsCount;
+    }
+
+    //read only maps upload nothing
+    log->Record(COMMAND_MAP, 1, (MapType == D3D11_MAP_READ) ? 0 : rowPitch * rowsCount);
+
+    return S_OK;
+}
+
+void RecordingRenderContext::Unmap(ID3D11Resource *Resource, UINT Subresource)
+{
+    log->Record(COMMAND_UNMAP);
+
+    if(context)
+        context->Unmap(Resource, Subresource);
+}
+
+void RecordingRenderContext::UpdateSubresource(ID3D11Resource *Resource, UINT Subresource, const D3D11_BOX *Box,
+                                               const void *Data, UINT RowPitch, UINT DepthPitch)
+{
+    UINT bytes = 0, rowPitch, rowsCount;
+
+    if(GetSubresourceLayout(Resource, Subresource, rowPitch, rowsCount)){
+        //RowPitch of the source is ignored for the buffers
+        if(IsBuffer(Resource))
+            bytes = (Box) ? Box->right - Box->left : rowPitch;
+        else
+            bytes = RowPitch * ((Box) ? (Box->bottom - Box->top) * (Box->back - Box->front) : rowsCount);
+    }
+
+    log->Record(COMMAND_UPDATE_SUBRESOURCE, 1, bytes);
+
+    if(context)
+        context->UpdateSubresource(Resource, Subresource, Box, Data, RowPitch, DepthPitch);
+}
+
+void RecordingRenderContext::CopyResource(ID3D11Resource *Destination, ID3D11Resource *Source)
+{
+    log->Record(COMMAND_COPY_RESOURCE);
+
+    if(context)
+        context->CopyResource(Destination, Source);
+}
+
+void RecordingRenderContext::GenerateMips(ID3D11ShaderResourceView *View)
+{
+    log->Record(COMMAND_GENERATE_MIPS);
+
+    if(context)
+        context->GenerateMips(View);
+}
+
+void RecordingRenderContext::IASetInputLayout(ID3D11InputLayout *Layout)
+{
+    log->Record(COMMAND_SET_INPUT_LAYOUT);
+
+    if(context)
+        context->IASetInputLayout(Layout);
+}
+
+void RecordingRenderContext::IASetVertexBuffers(UINT StartSlot, UINT BuffersCount, ID3D11Buffer *const *Buffers, const UINT *Strides, const UINT *Offsets)
+{
+    log->Record(COMMAND_SET_VERTEX_BUFFERS, BuffersCount);
+
+    if(context)
+        context->IASetVertexBuffers(StartSlot, BuffersCount, Buffers, Strides, Offsets);
+}
+
+void RecordingRenderContext::IASetIndexBuffer(ID3D11Buffer *Buffer, DXGI_FORMAT Format, UINT Offset)
+{
+    log->Record(COMMAND_SET_INDEX_BUFFER);
+
+    if(context)
+        context->IASetIndexBuffer(Buffer, Format, Offset);
+}
+
+void RecordingRenderContext::IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY Topology)
+{
+    log->Record(COMMAND_SET_TOPOLOGY);
+
+    if(context)
+        context->IASetPrimitiveTopology(Topology);
+}
+
+void RecordingRenderContext::VSSetShader(ID3D11VertexShader *Shader, ID3D11ClassInstance *const *ClassInstances, UINT ClassInstancesCount)
+{
+    log->Record(COMMAND_SET_SHADER, 1, 0, SHADER_STAGE_VERTEX);
+
+    if(context)
+        context->VSSetShader(Shader, ClassInstances, ClassInstancesCount);
+}
+
+void RecordingRenderContext::VSSetShaderResources(UINT StartSlot, UINT ViewsCount, ID3D11ShaderResourceView *const *Views)
+{
+    log->Record(COMMAND_SET_SHADER_RESOURCES, ViewsCount, 0, SHADER_STAGE_VERTEX);
+
+    if(context)
+        context->VSSetShaderResources(StartSlot, ViewsCount, Views);
+}
+
+void RecordingRenderContext::VSSetConstantBuffers(UINT StartSlot, UINT BuffersCount, ID3D11Buffer *const *Buffers)
+{
+    log->Record(COMMAND_SET_CONSTANT_BUFFERS, BuffersCount, 0, SHADER_STAGE_VERTEX);
+
+    if(context)
+        context->VSSetConstantBuffers(StartSlot, BuffersCount, Buffers);
+}
+
+void RecordingRenderContext::VSSetSamplers(UINT StartSlot, UINT SamplersCount, ID3D11SamplerState *const *Samplers)
+{
+    log->Record(COMMAND_SET_SAMPLERS, SamplersCount, 0, SHADER_STAGE_VERTEX);
+
+    if(context)
+        context->VSSetSamplers(StartSlot, SamplersCount, Samplers);
+}
+
+void RecordingRenderContext::HSSetShader(ID3D11HullShader *Shader, ID3D11ClassInstance *const *ClassInstances, UINT ClassInstancesCount)
+{
+    log->Record(COMMAND_SET_SHADER, 1, 0, SHADER_STAGE_HULL);
+
+    if(context)
+        context->HSSetShader(Shader, ClassInstances, ClassInstancesCount);
+}
+
+void RecordingRenderContext::HSSetShaderResources(UINT StartSlot, UINT ViewsCount, ID3D11ShaderResourceView *const *Views)
+{
+    log->Record(COMMAND_SET_SHADER_RESOURCES, ViewsCount, 0, SHADER_STAGE_HULL);
+
+    if(context)
+        context->HSSetShaderResources(StartSlot, ViewsCount, Views);
+}
+
+void RecordingRenderContext::HSSetConstantBuffers(UINT StartSlot, UINT BuffersCount, ID3D11Buffer *const *Buffers)
+{
+    log->Record(COMMAND_SET_CONSTANT_BUFFERS, BuffersCount, 0, SHADER_STAGE_HULL);
+
+    if(context)
+        context->HSSetConstantBuffers(StartSlot, BuffersCount, Buffers);
+}
+
+void RecordingRenderContext::HSSetSamplers(UINT StartSlot, UINT SamplersCount, ID3D11SamplerState *const *Samplers)
+{
+    log->Record(COMMAND_SET_SAMPLERS, SamplersCount, 0, SHADER_STAGE_HULL);
+
+    if(context)
+        context->HSSetSamplers(StartSlot, SamplersCount, Samplers);
+}
+
+void RecordingRenderContext::DSSetShader(ID3D11DomainShader *Shader, ID3D11ClassInstance *const *ClassInstances, UINT ClassInstancesCount)
+{
+    log->Record(COMMAND_SET_SHADER, 1, 0, SHADER_STAGE_DOMAIN);
+
+    if(context)
+        context->DSSetShader(Shader, ClassInstances, ClassInstancesCount);
+}
+
+void RecordingRenderContext::DSSetShaderResources(UINT StartSlot, UINT ViewsCount, ID3D11ShaderResourceView *const *Views)
+{
+    log->Record(COMMAND_SET_SHADER_RESOURCES, ViewsCount, 0, SHADER_STAGE_DOMAIN);
+
+    if(context)
+        context->DSSetShaderResources(StartSlot, ViewsCount, Views);
+}
+
+void RecordingRenderContext::DSSetConstantBuffers(UINT StartSlot, UINT BuffersCount, ID3D11Buffer *const *Buffers)
+{
+    log->Record(COMMAND_SET_CONSTANT_BUFFERS, BuffersCount, 0, SHADER_STAGE_DOMAIN);
+
+    if(context)
+        context->DSSetConstantBuffers(StartSlot, BuffersCount, Buffers);
+}
+
+void RecordingRenderContext::DSSetSamplers(UINT StartSlot, UINT SamplersCount, ID3D11SamplerState *const *Samplers)
+{
+    log->Record(COMMAND_SET_SAMPLERS, SamplersCount, 0, SHADER_STAGE_DOMAIN);
+
+    if(context)
+        context->DSSetSamplers(StartSlot, SamplersCount, Samplers);
+}
+
+void RecordingRenderContext::GSSetShader(ID3D11GeometryShader *Shader, ID3D11ClassInstance *const *ClassInstances, UINT ClassInstancesCount)
+{
+    log->Record(COMMAND_SET_SHADER, 1, 0, SHADER_STAGE_GEOMETRY);
+
+    if(context)
+        context->GSSetShader(Shader, ClassInstances, ClassInstancesCount);
+}
+
+void RecordingRenderContext::GSSetShaderResources(UINT StartSlot, UINT ViewsCount, ID3D11ShaderResourceView *const *Views)
+{
+    log->Record(COMMAND_SET_SHADER_RESOURCES, ViewsCount, 0, SHADER_STAGE_GEOMETRY);
+
+    if(context)
+        context->GSSetShaderResources(StartSlot, ViewsCount, Views);
+}
+
+void RecordingRenderContext::GSSetConstantBuffers(UINT StartSlot, UINT BuffersCount, ID3D11Buffer *const *Buffers)
+{
+    log->Record(COMMAND_SET_CONSTANT_BUFFERS, BuffersCount, 0, SHADER_STAGE_GEOMETRY);
+
+    if(context)
+        context->GSSetConstantBuffers(StartSlot, BuffersCount, Buffers);
+}
+
+void RecordingRenderContext::GSSetSamplers(UINT StartSlot, UINT SamplersCount, ID3D11SamplerState *const *Samplers)
+{
+    log->Record(COMMAND_SET_SAMPLERS, SamplersCount, 0, SHADER_STAGE_GEOMETRY);
+
+    if(context)
+        context->GSSetSamplers(StartSlot, SamplersCount, Samplers);
+}
+
+void RecordingRenderContext::PSSetShader(ID3D11PixelShader *Shader, ID3D11ClassInstance *const *ClassInstances, UINT ClassInstancesCount)
+{
+    log->Record(COMMAND_SET_SHADER, 1, 0, SHADER_STAGE_PIXEL);
+
+    if(context)
+        context->PSSetShader(Shader, ClassInstances, ClassInstancesCount);
+}
+
+void RecordingRenderContext::PSSetShaderResources(UINT StartSlot, UINT ViewsCount, ID3D11ShaderResourceView *const *Views)
+{
+    log->Record(COMMAND_SET_SHADER_RESOURCES, ViewsCount, 0, SHADER_STAGE_PIXEL);
+
+    if(context)
+        context->PSSetShaderResources(StartSlot, ViewsCount, Views);
+}
+
+void RecordingRenderContext::PSSetConstantBuffers(UINT StartSlot, UINT BuffersCount, ID3D11Buffer *const *Buffers)
+{
+    log->Record(COMMAND_SET_CONSTANT_BUFFERS, BuffersCount, 0, SHADER_STAGE_PIXEL);
+
+    if(context)
+        context->PSSetConstantBuffers(StartSlot, BuffersCount, Buffers);
+}
+
+void RecordingRenderContext::PSSetSamplers(UINT StartSlot, UINT SamplersCount, ID3D11SamplerState *const *Samplers)
+{
+    log->Record(COMMAND_SET_SAMPLERS, SamplersCount, 0, SHADER_STAGE_PIXEL);
+
+    if(context)
+        context->PSSetSamplers(StartSlot, SamplersCount, Samplers);
+}
+
+void RecordingRenderContext::RSSetState(ID3D11RasterizerState *State)
+{
+    log->Record(COMMAND_SET_RASTERIZER_STATE);
+
+    if(context)
+        context->RSSetState(State);
+}
+
+void RecordingRenderContext::RSSetViewports(UINT ViewportsCount, const D3D11_VIEWPORT *Viewports)
+{
+    log->Record(COMMAND_SET_VIEWPORTS, ViewportsCount);
+
+    if(context)
+        context->RSSetViewports(ViewportsCount, Viewports);
+    else
+        viewports.assign(Viewports, Viewports + ViewportsCount);
+}
+
+void RecordingRenderContext::RSGetViewports(UINT *ViewportsCount, D3D11_VIEWPORT *Viewports)
+{
+    if(context){
+        context->RSGetViewports(ViewportsCount, Viewports);
+        return;
+    }
+
+    //same as the context, NULL Viewports asks for the count
+    if(Viewports){
+        UINT count = (*ViewportsCount < viewports.size()) ? *ViewportsCount : (UINT)viewports.size();
+        std::copy(viewports.begin(), viewports.begin() + count, Viewports);
+    }
+
+    *ViewportsCount = (UINT)viewports.size();
+}
+
+void RecordingRenderContext::OMSetRenderTargets(UINT ViewsCount, ID3D11RenderTargetView *const *Views, ID3D11DepthStencilView *DepthStencilView)
+{
+    log->Record(COMMAND_SET_RENDER_TARGETS, ViewsCount);
+
+    if(context)
+        context->OMSetRenderTargets(ViewsCount, Views, DepthStencilView);
+}
+
+void RecordingRenderContext::OMSetBlendState(ID3D11BlendState *State, const FLOAT BlendFactor[4], UINT SampleMask)
+{
+    log->Record(COMMAND_SET_BLEND_STATE);
+
+    if(context)
+        context->OMSetBlendState(State, BlendFactor, SampleMask);
+}
+
+void RecordingRenderContext::OMSetDepthStencilState(ID3D11DepthStencilState *State, UINT StencilRef)
+{
+    log->Record(COMMAND_SET_DEPTH_STENCIL_STATE);
+
+    if(context)
+        context->OMSetDepthStencilState(State, StencilRef);
+}
+
+void RecordingRenderContext::Draw(UINT VertexCount, UINT StartVertex)
+{
+    log->Record(COMMAND_DRAW, VertexCount);
+
+    if(context)
+        context->Draw(VertexCount, StartVertex);
+}
+
+void RecordingRenderContext::DrawIndexed(UINT IndexCount, UINT StartIndex, INT BaseVertex)
+{
+    log->Record(COMMAND_DRAW_INDEXED, IndexCount);
+
+    if(context)
+        context->DrawIndexed(IndexCount, StartIndex, BaseVertex);
+}
+
+void RecordingRenderContext::BeginEvent(LPCWSTR Name)
+{
+    log->RecordBeginEvent(Name);
+
+    if(context)
+        context->BeginEvent(Name);
+}
+
+void RecordingRenderContext::EndEvent()
+{
+    log->Record(COMMAND_END_EVENT);
+
+    if(context)
+        context->EndEvent();
+}
+
+HRESULT RecordingRenderContext::Present(UINT SyncInterval, UINT Flags)
+{
+    log->Record(COMMAND_PRESENT);
+
+    return (context) ? context->Present(SyncInterval, Flags) : S_OK;
+}
+
+}
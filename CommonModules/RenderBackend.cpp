@@ -0,0 +1,294 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include <RenderBackend.h>
+#include <DeviceKeeper.h>
+
+namespace RenderBackend
+{
+
+HRESULT D3DRenderDevice::CreateBuffer(const D3D11_BUFFER_DESC *Desc, const D3D11_SUBRESOURCE_DATA *InitialData, ID3D11Buffer **Buffer)
+{
+    return device->CreateBuffer(Desc, InitialData, Buffer);
+}
+
+HRESULT D3DRenderDevice::CreateTexture2D(const D3D11_TEXTURE2D_DESC *Desc, const D3D11_SUBRESOURCE_DATA *InitialData, ID3D11Texture2D **Texture)
+{
+    return device->CreateTexture2D(Desc, InitialData, Texture);
+}
+
+HRESULT D3DRenderDevice::CreateShaderResourceView(ID3D11Resource *Resource, const D3D11_SHADER_RESOURCE_VIEW_DESC *Desc, ID3D11ShaderResourceView **View)
+{
+    return device->CreateShaderResourceView(Resource, Desc, View);
+}
+
+HRESULT D3DRenderDevice::CreateRenderTargetView(ID3D11Resource *Resource, const D3D11_RENDER_TARGET_VIEW_DESC *Desc, ID3D11RenderTargetView **View)
+{
+    return device->CreateRenderTargetView(Resource, Desc, View);
+}
+
+HRESULT D3DRenderDevice::CreateSamplerState(const D3D11_SAMPLER_DESC *Desc, ID3D11SamplerState **State)
+{
+    return device->CreateSamplerState(Desc, State);
+}
+
+HRESULT D3DRenderDevice::CreateRasterizerState(const D3D11_RASTERIZER_DESC *Desc, ID3D11RasterizerState **State)
+{
+    return device->CreateRasterizerState(Desc, State);
+}
+
+HRESULT D3DRenderDevice::CreateDepthStencilState(const D3D11_DEPTH_STENCIL_DESC *Desc, ID3D11DepthStencilState **State)
+{
+    return device->CreateDepthStencilState(Desc, State);
+}
+
+HRESULT D3DRenderDevice::CreateBlendState(const D3D11_BLEND_DESC *Desc, ID3D11BlendState **State)
+{
+    return device->CreateBlendState(Desc, State);
+}
+
+HRESULT D3DRenderDevice::CreateInputLayout(const D3D11_INPUT_ELEMENT_DESC *Elements, UINT ElementsCount,
+                                           const void *Bytecode, SIZE_T BytecodeLength, ID3D11InputLayout **Layout)
+{
+    return device->CreateInputLayout(Elements, ElementsCount, Bytecode, BytecodeLength, Layout);
+}
+
+HRESULT D3DRenderDevice::CreateVertexShader(const void *Bytecode, SIZE_T BytecodeLength, ID3D11ClassLinkage *Linkage, ID3D11VertexShader **Shader)
+{
+    return device->CreateVertexShader(Bytecode, BytecodeLength, Linkage, Shader);
+}
+
+HRESULT D3DRenderDevice::CreatePixelShader(const void *Bytecode, SIZE_T BytecodeLength, ID3D11ClassLinkage *Linkage, ID3D11PixelShader **Shader)
+{
+    return device->CreatePixelShader(Bytecode, BytecodeLength, Linkage, Shader);
+}
+
+HRESULT D3DRenderDevice::CreateHullShader(const void *Bytecode, SIZE_T BytecodeLength, ID3D11ClassLinkage *Linkage, ID3D11HullShader **Shader)
+{
+    return device->CreateHullShader(Bytecode, BytecodeLength, Linkage, Shader);
+}
+
+HRESULT D3DRenderDevice::CreateDomainShader(const void *Bytecode, SIZE_T BytecodeLength, ID3D11ClassLinkage *Linkage, ID3D11DomainShader **Shader)
+{
+    return device->CreateDomainShader(Bytecode, BytecodeLength, Linkage, Shader);
+}
+
+HRESULT D3DRenderDevice::CreateGeometryShader(const void *Bytecode, SIZE_T BytecodeLength, ID3D11ClassLinkage *Linkage, ID3D11GeometryShader **Shader)
+{
+    return device->CreateGeometryShader(Bytecode, BytecodeLength, Linkage, Shader);
+}
+
+HRESULT D3DRenderDevice::CreateGeometryShaderWithStreamOutput(const void *Bytecode, SIZE_T BytecodeLength,
+                                                              const D3D11_SO_DECLARATION_ENTRY *Declaration, UINT EntriesCount,
+                                                              const UINT *BufferStrides, UINT StridesCount, UINT RasterizedStream,
+                                                              ID3D11ClassLinkage *Linkage, ID3D11GeometryShader **Shader)
+{
+    return device->CreateGeometryShaderWithStreamOutput(Bytecode, BytecodeLength, Declaration, EntriesCount, BufferStrides, StridesCount, RasterizedStream, Linkage, Shader);
+}
+
+void D3DRenderContext::ClearRenderTargetView(ID3D11RenderTargetView *View, const FLOAT Color[4])
+{
+    context->ClearRenderTargetView(View, Color);
+}
+
+void D3DRenderContext::ClearDepthStencilView(ID3D11DepthStencilView *View, UINT ClearFlags, FLOAT Depth, UINT8 Stencil)
+{
+    context->ClearDepthStencilView(View, ClearFlags, Depth, Stencil);
+}
+
+HRESULT D3DRenderContext::Map(ID3D11Resource *Resource, UINT Subresource, D3D11_MAP MapType, UINT MapFlags, D3D11_MAPPED_SUBRESOURCE *MappedResource)
+{
+    return context->Map(Resource, Subresource, MapType, MapFlags, MappedResource);
+}
+
+void D3DRenderContext::Unmap(ID3D11Resource *Resource, UINT Subresource)
+{
+    context->Unmap(Resource, Subresource);
+}
+
+void D3DRenderContext::UpdateSubresource(ID3D11Resource *Resource, UINT Subresource, const D3D11_BOX *Box,
+                                         const void *Data, UINT RowPitch, UINT DepthPitch)
+{
+    context->UpdateSubresource(Resource, Subresource, Box, Data, RowPitch, DepthPitch);
+}
+
+void D3DRenderContext::CopyResource(ID3D11Resource *Destination, ID3D11Resource *Source)
+{
+    context->CopyResource(Destination, Source);
+}
+
+void D3DRenderContext::GenerateMips(ID3D11ShaderResourceView *View)
+{
+    context->GenerateMips(View);
+}
+
+void D3DRenderContext::IASetInputLayout(ID3D11InputLayout *Layout)
+{
+    context->IASetInputLayout(Layout);
+}
+
+void D3DRenderContext::IASetVertexBuffers(UINT StartSlot, UINT BuffersCount, ID3D11Buffer *const *Buffers, const UINT *Strides, const UINT *Offsets)
+{
+    context->IASetVertexBuffers(StartSlot, BuffersCount, Buffers, Strides, Offsets);
+}
+
+void D3DRenderContext::IASetIndexBuffer(ID3D11Buffer *Buffer, DXGI_FORMAT Format, UINT Offset)
+{
+    context->IASetIndexBuffer(Buffer, Format, Offset);
+}
+
+void D3DRenderContext::IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY Topology)
+{
+    context->IASetPrimitiveTopology(Topology);
+}
+
+void D3DRenderContext::VSSetShader(ID3D11VertexShader *Shader, ID3D11ClassInstance *const *ClassInstances, UINT ClassInstancesCount)
+{
+    context->VSSetShader(Shader, ClassInstances, ClassInstancesCount);
+}
+
+void D3DRenderContext::VSSetShaderResources(UINT StartSlot, UINT ViewsCount, ID3D11ShaderResourceView *const *Views)
+{
+    context->VSSetShaderResources(StartSlot, ViewsCount, Views);
+}
+
+void D3DRenderContext::VSSetConstantBuffers(UINT StartSlot, UINT BuffersCount, ID3D11Buffer *const *Buffers)
+{
+    context->VSSetConstantBuffers(StartSlot, BuffersCount, Buffers);
+}
+
+void D3DRenderContext::VSSetSamplers(UINT StartSlot, UINT SamplersCount, ID3D11SamplerState *const *Samplers)
+{
+    context->VSSetSamplers(StartSlot, SamplersCount, Samplers);
+}
+
+void D3DRenderContext::HSSetShader(ID3D11HullShader *Shader, ID3D11ClassInstance *const *ClassInstances, UINT ClassInstancesCount)
+{
+    context->HSSetShader(Shader, ClassInstances, ClassInstancesCount);
+}
+
+void D3DRenderContext::HSSetShaderResources(UINT StartSlot, UINT ViewsCount, ID3D11ShaderResourceView *const *Views)
+{
+    context->HSSetShaderResources(StartSlot, ViewsCount, Views);
+}
+
+void D3DRenderContext::HSSetConstantBuffers(UINT StartSlot, UINT BuffersCount, ID3D11Buffer *const *Buffers)
+{
+    context->HSSetConstantBuffers(StartSlot, BuffersCount, Buffers);
+}
+
+void D3DRenderContext::HSSetSamplers(UINT StartSlot, UINT SamplersCount, ID3D11SamplerState *const *Samplers)
+{
+    context->HSSetSamplers(StartSlot, SamplersCount, Samplers);
+}
+
+void D3DRenderContext::DSSetShader(ID3D11DomainShader *Shader, ID3D11ClassInstance *const *ClassInstances, UINT ClassInstancesCount)
+{
+    context->DSSetShader(Shader, ClassInstances, ClassInstancesCount);
+}
+
+void D3DRenderContext::DSSetShaderResources(UINT StartSlot, UINT ViewsCount, ID3D11ShaderResourceView *const *Views)
+{
+    context->DSSetShaderResources(StartSlot, ViewsCount, Views);
+}
+
+void D3DRenderContext::DSSetConstantBuffers(UINT StartSlot, UINT BuffersCount, ID3D11Buffer *const *Buffers)
+{
+    context->DSSetConstantBuffers(StartSlot, BuffersCount, Buffers);
+}
+
+void D3DRenderContext::DSSetSamplers(UINT StartSlot, UINT SamplersCount, ID3D11SamplerState *const *Samplers)
+{
+    context->DSSetSamplers(StartSlot, SamplersCount, Samplers);
+}
+
+void D3DRenderContext::GSSetShader(ID3D11GeometryShader *Shader, ID3D11ClassInstance *const *ClassInstances, UINT ClassInstancesCount)
+{
+    context->GSSetShader(Shader, ClassInstances, ClassInstancesCount);
+}
+
+void D3DRenderContext::GSSetShaderResources(UINT StartSlot, UINT ViewsCount, ID3D11ShaderResourceView *const *Views)
+{
+    context->GSSetShaderResources(StartSlot, ViewsCount, Views);
+}
+
+void D3DRenderContext::GSSetConstantBuffers(UINT StartSlot, UINT BuffersCount, ID3D11Buffer *const *Buffers)
+{
+    context->GSSetConstantBuffers(StartSlot, BuffersCount, Buffers);
+}
+
+void D3DRenderContext::GSSetSamplers(UINT StartSlot, UINT SamplersCount, ID3D11SamplerState *const *Samplers)
+{
+    context->GSSetSamplers(StartSlot, SamplersCount, Samplers);
+}
+
+void D3DRenderContext::PSSetShader(ID3D11PixelShader *Shader, ID3D11ClassInstance *const *ClassInstances, UINT ClassInstancesCount)
+{
+    context->PSSetShader(Shader, ClassInstances, ClassInstancesCount);
+}
+
+void D3DRenderContext::PSSetShaderResources(UINT StartSlot, UINT ViewsCount, ID3D11ShaderResourceView *const *Views)
+{
+    context->PSSetShaderResources(StartSlot, ViewsCount, Views);
+}
+
+void D3DRenderContext::PSSetConstantBuffers(UINT StartSlot, UINT BuffersCount, ID3D11Buffer *const *Buffers)
+{
+    context->PSSetConstantBuffers(StartSlot, BuffersCount, Buffers);
+}
+
+void D3DRenderContext::PSSetSamplers(UINT StartSlot, UINT SamplersCount, ID3D11SamplerState *const *Samplers)
+{
+    context->PSSetSamplers(StartSlot, SamplersCount, Samplers);
+}
+
+void D3DRenderContext::RSSetState(ID3D11RasterizerState *State)
+{
+    context->RSSetState(State);
+}
+
+void D3DRenderContext::RSSetViewports(UINT ViewportsCount, const D3D11_VIEWPORT *Viewports)
+{
+    context->RSSetViewports(ViewportsCount, Viewports);
+}
+
+void D3DRenderContext::RSGetViewports(UINT *ViewportsCount, D3D11_VIEWPORT *Viewports)
+{
+    context->RSGetViewports(ViewportsCount, Viewports);
+}
+
+void D3DRenderContext::OMSetRenderTargets(UINT ViewsCount, ID3D11RenderTargetView *const *Views, ID3D11DepthStencilView *DepthStencilView)
+{
+    context->OMSetRenderTargets(ViewsCount, Views, DepthStencilView);
+}
+
+void D3DRenderContext::OMSetBlendState(ID3D11BlendState *State, const FLOAT BlendFactor[4], UINT SampleMask)
+{
+    context->OMSetBlendState(State, BlendFactor, SampleMask);
+}
+
+void D3DRenderContext::OMSetDepthStencilState(ID3D11DepthStencilState *State, UINT StencilRef)
+{
+    context->OMSetDepthStencilState(State, StencilRef);
+}
+
+void D3DRenderContext::Draw(UINT VertexCount, UINT StartVertex)
+{
+    context->Draw(VertexCount, StartVertex);
+}
+
+void D3DRenderContext::DrawIndexed(UINT IndexCount, UINT StartIndex, INT BaseVertex)
+{
+    context->DrawIndexed(IndexCount, StartIndex, BaseVertex);
+}
+
+HRESULT D3DRenderContext::Present(UINT SyncInterval, UINT Flags)
+{
+    return DeviceKeeper::GetSwapChain()->Present(SyncInterval, Flags);
+}
+
+}
@@ -20,7 +20,7 @@ void RenderStatesManager::CreateRenderState(const std::string &StateName, const
     DepthStencilData depthStencilData;
     depthStencilData.ref = DepthStencilDesc.stencilRef;
 
-    HR(DeviceKeeper::GetDevice()->CreateDepthStencilState(&DepthStencilDesc.stencilDescription, &depthStencilData.state));
+    HR(DeviceKeeper::GetRenderDevice()->CreateDepthStencilState(&DepthStencilDesc.stencilDescription, &depthStencilData.state));
 
     depthStencilStates.insert(std::make_pair(StateName, depthStencilData));
 }
@@ -36,7 +36,7 @@ void RenderStatesManager::CreateRenderState(const std::string &StateName, const
     memcpy(blendData.blendFactor, BlendDesc.blendFactor, sizeof(blendData.blendFactor));
     blendData.sampleMask = BlendDesc.sampleMask;
     
-    HR(DeviceKeeper::GetDevice()->CreateBlendState(&BlendDesc.blendDescription, &blendData.state));
+    HR(DeviceKeeper::GetRenderDevice()->CreateBlendState(&BlendDesc.blendDescription, &blendData.state));
 
     blendStates.insert(std::make_pair(StateName, blendData));
 }
@@ -49,7 +49,7 @@ void RenderStatesManager::CreateRenderState(const std::string &StateName, const
         throw RenderStatesManagerException("State " + StateName + " is used");
 
 	ID3D11RasterizerState *rasterState = NULL;
-	HR(DeviceKeeper::GetDevice()->CreateRasterizerState(&RasteriserDesc, &rasterState), []{ return D3DException("cant create rasteriser state");});
+	HR(DeviceKeeper::GetRenderDevice()->CreateRasterizerState(&RasteriserDesc, &rasterState), []{ return D3DException("cant create rasteriser state");});
 
 	rasteriserStates.insert({StateName, rasterState});
 }
@@ -85,19 +85,19 @@ RenderStatesManager::RenderStateType RenderStatesManager::ApplyState(const std::
     BlendStatesStorage::const_iterator bsCi = blendStates.find(StateName);
     if(bsCi != blendStates.end()){
         const BlendData &blendData = bsCi->second;
-        DeviceKeeper::GetDeviceContext()->OMSetBlendState(blendData.state, blendData.blendFactor, blendData.sampleMask);
+        DeviceKeeper::GetRenderContext()->OMSetBlendState(blendData.state, blendData.blendFactor, blendData.sampleMask);
         return RS_TYPE_BLEND;
     }
 
     DepthStencilStatesStorage::const_iterator dsCi = depthStencilStates.find(StateName);
     if(dsCi != depthStencilStates.end()){
-        DeviceKeeper::GetDeviceContext()->OMSetDepthStencilState(dsCi->second.state, dsCi->second.ref);
+        DeviceKeeper::GetRenderContext()->OMSetDepthStencilState(dsCi->second.state, dsCi->second.ref);
         return RS_TYPE_DEPTH_STENCIL;
     }
 
 	RasteriserStatesStorage::const_iterator rsCi = rasteriserStates.find(StateName);
     if(rsCi != rasteriserStates.end()){
-		DeviceKeeper::GetDeviceContext()->RSSetState(rsCi->second);
+		DeviceKeeper::GetRenderContext()->RSSetState(rsCi->second);
         return RS_TYPE_RASTERIZER;
     }
     
@@ -106,17 +106,17 @@ RenderStatesManager::RenderStateType RenderStatesManager::ApplyState(const std::
 
 void RenderStatesManager::ResetBlendState()
 {
-    DeviceKeeper::GetDeviceContext()->OMSetBlendState(NULL, NULL, 0xffffffff);
+    DeviceKeeper::GetRenderContext()->OMSetBlendState(NULL, NULL, 0xffffffff);
 }
 
 void RenderStatesManager::ResetDepthStencilState()
 {
-    DeviceKeeper::GetDeviceContext()->OMSetDepthStencilState(NULL, 0);
+    DeviceKeeper::GetRenderContext()->OMSetDepthStencilState(NULL, 0);
 }
 
 void RenderStatesManager::ResetRasteriserState()
 {
-	DeviceKeeper::GetDeviceContext()->RSSetState(NULL);
+	DeviceKeeper::GetRenderContext()->RSSetState(NULL);
 }
 
 void RenderStatesManager::ProcessWithStates(const NamesStorage &StatesNames, const Procedure &Proc) throw (Exception)
@@ -57,6 +57,8 @@ void DrawingContainer::AddObject(const IObject *Object, const Meshes::IMesh *Mes
     objectsToMeshes[Object] = Mesh;
 
     it->second.objectsCount++;
+
+    version++;
 }
 
 void DrawingContainer::SetDrawingManager(const Meshes::IMesh *Mesh, IMeshDrawManager *DrawingManager) throw (DrawingContainerException)
@@ -65,6 +67,8 @@ void DrawingContainer::SetDrawingManager(const Meshes::IMesh *Mesh, IMeshDrawMan
 		throw DrawingContainerException("Invalid drawing manager");
 
     meshesToDrawingManagers[Mesh].drawingManager = DrawingManager;
+
+    version++;
 }
 
 void DrawingContainer::RemoveObject(const IObject *Object, BOOL ClearMesh)
@@ -84,12 +88,20 @@ void DrawingContainer::RemoveObject(const IObject *Object, BOOL ClearMesh)
             meshesToDrawingManagers.erase(mIt);
     }
 
-    objectsToMeshes.erase(it);
+    //removed object versions stay in the container version, so the scene version never goes back
+    version += ((Object) ? Object->GetVersion() : 0) + 1;
 
+    objectsToMeshes.erase(it);
 }
 
 void DrawingContainer::ClearObjects(BOOL ClearMeshes)
 {
+    for(auto &pair : objectsToMeshes)
+        if(pair.first)
+            version += pair.first->GetVersion();
+
+    version++;
+
     objectsToMeshes.clear();
 
     if(ClearMeshes)
@@ -99,6 +111,17 @@ void DrawingContainer::ClearObjects(BOOL ClearMeshes)
             pair.second.objectsCount = 0;
 }
 
+UINT DrawingContainer::GetSceneVersion() const
+{
+    UINT sceneVersion = version;
+
+    for(auto &pair : objectsToMeshes)
+        if(pair.first)
+            sceneVersion += pair.first->GetVersion();
+
+    return sceneVersion;
+}
+
 static void DrawObject(const IObject *Object, const Meshes::IMesh *Mesh, IMeshDrawManager *DrawManager, const Camera::ICamera *Camera)
 {
     DrawManager->BeginDraw(Object, Mesh, Camera);
@@ -310,19 +333,19 @@ static void Draw2DObjectsGroup(const TObjectData *FirstObject,
                                ID3D11Buffer *vertexBuffer)
 {
     D3D11_MAPPED_SUBRESOURCE rawData;
-    HR(DeviceKeeper::GetDeviceContext()->Map(vertexBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &rawData));
+    HR(DeviceKeeper::GetRenderContext()->Map(vertexBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &rawData));
 
     TObjectData *objPtr = reinterpret_cast<TObjectData*>(rawData.pData);
     memcpy(objPtr, FirstObject, sizeof(TObjectData) * ObjectsCnt);
 
-    DeviceKeeper::GetDeviceContext()->Unmap(vertexBuffer, 0);
+    DeviceKeeper::GetRenderContext()->Unmap(vertexBuffer, 0);
 
     UINT offset = 0, stride = sizeof(TObjectData);
 
-    DeviceKeeper::GetDeviceContext()->IASetVertexBuffers(0, 1, &vertexBuffer, &stride, &offset);
-    DeviceKeeper::GetDeviceContext()->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_POINTLIST);
+    DeviceKeeper::GetRenderContext()->IASetVertexBuffers(0, 1, &vertexBuffer, &stride, &offset);
+    DeviceKeeper::GetRenderContext()->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_POINTLIST);
 
-    DeviceKeeper::GetDeviceContext()->Draw(ObjectsCnt, 0);
+    DeviceKeeper::GetRenderContext()->Draw(ObjectsCnt, 0);
 }
 
 template<class TObjectData>
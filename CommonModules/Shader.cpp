@@ -13,14 +13,26 @@
 namespace Shaders
 {
 
-static ID3D10Blob* CompileShader(const std::wstring &FileName, const std::string &EntryPoint, const std::string &Profile) throw (Exception)
+static ID3D10Blob* CompileShader(const std::wstring &FileName,
+                                 const std::string &EntryPoint,
+                                 const std::string &Profile,
+                                 const ShaderMacros &Macros = ShaderMacros()) throw (Exception)
 {
 	ID3D10Blob* errorsMsg = NULL;
 	ID3D10Blob* shaderBuffer = NULL;
 
+    std::vector<D3D10_SHADER_MACRO> defines;
+    for(const ShaderMacros::value_type &macro : Macros){
+        D3D10_SHADER_MACRO define = {macro.first.c_str(), macro.second.c_str()};
+        defines.push_back(define);
+    }
+
+    D3D10_SHADER_MACRO terminator = {NULL, NULL};
+    defines.push_back(terminator);
+
 	HRESULT hr = D3DX11CompileFromFile(
 		FileName.c_str(),
-		NULL,
+		&defines[0],
 		NULL,
 		EntryPoint.c_str(),
 		Profile.c_str(),
@@ -42,11 +54,11 @@ static ID3D10Blob* CompileShader(const std::wstring &FileName, const std::string
     return shaderBuffer; 
 }
 
-void PixelShader::Load(const std::wstring &FileName, const std::string &EntryPoint) throw (Exception)
+void PixelShader::Load(const std::wstring &FileName, const std::string &EntryPoint, const ShaderMacros &Macros) throw (Exception)
 {
-    Utils::AutoCOM<ID3D10Blob> shaderBuffer = CompileShader(FileName, EntryPoint, "ps_5_0");
+    Utils::AutoCOM<ID3D10Blob> shaderBuffer = CompileShader(FileName, EntryPoint, "ps_5_0", Macros);
 
-    HR(DeviceKeeper::GetDevice()->CreatePixelShader(
+    HR(DeviceKeeper::GetRenderDevice()->CreatePixelShader(
         shaderBuffer->GetBufferPointer(),
         shaderBuffer->GetBufferSize(),
         NULL,
@@ -55,22 +67,22 @@ void PixelShader::Load(const std::wstring &FileName, const std::string &EntryPoi
 
 void PixelShader::SetShaderResourceView(RegisterType Register, ID3D11ShaderResourceView *SRW) const
 {
-    DeviceKeeper::GetDeviceContext()->PSSetShaderResources(Register, 1, &SRW);
+    DeviceKeeper::GetRenderContext()->PSSetShaderResources(Register, 1, &SRW);
 }
 
 void PixelShader::SetShader(BOOL CleanUp) const
 {
-     DeviceKeeper::GetDeviceContext()->PSSetShader((CleanUp) ? NULL : ps, NULL, 0);
+     DeviceKeeper::GetRenderContext()->PSSetShader((CleanUp) ? NULL : ps, NULL, 0);
 }
 
 void PixelShader::SetConstantBuffer(RegisterType Register, ID3D11Buffer *ConstantBuffer) const
 {
-    DeviceKeeper::GetDeviceContext()->PSSetConstantBuffers(Register, 1, &ConstantBuffer);
+    DeviceKeeper::GetRenderContext()->PSSetConstantBuffers(Register, 1, &ConstantBuffer);
 }
 
 void PixelShader::SetSamplerState(RegisterType Register, ID3D11SamplerState *SamplerState) const
 {
-    DeviceKeeper::GetDeviceContext()->PSSetSamplers(Register, 1, &SamplerState);
+    DeviceKeeper::GetRenderContext()->PSSetSamplers(Register, 1, &SamplerState);
 }
 
 PixelShader::~PixelShader()
@@ -118,13 +130,13 @@ void VertexShader::Load(const std::wstring &FileName, const std::string &EntryPo
 {
     Utils::AutoCOM<ID3D10Blob> shaderBuffer = CompileShader(FileName, EntryPoint, "vs_5_0");
 
-    HR(DeviceKeeper::GetDevice()->CreateVertexShader(
+    HR(DeviceKeeper::GetRenderDevice()->CreateVertexShader(
         shaderBuffer->GetBufferPointer(),
         shaderBuffer->GetBufferSize(),
         NULL, 
         &vs));
 
-    HR(DeviceKeeper::GetDevice()->CreateInputLayout(
+    HR(DeviceKeeper::GetRenderDevice()->CreateInputLayout(
         &InputLayout[0],
         InputLayout.size(),
         shaderBuffer->GetBufferPointer(),
@@ -134,28 +146,28 @@ void VertexShader::Load(const std::wstring &FileName, const std::string &EntryPo
 
 void VertexShader::SetShaderResourceView(RegisterType Register, ID3D11ShaderResourceView *SRW) const
 {
-    DeviceKeeper::GetDeviceContext()->VSSetShaderResources(Register, 1, &SRW);
+    DeviceKeeper::GetRenderContext()->VSSetShaderResources(Register, 1, &SRW);
 }
 
 void VertexShader::SetShader(BOOL CleanUp) const
 {
-     DeviceKeeper::GetDeviceContext()->VSSetShader((CleanUp) ? NULL : vs, NULL, 0);
+     DeviceKeeper::GetRenderContext()->VSSetShader((CleanUp) ? NULL : vs, NULL, 0);
 }
 
 void VertexShader::SetConstantBuffer(RegisterType Register, ID3D11Buffer *ConstantBuffer) const
 {
-    DeviceKeeper::GetDeviceContext()->VSSetConstantBuffers(Register, 1, &ConstantBuffer);
+    DeviceKeeper::GetRenderContext()->VSSetConstantBuffers(Register, 1, &ConstantBuffer);
 }
 
 void VertexShader::SetSamplerState(RegisterType Register, ID3D11SamplerState *SamplerState) const
 {
-    DeviceKeeper::GetDeviceContext()->VSSetSamplers(Register, 1, &SamplerState);
+    DeviceKeeper::GetRenderContext()->VSSetSamplers(Register, 1, &SamplerState);
 }
 
 void VertexShader::Apply() const
 {
     Shader::Apply();
-    DeviceKeeper::GetDeviceContext()->IASetInputLayout(layout);
+    DeviceKeeper::GetRenderContext()->IASetInputLayout(layout);
 }
 
 VertexShader::~VertexShader()
@@ -369,8 +381,8 @@ void Shader::Construct(const Shader &Val)
         cbci->second->GetDesc(&desc);
 
         ID3D11Buffer *newBuffer;
-	    HR(DeviceKeeper::GetDevice()->CreateBuffer(&desc, NULL, &newBuffer));
-        DeviceKeeper::GetDeviceContext()->CopyResource(newBuffer, buffer);
+	    HR(DeviceKeeper::GetRenderDevice()->CreateBuffer(&desc, NULL, &newBuffer));
+        DeviceKeeper::GetRenderContext()->CopyResource(newBuffer, buffer);
 
         constantBuffers.insert(std::make_pair(cbci->first, newBuffer));
     }
@@ -385,7 +397,7 @@ void Shader::Construct(const Shader &Val)
             pair2.second->GetDesc(&desc);
 
             ID3D11SamplerState *newState;
-            HR(DeviceKeeper::GetDevice()->CreateSamplerState(&desc, &newState));
+            HR(DeviceKeeper::GetRenderDevice()->CreateSamplerState(&desc, &newState));
 
             newContainer.insert({pair2.first, newState});
         }
@@ -421,12 +433,12 @@ void Shader::SetBufferData(RegisterType RegId, const char *Data, INT DataSize)
     ID3D11Buffer *buffer = constantBuffers[RegId];
 
     D3D11_MAPPED_SUBRESOURCE rawData;
-    HR(DeviceKeeper::GetDeviceContext()->Map(buffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &rawData));
+    HR(DeviceKeeper::GetRenderContext()->Map(buffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &rawData));
 
     char *ptr = reinterpret_cast<char*>(rawData.pData);
     std::copy(Data, Data + DataSize, ptr);
 
-    DeviceKeeper::GetDeviceContext()->Unmap(buffer, 0);
+    DeviceKeeper::GetRenderContext()->Unmap(buffer, 0);
 }
 
 void Shader::SetVariableData(const std::string &VarName, const char *Data) throw (Exception)
@@ -558,7 +570,7 @@ void DomainShader::Load(const std::wstring &FileName, const std::string &EntryPo
 {
     Utils::AutoCOM<ID3D10Blob> buffer = CompileShader(FileName, EntryPoint, "ds_5_0");
 
-    HR(DeviceKeeper::GetDevice()->CreateDomainShader(
+    HR(DeviceKeeper::GetRenderDevice()->CreateDomainShader(
         buffer->GetBufferPointer(),
         buffer->GetBufferSize(),
         NULL, 
@@ -567,22 +579,22 @@ void DomainShader::Load(const std::wstring &FileName, const std::string &EntryPo
 
 void DomainShader::SetShaderResourceView(RegisterType Register, ID3D11ShaderResourceView *SRW) const
 {
-    DeviceKeeper::GetDeviceContext()->DSSetShaderResources(Register, 1, &SRW);
+    DeviceKeeper::GetRenderContext()->DSSetShaderResources(Register, 1, &SRW);
 }
 
 void DomainShader::SetShader(BOOL CleanUp) const
 {
-     DeviceKeeper::GetDeviceContext()->DSSetShader((CleanUp) ? NULL : ds, NULL, 0);
+     DeviceKeeper::GetRenderContext()->DSSetShader((CleanUp) ? NULL : ds, NULL, 0);
 }
 
 void DomainShader::SetConstantBuffer(RegisterType Register, ID3D11Buffer *ConstantBuffer) const
 {
-    DeviceKeeper::GetDeviceContext()->DSSetConstantBuffers(Register, 1, &ConstantBuffer);
+    DeviceKeeper::GetRenderContext()->DSSetConstantBuffers(Register, 1, &ConstantBuffer);
 }
 
 void DomainShader::SetSamplerState(RegisterType Register, ID3D11SamplerState *SamplerState) const
 {
-    DeviceKeeper::GetDeviceContext()->DSSetSamplers(Register, 1, &SamplerState);
+    DeviceKeeper::GetRenderContext()->DSSetSamplers(Register, 1, &SamplerState);
 }
 
 void HullShader::Construct(const HullShader &Val)
@@ -629,7 +641,7 @@ void HullShader::Load(const std::wstring &FileName, const std::string &EntryPoin
 {
     Utils::AutoCOM<ID3D10Blob> buffer = CompileShader(FileName, EntryPoint, "hs_5_0");
 
-    HR(DeviceKeeper::GetDevice()->CreateHullShader(
+    HR(DeviceKeeper::GetRenderDevice()->CreateHullShader(
         buffer->GetBufferPointer(),
         buffer->GetBufferSize(),
         NULL,
@@ -638,22 +650,22 @@ void HullShader::Load(const std::wstring &FileName, const std::string &EntryPoin
 
 void HullShader::SetShaderResourceView(RegisterType Register, ID3D11ShaderResourceView *SRW) const
 {
-    DeviceKeeper::GetDeviceContext()->HSSetShaderResources(Register, 1, &SRW);
+    DeviceKeeper::GetRenderContext()->HSSetShaderResources(Register, 1, &SRW);
 }
 
 void HullShader::SetShader(BOOL CleanUp) const
 {
-     DeviceKeeper::GetDeviceContext()->HSSetShader((CleanUp) ? NULL : hs, NULL, 0);
+     DeviceKeeper::GetRenderContext()->HSSetShader((CleanUp) ? NULL : hs, NULL, 0);
 }
 
 void HullShader::SetConstantBuffer(RegisterType Register, ID3D11Buffer *ConstantBuffer) const
 {
-    DeviceKeeper::GetDeviceContext()->HSSetConstantBuffers(Register, 1, &ConstantBuffer);
+    DeviceKeeper::GetRenderContext()->HSSetConstantBuffers(Register, 1, &ConstantBuffer);
 }
 
 void HullShader::SetSamplerState(RegisterType Register, ID3D11SamplerState *SamplerState) const
 {
-    DeviceKeeper::GetDeviceContext()->HSSetSamplers(Register, 1, &SamplerState);
+    DeviceKeeper::GetRenderContext()->HSSetSamplers(Register, 1, &SamplerState);
 }
 
 void GeometryShader::Construct(const GeometryShader &Val)
@@ -700,7 +712,7 @@ void GeometryShader::Load(const std::wstring &FileName, const std::string &Entry
 {
     Utils::AutoCOM<ID3D10Blob> buffer = CompileShader(FileName, EntryPoint, "gs_5_0");
     
-    HR(DeviceKeeper::GetDevice()->CreateGeometryShaderWithStreamOutput(
+    HR(DeviceKeeper::GetRenderDevice()->CreateGeometryShaderWithStreamOutput(
         buffer->GetBufferPointer(),
         buffer->GetBufferSize(),
         &InputSOMetadata[0],
@@ -716,7 +728,7 @@ void GeometryShader::Load(const std::wstring &FileName, const std::string &Entry
 {
     Utils::AutoCOM<ID3D10Blob> buffer = CompileShader(FileName, EntryPoint, "gs_5_0");
 
-    HR(DeviceKeeper::GetDevice()->CreateGeometryShader(
+    HR(DeviceKeeper::GetRenderDevice()->CreateGeometryShader(
         buffer->GetBufferPointer(),
         buffer->GetBufferSize(),
         NULL,
@@ -725,22 +737,22 @@ void GeometryShader::Load(const std::wstring &FileName, const std::string &Entry
 
 void GeometryShader::SetShaderResourceView(RegisterType Register, ID3D11ShaderResourceView *SRW) const
 {
-    DeviceKeeper::GetDeviceContext()->GSSetShaderResources(Register, 1, &SRW);
+    DeviceKeeper::GetRenderContext()->GSSetShaderResources(Register, 1, &SRW);
 }
 
 void GeometryShader::SetShader(BOOL CleanUp) const
 {
-     DeviceKeeper::GetDeviceContext()->GSSetShader((CleanUp) ? NULL : gs, NULL, 0);
+     DeviceKeeper::GetRenderContext()->GSSetShader((CleanUp) ? NULL : gs, NULL, 0);
 }
 
 void GeometryShader::SetConstantBuffer(RegisterType Register, ID3D11Buffer *ConstantBuffer) const
 {
-    DeviceKeeper::GetDeviceContext()->GSSetConstantBuffers(Register, 1, &ConstantBuffer);
+    DeviceKeeper::GetRenderContext()->GSSetConstantBuffers(Register, 1, &ConstantBuffer);
 }
 
 void GeometryShader::SetSamplerState(RegisterType Register, ID3D11SamplerState *SamplerState) const
 {
-    DeviceKeeper::GetDeviceContext()->GSSetSamplers(Register, 1, &SamplerState);
+    DeviceKeeper::GetRenderContext()->GSSetSamplers(Register, 1, &SamplerState);
 }
 
 }
@@ -68,14 +68,14 @@ ID3D11ShaderResourceView * LoadTexture2DFromFile(const std::wstring &FileName) t
 	textureDesc.MiscFlags = D3D11_RESOURCE_MISC_GENERATE_MIPS;
 
 	ID3D11Texture2D* texture;
-	HR(DeviceKeeper::GetDevice()->CreateTexture2D(&textureDesc, NULL, &texture));
+	HR(DeviceKeeper::GetRenderDevice()->CreateTexture2D(&textureDesc, NULL, &texture));
     Utils::AutoCOM<ID3D11Texture2D> texturePtr = texture;
 
 	size_t rowPitch, slicePitch;
 	ComputePitch(info.format, info.width, info.height, rowPitch, slicePitch);
 	
 	const Image *img2 = img.GetImage(0, 0, 0);
-	DeviceKeeper::GetDeviceContext()->UpdateSubresource(texturePtr.Get(), 0, NULL, img2->pixels, rowPitch, 0);
+	DeviceKeeper::GetRenderContext()->UpdateSubresource(texturePtr.Get(), 0, NULL, img2->pixels, rowPitch, 0);
 
 	D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc;
 	srvDesc.Format = textureDesc.Format;
@@ -84,9 +84,9 @@ ID3D11ShaderResourceView * LoadTexture2DFromFile(const std::wstring &FileName) t
 	srvDesc.Texture2D.MipLevels = -1;
 
 	ID3D11ShaderResourceView* textureSRV;	
-	HR(DeviceKeeper::GetDevice()->CreateShaderResourceView(texturePtr.Get(), &srvDesc, &textureSRV));
+	HR(DeviceKeeper::GetRenderDevice()->CreateShaderResourceView(texturePtr.Get(), &srvDesc, &textureSRV));
 	
-	DeviceKeeper::GetDeviceContext()->GenerateMips(textureSRV);
+	DeviceKeeper::GetRenderContext()->GenerateMips(textureSRV);
 
 	return textureSRV;
 }
@@ -157,11 +157,11 @@ ID3D11ShaderResourceView * CreateTexture2D(const SizeUS &Size, DXGI_FORMAT Forma
     initData.pSysMem = Data;
 
     ID3D11Texture2D* tex = NULL;
-	HR(DeviceKeeper::GetDevice()->CreateTexture2D(&texDesc, &initData, &tex));
+	HR(DeviceKeeper::GetRenderDevice()->CreateTexture2D(&texDesc, &initData, &tex));
     Utils::AutoCOM<ID3D11Texture2D> texturePtr = tex;
 	
     ID3D11ShaderResourceView *outSRV;
-    HR(DeviceKeeper::GetDevice()->CreateShaderResourceView(texturePtr.Get(), 0, &outSRV));
+    HR(DeviceKeeper::GetRenderDevice()->CreateShaderResourceView(texturePtr.Get(), 0, &outSRV));
 
     return outSRV;
 }
@@ -258,7 +258,7 @@ void RenderTargetCube::Init(DXGI_FORMAT Format, USHORT Size, UINT MipLevelsCnt)
         texDesc.MiscFlags |= D3D11_RESOURCE_MISC_GENERATE_MIPS;
 
     ID3D11Texture2D* cubeTexPtr = 0;
-    HR(DeviceKeeper::GetDevice()->CreateTexture2D(&texDesc, 0, &cubeTexPtr), [] {return TextureException("cant create cube texture");});
+    HR(DeviceKeeper::GetRenderDevice()->CreateTexture2D(&texDesc, 0, &cubeTexPtr), [] {return TextureException("cant create cube texture");});
 
     Utils::AutoCOM<ID3D11Texture2D> cubeTex(cubeTexPtr);
 
@@ -270,7 +270,7 @@ void RenderTargetCube::Init(DXGI_FORMAT Format, USHORT Size, UINT MipLevelsCnt)
         rtvDesc.Texture2DArray.ArraySize = 1;
         rtvDesc.Texture2DArray.FirstArraySlice = i;
 
-        HR(DeviceKeeper::GetDevice()->CreateRenderTargetView(cubeTex, &rtvDesc, &rtv[i]), [] {return TextureException("cant create cube RTV");});
+        HR(DeviceKeeper::GetRenderDevice()->CreateRenderTargetView(cubeTex, &rtvDesc, &rtv[i]), [] {return TextureException("cant create cube RTV");});
     }
 
     D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
@@ -278,7 +278,7 @@ void RenderTargetCube::Init(DXGI_FORMAT Format, USHORT Size, UINT MipLevelsCnt)
     srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURECUBE;
     srvDesc.TextureCube.MipLevels = (MipLevelsCnt == 0) ? -1 : MipLevelsCnt;
 
-    HR(DeviceKeeper::GetDevice()->CreateShaderResourceView(cubeTex, &srvDesc, &srv));
+    HR(DeviceKeeper::GetRenderDevice()->CreateShaderResourceView(cubeTex, &srvDesc, &srv));
 }
 
 ID3D11RenderTargetView *RenderTargetCube::GetRenderTargetView(UINT Edge) const throw (Exception)
@@ -297,7 +297,7 @@ void RenderTarget::Init(DXGI_FORMAT Format, BOOL UseViewport, UINT ViewportInd)
 
     if(UseViewport){
         UINT viewportsCnt = 0;
-        DeviceKeeper::GetDeviceContext()->RSGetViewports(&viewportsCnt, NULL);
+        DeviceKeeper::GetRenderContext()->RSGetViewports(&viewportsCnt, NULL);
 
         if(!viewportsCnt)
             throw TextureException("Viewports not set");
@@ -305,7 +305,7 @@ void RenderTarget::Init(DXGI_FORMAT Format, BOOL UseViewport, UINT ViewportInd)
         std::vector<D3D11_VIEWPORT> viewpors;
         viewpors.resize(viewportsCnt);
 
-        DeviceKeeper::GetDeviceContext()->RSGetViewports(&viewportsCnt, static_cast<D3D11_VIEWPORT*>(&viewpors[0]));
+        DeviceKeeper::GetRenderContext()->RSGetViewports(&viewportsCnt, static_cast<D3D11_VIEWPORT*>(&viewpors[0]));
 
         D3D11_VIEWPORT viewport;
         if(ViewportInd == -1)
@@ -383,7 +383,7 @@ void RenderTarget::Init(DXGI_FORMAT Format, USHORT Width, USHORT Height) throw (
     textureDesc.MiscFlags = 0;
 
     ID3D11Texture2D* texture;
-    HR(DeviceKeeper::GetDevice()->CreateTexture2D(&textureDesc, NULL, &texture));
+    HR(DeviceKeeper::GetRenderDevice()->CreateTexture2D(&textureDesc, NULL, &texture));
     Utils::AutoCOM<ID3D11Texture2D> texturePtr = texture;
 
     D3D11_RENDER_TARGET_VIEW_DESC rtvDesc;
@@ -391,7 +391,7 @@ void RenderTarget::Init(DXGI_FORMAT Format, USHORT Width, USHORT Height) throw (
     rtvDesc.Format = Format;
 	rtvDesc.ViewDimension = D3D11_RTV_DIMENSION_TEXTURE2D;
 
-    HR(DeviceKeeper::GetDevice()->CreateRenderTargetView(texturePtr.Get(), &rtvDesc, &rtv));
+    HR(DeviceKeeper::GetRenderDevice()->CreateRenderTargetView(texturePtr.Get(), &rtvDesc, &rtv));
 
     D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc;
     memset(&srvDesc, 0, sizeof(D3D11_RENDER_TARGET_VIEW_DESC));
@@ -399,7 +399,7 @@ void RenderTarget::Init(DXGI_FORMAT Format, USHORT Width, USHORT Height) throw (
 	srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;	
 	srvDesc.Texture2D.MipLevels = 1;
 
-    HR(DeviceKeeper::GetDevice()->CreateShaderResourceView(texture, &srvDesc, &srv));
+    HR(DeviceKeeper::GetRenderDevice()->CreateShaderResourceView(texture, &srvDesc, &srv));
 }
 
 RenderTarget::~RenderTarget()
@@ -408,4 +408,154 @@ RenderTarget::~RenderTarget()
     ReleaseCOM(srv);
 }
 
+RenderTargetMips::RenderTargetMips() : srv(NULL), width(0), height(0), format(DXGI_FORMAT_UNKNOWN){}
+
+RenderTargetMips::~RenderTargetMips()
+{
+    Release();
+}
+
+void RenderTargetMips::Release()
+{
+    for(ID3D11RenderTargetView *&view : rtv)
+        ReleaseCOM(view);
+
+    for(ID3D11ShaderResourceView *&view : mipSrv)
+        ReleaseCOM(view);
+
+    rtv.clear();
+    mipSrv.clear();
+
+    ReleaseCOM(srv);
+}
+
+void RenderTargetMips::Construct(const RenderTargetMips &Val)
+{
+    if(this == &Val)
+        return;
+
+    Release();
+
+    width = Val.width;
+    height = Val.height;
+    format = Val.format;
+
+    if(Val.srv)
+        Val.srv->AddRef();
+
+    srv = Val.srv;
+
+    for(ID3D11RenderTargetView *view : Val.rtv){
+        if(view)
+            view->AddRef();
+
+        rtv.push_back(view);
+    }
+
+    for(ID3D11ShaderResourceView *view : Val.mipSrv){
+        if(view)
+            view->AddRef();
+
+        mipSrv.push_back(view);
+    }
+}
+
+RenderTargetMips::RenderTargetMips(const RenderTargetMips &Val) : srv(NULL), width(0), height(0), format(DXGI_FORMAT_UNKNOWN)
+{
+    Construct(Val);
+}
+
+RenderTargetMips &RenderTargetMips::operator= (const RenderTargetMips &Val)
+{
+    Construct(Val);
+    return *this;
+}
+
+USHORT RenderTargetMips::GetWidth(UINT MipLevel) const
+{
+    USHORT levelWidth = width >> MipLevel;
+    return (levelWidth > 0) ? levelWidth : 1;
+}
+
+USHORT RenderTargetMips::GetHeight(UINT MipLevel) const
+{
+    USHORT levelHeight = height >> MipLevel;
+    return (levelHeight > 0) ? levelHeight : 1;
+}
+
+void RenderTargetMips::Init(DXGI_FORMAT Format, USHORT Width, USHORT Height, UINT MipLevelsCnt) throw (Exception)
+{
+    Release();
+
+    width = Width;
+    height = Height;
+    format = Format;
+
+    UINT fullChainLevelsCnt = 1;
+    while((Width >> fullChainLevelsCnt) > 0 || (Height >> fullChainLevelsCnt) > 0)
+        fullChainLevelsCnt++;
+
+    if(MipLevelsCnt == 0 || MipLevelsCnt > fullChainLevelsCnt)
+        MipLevelsCnt = fullChainLevelsCnt;
+
+    D3D11_TEXTURE2D_DESC texDesc = {};
+    texDesc.Width = Width;
+    texDesc.Height = Height;
+    texDesc.ArraySize = 1;
+    texDesc.MipLevels = MipLevelsCnt;
+    texDesc.SampleDesc.Count = 1;
+    texDesc.Format = Format;
+    texDesc.Usage = D3D11_USAGE_DEFAULT;
+    texDesc.BindFlags = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE;
+
+    ID3D11Texture2D* texPtr = 0;
+    HR(DeviceKeeper::GetRenderDevice()->CreateTexture2D(&texDesc, 0, &texPtr), [] {return TextureException("cant create mipmapped texture");});
+
+    Utils::AutoCOM<ID3D11Texture2D> tex(texPtr);
+
+    rtv.resize(MipLevelsCnt, NULL);
+    mipSrv.resize(MipLevelsCnt, NULL);
+
+    for(UINT i = 0; i < MipLevelsCnt; ++i){
+
+        D3D11_RENDER_TARGET_VIEW_DESC rtvDesc = {};
+        rtvDesc.Format = Format;
+        rtvDesc.ViewDimension = D3D11_RTV_DIMENSION_TEXTURE2D;
+        rtvDesc.Texture2D.MipSlice = i;
+
+        HR(DeviceKeeper::GetRenderDevice()->CreateRenderTargetView(tex, &rtvDesc, &rtv[i]), [] {return TextureException("cant create mip RTV");});
+
+        D3D11_SHADER_RESOURCE_VIEW_DESC mipSrvDesc = {};
+        mipSrvDesc.Format = Format;
+        mipSrvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+        mipSrvDesc.Texture2D.MostDetailedMip = i;
+        mipSrvDesc.Texture2D.MipLevels = 1;
+
+        HR(DeviceKeeper::GetRenderDevice()->CreateShaderResourceView(tex, &mipSrvDesc, &mipSrv[i]), [] {return TextureException("cant create mip SRV");});
+    }
+
+    D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+    srvDesc.Format = Format;
+    srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+    srvDesc.Texture2D.MipLevels = MipLevelsCnt;
+
+    HR(DeviceKeeper::GetRenderDevice()->CreateShaderResourceView(tex, &srvDesc, &srv));
+}
+
+ID3D11RenderTargetView *RenderTargetMips::GetRenderTargetView(UINT MipLevel) const throw (Exception)
+{
+    if(MipLevel >= rtv.size())
+        throw RenderTargetException("Invalid render target mip level");
+
+    return rtv[MipLevel];
+}
+
+ID3D11ShaderResourceView *RenderTargetMips::GetShaderResourceView(UINT MipLevel) const throw (Exception)
+{
+    if(MipLevel >= mipSrv.size())
+        throw RenderTargetException("Invalid render target mip level");
+
+    return mipSrv[MipLevel];
+}
+
 }
\ No newline at end of file
@@ -0,0 +1,106 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include <CpuRendering/BatchAO.h>
+#include <CpuRendering/Stopwatch.h>
+
+namespace CpuRendering
+{
+
+BatchAORenderer::ScratchPtr BatchAORenderer::AcquireScratch()
+{
+    std::lock_guard<std::mutex> lock(scratchMutex);
+
+    if(scratchPool.empty()){
+        scratchCount++;
+        return ScratchPtr(new Scratch());
+    }
+
+    ScratchPtr set = std::move(scratchPool.back());
+    scratchPool.pop_back();
+
+    return set;
+}
+
+void BatchAORenderer::ReleaseScratch(ScratchPtr &Set)
+{
+    std::lock_guard<std::mutex> lock(scratchMutex);
+    scratchPool.push_back(std::move(Set));
+}
+
+void BatchAORenderer::RenderView(const MeshView &Mesh, const Matrix &View, const BatchAOParams &Params, Scratch &Set, ThreadPool *ViewPool,
+                                 OcclusionImage &Occlusion)
+{
+    Set.rasterizer.SetThreadPool(ViewPool);
+    Set.ssao.SetThreadPool(ViewPool);
+    Set.blur.SetThreadPool(ViewPool);
+
+    Stopwatch stopwatch;
+
+    Set.rasterizer.Clear(Params.width, Params.height, Set.normalDepth);
+    Set.rasterizer.Draw(Mesh, CreatePrepassTransforms(Matrix(), View, Params.ssao.proj), Set.normalDepth);
+
+    Set.prepassSeconds += stopwatch.GetSeconds();
+    stopwatch.Restart();
+
+    Set.ssao.Compute(Set.normalDepth, Params.ssao, Occlusion);
+
+    Set.ssaoSeconds += stopwatch.GetSeconds();
+    stopwatch.Restart();
+
+    if(Params.useBlur)
+        Set.blur.Blur(Occlusion, Set.normalDepth, Params.blur);
+
+    Set.blurSeconds += stopwatch.GetSeconds();
+}
+
+void BatchAORenderer::Render(const MeshView &Mesh, const CameraPath &Views, const BatchAOParams &Params, BatchSplit Split,
+                             const ViewCallback &Output) throw (Exception)
+{
+    if(Params.width <= 0 || Params.height <= 0)
+        throw CpuRenderingException("Batch view size must be positive");
+
+    counters = BatchAOCounters();
+    counters.views = Views.size();
+
+    for(ScratchPtr &set : scratchPool)
+        set->prepassSeconds = set->ssaoSeconds = set->blurSeconds = 0.0;
+
+    Stopwatch stopwatch;
+
+    auto renderView = [&](size_t ViewIndex, ThreadPool *ViewPool)
+    {
+        ScratchPtr set = AcquireScratch();
+        std::shared_ptr<OcclusionImage> occlusion(new OcclusionImage());
+
+        try{
+            RenderView(Mesh, Views[ViewIndex], Params, *set, ViewPool, *occlusion);
+        }catch(...){
+            ReleaseScratch(set);
+            throw;
+        }
+
+        ReleaseScratch(set);
+        Output(ViewIndex, occlusion);
+    };
+
+    if(Split == BATCH_SPLIT_VIEWS && pool != NULL)
+        pool->Execute(Views.size(), [&](size_t ViewIndex){renderView(ViewIndex, NULL);});
+    else
+        for(size_t v = 0; v < Views.size(); v++)
+            renderView(v, pool);
+
+    counters.seconds = stopwatch.GetSeconds();
+
+    for(const ScratchPtr &set : scratchPool){
+        counters.prepassSeconds += set->prepassSeconds;
+        counters.ssaoSeconds += set->ssaoSeconds;
+        counters.blurSeconds += set->blurSeconds;
+    }
+}
+
+}
@@ -0,0 +1,130 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include <CpuRendering/CameraPath.h>
+#include <CpuRendering/Image.h>
+#include <fstream>
+#include <sstream>
+
+namespace CpuRendering
+{
+
+void SaveCameraPath(const std::string &FileName, const CameraPath &Path) throw (Exception)
+{
+    std::ofstream file(FileName.c_str());
+
+    if(!file)
+        throw CpuRenderingException("Can't create camera path file " + FileName);
+
+    file.precision(9);
+
+    for(const Matrix &view : Path){
+        for(int i = 0; i < 16; i++)
+            file << ((i != 0) ? " " : "") << view.m[i / 4][i % 4];
+        file << "\n";
+    }
+
+    if(!file)
+        throw CpuRenderingException("Can't write camera path file " + FileName);
+}
+
+CameraPath LoadCameraPath(const std::string &FileName) throw (Exception)
+{
+    std::ifstream file(FileName.c_str());
+
+    if(!file)
+        throw CpuRenderingException("Can't open camera path file " + FileName);
+
+    CameraPath path;
+    std::string line;
+
+    while(std::getline(file, line)){
+
+        if(line.find_first_not_of(" \t\r") == std::string::npos)
+            continue;
+
+        std::istringstream lineStream(line);
+
+        Matrix view;
+        for(int i = 0; i < 16; i++)
+            if(!(lineStream >> view.m[i / 4][i % 4]))
+                throw CpuRenderingException("Invalid camera path file " + FileName);
+
+        path.push_back(view);
+    }
+
+    return path;
+}
+
+Matrix CreateEyeCameraView(const Float3 &Pos, const Float3 &Dir)
+{
+    return LookAtLH(Pos, Pos + Normalize(Dir), Float3(0.0f, 1.0f, 0.0f));
+}
+
+Matrix CreateTargetCameraView(const Float3 &Pos, const Float3 &Target, const Float3 &Up)
+{
+    return LookAtLH(Pos, Target, Up);
+}
+
+static bool ReadFloat3(std::istringstream &Stream, Float3 &Value)
+{
+    return static_cast<bool>(Stream >> Value.x >> Value.y >> Value.z);
+}
+
+CameraPath LoadCameraPoses(const std::string &FileName) throw (Exception)
+{
+    std::ifstream file(FileName.c_str());
+
+    if(!file)
+        throw CpuRenderingException("Can't open camera poses file " + FileName);
+
+    CameraPath views;
+    std::string line;
+
+    while(std::getline(file, line)){
+
+        size_t start = line.find_first_not_of(" \t\r");
+        if(start == std::string::npos || line[start] == '#')
+            continue;
+
+        std::istringstream lineStream(line);
+        std::string kind;
+        lineStream >> kind;
+
+        Float3 pos, dir, target, up(0.0f, 1.0f, 0.0f);
+
+        if(kind == "eye"){
+            if(!ReadFloat3(lineStream, pos) || !ReadFloat3(lineStream, dir))
+                throw CpuRenderingException("Invalid eye camera pose in " + FileName);
+
+            views.push_back(CreateEyeCameraView(pos, dir));
+        }else if(kind == "target"){
+            if(!ReadFloat3(lineStream, pos) || !ReadFloat3(lineStream, target))
+                throw CpuRenderingException("Invalid target camera pose in " + FileName);
+
+            //up is optional
+            Float3 customUp;
+            if(ReadFloat3(lineStream, customUp))
+                up = customUp;
+
+            views.push_back(CreateTargetCameraView(pos, target, up));
+        }else{
+            std::istringstream matrixStream(line);
+
+            Matrix view;
+            for(int i = 0; i < 16; i++)
+                if(!(matrixStream >> view.m[i / 4][i % 4]))
+                    throw CpuRenderingException("Invalid camera poses file " + FileName);
+
+            views.push_back(view);
+        }
+    }
+
+    return views;
+}
+
+}
@@ -0,0 +1,60 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include <CpuRendering/Deinterleave.h>
+#include <algorithm>
+
+namespace CpuRendering
+{
+
+static const int DeinterleaveTileSize = 64;
+
+void DeinterleavedDepth::Build(const NormalDepthImage &NormalDepth, ThreadPool *Pool) throw (Exception)
+{
+    if(NormalDepth.GetWidth() == 0 || NormalDepth.GetHeight() == 0)
+        throw CpuRenderingException("Deinterleaving source is empty");
+
+    width = NormalDepth.GetWidth();
+    height = NormalDepth.GetHeight();
+
+    int layerWidth = GetLayerWidth(), layerHeight = GetLayerHeight();
+
+    layers.resize(DeinterleavedLayersCount);
+
+    for(DepthImage &layer : layers)
+        if(!layer.IsSameSize(layerWidth, layerHeight))
+            layer.Init(layerWidth, layerHeight);
+
+    //layers are stacked vertically, so tiles cover the rows of all layers at once
+    ForEachTile(Pool, SplitToTiles(layerWidth, layerHeight * DeinterleavedLayersCount, DeinterleaveTileSize), [&](const Tile &Region)
+    {
+        for(int row = Region.top; row < Region.bottom; row++){
+
+            int layerIndex = row / layerHeight, y = row % layerHeight;
+            int layerX = layerIndex % DeinterleaveFactor, layerY = layerIndex / DeinterleaveFactor;
+
+            const Float4 *src = NormalDepth.GetRow(std::min(y * DeinterleaveFactor + layerY, height - 1));
+            float *dst = layers[layerIndex].GetRow(y);
+
+            for(int x = Region.left; x < Region.right; x++)
+                dst[x] = src[std::min(x * DeinterleaveFactor + layerX, width - 1)].w;
+        }
+    });
+}
+
+LayerDepthSampler::LayerDepthSampler(const DeinterleavedDepth &Depth, int Layer) : layer(Depth.GetLayer(Layer))
+{
+    //(TexCoord * size - offset - 0.5) / DeinterleaveFactor
+    scaleX = (float)Depth.GetWidth() / DeinterleaveFactor;
+    scaleY = (float)Depth.GetHeight() / DeinterleaveFactor;
+    biasX = -(Layer % DeinterleaveFactor + 0.5f) / DeinterleaveFactor;
+    biasY = -(Layer / DeinterleaveFactor + 0.5f) / DeinterleaveFactor;
+    maxX = (float)(layer.GetWidth() - 1);
+    maxY = (float)(layer.GetHeight() - 1);
+}
+
+}
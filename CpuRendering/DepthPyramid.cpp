@@ -0,0 +1,85 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include <CpuRendering/DepthPyramid.h>
+#include <algorithm>
+
+namespace CpuRendering
+{
+
+static const int DepthPyramidTileSize = 64;
+
+void DepthPyramid::Build(const NormalDepthImage &NormalDepth, int LevelsCount, ThreadPool *Pool) throw (Exception)
+{
+    int width = NormalDepth.GetWidth(), height = NormalDepth.GetHeight();
+
+    if(width == 0 || height == 0)
+        throw CpuRenderingException("Depth pyramid source is empty");
+
+    if(LevelsCount < 1)
+        throw CpuRenderingException("Depth pyramid must have at least one level");
+
+    int fullChainLevelsCount = 1;
+    while((width >> fullChainLevelsCount) > 0 || (height >> fullChainLevelsCount) > 0)
+        fullChainLevelsCount++;
+
+    LevelsCount = std::min(LevelsCount, fullChainLevelsCount);
+
+    depth.resize(LevelsCount);
+
+    if(!depth[0].IsSameSize(NormalDepth))
+        depth[0].Init(width, height);
+
+    ForEachTile(Pool, SplitToTiles(width, height, DepthPyramidTileSize), [&](const Tile &Region)
+    {
+        for(int y = Region.top; y < Region.bottom; y++){
+            const Float4 *src = NormalDepth.GetRow(y);
+            float *dst = depth[0].GetRow(y);
+            for(int x = Region.left; x < Region.right; x++)
+                dst[x] = src[x].w;
+        }
+    });
+
+    for(int level = 1; level < LevelsCount; level++){
+
+        const DepthImage &prevDepth = depth[level - 1];
+
+        int levelWidth = std::max(width >> level, 1), levelHeight = std::max(height >> level, 1);
+
+        if(!depth[level].IsSameSize(levelWidth, levelHeight))
+            depth[level].Init(levelWidth, levelHeight);
+
+        //rotated grid: the picked texel of the 2x2 block alternates with the parity of the other axis
+        ForEachTile(Pool, SplitToTiles(levelWidth, levelHeight, DepthPyramidTileSize), [&](const Tile &Region)
+        {
+            for(int y = Region.top; y < Region.bottom; y++)
+                for(int x = Region.left; x < Region.right; x++)
+                    depth[level].At(x, y) = prevDepth.AtClamped(2 * x + (y & 1), 2 * y + (x & 1));
+        });
+    }
+}
+
+int GetDepthPyramidLevel(float ScreenRadiusSq, int LevelsCount)
+{
+    int level = 0;
+    float boundSq = (float)(1 << (DepthPyramidLogMaxOffset + 1));
+    boundSq *= boundSq;
+
+    while(level < LevelsCount - 1 && ScreenRadiusSq >= boundSq){
+        level++;
+        boundSq *= 4.0f;
+    }
+
+    return level;
+}
+
+float SampleDepthLinear(const DepthImage &Depth, const Float2 &TexCoord)
+{
+    return SampleLinear(Depth, TexCoord, [](float Pixel){return Pixel;});
+}
+
+}
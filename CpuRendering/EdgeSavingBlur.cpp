@@ -0,0 +1,163 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include <CpuRendering/EdgeSavingBlur.h>
+#include <numeric>
+
+namespace CpuRendering
+{
+
+static const int BlurTileSize = 64;
+//rows of the EdgeSavingBlurEngine tasks
+static const int BlurBandHeight = 8;
+static const float Pi = 3.14159265f;
+
+BlurKernel CreateGaussianBlurKernel(int Radius, float Deviation)
+{
+    //same expression as GetGaussianKernel, the exponent is not divided by 2 * sigma ^ 2
+    float a = (Deviation == -1.0f) ? (float)(Radius * Radius) : Deviation * Deviation;
+    float f = 1.0f / sqrtf(2.0f * Pi * a);
+
+    BlurKernel kernel(Radius * 2 + 1);
+    for(int x = -Radius; x <= Radius; x++)
+        kernel[x + Radius] = f * expf(-(x * x) / a);
+
+    float sum = std::accumulate(kernel.begin(), kernel.end(), 0.0f);
+
+    for(float &weight : kernel)
+        weight /= sum;
+
+    return kernel;
+}
+
+BlurKernel CreateIteratedBlurKernel(const BlurKernel &Kernel, int Iterations)
+{
+    BlurKernel kernel = Kernel;
+
+    for(int i = 1; i < Iterations; i++){
+
+        BlurKernel convolved(kernel.size() + Kernel.size() - 1, 0.0f);
+
+        for(size_t a = 0; a < kernel.size(); a++)
+            for(size_t b = 0; b < Kernel.size(); b++)
+                convolved[a + b] += kernel[a] * Kernel[b];
+
+        kernel = convolved;
+    }
+
+    return kernel;
+}
+
+void EdgeSavingBlurPass(const OcclusionImage &Source, const NormalDepthImage &NormalDepth, const EdgeSavingBlurParams &Params, bool Vertical,
+                        OcclusionImage &Destination, ThreadPool *Pool) throw (Exception)
+{
+    if(!Source.IsSameSize(NormalDepth) || Source.GetWidth() == 0 || Source.GetHeight() == 0)
+        throw CpuRenderingException("Blur source must be of the normal/depth buffer size");
+
+    if(Params.kernel.size() % 2 == 0)
+        throw CpuRenderingException("Blur kernel size must be odd");
+
+    if(!Destination.IsSameSize(Source))
+        Destination.Init(Source.GetWidth(), Source.GetHeight());
+
+    auto source = [&](int X, int Y){return Source.At(X, Y);};
+
+    ForEachTile(Pool, SplitToTiles(Source.GetWidth(), Source.GetHeight(), BlurTileSize), [&](const Tile &Region)
+    {
+        for(int y = Region.top; y < Region.bottom; y++){
+            float *row = Destination.GetRow(y);
+            for(int x = Region.left; x < Region.right; x++)
+                row[x] = EdgeSavingBlurPixel(NormalDepth, Params, Vertical, x, y, source);
+        }
+    });
+}
+
+void EdgeSavingBlur(OcclusionImage &Occlusion, const NormalDepthImage &NormalDepth, const EdgeSavingBlurParams &Params,
+                    OcclusionImage &Intermediate, ThreadPool *Pool) throw (Exception)
+{
+    for(int i = 0; i < Params.iterations; i++){
+        EdgeSavingBlurPass(Occlusion, NormalDepth, Params, true, Intermediate, Pool);
+        EdgeSavingBlurPass(Intermediate, NormalDepth, Params, false, Occlusion, Pool);
+    }
+}
+
+//Horizontal pass of EdgeSavingBlurPixel on the normalized guide, the taps are taken in the same order
+void EdgeSavingBlurEngine::BlurRows(const OcclusionImage &Source, const NormalDepthImage &Guide, const EdgeSavingBlurParams &Params,
+                                    OcclusionImage &Destination) const
+{
+    const int width = Source.GetWidth(), radius = GetBlurRadius(Params);
+    const float *weights = &Params.kernel[radius];
+
+    ForEachTile(pool, SplitToRows(width, Source.GetHeight(), BlurBandHeight), [&](const Tile &Region)
+    {
+        for(int y = Region.top; y < Region.bottom; y++){
+            const float *src = Source.GetRow(y);
+            const Float4 *guideRow = Guide.GetRow(y);
+            float *dst = Destination.GetRow(y);
+
+            for(int x = 0; x < width; x++){
+                const Float4 &center = guideRow[x];
+                Float3 normal = center.Xyz();
+
+                float totalWeight = 0.0f, total = 0.0f;
+
+                for(int i = -radius; i <= radius; i++){
+
+                    int tap = x + i;
+                    tap = (tap < 0) ? 0 : ((tap >= width) ? width - 1 : tap);
+
+                    const Float4 &tapGuide = guideRow[tap];
+
+                    if(Dot(tapGuide.Xyz(), normal) < Params.minNormalDot || fabsf(tapGuide.w - center.w) > Params.maxDepthDifference)
+                        continue;
+
+                    totalWeight += weights[i];
+                    total += src[tap] * weights[i];
+                }
+
+                dst[x] = total / totalWeight;
+            }
+        }
+    });
+}
+
+void EdgeSavingBlurEngine::Blur(OcclusionImage &Occlusion, const NormalDepthImage &NormalDepth, const EdgeSavingBlurParams &Params) throw (Exception)
+{
+    if(!Occlusion.IsSameSize(NormalDepth) || Occlusion.GetWidth() == 0 || Occlusion.GetHeight() == 0)
+        throw CpuRenderingException("Blur source must be of the normal/depth buffer size");
+
+    if(Params.kernel.size() % 2 == 0)
+        throw CpuRenderingException("Blur kernel size must be odd");
+
+    if(!guide.IsSameSize(NormalDepth))
+        guide.Init(NormalDepth.GetWidth(), NormalDepth.GetHeight());
+
+    ForEachTile(pool, SplitToRows(NormalDepth.GetWidth(), NormalDepth.GetHeight(), BlurBandHeight), [&](const Tile &Region)
+    {
+        for(int y = Region.top; y < Region.bottom; y++){
+            const Float4 *src = NormalDepth.GetRow(y);
+            Float4 *dst = guide.GetRow(y);
+
+            for(int x = 0; x < Region.right; x++)
+                dst[x] = Float4(Normalize(src[x].Xyz()), src[x].w);
+        }
+    });
+
+    TransposeImage(guide, transposedGuide, pool);
+
+    if(!transposedBlurred.IsSameSize(NormalDepth.GetHeight(), NormalDepth.GetWidth()))
+        transposedBlurred.Init(NormalDepth.GetHeight(), NormalDepth.GetWidth());
+
+    for(int i = 0; i < Params.iterations; i++){
+        TransposeImage(Occlusion, transposed, pool);
+        BlurRows(transposed, transposedGuide, Params, transposedBlurred);
+        TransposeImage(transposedBlurred, intermediate, pool);
+        BlurRows(intermediate, guide, Params, Occlusion);
+    }
+}
+
+}
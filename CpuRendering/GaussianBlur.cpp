@@ -0,0 +1,215 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include <CpuRendering/GaussianBlur.h>
+#include <CpuRendering/LinearBlur.h>
+#include <xmmintrin.h>
+#include <algorithm>
+#include <math.h>
+#include <vector>
+
+namespace CpuRendering
+{
+
+//columns of a RecursiveGaussianColumns task, a multiple of the SSE width
+static const int RecursiveStripWidth = 64;
+
+RecursiveGaussianCoefficients::RecursiveGaussianCoefficients()
+{
+    for(int i = 0; i < 3; i++){
+        a[i] = 0.0f;
+        for(int j = 0; j < 3; j++)
+            boundary[i][j] = 0.0f;
+    }
+}
+
+RecursiveGaussianCoefficients GetRecursiveGaussianCoefficients(float Sigma) throw (Exception)
+{
+    if(Sigma < 0.5f)
+        throw CpuRenderingException("Recursive gaussian deviation must be at least 0.5");
+
+    //Young, van Vliet, "Recursive implementation of the Gaussian filter", 1995
+    double q = (Sigma >= 2.5f) ? 0.98711 * Sigma - 0.96330 : 3.97156 - 4.14554 * sqrt(1.0 - 0.26891 * Sigma);
+    double q2 = q * q, q3 = q2 * q;
+
+    double b0 = 1.57825 + 2.44413 * q + 1.4281 * q2 + 0.422205 * q3;
+    double a[] = {(2.44413 * q + 2.85619 * q2 + 1.26661 * q3) / b0, -(1.4281 * q2 + 1.26661 * q3) / b0, 0.422205 * q3 / b0};
+    double b = 1.0 - (a[0] + a[1] + a[2]);
+
+    RecursiveGaussianCoefficients coefficients;
+    coefficients.b = (float)b;
+    for(int i = 0; i < 3; i++)
+        coefficients.a[i] = (float)a[i];
+
+    //Past the border the input is the border value, the differences of the forward values from it decay as the
+    //homogeneous recursion does. They are run far enough forward and back to get the backward values of the first
+    //3 texels past the border for every one of the 3 last differences, Triggs and Sdika give the same matrix analytically
+    const int length = (int)(20.0f * Sigma) + 100;
+
+    for(int column = 0; column < 3; column++){
+
+        std::vector<double> forward(length + 3, 0.0), backward(length + 6, 0.0);
+
+        //forward[2] is the last texel, forward[0] the third from the end
+        forward[2 - column] = 1.0;
+
+        for(int n = 3; n < length + 3; n++)
+            forward[n] = a[0] * forward[n - 1] + a[1] * forward[n - 2] + a[2] * forward[n - 3];
+
+        for(int n = length + 2; n >= 3; n--)
+            backward[n] = b * forward[n] + a[0] * backward[n + 1] + a[1] * backward[n + 2] + a[2] * backward[n + 3];
+
+        for(int row = 0; row < 3; row++)
+            coefficients.boundary[row][column] = (float)backward[3 + row];
+    }
+
+    return coefficients;
+}
+
+//4 columns of SSE lanes or a single one
+struct SseLanes
+{
+    typedef __m128 Type;
+    static const int Count = 4;
+    static Type Load(const float *Ptr){return _mm_loadu_ps(Ptr);}
+    static void Store(float *Ptr, Type Value){_mm_storeu_ps(Ptr, Value);}
+    static Type Set(float Value){return _mm_set1_ps(Value);}
+    static Type Add(Type A, Type B){return _mm_add_ps(A, B);}
+    static Type Sub(Type A, Type B){return _mm_sub_ps(A, B);}
+    static Type Mul(Type A, Type B){return _mm_mul_ps(A, B);}
+};
+
+struct ScalarLanes
+{
+    typedef float Type;
+    static const int Count = 1;
+    static Type Load(const float *Ptr){return *Ptr;}
+    static void Store(float *Ptr, Type Value){*Ptr = Value;}
+    static Type Set(float Value){return Value;}
+    static Type Add(Type A, Type B){return A + B;}
+    static Type Sub(Type A, Type B){return A - B;}
+    static Type Mul(Type A, Type B){return A * B;}
+};
+
+template<class TLanes>
+static void FilterColumns(const OcclusionImage &Source, const RecursiveGaussianCoefficients &Coefficients, int X, OcclusionImage &Destination)
+{
+    typedef typename TLanes::Type Lanes;
+
+    const int height = Source.GetHeight();
+
+    const Lanes b = TLanes::Set(Coefficients.b);
+    const Lanes a1 = TLanes::Set(Coefficients.a[0]), a2 = TLanes::Set(Coefficients.a[1]), a3 = TLanes::Set(Coefficients.a[2]);
+
+    //the clamp addressing makes the steady state of the border value before the first texel
+    Lanes first = TLanes::Load(Source.GetRow(0) + X);
+    Lanes last = TLanes::Load(Source.GetRow(height - 1) + X);
+    Lanes w1 = first, w2 = first, w3 = first;
+
+    for(int y = 0; y < height; y++){
+        Lanes w = TLanes::Add(TLanes::Mul(b, TLanes::Load(Source.GetRow(y) + X)),
+                              TLanes::Add(TLanes::Mul(a1, w1), TLanes::Add(TLanes::Mul(a2, w2), TLanes::Mul(a3, w3))));
+        TLanes::Store(Destination.GetRow(y) + X, w);
+        w3 = w2;
+        w2 = w1;
+        w1 = w;
+    }
+
+    Lanes d1 = TLanes::Sub(w1, last), d2 = TLanes::Sub(w2, last), d3 = TLanes::Sub(w3, last);
+
+    Lanes y1 = last, y2 = last, y3 = last;
+    Lanes *past[] = {&y1, &y2, &y3};
+
+    for(int row = 0; row < 3; row++){
+        const float *m = Coefficients.boundary[row];
+        *past[row] = TLanes::Add(last, TLanes::Add(TLanes::Mul(TLanes::Set(m[0]), d1),
+                                                   TLanes::Add(TLanes::Mul(TLanes::Set(m[1]), d2), TLanes::Mul(TLanes::Set(m[2]), d3))));
+    }
+
+    for(int y = height - 1; y >= 0; y--){
+        float *row = Destination.GetRow(y) + X;
+        Lanes value = TLanes::Add(TLanes::Mul(b, TLanes::Load(row)),
+                                  TLanes::Add(TLanes::Mul(a1, y1), TLanes::Add(TLanes::Mul(a2, y2), TLanes::Mul(a3, y3))));
+        TLanes::Store(row, value);
+        y3 = y2;
+        y2 = y1;
+        y1 = value;
+    }
+}
+
+void RecursiveGaussianColumns(const OcclusionImage &Source, const RecursiveGaussianCoefficients &Coefficients, OcclusionImage &Destination,
+                              ThreadPool *Pool) throw (Exception)
+{
+    if(Source.GetWidth() == 0 || Source.GetHeight() == 0)
+        throw CpuRenderingException("Blur source is empty");
+
+    if(!Destination.IsSameSize(Source))
+        Destination.Init(Source.GetWidth(), Source.GetHeight());
+
+    TilesStorage strips;
+    for(int x = 0; x < Source.GetWidth(); x += RecursiveStripWidth)
+        strips.push_back(Tile(x, 0, std::min(x + RecursiveStripWidth, Source.GetWidth()), Source.GetHeight()));
+
+    ForEachTile(Pool, strips, [&](const Tile &Region)
+    {
+        int x = Region.left;
+
+        for(; x + SseLanes::Count <= Region.right; x += SseLanes::Count)
+            FilterColumns<SseLanes>(Source, Coefficients, x, Destination);
+
+        for(; x < Region.right; x++)
+            FilterColumns<ScalarLanes>(Source, Coefficients, x, Destination);
+    });
+}
+
+void GaussianBlur::SetKernel(const BlurKernel &Kernel) throw (Exception)
+{
+    if(Kernel.size() % 2 == 0)
+        throw CpuRenderingException("Blur kernel size must be odd");
+
+    kernel = Kernel;
+}
+
+void GaussianBlur::SetDeviation(float Deviation) throw (Exception)
+{
+    coefficients = GetRecursiveGaussianCoefficients(Deviation);
+    deviation = Deviation;
+
+    //GetGaussianKernel takes exp(-x ^ 2 / Deviation ^ 2)
+    kernel = CreateGaussianBlurKernel((int)ceilf(3.0f * Deviation), Deviation * sqrtf(2.0f));
+}
+
+void GaussianBlur::Draw(OcclusionImage &Occlusion) throw (Exception)
+{
+    if(Occlusion.GetWidth() == 0 || Occlusion.GetHeight() == 0)
+        throw CpuRenderingException("Blur source is empty");
+
+    if(method == GAUSSIAN_BLUR_FIR){
+
+        if(kernel.empty())
+            throw CpuRenderingException("Blur kernel is not set");
+
+        for(size_t i = 0; i < blurIterations; i++){
+            GaussianBlurPass(Occlusion, kernel, true, tmp1, pool);
+            GaussianBlurPass(tmp1, kernel, false, Occlusion, pool);
+        }
+
+        return;
+    }
+
+    if(deviation == 0.0f)
+        throw CpuRenderingException("Blur deviation is not set");
+
+    for(size_t i = 0; i < blurIterations; i++){
+        RecursiveGaussianColumns(Occlusion, coefficients, Occlusion, pool);
+        TransposeImage(Occlusion, transposed, pool);
+        RecursiveGaussianColumns(transposed, coefficients, transposed, pool);
+        TransposeImage(transposed, Occlusion, pool);
+    }
+}
+
+}
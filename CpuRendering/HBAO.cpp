@@ -0,0 +1,117 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include <CpuRendering/HBAO.h>
+
+namespace CpuRendering
+{
+
+static const float Pi = 3.14159265f;
+
+template<class TDepthSampler>
+static float ComputeHBAOVisibility(const NormalDepthImage &NormalDepth, const SSAOParams &Params, const HBAOParams &HbaoParams,
+                                   int X, int Y, const TDepthSampler &Sampler)
+{
+    const Float4 &normalDepthData = NormalDepth.At(X, Y);
+
+    //background has nothing to occlude
+    if(normalDepthData.w <= 0.0f)
+        return 1.0f;
+
+    Float3 normalV = Normalize(normalDepthData.Xyz());
+
+    Float2 originTc((X + 0.5f) / NormalDepth.GetWidth(), (Y + 0.5f) / NormalDepth.GetHeight());
+
+    Float4 eyeRayN(2.0f * originTc.x - 1.0f, 1.0f - 2.0f * originTc.y, 1.0f, 1.0f);
+    Float3 viewRay = Transform(eyeRayN, Params.invProj).Xyz() * normalDepthData.w;
+
+    //occlusion radius projected to the texture space at the pixel depth
+    Float2 radiusTc(0.5f * Params.occlusionRadius * Params.proj.m[0][0] / viewRay.z,
+                    0.5f * Params.occlusionRadius * Params.proj.m[1][1] / viewRay.z);
+
+    const RandomOffsetsImage &rnd = Params.randomOffsets;
+    const Float3 &jitter = rnd.At(X % rnd.GetWidth(), Y % rnd.GetHeight());
+
+    float radiusSq = Params.occlusionRadius * Params.occlusionRadius;
+    float totalOcclusion = 0.0f;
+
+    for(int d = 0; d < HbaoParams.directionsCount; d++){
+
+        float angle = 2.0f * Pi * (d + jitter.x) / HbaoParams.directionsCount;
+        Float2 directionTc(cosf(angle) * radiusTc.x, sinf(angle) * radiusTc.y);
+
+        float maxSinH = HbaoParams.angleBias;
+
+        for(int s = 0; s < HbaoParams.stepsCount; s++){
+
+            float t = (s + 0.5f + 0.5f * jitter.y) / HbaoParams.stepsCount;
+            Float2 samplingTc = originTc + directionTc * t;
+
+            float sampledDepth = Sampler.Sample(samplingTc, originTc);
+
+            if(sampledDepth <= 0.0f)
+                continue;
+
+            Float4 samplingRayN(2.0f * samplingTc.x - 1.0f, 1.0f - 2.0f * samplingTc.y, 1.0f, 1.0f);
+            Float3 toSamplingPos = Transform(samplingRayN, Params.invProj).Xyz() * sampledDepth - viewRay;
+
+            float distanceSq = Dot(toSamplingPos, toSamplingPos);
+
+            if(distanceSq >= radiusSq || distanceSq < 1e-8f)
+                continue;
+
+            float sinH = Dot(normalV, toSamplingPos) / sqrtf(distanceSq);
+
+            if(sinH > maxSinH){
+                totalOcclusion += (sinH - maxSinH) * (1.0f - distanceSq / radiusSq);
+                maxSinH = sinH;
+            }
+        }
+    }
+
+    return Saturate(1.0f - Params.harshness * totalOcclusion / HbaoParams.directionsCount);
+}
+
+float HBAOEngine::ComputeVisibility(const NormalDepthImage &NormalDepth, const SSAOParams &Params, const HBAOParams &HbaoParams,
+                                    int X, int Y, const DepthPyramid *Pyramid)
+{
+    if(Pyramid != NULL)
+        return ComputeHBAOVisibility(NormalDepth, Params, HbaoParams, X, Y, PyramidDepthSampler(*Pyramid));
+
+    return ComputeHBAOVisibility(NormalDepth, Params, HbaoParams, X, Y, FlatDepthSampler(NormalDepth));
+}
+
+void HBAOEngine::Compute(const NormalDepthImage &NormalDepth, const SSAOParams &Params, OcclusionImage &Occlusion) const throw (Exception)
+{
+    if(Params.randomOffsets.GetWidth() == 0 || Params.randomOffsets.GetHeight() == 0)
+        throw CpuRenderingException("HBAO random offsets are not set");
+
+    if(hbaoParams.directionsCount < 1 || hbaoParams.stepsCount < 1)
+        throw CpuRenderingException("HBAO must have at least one direction and one step");
+
+    if(!Occlusion.IsSameSize(NormalDepth))
+        Occlusion.Init(NormalDepth.GetWidth(), NormalDepth.GetHeight());
+
+    DepthPyramid pyramid;
+    if(useDepthPyramid)
+        pyramid.Build(NormalDepth, DepthPyramidMaxLevelsCount, pool);
+
+    const DepthPyramid *pyramidPtr = (useDepthPyramid) ? &pyramid : NULL;
+
+    ForEachTile(pool, SplitToTiles(NormalDepth.GetWidth(), NormalDepth.GetHeight(), tileSize), [&](const Tile &Region)
+    {
+        for(int y = Region.top; y < Region.bottom; y++){
+            float *row = Occlusion.GetRow(y);
+            for(int x = Region.left; x < Region.right; x++){
+                float visibility = ComputeVisibility(NormalDepth, Params, hbaoParams, x, y, pyramidPtr);
+                row[x] = visibility * visibility;
+            }
+        }
+    });
+}
+
+}
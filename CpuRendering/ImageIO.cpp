@@ -0,0 +1,212 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include <CpuRendering/ImageIO.h>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <stdint.h>
+
+namespace CpuRendering
+{
+
+typedef std::vector<unsigned char> ByteStorage;
+
+//largest LEN of a stored deflate block
+static const size_t MaxStoredBlockSize = 65535;
+
+static void WriteFile(const std::string &FileName, const ByteStorage &Header, const char *Data, size_t DataSize) throw (Exception)
+{
+    std::ofstream file(FileName.c_str(), std::ios::binary);
+
+    if(!file)
+        throw CpuRenderingException("Can't create image file " + FileName);
+
+    file.write(reinterpret_cast<const char*>(Header.data()), Header.size());
+    file.write(Data, DataSize);
+
+    if(!file)
+        throw CpuRenderingException("Can't write image file " + FileName);
+}
+
+template<class TPixel>
+static void SavePFMImage(const std::string &FileName, const Image<TPixel> &Source, const char *Type, int ChannelsCount) throw (Exception)
+{
+    static_assert(sizeof(TPixel) % sizeof(float) == 0, "PFM pixel must be made of floats");
+
+    if(Source.GetWidth() == 0 || Source.GetHeight() == 0)
+        throw CpuRenderingException("Image of " + FileName + " is empty");
+
+    //negative scale is the little endian map, x86 is the only target of the demo
+    std::ostringstream header;
+    header << Type << "\n" << Source.GetWidth() << " " << Source.GetHeight() << "\n-1.0\n";
+    std::string headerText = header.str();
+
+    std::vector<float> data;
+    data.reserve((size_t)Source.GetWidth() * Source.GetHeight() * ChannelsCount);
+
+    for(int y = Source.GetHeight() - 1; y >= 0; y--){
+        const float *row = reinterpret_cast<const float*>(Source.GetRow(y));
+        data.insert(data.end(), row, row + (size_t)Source.GetWidth() * ChannelsCount);
+    }
+
+    WriteFile(FileName, ByteStorage(headerText.begin(), headerText.end()), reinterpret_cast<const char*>(data.data()), data.size() * sizeof(float));
+}
+
+void SavePFM(const std::string &FileName, const OcclusionImage &Source) throw (Exception)
+{
+    SavePFMImage(FileName, Source, "Pf", 1);
+}
+
+void SavePFM(const std::string &FileName, const ColorImage &Source) throw (Exception)
+{
+    SavePFMImage(FileName, Source, "PF", 3);
+}
+
+//built before main, the images may be saved from several threads
+struct Crc32Table
+{
+    uint32_t values[256];
+    Crc32Table()
+    {
+        for(uint32_t n = 0; n < 256; n++){
+            uint32_t c = n;
+            for(int k = 0; k < 8; k++)
+                c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+            values[n] = c;
+        }
+    }
+};
+
+static const Crc32Table CrcTable;
+
+static uint32_t GetCrc32(const unsigned char *Data, size_t Size, uint32_t Crc = 0)
+{
+    Crc ^= 0xffffffffu;
+    for(size_t i = 0; i < Size; i++)
+        Crc = CrcTable.values[(Crc ^ Data[i]) & 0xff] ^ (Crc >> 8);
+
+    return Crc ^ 0xffffffffu;
+}
+
+static void PutUInt32BE(ByteStorage &Bytes, uint32_t Value)
+{
+    Bytes.push_back((unsigned char)(Value >> 24));
+    Bytes.push_back((unsigned char)(Value >> 16));
+    Bytes.push_back((unsigned char)(Value >> 8));
+    Bytes.push_back((unsigned char)Value);
+}
+
+static void PutChunk(ByteStorage &Png, const char *Type, const ByteStorage &Data)
+{
+    PutUInt32BE(Png, (uint32_t)Data.size());
+
+    size_t typeStart = Png.size();
+    Png.insert(Png.end(), Type, Type + 4);
+    Png.insert(Png.end(), Data.begin(), Data.end());
+
+    //CRC covers the type and the data
+    PutUInt32BE(Png, GetCrc32(&Png[typeStart], Png.size() - typeStart));
+}
+
+//zlib stream of stored deflate blocks
+static ByteStorage StoreZlib(const ByteStorage &Data)
+{
+    ByteStorage stream;
+    stream.reserve(Data.size() + Data.size() / MaxStoredBlockSize * 5 + 11);
+
+    //deflate with the 32K window, no preset dictionary, FCHECK makes the header a multiple of 31
+    stream.push_back(0x78);
+    stream.push_back(0x01);
+
+    size_t offset = 0;
+    do{
+        size_t blockSize = Data.size() - offset;
+        blockSize = (blockSize > MaxStoredBlockSize) ? MaxStoredBlockSize : blockSize;
+
+        bool last = offset + blockSize == Data.size();
+
+        stream.push_back(last ? 1 : 0);
+        stream.push_back((unsigned char)blockSize);
+        stream.push_back((unsigned char)(blockSize >> 8));
+        stream.push_back((unsigned char)~blockSize);
+        stream.push_back((unsigned char)(~blockSize >> 8));
+        stream.insert(stream.end(), Data.begin() + offset, Data.begin() + offset + blockSize);
+
+        offset += blockSize;
+    }while(offset < Data.size());
+
+    uint32_t a = 1, b = 0;
+    for(unsigned char byte : Data){
+        a = (a + byte) % 65521;
+        b = (b + a) % 65521;
+    }
+
+    PutUInt32BE(stream, (b << 16) | a);
+
+    return stream;
+}
+
+static unsigned char ToUNorm8(float Value)
+{
+    return (unsigned char)(Saturate(Value) * 255.0f + 0.5f);
+}
+
+template<class TPixel, class TChannels>
+static void SavePNGImage(const std::string &FileName, const Image<TPixel> &Source, unsigned char ColorType, int ChannelsCount,
+                         const TChannels &Channels) throw (Exception)
+{
+    if(Source.GetWidth() == 0 || Source.GetHeight() == 0)
+        throw CpuRenderingException("Image of " + FileName + " is empty");
+
+    //every scanline starts with the filter type 0, the bytes are stored as is
+    ByteStorage scanlines;
+    scanlines.reserve((size_t)Source.GetHeight() * (1 + (size_t)Source.GetWidth() * ChannelsCount));
+
+    for(int y = 0; y < Source.GetHeight(); y++){
+        scanlines.push_back(0);
+        const TPixel *row = Source.GetRow(y);
+        for(int x = 0; x < Source.GetWidth(); x++)
+            Channels(row[x], scanlines);
+    }
+
+    ByteStorage header;
+    PutUInt32BE(header, (uint32_t)Source.GetWidth());
+    PutUInt32BE(header, (uint32_t)Source.GetHeight());
+    //bit depth, color type, deflate, adaptive filtering, no interlace
+    const unsigned char format[] = {8, ColorType, 0, 0, 0};
+    header.insert(header.end(), format, format + sizeof(format));
+
+    const unsigned char signature[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+    ByteStorage png(signature, signature + sizeof(signature));
+
+    PutChunk(png, "IHDR", header);
+    PutChunk(png, "IDAT", StoreZlib(scanlines));
+    PutChunk(png, "IEND", ByteStorage());
+
+    WriteFile(FileName, png, NULL, 0);
+}
+
+void SavePNG(const std::string &FileName, const OcclusionImage &Source) throw (Exception)
+{
+    SavePNGImage(FileName, Source, 0, 1, [](float Value, ByteStorage &Bytes)
+    {
+        Bytes.push_back(ToUNorm8(Value));
+    });
+}
+
+void SavePNG(const std::string &FileName, const ColorImage &Source) throw (Exception)
+{
+    SavePNGImage(FileName, Source, 2, 3, [](const Float3 &Value, ByteStorage &Bytes)
+    {
+        Bytes.push_back(ToUNorm8(Value.x));
+        Bytes.push_back(ToUNorm8(Value.y));
+        Bytes.push_back(ToUNorm8(Value.z));
+    });
+}
+
+}
@@ -0,0 +1,83 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include <CpuRendering/Lighting.h>
+#include <math.h>
+
+namespace CpuRendering
+{
+
+static const int LightingRowsChunk = 16;
+
+static Float3 Modulate(const Float4 &A, const Float4 &B)
+{
+    return {A.x * B.x, A.y * B.y, A.z * B.z};
+}
+
+void ShadePointLight(const NormalDepthImage &NormalDepth, const OcclusionImage *Occlusion, const Matrix &View, const Matrix &InvProj,
+                     const PointLightParams &Params, ColorImage &Color, ThreadPool *Pool) throw (Exception)
+{
+    if(NormalDepth.GetWidth() == 0 || NormalDepth.GetHeight() == 0)
+        throw CpuRenderingException("Lighting source is empty");
+
+    if(Occlusion != NULL && !Occlusion->IsSameSize(NormalDepth))
+        throw CpuRenderingException("Occlusion and normal/depth sizes differ");
+
+    if(!Color.IsSameSize(NormalDepth))
+        Color.Init(NormalDepth.GetWidth(), NormalDepth.GetHeight());
+
+    Float3 lightPosV = Transform(Float4(Params.pos, 1.0f), View).Xyz();
+
+    Float3 ambient = Modulate(Params.materialAmbient, Params.ambient);
+    Float3 diffuse = Modulate(Params.materialDiffuse, Params.diffuse);
+    Float3 specular = Modulate(Params.materialSpecularWithPower, Params.specular);
+    float specularPower = Params.materialSpecularWithPower.w;
+
+    ForEachTile(Pool, SplitToRows(NormalDepth.GetWidth(), NormalDepth.GetHeight(), LightingRowsChunk), [&](const Tile &Region)
+    {
+        for(int y = Region.top; y < Region.bottom; y++){
+
+            const Float4 *normalDepthRow = NormalDepth.GetRow(y);
+            Float3 *colorRow = Color.GetRow(y);
+
+            for(int x = Region.left; x < Region.right; x++){
+
+                const Float4 &normalDepth = normalDepthRow[x];
+
+                if(normalDepth.w <= 0.0f){
+                    colorRow[x] = Float3();
+                    continue;
+                }
+
+                //same eye ray as ComputeSSAOVisibility
+                Float4 eyeRayN(2.0f * (x + 0.5f) / NormalDepth.GetWidth() - 1.0f, 1.0f - 2.0f * (y + 0.5f) / NormalDepth.GetHeight(), 1.0f, 1.0f);
+                Float3 posV = Transform(eyeRayN, InvProj).Xyz() * normalDepth.w;
+                Float3 normalV = Normalize(normalDepth.Xyz());
+
+                Float3 toLight = lightPosV - posV;
+                float distance = Length(toLight);
+                toLight = toLight / distance;
+
+                float diff = Saturate(Dot(toLight, normalV));
+                float spec = 0.0f;
+
+                if(diff > 0.0f){
+                    Float3 fromLight = -toLight;
+                    Float3 reflected = Normalize(fromLight - normalV * (2.0f * Dot(normalV, fromLight)));
+                    spec = powf(Saturate(Dot(Normalize(-posV), reflected)), specularPower);
+                }
+
+                float att = (1.0f - Saturate((distance - Params.range) / Params.fadeDistance)) * Params.intencity;
+                float ssaoFactor = (Occlusion != NULL) ? Occlusion->At(x, y) : 1.0f;
+
+                colorRow[x] = (ambient * ssaoFactor + diffuse * diff + specular * spec) * att;
+            }
+        }
+    });
+}
+
+}
@@ -0,0 +1,199 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include <CpuRendering/LinearBlur.h>
+#include <math.h>
+
+namespace CpuRendering
+{
+
+static const int LinearBlurTileSize = 64;
+
+static LinearBlurTap MergeTaps(int First, float FirstWeight, float SecondWeight)
+{
+    LinearBlurTap tap;
+    tap.weight = FirstWeight + SecondWeight;
+    tap.offset = First + ((tap.weight > 0.0f) ? SecondWeight / tap.weight : 0.0f);
+    tap.first = First;
+    tap.firstWeight = FirstWeight;
+
+    return tap;
+}
+
+LinearBlurKernel CreateLinearBlurKernel(const BlurKernel &Kernel) throw (Exception)
+{
+    if(Kernel.size() % 2 == 0)
+        throw CpuRenderingException("Blur kernel size must be odd");
+
+    const int radius = (int)Kernel.size() / 2;
+
+    //weight of the texel at Offset, the center one is shared by both sides
+    auto weight = [&](int Offset) -> float
+    {
+        if(Offset < -radius || Offset > radius)
+            return 0.0f;
+
+        return (Offset == 0) ? Kernel[radius] * 0.5f : Kernel[Offset + radius];
+    };
+
+    LinearBlurKernel taps;
+
+    for(int i = 0; i <= radius; i += 2){
+        taps.push_back(MergeTaps(-i - 1, weight(-i - 1), weight(-i)));
+        taps.push_back(MergeTaps(i, weight(i), weight(i + 1)));
+    }
+
+    if((int)taps.size() > MaxLinearBlurTaps)
+        throw CpuRenderingException("Blur kernel is too wide for the taps array");
+
+    return taps;
+}
+
+static float RoundFraction(float Fraction, int SubtexelBits)
+{
+    if(SubtexelBits <= 0)
+        return Fraction;
+
+    float steps = (float)(1 << SubtexelBits);
+
+    return floorf(Fraction * steps + 0.5f) / steps;
+}
+
+//1D fetch of the linear sampler with the clamp addressing along the pass axis
+template<class TSource>
+static float FetchLinear(const TSource &Source, int Last, float Offset, int First, int SubtexelBits)
+{
+    int t0 = (First < 0) ? 0 : ((First > Last) ? Last : First);
+    int t1 = (First + 1 < 0) ? 0 : ((First + 1 > Last) ? Last : First + 1);
+
+    float v0 = Source(t0), v1 = Source(t1);
+
+    return v0 + (v1 - v0) * RoundFraction(Offset - First, SubtexelBits);
+}
+
+static void CheckPass(const OcclusionImage &Source, const BlurKernel &Kernel, OcclusionImage &Destination) throw (Exception)
+{
+    if(Source.GetWidth() == 0 || Source.GetHeight() == 0)
+        throw CpuRenderingException("Blur source is empty");
+
+    if(Kernel.size() % 2 == 0)
+        throw CpuRenderingException("Blur kernel size must be odd");
+
+    if(!Destination.IsSameSize(Source))
+        Destination.Init(Source.GetWidth(), Source.GetHeight());
+}
+
+void GaussianBlurPass(const OcclusionImage &Source, const BlurKernel &Kernel, bool Vertical, OcclusionImage &Destination,
+                      ThreadPool *Pool) throw (Exception)
+{
+    CheckPass(Source, Kernel, Destination);
+
+    const int radius = (int)Kernel.size() / 2;
+
+    ForEachTile(Pool, SplitToTiles(Source.GetWidth(), Source.GetHeight(), LinearBlurTileSize), [&](const Tile &Region)
+    {
+        for(int y = Region.top; y < Region.bottom; y++){
+            float *row = Destination.GetRow(y);
+
+            for(int x = Region.left; x < Region.right; x++){
+                float total = 0.0f;
+
+                for(int i = -radius; i <= radius; i++)
+                    total += ((Vertical) ? Source.AtClamped(x, y + i) : Source.AtClamped(x + i, y)) * Kernel[i + radius];
+
+                row[x] = total;
+            }
+        }
+    });
+}
+
+void LinearBlurPass(const OcclusionImage &Source, const BlurKernel &Kernel, bool Vertical, int SubtexelBits, OcclusionImage &Destination,
+                    ThreadPool *Pool) throw (Exception)
+{
+    CheckPass(Source, Kernel, Destination);
+
+    const LinearBlurKernel taps = CreateLinearBlurKernel(Kernel);
+    const int last = ((Vertical) ? Source.GetHeight() : Source.GetWidth()) - 1;
+
+    ForEachTile(Pool, SplitToTiles(Source.GetWidth(), Source.GetHeight(), LinearBlurTileSize), [&](const Tile &Region)
+    {
+        for(int y = Region.top; y < Region.bottom; y++){
+            float *row = Destination.GetRow(y);
+
+            for(int x = Region.left; x < Region.right; x++){
+                int center = (Vertical) ? y : x;
+                auto source = [&](int Tap){return (Vertical) ? Source.At(x, Tap) : Source.At(Tap, y);};
+
+                float total = 0.0f;
+
+                for(const LinearBlurTap &tap : taps)
+                    total += FetchLinear(source, last, center + tap.offset, center + tap.first, SubtexelBits) * tap.weight;
+
+                row[x] = total;
+            }
+        }
+    });
+}
+
+void EdgeSavingLinearBlurPass(const OcclusionImage &Source, const NormalDepthImage &NormalDepth, const EdgeSavingBlurParams &Params, bool Vertical,
+                              int SubtexelBits, OcclusionImage &Destination, ThreadPool *Pool) throw (Exception)
+{
+    if(!Source.IsSameSize(NormalDepth))
+        throw CpuRenderingException("Blur source must be of the normal/depth buffer size");
+
+    CheckPass(Source, Params.kernel, Destination);
+
+    const LinearBlurKernel taps = CreateLinearBlurKernel(Params.kernel);
+    const int last = ((Vertical) ? Source.GetHeight() : Source.GetWidth()) - 1;
+
+    ForEachTile(Pool, SplitToTiles(Source.GetWidth(), Source.GetHeight(), LinearBlurTileSize), [&](const Tile &Region)
+    {
+        for(int y = Region.top; y < Region.bottom; y++){
+            float *row = Destination.GetRow(y);
+
+            for(int x = Region.left; x < Region.right; x++){
+                const Float4 &centerNormalDepth = NormalDepth.At(x, y);
+                Float3 normal = Normalize(centerNormalDepth.Xyz());
+
+                int center = (Vertical) ? y : x;
+                auto source = [&](int Tap){return (Vertical) ? Source.At(x, Tap) : Source.At(Tap, y);};
+
+                auto accepted = [&](int Tap) -> bool
+                {
+                    Tap = (Tap < 0) ? 0 : ((Tap > last) ? last : Tap);
+                    const Float4 &tapNormalDepth = (Vertical) ? NormalDepth.At(x, Tap) : NormalDepth.At(Tap, y);
+
+                    return Dot(Normalize(tapNormalDepth.Xyz()), normal) >= Params.minNormalDot &&
+                           fabsf(tapNormalDepth.w - centerNormalDepth.w) <= Params.maxDepthDifference;
+                };
+
+                float totalWeight = 0.0f, total = 0.0f;
+
+                for(const LinearBlurTap &tap : taps){
+
+                    int first = center + tap.first;
+                    bool firstAccepted = accepted(first), secondAccepted = accepted(first + 1);
+
+                    if(firstAccepted && secondAccepted){
+                        totalWeight += tap.weight;
+                        total += FetchLinear(source, last, center + tap.offset, first, SubtexelBits) * tap.weight;
+                    }else if(firstAccepted){
+                        totalWeight += tap.firstWeight;
+                        total += FetchLinear(source, last, (float)first, first, SubtexelBits) * tap.firstWeight;
+                    }else if(secondAccepted){
+                        totalWeight += tap.weight - tap.firstWeight;
+                        total += FetchLinear(source, last, (float)(first + 1), first + 1, SubtexelBits) * (tap.weight - tap.firstWeight);
+                    }
+                }
+
+                row[x] = total / totalWeight;
+            }
+        }
+    });
+}
+
+}
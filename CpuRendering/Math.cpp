@@ -0,0 +1,87 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include <CpuRendering/Math.h>
+
+namespace CpuRendering
+{
+
+Matrix Inverse(const Matrix &M)
+{
+    const float *a = &M.m[0][0];
+    float inv[16];
+
+    inv[0] = a[5] * a[10] * a[15] - a[5] * a[11] * a[14] - a[9] * a[6] * a[15] + a[9] * a[7] * a[14] + a[13] * a[6] * a[11] - a[13] * a[7] * a[10];
+    inv[4] = -a[4] * a[10] * a[15] + a[4] * a[11] * a[14] + a[8] * a[6] * a[15] - a[8] * a[7] * a[14] - a[12] * a[6] * a[11] + a[12] * a[7] * a[10];
+    inv[8] = a[4] * a[9] * a[15] - a[4] * a[11] * a[13] - a[8] * a[5] * a[15] + a[8] * a[7] * a[13] + a[12] * a[5] * a[11] - a[12] * a[7] * a[9];
+    inv[12] = -a[4] * a[9] * a[14] + a[4] * a[10] * a[13] + a[8] * a[5] * a[14] - a[8] * a[6] * a[13] - a[12] * a[5] * a[10] + a[12] * a[6] * a[9];
+    inv[1] = -a[1] * a[10] * a[15] + a[1] * a[11] * a[14] + a[9] * a[2] * a[15] - a[9] * a[3] * a[14] - a[13] * a[2] * a[11] + a[13] * a[3] * a[10];
+    inv[5] = a[0] * a[10] * a[15] - a[0] * a[11] * a[14] - a[8] * a[2] * a[15] + a[8] * a[3] * a[14] + a[12] * a[2] * a[11] - a[12] * a[3] * a[10];
+    inv[9] = -a[0] * a[9] * a[15] + a[0] * a[11] * a[13] + a[8] * a[1] * a[15] - a[8] * a[3] * a[13] - a[12] * a[1] * a[11] + a[12] * a[3] * a[9];
+    inv[13] = a[0] * a[9] * a[14] - a[0] * a[10] * a[13] - a[8] * a[1] * a[14] + a[8] * a[2] * a[13] + a[12] * a[1] * a[10] - a[12] * a[2] * a[9];
+    inv[2] = a[1] * a[6] * a[15] - a[1] * a[7] * a[14] - a[5] * a[2] * a[15] + a[5] * a[3] * a[14] + a[13] * a[2] * a[7] - a[13] * a[3] * a[6];
+    inv[6] = -a[0] * a[6] * a[15] + a[0] * a[7] * a[14] + a[4] * a[2] * a[15] - a[4] * a[3] * a[14] - a[12] * a[2] * a[7] + a[12] * a[3] * a[6];
+    inv[10] = a[0] * a[5] * a[15] - a[0] * a[7] * a[13] - a[4] * a[1] * a[15] + a[4] * a[3] * a[13] + a[12] * a[1] * a[7] - a[12] * a[3] * a[5];
+    inv[14] = -a[0] * a[5] * a[14] + a[0] * a[6] * a[13] + a[4] * a[1] * a[14] - a[4] * a[2] * a[13] - a[12] * a[1] * a[6] + a[12] * a[2] * a[5];
+    inv[3] = -a[1] * a[6] * a[11] + a[1] * a[7] * a[10] + a[5] * a[2] * a[11] - a[5] * a[3] * a[10] - a[9] * a[2] * a[7] + a[9] * a[3] * a[6];
+    inv[7] = a[0] * a[6] * a[11] - a[0] * a[7] * a[10] - a[4] * a[2] * a[11] + a[4] * a[3] * a[10] + a[8] * a[2] * a[7] - a[8] * a[3] * a[6];
+    inv[11] = -a[0] * a[5] * a[11] + a[0] * a[7] * a[9] + a[4] * a[1] * a[11] - a[4] * a[3] * a[9] - a[8] * a[1] * a[7] + a[8] * a[3] * a[5];
+    inv[15] = a[0] * a[5] * a[10] - a[0] * a[6] * a[9] - a[4] * a[1] * a[10] + a[4] * a[2] * a[9] + a[8] * a[1] * a[6] - a[8] * a[2] * a[5];
+
+    float det = a[0] * inv[0] + a[1] * inv[4] + a[2] * inv[8] + a[3] * inv[12];
+
+    if(det == 0.0f)
+        return Matrix();
+
+    float invDet = 1.0f / det;
+    for(int i = 0; i < 16; i++)
+        inv[i] *= invDet;
+
+    return Matrix(inv);
+}
+
+Matrix Transpose(const Matrix &M)
+{
+    Matrix out;
+    for(int r = 0; r < 4; r++)
+        for(int c = 0; c < 4; c++)
+            out.m[r][c] = M.m[c][r];
+    return out;
+}
+
+Matrix PerspectiveFovLH(float FOV, float NearZ, float FarZ, float AspectRatio)
+{
+    float yScale = 1.0f / tanf(FOV * 0.5f);
+    float xScale = yScale / AspectRatio;
+
+    Matrix out;
+    out.m[0][0] = xScale;
+    out.m[1][1] = yScale;
+    out.m[2][2] = FarZ / (FarZ - NearZ);
+    out.m[2][3] = 1.0f;
+    out.m[3][2] = -NearZ * FarZ / (FarZ - NearZ);
+    out.m[3][3] = 0.0f;
+    return out;
+}
+
+Matrix LookAtLH(const Float3 &Eye, const Float3 &At, const Float3 &Up)
+{
+    Float3 zAxis = Normalize(At - Eye);
+    Float3 xAxis = Normalize(Cross(Up, zAxis));
+    Float3 yAxis = Cross(zAxis, xAxis);
+
+    Matrix out;
+    out.m[0][0] = xAxis.x; out.m[0][1] = yAxis.x; out.m[0][2] = zAxis.x;
+    out.m[1][0] = xAxis.y; out.m[1][1] = yAxis.y; out.m[1][2] = zAxis.y;
+    out.m[2][0] = xAxis.z; out.m[2][1] = yAxis.z; out.m[2][2] = zAxis.z;
+    out.m[3][0] = -Dot(xAxis, Eye);
+    out.m[3][1] = -Dot(yAxis, Eye);
+    out.m[3][2] = -Dot(zAxis, Eye);
+    return out;
+}
+
+}
@@ -0,0 +1,139 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include <CpuRendering/Mesh.h>
+#include <stdint.h>
+#include <fstream>
+#include <algorithm>
+
+namespace CpuRendering
+{
+
+void TriangleMesh::Append(const TriangleMesh &Mesh)
+{
+    unsigned int base = (unsigned int)vertices.size();
+
+    vertices.insert(vertices.end(), Mesh.vertices.begin(), Mesh.vertices.end());
+
+    for(unsigned int index : Mesh.indices)
+        indices.push_back(base + index);
+}
+
+template<class TNum>
+static TNum ReadNumber(std::ifstream &File, const std::string &FileName) throw (Exception)
+{
+    TNum num;
+    if(!File.read(reinterpret_cast<char*>(&num), sizeof(TNum)))
+        throw CpuRenderingException("Can't read mesh file " + FileName);
+
+    return num;
+}
+
+TriangleMesh LoadColladaBinaryMesh(const std::string &FileName) throw (Exception)
+{
+    std::ifstream file(FileName.c_str(), std::ios::binary);
+
+    if(!file)
+        throw CpuRenderingException("Can't open mesh file " + FileName);
+
+    TriangleMesh mesh;
+
+    uint32_t meshesCnt = ReadNumber<uint32_t>(file, FileName);
+
+    for(uint32_t m = 0; m < meshesCnt; m++){
+        uint32_t subsetsCnt = ReadNumber<uint32_t>(file, FileName);
+
+        for(uint32_t s = 0; s < subsetsCnt; s++){
+            uint32_t vertsCnt = ReadNumber<uint32_t>(file, FileName);
+
+            if(vertsCnt % 3 != 0)
+                throw CpuRenderingException("Invalid mesh file " + FileName);
+
+            std::vector<float> data((size_t)vertsCnt * 8);
+
+            if(vertsCnt > 0 && !file.read(reinterpret_cast<char*>(&data[0]), data.size() * sizeof(float)))
+                throw CpuRenderingException("Can't read mesh file " + FileName);
+
+            for(uint32_t v = 0; v < vertsCnt; v++){
+                const float *src = &data[(size_t)v * 8];
+
+                MeshVertex vertex;
+                vertex.pos = Float3(src[0], src[1], src[2]);
+                vertex.normal = Float3(src[3], src[4], src[5]);
+                vertex.tc = Float2(src[6], src[7]);
+
+                mesh.indices.push_back((unsigned int)mesh.vertices.size());
+                mesh.vertices.push_back(vertex);
+            }
+        }
+    }
+
+    return mesh;
+}
+
+//"MESHCACH" and the version
+static const char MeshCacheMagic[8] = {'M', 'E', 'S', 'H', 'C', 'A', 'C', 'H'};
+static const uint32_t MeshCacheVersion = 1;
+
+struct MeshCacheHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t vertexSize;
+    uint32_t verticesCount;
+    uint32_t indicesCount;
+};
+
+void SaveMeshCache(const std::string &FileName, const MeshView &Mesh) throw (Exception)
+{
+    std::ofstream file(FileName.c_str(), std::ios::binary);
+
+    if(!file)
+        throw CpuRenderingException("Can't create mesh cache file " + FileName);
+
+    MeshCacheHeader header;
+    std::copy(MeshCacheMagic, MeshCacheMagic + sizeof(MeshCacheMagic), header.magic);
+    header.version = MeshCacheVersion;
+    header.vertexSize = sizeof(MeshVertex);
+    header.verticesCount = (uint32_t)Mesh.verticesCount;
+    header.indicesCount = (uint32_t)Mesh.indicesCount;
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(Mesh.vertices), Mesh.verticesCount * sizeof(MeshVertex));
+    file.write(reinterpret_cast<const char*>(Mesh.indices), Mesh.indicesCount * sizeof(unsigned int));
+
+    if(!file)
+        throw CpuRenderingException("Can't write mesh cache file " + FileName);
+}
+
+void MappedMeshCache::Open(const std::string &FileName) throw (Exception)
+{
+    mesh = MeshView();
+    file.Open(FileName);
+
+    const char *data = static_cast<const char*>(file.GetData());
+
+    MeshCacheHeader header;
+    if(file.GetSize() < sizeof(header))
+        throw CpuRenderingException("Invalid mesh cache file " + FileName);
+
+    std::copy(data, data + sizeof(header), reinterpret_cast<char*>(&header));
+
+    size_t expectedSize = sizeof(header) + (size_t)header.verticesCount * sizeof(MeshVertex) + (size_t)header.indicesCount * sizeof(unsigned int);
+
+    if(!std::equal(MeshCacheMagic, MeshCacheMagic + sizeof(MeshCacheMagic), header.magic) || header.version != MeshCacheVersion ||
+       header.vertexSize != sizeof(MeshVertex) || file.GetSize() != expectedSize)
+        throw CpuRenderingException("Invalid mesh cache file " + FileName);
+
+    //the header keeps the arrays 4 byte aligned, the mapping itself is page aligned
+    mesh.vertices = reinterpret_cast<const MeshVertex*>(data + sizeof(header));
+    mesh.indices = reinterpret_cast<const unsigned int*>(data + sizeof(header) + (size_t)header.verticesCount * sizeof(MeshVertex));
+    mesh.verticesCount = header.verticesCount;
+    mesh.indicesCount = header.indicesCount;
+}
+
+}
@@ -0,0 +1,121 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include <CpuRendering/MultiScaleSSAO.h>
+#include <CpuRendering/TemporalSSAO.h>
+#include <algorithm>
+
+namespace CpuRendering
+{
+
+static const int CombineTileSize = 64;
+
+float CombineMultiScale(float A, float B, MultiScaleCombine Combine)
+{
+    return (Combine == MULTI_SCALE_COMBINE_MULTIPLY) ? A * B : std::min(A, B);
+}
+
+void MultiScaleSSAOEngine::SetMultiScaleParams(const MultiScaleParams &Params) throw (Exception)
+{
+    int prevScale = 1;
+
+    for(const MultiScaleLayer &layer : Params.layers){
+
+        if(layer.resolutionScale != 1 && layer.resolutionScale != 2 && layer.resolutionScale != 4)
+            throw CpuRenderingException("Multi-scale layer resolution scale must be 1, 2 or 4");
+
+        if(layer.resolutionScale < prevScale)
+            throw CpuRenderingException("Multi-scale layers must go from the finest to the coarsest");
+
+        if(layer.sampleStep < 1)
+            throw CpuRenderingException("Multi-scale layer sample step must be positive");
+
+        if(layer.radiusScale <= 0.0f)
+            throw CpuRenderingException("Multi-scale layer radius scale must be positive");
+
+        prevScale = layer.resolutionScale;
+    }
+
+    multiScaleParams = Params;
+}
+
+int MultiScaleSSAOEngine::GetDepthFetchesCount(const SSAOParams &Params) const
+{
+    float fetches = 0.0f;
+
+    for(const MultiScaleLayer &layer : multiScaleParams.layers){
+        int samples = (int)(Params.kernel.size() + layer.sampleStep - 1) / layer.sampleStep;
+        fetches += (float)samples / (layer.resolutionScale * layer.resolutionScale);
+    }
+
+    return (int)ceilf(fetches);
+}
+
+void MultiScaleSSAOEngine::ComputeLayer(const NormalDepthImage &LayerNormalDepth, const SSAOParams &Params, int Layer,
+                                        OcclusionImage &Occlusion) const throw (Exception)
+{
+    if(Layer < 0 || Layer >= MultiScaleLayersCount)
+        throw CpuRenderingException("Invalid multi-scale layer");
+
+    const MultiScaleLayer &layer = multiScaleParams.layers[Layer];
+
+    SSAOParams layerParams = Params;
+    layerParams.occlusionRadius = Params.occlusionRadius * layer.radiusScale;
+    layerParams.kernel = GetKernelSubset(Params.kernel, 0, layer.sampleStep);
+
+    SSAOEngine engine(pool, tileSize);
+    engine.Compute(LayerNormalDepth, layerParams, Occlusion);
+}
+
+void MultiScaleSSAOEngine::Compute(const NormalDepthImage &NormalDepth, const SSAOParams &Params, OcclusionImage &Occlusion) const throw (Exception)
+{
+    //every low resolution layer takes the nearest sample of its block of the full resolution buffer, as DownsampleNormalDepth.ps
+    NormalDepthImage layerNormalDepth[MultiScaleLayersCount];
+
+    for(int l = 0; l < MultiScaleLayersCount; l++){
+        int scale = multiScaleParams.layers[l].resolutionScale;
+
+        if(scale > 1)
+            DownsampleNormalDepth(NormalDepth, scale, layerNormalDepth[l], pool);
+    }
+
+    auto getLayerNormalDepth = [&](int Layer) -> const NormalDepthImage&
+    {
+        return (multiScaleParams.layers[Layer].resolutionScale > 1) ? layerNormalDepth[Layer] : NormalDepth;
+    };
+
+    OcclusionImage combined, layerOcclusion, upsampled;
+
+    ComputeLayer(getLayerNormalDepth(MultiScaleLayersCount - 1), Params, MultiScaleLayersCount - 1, combined);
+
+    for(int l = MultiScaleLayersCount - 2; l >= 0; l--){
+
+        ComputeLayer(getLayerNormalDepth(l), Params, l, layerOcclusion);
+
+        if(combined.IsSameSize(layerOcclusion))
+            std::swap(upsampled, combined);
+        else
+            BilateralUpsample(combined, getLayerNormalDepth(l + 1), getLayerNormalDepth(l), upsampled, BilateralUpsampleParams(), pool);
+
+        ForEachTile(pool, SplitToTiles(layerOcclusion.GetWidth(), layerOcclusion.GetHeight(), CombineTileSize), [&](const Tile &Region)
+        {
+            for(int y = Region.top; y < Region.bottom; y++){
+                const float *src = upsampled.GetRow(y);
+                float *dst = layerOcclusion.GetRow(y);
+
+                for(int x = Region.left; x < Region.right; x++)
+                    dst[x] = CombineMultiScale(dst[x], src[x], multiScaleParams.combine);
+            }
+        });
+
+        std::swap(combined, layerOcclusion);
+    }
+
+    std::swap(Occlusion, combined);
+}
+
+}
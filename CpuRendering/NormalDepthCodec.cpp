@@ -0,0 +1,149 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include <CpuRendering/NormalDepthCodec.h>
+#include <math.h>
+
+namespace CpuRendering
+{
+
+static const int CodecTileSize = 64;
+static const float Unorm16Max = 65535.0f;
+
+static unsigned short EncodeUnorm16(float Val)
+{
+    return (unsigned short)(Saturate(Val) * Unorm16Max + 0.5f);
+}
+
+static float DecodeUnorm16(unsigned short Val)
+{
+    return Val * (1.0f / Unorm16Max);
+}
+
+Float2 EncodeOctahedral(const Float3 &Normal)
+{
+    Float3 n = Normal / (fabsf(Normal.x) + fabsf(Normal.y) + fabsf(Normal.z));
+
+    //lower hemisphere is folded over the diagonals
+    if(n.z < 0.0f)
+        n = Float3((1.0f - fabsf(n.y)) * (n.x >= 0.0f ? 1.0f : -1.0f), (1.0f - fabsf(n.x)) * (n.y >= 0.0f ? 1.0f : -1.0f), n.z);
+
+    return Float2(n.x * 0.5f + 0.5f, n.y * 0.5f + 0.5f);
+}
+
+Float3 DecodeOctahedral(const Float2 &Encoded)
+{
+    Float3 n(Encoded.x * 2.0f - 1.0f, Encoded.y * 2.0f - 1.0f, 0.0f);
+    n.z = 1.0f - fabsf(n.x) - fabsf(n.y);
+
+    float t = Saturate(-n.z);
+    n.x += (n.x >= 0.0f) ? -t : t;
+    n.y += (n.y >= 0.0f) ? -t : t;
+
+    return Normalize(n);
+}
+
+PackedNormalDepth EncodeNormalDepth(const Float4 &NormalDepth, DepthPrecision Precision)
+{
+    PackedNormalDepth packed;
+
+    if(NormalDepth.w <= 0.0f)
+        return packed;
+
+    Float2 normal = EncodeOctahedral(NormalDepth.Xyz());
+    packed.normalX = EncodeUnorm16(normal.x);
+    packed.normalY = EncodeUnorm16(normal.y);
+
+    float depth = Saturate(NormalDepth.w / PackedMaxDepth) * Unorm16Max;
+
+    if(Precision == DEPTH_PRECISION_16){
+        packed.depthHigh = (unsigned short)(depth + 0.5f);
+        return packed;
+    }
+
+    float high = floorf(depth);
+    packed.depthHigh = (unsigned short)high;
+    packed.depthLow = EncodeUnorm16(depth - high);
+
+    return packed;
+}
+
+Float4 DecodeNormalDepth(const PackedNormalDepth &Packed)
+{
+    float depth = (Packed.depthHigh + DecodeUnorm16(Packed.depthLow)) * (PackedMaxDepth / Unorm16Max);
+
+    return Float4(DecodeOctahedral(Float2(DecodeUnorm16(Packed.normalX), DecodeUnorm16(Packed.normalY))), depth);
+}
+
+PackedBentNormal EncodeBentNormal(const Float3 &BentNormal)
+{
+    Float2 encoded = EncodeOctahedral(BentNormal);
+
+    PackedBentNormal packed;
+    packed.x = EncodeOcclusion(encoded.x);
+    packed.y = EncodeOcclusion(encoded.y);
+
+    return packed;
+}
+
+Float3 DecodeBentNormal(const PackedBentNormal &Packed)
+{
+    return DecodeOctahedral(Float2(DecodeOcclusion(Packed.x), DecodeOcclusion(Packed.y)));
+}
+
+//Source and destination of the same size, every pixel converted by Function
+template<class TSource, class TDestination, class TFunction>
+static void ConvertImage(const Image<TSource> &Source, Image<TDestination> &Destination, ThreadPool *Pool, const TFunction &Function) throw (Exception)
+{
+    if(Source.GetWidth() == 0 || Source.GetHeight() == 0)
+        throw CpuRenderingException("Codec source is empty");
+
+    if(!Destination.IsSameSize(Source))
+        Destination.Init(Source.GetWidth(), Source.GetHeight());
+
+    ForEachTile(Pool, SplitToTiles(Source.GetWidth(), Source.GetHeight(), CodecTileSize), [&](const Tile &Region)
+    {
+        for(int y = Region.top; y < Region.bottom; y++){
+            const TSource *src = Source.GetRow(y);
+            TDestination *dst = Destination.GetRow(y);
+            for(int x = Region.left; x < Region.right; x++)
+                dst[x] = Function(src[x]);
+        }
+    });
+}
+
+void PackNormalDepth(const NormalDepthImage &NormalDepth, DepthPrecision Precision, PackedNormalDepthImage &Packed, ThreadPool *Pool) throw (Exception)
+{
+    ConvertImage(NormalDepth, Packed, Pool, [Precision](const Float4 &Pixel){return EncodeNormalDepth(Pixel, Precision);});
+}
+
+void UnpackNormalDepth(const PackedNormalDepthImage &Packed, NormalDepthImage &NormalDepth, ThreadPool *Pool) throw (Exception)
+{
+    ConvertImage(Packed, NormalDepth, Pool, [](const PackedNormalDepth &Pixel){return DecodeNormalDepth(Pixel);});
+}
+
+void PackOcclusion(const OcclusionImage &Occlusion, PackedOcclusionImage &Packed, ThreadPool *Pool) throw (Exception)
+{
+    ConvertImage(Occlusion, Packed, Pool, [](float Pixel){return EncodeOcclusion(Pixel);});
+}
+
+void UnpackOcclusion(const PackedOcclusionImage &Packed, OcclusionImage &Occlusion, ThreadPool *Pool) throw (Exception)
+{
+    ConvertImage(Packed, Occlusion, Pool, [](unsigned char Pixel){return DecodeOcclusion(Pixel);});
+}
+
+void PackBentNormals(const Image<Float3> &BentNormals, PackedBentNormalImage &Packed, ThreadPool *Pool) throw (Exception)
+{
+    ConvertImage(BentNormals, Packed, Pool, [](const Float3 &Pixel){return EncodeBentNormal(Pixel);});
+}
+
+void UnpackBentNormals(const PackedBentNormalImage &Packed, Image<Float3> &BentNormals, ThreadPool *Pool) throw (Exception)
+{
+    ConvertImage(Packed, BentNormals, Pool, [](const PackedBentNormal &Pixel){return DecodeBentNormal(Pixel);});
+}
+
+}
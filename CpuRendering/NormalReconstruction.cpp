@@ -0,0 +1,132 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include <CpuRendering/NormalReconstruction.h>
+#include <math.h>
+
+namespace CpuRendering
+{
+
+static const int ReconstructionTileSize = 64;
+
+Float3 GetViewPosition(const DepthImage &Depth, const Matrix &InvProj, int X, int Y)
+{
+    float texX = (X + 0.5f) / Depth.GetWidth();
+    float texY = (Y + 0.5f) / Depth.GetHeight();
+
+    return Transform(Float4(2.0f * texX - 1.0f, 1.0f - 2.0f * texY, 1.0f, 1.0f), InvProj).Xyz() * Depth.At(X, Y);
+}
+
+//Loads past the texture borders return zero on the GPU, so they are background here too
+static float GetDepth(const DepthImage &Depth, int X, int Y)
+{
+    if(X < 0 || Y < 0 || X >= Depth.GetWidth() || Y >= Depth.GetHeight())
+        return 0.0f;
+
+    return Depth.At(X, Y);
+}
+
+//Position difference along the screen axis of (StepX, StepY) taken from the next or the previous pixel,
+//false if both of them are background
+static bool GetAxisDifference(const DepthImage &Depth, const Matrix &InvProj, int X, int Y, int StepX, int StepY,
+                              NormalReconstruction Method, Float3 &Difference)
+{
+    float center = Depth.At(X, Y);
+    float prev = GetDepth(Depth, X - StepX, Y - StepY);
+    float next = GetDepth(Depth, X + StepX, Y + StepY);
+
+    if(prev <= 0.0f && next <= 0.0f)
+        return false;
+
+    bool takeNext = next > 0.0f;
+
+    if(Method != NORMAL_RECONSTRUCTION_SIMPLE && prev > 0.0f && next > 0.0f){
+
+        float prevError = fabsf(prev - center), nextError = fabsf(next - center);
+
+        if(Method == NORMAL_RECONSTRUCTION_BEST_OF_NEIGHBOURS){
+            //second pixel of a side gives the line the center depth is extrapolated on,
+            //the side past a silhouette keeps the first order error
+            float prev2 = GetDepth(Depth, X - 2 * StepX, Y - 2 * StepY);
+            float next2 = GetDepth(Depth, X + 2 * StepX, Y + 2 * StepY);
+
+            if(prev2 > 0.0f)
+                prevError = fabsf(2.0f * prev - prev2 - center);
+            if(next2 > 0.0f)
+                nextError = fabsf(2.0f * next - next2 - center);
+        }
+
+        takeNext = nextError < prevError;
+    }
+
+    Float3 pos = GetViewPosition(Depth, InvProj, X, Y);
+
+    if(takeNext)
+        Difference = GetViewPosition(Depth, InvProj, X + StepX, Y + StepY) - pos;
+    else
+        Difference = pos - GetViewPosition(Depth, InvProj, X - StepX, Y - StepY);
+
+    return true;
+}
+
+Float3 ReconstructNormal(const DepthImage &Depth, const Matrix &InvProj, int X, int Y, NormalReconstruction Method)
+{
+    const Float3 facingCamera(0.0f, 0.0f, -1.0f);
+
+    Float3 dx, dy;
+    if(!GetAxisDifference(Depth, InvProj, X, Y, 1, 0, Method, dx) || !GetAxisDifference(Depth, InvProj, X, Y, 0, 1, Method, dy))
+        return facingCamera;
+
+    //screen y goes down, so the cross product of the differences faces the camera
+    Float3 normal = Cross(dx, dy);
+    float length = Length(normal);
+
+    return (length > 0.0f) ? normal / length : facingCamera;
+}
+
+void ReconstructNormals(const DepthImage &Depth, const Matrix &InvProj, NormalReconstruction Method,
+                        NormalDepthImage &NormalDepth, ThreadPool *Pool) throw (Exception)
+{
+    if(Depth.GetWidth() == 0 || Depth.GetHeight() == 0)
+        throw CpuRenderingException("Normal reconstruction source is empty");
+
+    if(!NormalDepth.IsSameSize(Depth))
+        NormalDepth.Init(Depth.GetWidth(), Depth.GetHeight());
+
+    ForEachTile(Pool, SplitToTiles(Depth.GetWidth(), Depth.GetHeight(), ReconstructionTileSize), [&](const Tile &Region)
+    {
+        for(int y = Region.top; y < Region.bottom; y++){
+            const float *src = Depth.GetRow(y);
+            Float4 *dst = NormalDepth.GetRow(y);
+
+            for(int x = Region.left; x < Region.right; x++)
+                dst[x] = (src[x] > 0.0f) ? Float4(ReconstructNormal(Depth, InvProj, x, y, Method), src[x]) : Float4(1.0f, 1.0f, 1.0f, 0.0f);
+        }
+    });
+}
+
+void ExtractDepth(const NormalDepthImage &NormalDepth, DepthImage &Depth, ThreadPool *Pool) throw (Exception)
+{
+    if(NormalDepth.GetWidth() == 0 || NormalDepth.GetHeight() == 0)
+        throw CpuRenderingException("Depth source is empty");
+
+    if(!Depth.IsSameSize(NormalDepth))
+        Depth.Init(NormalDepth.GetWidth(), NormalDepth.GetHeight());
+
+    ForEachTile(Pool, SplitToTiles(NormalDepth.GetWidth(), NormalDepth.GetHeight(), ReconstructionTileSize), [&](const Tile &Region)
+    {
+        for(int y = Region.top; y < Region.bottom; y++){
+            const Float4 *src = NormalDepth.GetRow(y);
+            float *dst = Depth.GetRow(y);
+
+            for(int x = Region.left; x < Region.right; x++)
+                dst[x] = src[x].w;
+        }
+    });
+}
+
+}
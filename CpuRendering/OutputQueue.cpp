@@ -0,0 +1,104 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include <CpuRendering/OutputQueue.h>
+#include <CpuRendering/Image.h>
+
+namespace CpuRendering
+{
+
+OutputQueue::OutputQueue(size_t MaxPendingJobs) : maxPendingJobs((MaxPendingJobs > 0) ? MaxPendingJobs : 1)
+{
+    writer = std::thread(&OutputQueue::WriterLoop, this);
+}
+
+OutputQueue::~OutputQueue()
+{
+    try{
+        Finish();
+    }catch(...){
+    }
+}
+
+void OutputQueue::WriterLoop()
+{
+    while(true){
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            jobsCondition.wait(lock, [&]{return finishing || !jobs.empty();});
+
+            if(jobs.empty())
+                return;
+
+            job = jobs.front();
+            jobs.pop_front();
+        }
+        spaceCondition.notify_one();
+
+        try{
+            job();
+        }catch(...){
+            std::lock_guard<std::mutex> lock(mutex);
+            if(!jobException)
+                jobException = std::current_exception();
+            jobs.clear();
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        doneJobs++;
+    }
+}
+
+void OutputQueue::Push(const Job &NewJob) throw (Exception)
+{
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        if(finishing)
+            throw CpuRenderingException("Output queue is finished");
+
+        spaceCondition.wait(lock, [&]{return jobs.size() < maxPendingJobs || jobException;});
+
+        //the failure is reported by Finish
+        if(jobException)
+            return;
+
+        jobs.push_back(NewJob);
+    }
+    jobsCondition.notify_one();
+}
+
+void OutputQueue::Finish()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        finishing = true;
+    }
+    jobsCondition.notify_one();
+
+    if(writer.joinable())
+        writer.join();
+
+    std::exception_ptr exception;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        exception = jobException;
+        jobException = std::exception_ptr();
+    }
+
+    if(exception)
+        std::rethrow_exception(exception);
+}
+
+size_t OutputQueue::GetDoneJobsCount()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return doneJobs;
+}
+
+}
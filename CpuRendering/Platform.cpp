@@ -0,0 +1,469 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include <CpuRendering/Platform.h>
+#include <CpuRendering/Image.h>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <windows.h>
+#pragma comment(lib, "ws2_32.lib")
+#else
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+#include <errno.h>
+#endif
+
+namespace CpuRendering
+{
+
+#if defined(_WIN32)
+
+typedef SOCKET SocketHandle;
+static const intptr_t InvalidSocket = (intptr_t)INVALID_SOCKET;
+
+static void CloseSocket(SocketHandle Handle) {closesocket(Handle);}
+
+//WSAStartup before main, the farm may open the sockets from several threads
+struct WinsockInitializer
+{
+    WinsockInitializer()
+    {
+        WSADATA data;
+        WSAStartup(MAKEWORD(2, 2), &data);
+    }
+    ~WinsockInitializer(){WSACleanup();}
+};
+
+static WinsockInitializer Winsock;
+
+#else
+
+typedef int SocketHandle;
+static const intptr_t InvalidSocket = -1;
+
+static void CloseSocket(SocketHandle Handle) {close(Handle);}
+
+//writes to a socket of a dead worker fail with EPIPE instead of killing the coordinator
+struct SigPipeIgnorer
+{
+    SigPipeIgnorer(){signal(SIGPIPE, SIG_IGN);}
+};
+
+static SigPipeIgnorer SigPipe;
+
+#endif
+
+void MappedFile::Open(const std::string &FileName) throw (Exception)
+{
+    Close();
+
+#if defined(_WIN32)
+    HANDLE fileHandle = CreateFileA(FileName.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if(fileHandle == INVALID_HANDLE_VALUE)
+        throw CpuRenderingException("Can't open mapped file " + FileName);
+
+    file = (intptr_t)fileHandle;
+
+    LARGE_INTEGER fileSize;
+    if(!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0 || (ULONGLONG)fileSize.QuadPart > (size_t)-1){
+        Close();
+        throw CpuRenderingException("Can't map empty or too large file " + FileName);
+    }
+
+    HANDLE mappingHandle = CreateFileMappingA(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+    if(mappingHandle == NULL){
+        Close();
+        throw CpuRenderingException("Can't map file " + FileName);
+    }
+
+    mapping = (intptr_t)mappingHandle;
+
+    data = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+    if(data == NULL){
+        Close();
+        throw CpuRenderingException("Can't map file " + FileName);
+    }
+
+    size = (size_t)fileSize.QuadPart;
+#else
+    int fd = open(FileName.c_str(), O_RDONLY);
+    if(fd < 0)
+        throw CpuRenderingException("Can't open mapped file " + FileName);
+
+    file = fd;
+
+    struct stat fileStat;
+    if(fstat(fd, &fileStat) != 0 || fileStat.st_size == 0){
+        Close();
+        throw CpuRenderingException("Can't map empty file " + FileName);
+    }
+
+    void *view = mmap(NULL, (size_t)fileStat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    if(view == MAP_FAILED){
+        Close();
+        throw CpuRenderingException("Can't map file " + FileName);
+    }
+
+    data = view;
+    size = (size_t)fileStat.st_size;
+#endif
+}
+
+void MappedFile::Close()
+{
+#if defined(_WIN32)
+    if(data != NULL)
+        UnmapViewOfFile(data);
+    if(mapping != -1)
+        CloseHandle((HANDLE)mapping);
+    if(file != -1)
+        CloseHandle((HANDLE)file);
+#else
+    if(data != NULL)
+        munmap(const_cast<void*>(data), size);
+    if(file != -1)
+        close((int)file);
+#endif
+
+    data = NULL;
+    size = 0;
+    file = mapping = -1;
+}
+
+Socket &Socket::operator= (Socket &&Other)
+{
+    if(this != &Other){
+        Close();
+        handle = Other.handle;
+        Other.handle = -1;
+    }
+
+    return *this;
+}
+
+//job headers are small, Nagle would hold them back until the previous result is acknowledged
+static void SetNoDelay(SocketHandle Handle)
+{
+    int noDelay = 1;
+    setsockopt(Handle, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+}
+
+void Socket::Listen(unsigned short Port) throw (Exception)
+{
+    Close();
+
+    SocketHandle listener = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if((intptr_t)listener == InvalidSocket)
+        throw CpuRenderingException("Can't create socket");
+
+    handle = (intptr_t)listener;
+
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(Port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    if(bind(listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 || listen(listener, SOMAXCONN) != 0){
+        Close();
+        throw CpuRenderingException("Can't listen on port " + std::to_string(Port));
+    }
+}
+
+unsigned short Socket::GetPort() const throw (Exception)
+{
+    sockaddr_in address = {};
+    socklen_t length = sizeof(address);
+
+    if(getsockname((SocketHandle)handle, reinterpret_cast<sockaddr*>(&address), &length) != 0)
+        throw CpuRenderingException("Can't get the socket port");
+
+    return ntohs(address.sin_port);
+}
+
+bool Socket::Accept(int TimeoutMs, Socket &Connection) throw (Exception)
+{
+#if defined(_WIN32)
+    fd_set readSet;
+    FD_ZERO(&readSet);
+    FD_SET((SocketHandle)handle, &readSet);
+
+    timeval timeout = {TimeoutMs / 1000, (TimeoutMs % 1000) * 1000};
+    int ready = select(0, &readSet, NULL, NULL, &timeout);
+#else
+    pollfd pollData = {(int)handle, POLLIN, 0};
+    int ready = poll(&pollData, 1, TimeoutMs);
+#endif
+
+    if(ready < 0)
+        throw CpuRenderingException("Can't wait for a connection");
+
+    if(ready == 0)
+        return false;
+
+    SocketHandle accepted = accept((SocketHandle)handle, NULL, NULL);
+    if((intptr_t)accepted == InvalidSocket)
+        throw CpuRenderingException("Can't accept a connection");
+
+    SetNoDelay(accepted);
+
+    Connection.Close();
+    Connection.handle = (intptr_t)accepted;
+
+    return true;
+}
+
+void Socket::Connect(const std::string &Host, unsigned short Port) throw (Exception)
+{
+    Close();
+
+    SocketHandle connection = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if((intptr_t)connection == InvalidSocket)
+        throw CpuRenderingException("Can't create socket");
+
+    handle = (intptr_t)connection;
+
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(Port);
+
+    if(inet_pton(AF_INET, Host.c_str(), &address.sin_addr) != 1 ||
+       connect(connection, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0){
+        Close();
+        throw CpuRenderingException("Can't connect to " + Host + ":" + std::to_string(Port));
+    }
+
+    SetNoDelay(connection);
+}
+
+void Socket::SendAll(const void *Data, size_t Size) throw (Exception)
+{
+    const char *bytes = static_cast<const char*>(Data);
+
+    while(Size > 0){
+        int chunk = (Size > (1 << 20)) ? (1 << 20) : (int)Size;
+#if defined(_WIN32)
+        int sent = send((SocketHandle)handle, bytes, chunk, 0);
+#elif defined(MSG_NOSIGNAL)
+        int sent = (int)send((SocketHandle)handle, bytes, chunk, MSG_NOSIGNAL);
+#else
+        int sent = (int)send((SocketHandle)handle, bytes, chunk, 0);
+#endif
+        if(sent <= 0){
+#if !defined(_WIN32)
+            if(sent < 0 && errno == EINTR)
+                continue;
+#endif
+            throw CpuRenderingException("Connection is lost while sending");
+        }
+
+        bytes += sent;
+        Size -= sent;
+    }
+}
+
+void Socket::ReceiveAll(void *Data, size_t Size) throw (Exception)
+{
+    char *bytes = static_cast<char*>(Data);
+
+    while(Size > 0){
+        int chunk = (Size > (1 << 20)) ? (1 << 20) : (int)Size;
+        int received = (int)recv((SocketHandle)handle, bytes, chunk, 0);
+
+        if(received <= 0){
+#if !defined(_WIN32)
+            if(received < 0 && errno == EINTR)
+                continue;
+#endif
+            throw CpuRenderingException("Connection is lost while receiving");
+        }
+
+        bytes += received;
+        Size -= received;
+    }
+}
+
+void Socket::Close()
+{
+    if(handle != -1)
+        CloseSocket((SocketHandle)handle);
+
+    handle = -1;
+}
+
+#if defined(_WIN32)
+
+//quotes an argument for CommandLineToArgvW and the CRT parser
+static std::string QuoteArgument(const std::string &Argument)
+{
+    if(!Argument.empty() && Argument.find_first_of(" \t\"") == std::string::npos)
+        return Argument;
+
+    std::string quoted = "\"";
+    size_t backslashes = 0;
+
+    for(char c : Argument){
+        if(c == '\\'){
+            backslashes++;
+            continue;
+        }
+
+        quoted.append((c == '"') ? backslashes * 2 + 1 : backslashes, '\\');
+        quoted += c;
+        backslashes = 0;
+    }
+
+    quoted.append(backslashes * 2, '\\');
+    quoted += '"';
+
+    return quoted;
+}
+
+void ChildProcess::Start(const std::vector<std::string> &Arguments) throw (Exception)
+{
+    Kill();
+
+    if(Arguments.empty())
+        throw CpuRenderingException("Process executable is not set");
+
+    std::string commandLine;
+    for(const std::string &argument : Arguments)
+        commandLine += ((commandLine.empty()) ? "" : " ") + QuoteArgument(argument);
+
+    STARTUPINFOA startupInfo = {};
+    startupInfo.cb = sizeof(startupInfo);
+    PROCESS_INFORMATION processInfo = {};
+
+    if(!CreateProcessA(Arguments[0].c_str(), &commandLine[0], NULL, NULL, FALSE, 0, NULL, NULL, &startupInfo, &processInfo))
+        throw CpuRenderingException("Can't start process " + Arguments[0]);
+
+    CloseHandle(processInfo.hThread);
+    handle = (intptr_t)processInfo.hProcess;
+}
+
+int ChildProcess::Wait()
+{
+    if(handle == -1)
+        return -1;
+
+    DWORD exitCode = (DWORD)-1;
+    WaitForSingleObject((HANDLE)handle, INFINITE);
+    GetExitCodeProcess((HANDLE)handle, &exitCode);
+
+    CloseHandle((HANDLE)handle);
+    handle = -1;
+
+    return (int)exitCode;
+}
+
+void ChildProcess::Kill()
+{
+    if(handle == -1)
+        return;
+
+    TerminateProcess((HANDLE)handle, 1);
+    Wait();
+}
+
+std::string GetExecutablePath() throw (Exception)
+{
+    char path[MAX_PATH];
+    DWORD length = GetModuleFileNameA(NULL, path, MAX_PATH);
+
+    if(length == 0 || length == MAX_PATH)
+        throw CpuRenderingException("Can't get the executable path");
+
+    return std::string(path, length);
+}
+
+void ExitImmediately(int ExitCode)
+{
+    TerminateProcess(GetCurrentProcess(), (UINT)ExitCode);
+}
+
+#else
+
+void ChildProcess::Start(const std::vector<std::string> &Arguments) throw (Exception)
+{
+    Kill();
+
+    if(Arguments.empty())
+        throw CpuRenderingException("Process executable is not set");
+
+    std::vector<char*> argv;
+    for(const std::string &argument : Arguments)
+        argv.push_back(const_cast<char*>(argument.c_str()));
+    argv.push_back(NULL);
+
+    pid_t pid = fork();
+
+    if(pid < 0)
+        throw CpuRenderingException("Can't start process " + Arguments[0]);
+
+    if(pid == 0){
+        execv(argv[0], &argv[0]);
+        _exit(127);
+    }
+
+    handle = pid;
+}
+
+int ChildProcess::Wait()
+{
+    if(handle == -1)
+        return -1;
+
+    int status = 0;
+    while(waitpid((pid_t)handle, &status, 0) < 0 && errno == EINTR);
+
+    handle = -1;
+
+    return (WIFEXITED(status)) ? WEXITSTATUS(status) : -1;
+}
+
+void ChildProcess::Kill()
+{
+    if(handle == -1)
+        return;
+
+    kill((pid_t)handle, SIGKILL);
+    Wait();
+}
+
+std::string GetExecutablePath() throw (Exception)
+{
+    char path[4096];
+    ssize_t length = readlink("/proc/self/exe", path, sizeof(path));
+
+    if(length <= 0 || length == (ssize_t)sizeof(path))
+        throw CpuRenderingException("Can't get the executable path");
+
+    return std::string(path, (size_t)length);
+}
+
+void ExitImmediately(int ExitCode)
+{
+    _exit(ExitCode);
+}
+
+#endif
+
+}
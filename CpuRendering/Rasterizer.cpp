@@ -0,0 +1,475 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include <CpuRendering/Rasterizer.h>
+#include <emmintrin.h>
+#include <algorithm>
+#include <math.h>
+
+namespace CpuRendering
+{
+
+static const int VerticesTaskSize = 16384;
+static const int SubpixelBits = 8;
+static const int64_t SubpixelSize = 1 << SubpixelBits;
+
+//planes of the clip space, the first ones clip and the viewport ones only cull
+enum ClipPlane
+{
+    CLIP_PLANE_NEAR,
+    CLIP_PLANE_FAR,
+    CLIP_PLANE_GUARD_LEFT,
+    CLIP_PLANE_GUARD_RIGHT,
+    CLIP_PLANE_GUARD_BOTTOM,
+    CLIP_PLANE_GUARD_TOP,
+    CLIP_PLANE_LEFT,
+    CLIP_PLANE_RIGHT,
+    CLIP_PLANE_BOTTOM,
+    CLIP_PLANE_TOP,
+    CLIP_PLANES_COUNT
+};
+
+static const int ClippingPlanesCount = CLIP_PLANE_GUARD_TOP + 1;
+static const unsigned int ClippingPlanesMask = (1 << ClippingPlanesCount) - 1;
+//a triangle split by all clipping planes
+static const int MaxClippedVertices = 3 + ClippingPlanesCount;
+
+static float GetPlaneDistance(const Float4 &Pos, int Plane)
+{
+    const float guard = (float)NormalDepthRasterizer::GuardBand;
+
+    switch(Plane){
+        case CLIP_PLANE_NEAR: return Pos.z;
+        case CLIP_PLANE_FAR: return Pos.w - Pos.z;
+        case CLIP_PLANE_GUARD_LEFT: return guard * Pos.w + Pos.x;
+        case CLIP_PLANE_GUARD_RIGHT: return guard * Pos.w - Pos.x;
+        case CLIP_PLANE_GUARD_BOTTOM: return guard * Pos.w + Pos.y;
+        case CLIP_PLANE_GUARD_TOP: return guard * Pos.w - Pos.y;
+        case CLIP_PLANE_LEFT: return Pos.w + Pos.x;
+        case CLIP_PLANE_RIGHT: return Pos.w - Pos.x;
+        case CLIP_PLANE_BOTTOM: return Pos.w + Pos.y;
+        default: return Pos.w - Pos.y;
+    }
+}
+
+static unsigned int GetOutCode(const Float4 &Pos)
+{
+    const float guard = (float)NormalDepthRasterizer::GuardBand;
+
+    return (Pos.z < 0.0f) << CLIP_PLANE_NEAR | (Pos.w - Pos.z < 0.0f) << CLIP_PLANE_FAR |
+           (guard * Pos.w + Pos.x < 0.0f) << CLIP_PLANE_GUARD_LEFT | (guard * Pos.w - Pos.x < 0.0f) << CLIP_PLANE_GUARD_RIGHT |
+           (guard * Pos.w + Pos.y < 0.0f) << CLIP_PLANE_GUARD_BOTTOM | (guard * Pos.w - Pos.y < 0.0f) << CLIP_PLANE_GUARD_TOP |
+           (Pos.w + Pos.x < 0.0f) << CLIP_PLANE_LEFT | (Pos.w - Pos.x < 0.0f) << CLIP_PLANE_RIGHT |
+           (Pos.w + Pos.y < 0.0f) << CLIP_PLANE_BOTTOM | (Pos.w - Pos.y < 0.0f) << CLIP_PLANE_TOP;
+}
+
+//lanes of the 4 pixels of a group as the float masks, bit i - lane i
+static __m128 GetLanesMask(int Bits)
+{
+    return _mm_castsi128_ps(_mm_set_epi32((Bits & 8) ? -1 : 0, (Bits & 4) ? -1 : 0, (Bits & 2) ? -1 : 0, (Bits & 1) ? -1 : 0));
+}
+
+PrepassTransforms CreatePrepassTransforms(const Matrix &World, const Matrix &View, const Matrix &Proj)
+{
+    PrepassTransforms transforms;
+    transforms.worldView = Mul(World, View);
+    transforms.worldViewProj = Mul(transforms.worldView, Proj);
+    transforms.worldInvTransView = Mul(Transpose(Inverse(World)), View);
+
+    return transforms;
+}
+
+void NormalDepthRasterizer::Clear(int Width, int Height, NormalDepthImage &NormalDepth) throw (Exception)
+{
+    if(Width <= 0 || Height <= 0)
+        throw CpuRenderingException("Rasterizer target is empty");
+
+    width = Width;
+    height = Height;
+    //groups of 4 pixels never cross the rows
+    depthStride = (Width + 3) & ~3;
+    tilesX = (Width + TileSize - 1) / TileSize;
+    tilesY = (Height + TileSize - 1) / TileSize;
+
+    depth.assign((size_t)depthStride * Height, 1.0f);
+    NormalDepth.Init(Width, Height, Float4(1.0f, 1.0f, 1.0f, 0.0f));
+}
+
+void NormalDepthRasterizer::Draw(const MeshView &Mesh, const PrepassTransforms &Transforms, NormalDepthImage &NormalDepth) throw (Exception)
+{
+    if(depth.empty() || !NormalDepth.IsSameSize(width, height))
+        throw CpuRenderingException("Rasterizer target is not cleared");
+
+    if(Mesh.indicesCount % 3 != 0)
+        throw CpuRenderingException("Rasterizer mesh is not a triangle list");
+
+    for(size_t i = 0; i < Mesh.indicesCount; i++)
+        if(Mesh.indices[i] >= Mesh.verticesCount)
+            throw CpuRenderingException("Rasterizer mesh index is out of range");
+
+    //NormalVDepthV.vs, the ranges of the vertices are the rows of a single column
+    vertices.resize(Mesh.verticesCount);
+
+    ForEachTile(pool, SplitToRows(1, (int)Mesh.verticesCount, VerticesTaskSize), [&](const Tile &Range)
+    {
+        const Matrix &worldViewProj = Transforms.worldViewProj, &worldInvTransView = Transforms.worldInvTransView, &worldView = Transforms.worldView;
+
+        for(int v = Range.top; v < Range.bottom; v++){
+            const Float3 &pos = Mesh.vertices[v].pos, &normal = Mesh.vertices[v].normal;
+            ClipVertex &dst = vertices[v];
+
+            dst.pos = Transform(Float4(pos, 1.0f), worldViewProj);
+            dst.normal = Float3(normal.x * worldInvTransView.m[0][0] + normal.y * worldInvTransView.m[1][0] + normal.z * worldInvTransView.m[2][0],
+                                normal.x * worldInvTransView.m[0][1] + normal.y * worldInvTransView.m[1][1] + normal.z * worldInvTransView.m[2][1],
+                                normal.x * worldInvTransView.m[0][2] + normal.y * worldInvTransView.m[1][2] + normal.z * worldInvTransView.m[2][2]);
+            dst.viewZ = pos.x * worldView.m[0][2] + pos.y * worldView.m[1][2] + pos.z * worldView.m[2][2] + worldView.m[3][2];
+            dst.outCode = GetOutCode(dst.pos);
+
+            if((dst.outCode & ClippingPlanesMask) == 0)
+                ProjectVertex(dst);
+        }
+    });
+
+    size_t trianglesCount = Mesh.GetTrianglesCount();
+    size_t chunksCount = (trianglesCount + ChunkSize - 1) / ChunkSize;
+    size_t tilesCount = (size_t)tilesX * tilesY;
+
+    triangles.resize(chunksCount);
+    bins.resize(chunksCount);
+    chunkCounters.assign(chunksCount, RasterizerCounters());
+
+    ForEachTile(pool, SplitToRows(1, (int)chunksCount, 1), [&](const Tile &Range)
+    {
+        size_t chunk = Range.top;
+
+        triangles[chunk].clear();
+        bins[chunk].resize(tilesCount);
+
+        for(std::vector<uint32_t> &bin : bins[chunk])
+            bin.clear();
+
+        size_t last = std::min((chunk + 1) * ChunkSize, trianglesCount);
+
+        for(size_t t = chunk * ChunkSize; t < last; t++){
+            const unsigned int *index = &Mesh.indices[t * 3];
+            SetupTriangle(vertices[index[0]], vertices[index[1]], vertices[index[2]], chunk);
+        }
+    });
+
+    counters = RasterizerCounters();
+    counters.triangles = trianglesCount;
+
+    for(const RasterizerCounters &chunk : chunkCounters){
+        counters.culled += chunk.culled;
+        counters.clipped += chunk.clipped;
+        counters.binned += chunk.binned;
+    }
+
+    ForEachTile(pool, SplitToTiles(tilesX, tilesY, 1), [&](const Tile &Region)
+    {
+        RasterizeTile(Region.left, Region.top, NormalDepth);
+    });
+}
+
+void NormalDepthRasterizer::SetupTriangle(const ClipVertex &A, const ClipVertex &B, const ClipVertex &C, size_t Chunk)
+{
+    unsigned int codes[3] = {A.outCode, B.outCode, C.outCode};
+
+    if(codes[0] & codes[1] & codes[2]){
+        chunkCounters[Chunk].culled++;
+        return;
+    }
+
+    if(((codes[0] | codes[1] | codes[2]) & ClippingPlanesMask) == 0){
+        AddTriangle(A, B, C, Chunk);
+        return;
+    }
+
+    chunkCounters[Chunk].clipped++;
+
+    //Sutherland-Hodgman in the clip space, the attributes are linear there
+    ClipVertex polygons[2][MaxClippedVertices];
+    int count = 3, current = 0;
+
+    polygons[0][0] = A;
+    polygons[0][1] = B;
+    polygons[0][2] = C;
+
+    for(int plane = 0; plane < ClippingPlanesCount && count > 0; plane++){
+
+        if(((codes[0] | codes[1] | codes[2]) & (1 << plane)) == 0)
+            continue;
+
+        const ClipVertex *src = polygons[current];
+        ClipVertex *dst = polygons[1 - current];
+        int dstCount = 0;
+
+        for(int v = 0; v < count; v++){
+            const ClipVertex &first = src[v], &second = src[(v + 1) % count];
+            float firstDistance = GetPlaneDistance(first.pos, plane), secondDistance = GetPlaneDistance(second.pos, plane);
+
+            if(firstDistance >= 0.0f)
+                dst[dstCount++] = first;
+
+            if((firstDistance >= 0.0f) != (secondDistance >= 0.0f)){
+                float factor = firstDistance / (firstDistance - secondDistance);
+
+                ClipVertex &vertex = dst[dstCount++];
+                vertex.pos = first.pos + (second.pos - first.pos) * factor;
+                vertex.normal = first.normal + (second.normal - first.normal) * factor;
+                vertex.viewZ = Lerp(first.viewZ, second.viewZ, factor);
+                vertex.outCode = 0;
+            }
+        }
+
+        count = dstCount;
+        current = 1 - current;
+    }
+
+    for(int v = 0; v < count; v++)
+        ProjectVertex(polygons[current][v]);
+
+    for(int v = 2; v < count; v++)
+        AddTriangle(polygons[current][0], polygons[current][v - 1], polygons[current][v], Chunk);
+}
+
+void NormalDepthRasterizer::ProjectVertex(ClipVertex &Vertex) const
+{
+    //viewport transform of D3D11, y goes down
+    double invW = 1.0 / Vertex.pos.w;
+    double screenX = (Vertex.pos.x * invW * 0.5 + 0.5) * width;
+    double screenY = (0.5 - Vertex.pos.y * invW * 0.5) * height;
+
+    Vertex.screenX = (int64_t)floor(screenX * SubpixelSize + 0.5);
+    Vertex.screenY = (int64_t)floor(screenY * SubpixelSize + 0.5);
+    Vertex.invW = (float)invW;
+}
+
+void NormalDepthRasterizer::AddTriangle(const ClipVertex &A, const ClipVertex &B, const ClipVertex &C, size_t Chunk)
+{
+    const ClipVertex *src[3] = {&A, &B, &C};
+
+    RasterTriangle triangle;
+
+    for(int v = 0; v < 3; v++){
+        triangle.x[v] = src[v]->screenX;
+        triangle.y[v] = src[v]->screenY;
+    }
+
+    int64_t area = (triangle.x[1] - triangle.x[0]) * (triangle.y[2] - triangle.y[0]) - (triangle.y[1] - triangle.y[0]) * (triangle.x[2] - triangle.x[0]);
+
+    if(area == 0){
+        chunkCounters[Chunk].culled++;
+        return;
+    }
+
+    int order[3] = {0, 1, 2};
+
+    //counter clockwise triangles are drawn too, their vertices are swapped to the clockwise order
+    if(area < 0){
+        order[1] = 2;
+        order[2] = 1;
+        std::swap(triangle.x[1], triangle.x[2]);
+        std::swap(triangle.y[1], triangle.y[2]);
+    }
+
+    int64_t minX = std::min(triangle.x[0], std::min(triangle.x[1], triangle.x[2]));
+    int64_t maxX = std::max(triangle.x[0], std::max(triangle.x[1], triangle.x[2]));
+    int64_t minY = std::min(triangle.y[0], std::min(triangle.y[1], triangle.y[2]));
+    int64_t maxY = std::max(triangle.y[0], std::max(triangle.y[1], triangle.y[2]));
+
+    //pixels whose centers are inside the bounds
+    const int64_t half = SubpixelSize / 2;
+    triangle.minX = (int)std::max<int64_t>((minX - half + SubpixelSize - 1) >> SubpixelBits, 0);
+    triangle.maxX = (int)std::min<int64_t>((maxX - half) >> SubpixelBits, width - 1);
+    triangle.minY = (int)std::max<int64_t>((minY - half + SubpixelSize - 1) >> SubpixelBits, 0);
+    triangle.maxY = (int)std::min<int64_t>((maxY - half) >> SubpixelBits, height - 1);
+
+    if(triangle.minX > triangle.maxX || triangle.minY > triangle.maxY){
+        chunkCounters[Chunk].culled++;
+        return;
+    }
+
+    for(int e = 0; e < 3; e++){
+        int64_t dx = triangle.x[(e + 1) % 3] - triangle.x[e];
+        int64_t dy = triangle.y[(e + 1) % 3] - triangle.y[e];
+
+        bool topLeft = dy < 0 || (dy == 0 && dx > 0);
+        triangle.bias[e] = (topLeft) ? 0 : -1;
+    }
+
+    double values[3][ATTRIBUTES_COUNT];
+
+    for(int v = 0; v < 3; v++){
+        const ClipVertex &vertex = *src[order[v]];
+        double w = vertex.invW;
+
+        values[v][ATTRIBUTE_DEPTH] = vertex.pos.z * w;
+        values[v][ATTRIBUTE_INV_W] = w;
+        values[v][ATTRIBUTE_NORMAL_X] = vertex.normal.x * w;
+        values[v][ATTRIBUTE_NORMAL_Y] = vertex.normal.y * w;
+        values[v][ATTRIBUTE_NORMAL_Z] = vertex.normal.z * w;
+        values[v][ATTRIBUTE_VIEW_Z] = vertex.viewZ * w;
+    }
+
+    //gradients of the snapped triangle, the coverage is of the snapped one too
+    double originX = (double)triangle.x[0] / SubpixelSize, originY = (double)triangle.y[0] / SubpixelSize;
+    double d1x = (double)triangle.x[1] / SubpixelSize - originX, d1y = (double)triangle.y[1] / SubpixelSize - originY;
+    double d2x = (double)triangle.x[2] / SubpixelSize - originX, d2y = (double)triangle.y[2] / SubpixelSize - originY;
+    double det = d1x * d2y - d1y * d2x;
+
+    triangle.originX = (float)originX;
+    triangle.originY = (float)originY;
+
+    for(int a = 0; a < ATTRIBUTES_COUNT; a++){
+        double da1 = values[1][a] - values[0][a], da2 = values[2][a] - values[0][a];
+
+        triangle.planes[a][0] = (float)values[0][a];
+        triangle.planes[a][1] = (float)((da1 * d2y - da2 * d1y) / det);
+        triangle.planes[a][2] = (float)((da2 * d1x - da1 * d2x) / det);
+    }
+
+    std::vector<RasterTriangle> &chunkTriangles = triangles[Chunk];
+    uint32_t index = (uint32_t)chunkTriangles.size();
+
+    chunkTriangles.push_back(triangle);
+
+    for(int tileY = triangle.minY / TileSize; tileY <= triangle.maxY / TileSize; tileY++)
+        for(int tileX = triangle.minX / TileSize; tileX <= triangle.maxX / TileSize; tileX++){
+            bins[Chunk][(size_t)tileY * tilesX + tileX].push_back(index);
+            chunkCounters[Chunk].binned++;
+        }
+}
+
+void NormalDepthRasterizer::RasterizeTile(int TileX, int TileY, NormalDepthImage &NormalDepth)
+{
+    size_t tileIndex = (size_t)TileY * tilesX + TileX;
+
+    int tileLeft = TileX * TileSize, tileTop = TileY * TileSize;
+    int tileRight = std::min(tileLeft + TileSize, width) - 1, tileBottom = std::min(tileTop + TileSize, height) - 1;
+
+    const __m128 laneOffsets = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+
+    for(size_t chunk = 0; chunk < bins.size(); chunk++)
+        for(uint32_t triangleIndex : bins[chunk][tileIndex]){
+
+            const RasterTriangle &triangle = triangles[chunk][triangleIndex];
+
+            int left = std::max(triangle.minX, tileLeft), right = std::min(triangle.maxX, tileRight);
+            int top = std::max(triangle.minY, tileTop), bottom = std::min(triangle.maxY, tileBottom);
+
+            //groups of 4 pixels start at the multiples of 4, they stay in the tile
+            int groupLeft = left & ~3;
+
+            //E = dx * (py - y0) - dy * (px - x0) of the first 2 and the last 2 pixels of the first group,
+            //the groups step by 4 pixels and the rows by one
+            __m128i rowEdgesLow[3], rowEdgesHigh[3], groupSteps[3], rowSteps[3];
+
+            int64_t centerX = (int64_t)groupLeft * SubpixelSize + SubpixelSize / 2;
+            int64_t centerY = (int64_t)top * SubpixelSize + SubpixelSize / 2;
+
+            for(int e = 0; e < 3; e++){
+                int next = (e + 1) % 3;
+                int64_t dx = triangle.x[next] - triangle.x[e], dy = triangle.y[next] - triangle.y[e];
+                int64_t value = dx * (centerY - triangle.y[e]) - dy * (centerX - triangle.x[e]) + triangle.bias[e];
+                int64_t step = -dy * SubpixelSize;
+
+                int64_t low[2] = {value, value + step}, high[2] = {value + 2 * step, value + 3 * step};
+                int64_t groupStep[2] = {4 * step, 4 * step}, rowStep[2] = {dx * SubpixelSize, dx * SubpixelSize};
+
+                rowEdgesLow[e] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(low));
+                rowEdgesHigh[e] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(high));
+                groupSteps[e] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(groupStep));
+                rowSteps[e] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rowStep));
+            }
+
+            __m128 planeX[ATTRIBUTES_COUNT];
+            for(int a = 0; a < ATTRIBUTES_COUNT; a++)
+                planeX[a] = _mm_set1_ps(triangle.planes[a][1]);
+
+            for(int y = top; y <= bottom; y++){
+
+                __m128i edgesLow[3], edgesHigh[3];
+
+                for(int e = 0; e < 3; e++){
+                    edgesLow[e] = rowEdgesLow[e];
+                    edgesHigh[e] = rowEdgesHigh[e];
+                    rowEdgesLow[e] = _mm_add_epi64(rowEdgesLow[e], rowSteps[e]);
+                    rowEdgesHigh[e] = _mm_add_epi64(rowEdgesHigh[e], rowSteps[e]);
+                }
+
+                float relativeY = (float)y + 0.5f - triangle.originY;
+                __m128 rowValues[ATTRIBUTES_COUNT];
+
+                for(int a = 0; a < ATTRIBUTES_COUNT; a++)
+                    rowValues[a] = _mm_set1_ps(triangle.planes[a][0] + triangle.planes[a][2] * relativeY);
+
+                float *depthRow = &depth[(size_t)y * depthStride];
+                Float4 *dst = NormalDepth.GetRow(y);
+
+                for(int x = groupLeft; x <= right; x += 4){
+
+                    //sign bits of the 64 bit lanes are the ones of the doubles
+                    __m128i outsideLow = _mm_or_si128(_mm_or_si128(edgesLow[0], edgesLow[1]), edgesLow[2]);
+                    __m128i outsideHigh = _mm_or_si128(_mm_or_si128(edgesHigh[0], edgesHigh[1]), edgesHigh[2]);
+
+                    int covered = ~(_mm_movemask_pd(_mm_castsi128_pd(outsideLow)) | (_mm_movemask_pd(_mm_castsi128_pd(outsideHigh)) << 2)) & 15;
+
+                    //pixels out of the bounds of the tile part
+                    if(x < left)
+                        covered &= 15 << (left - x);
+                    if(x + 3 > right)
+                        covered &= 15 >> (x + 3 - right);
+
+                    if(covered){
+
+                        __m128 relativeX = _mm_add_ps(_mm_set1_ps((float)x - triangle.originX), laneOffsets);
+                        __m128 z = _mm_add_ps(rowValues[ATTRIBUTE_DEPTH], _mm_mul_ps(planeX[ATTRIBUTE_DEPTH], relativeX));
+                        __m128 oldZ = _mm_loadu_ps(depthRow + x);
+
+                        __m128 passed = _mm_and_ps(_mm_cmplt_ps(z, oldZ), GetLanesMask(covered));
+                        int passedBits = _mm_movemask_ps(passed);
+
+                        if(passedBits){
+                            _mm_storeu_ps(depthRow + x, _mm_or_ps(_mm_and_ps(passed, z), _mm_andnot_ps(passed, oldZ)));
+
+                            __m128 values[ATTRIBUTES_COUNT];
+                            for(int a = ATTRIBUTE_INV_W; a < ATTRIBUTES_COUNT; a++)
+                                values[a] = _mm_add_ps(rowValues[a], _mm_mul_ps(planeX[a], relativeX));
+
+                            __m128 w = _mm_div_ps(_mm_set1_ps(1.0f), values[ATTRIBUTE_INV_W]);
+                            __m128 nx = _mm_mul_ps(values[ATTRIBUTE_NORMAL_X], w);
+                            __m128 ny = _mm_mul_ps(values[ATTRIBUTE_NORMAL_Y], w);
+                            __m128 nz = _mm_mul_ps(values[ATTRIBUTE_NORMAL_Z], w);
+                            __m128 viewZ = _mm_mul_ps(values[ATTRIBUTE_VIEW_Z], w);
+
+                            //normalize(input.normalV) of NormalVDepthV.ps
+                            __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, nx), _mm_mul_ps(ny, ny)), _mm_mul_ps(nz, nz)));
+                            __m128 invLength = _mm_div_ps(_mm_set1_ps(1.0f), length);
+
+                            float lanes[4][4];
+                            _mm_storeu_ps(lanes[0], _mm_mul_ps(nx, invLength));
+                            _mm_storeu_ps(lanes[1], _mm_mul_ps(ny, invLength));
+                            _mm_storeu_ps(lanes[2], _mm_mul_ps(nz, invLength));
+                            _mm_storeu_ps(lanes[3], viewZ);
+
+                            for(int lane = 0; lane < 4; lane++)
+                                if(passedBits & (1 << lane))
+                                    dst[x + lane] = Float4(lanes[0][lane], lanes[1][lane], lanes[2][lane], lanes[3][lane]);
+                        }
+                    }
+
+                    for(int e = 0; e < 3; e++){
+                        edgesLow[e] = _mm_add_epi64(edgesLow[e], groupSteps[e]);
+                        edgesHigh[e] = _mm_add_epi64(edgesHigh[e], groupSteps[e]);
+                    }
+                }
+            }
+        }
+}
+
+}
@@ -0,0 +1,411 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include <CpuRendering/RenderFarm.h>
+#include <CpuRendering/NormalDepthCodec.h>
+#include <CpuRendering/Platform.h>
+#include <CpuRendering/Stopwatch.h>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+
+namespace CpuRendering
+{
+
+static const int FarmRowsChunk = 16;
+
+static const uint32_t FarmMessageJob = 1;
+static const uint32_t FarmMessageResult = 2;
+static const uint32_t FarmMessageQuit = 3;
+
+//follows FarmMessageJob
+struct FarmJobMessage
+{
+    uint32_t jobId;
+    uint32_t view;
+    int32_t left, top, right, bottom;
+    float viewMatrix[16];
+};
+
+//follows FarmMessageResult, the R8 rows of the tile come after it
+struct FarmResultMessage
+{
+    uint32_t jobId;
+    uint32_t size;
+};
+
+static Tile GrowTile(const Tile &Region, int GrowX, int GrowY, int Width, int Height)
+{
+    return Tile((Region.left - GrowX < 0) ? 0 : Region.left - GrowX,
+                (Region.top - GrowY < 0) ? 0 : Region.top - GrowY,
+                (Region.right + GrowX > Width) ? Width : Region.right + GrowX,
+                (Region.bottom + GrowY > Height) ? Height : Region.bottom + GrowY);
+}
+
+//row bands of Region
+template<class TFunction>
+static void ForEachRegionRows(ThreadPool *Pool, const Tile &Region, const TFunction &Function)
+{
+    TilesStorage bands = SplitToRows(Region.GetWidth(), Region.GetHeight(), FarmRowsChunk);
+
+    ForEachTile(Pool, bands, [&](const Tile &Band)
+    {
+        Function(Tile(Region.left + Band.left, Region.top + Band.top, Region.left + Band.right, Region.top + Band.bottom));
+    });
+}
+
+void RenderAOTile(const NormalDepthImage &NormalDepth, const BatchAOParams &Params, const Tile &Region, OcclusionImage &Occlusion,
+                  OcclusionImage &Intermediate, ThreadPool *Pool) throw (Exception)
+{
+    int width = NormalDepth.GetWidth(), height = NormalDepth.GetHeight();
+
+    if(Region.left < 0 || Region.top < 0 || Region.right > width || Region.bottom > height || Region.GetWidth() <= 0 || Region.GetHeight() <= 0)
+        throw CpuRenderingException("AO tile is out of the view");
+
+    if(Params.ssao.kernel.empty() || Params.ssao.randomOffsets.GetWidth() == 0)
+        throw CpuRenderingException("SSAO kernel or random offsets are empty");
+
+    if(!Occlusion.IsSameSize(NormalDepth))
+        Occlusion.Init(width, height);
+
+    if(!Intermediate.IsSameSize(NormalDepth))
+        Intermediate.Init(width, height);
+
+    int radius = (Params.useBlur) ? GetBlurRadius(Params.blur) : 0;
+    int iterations = (Params.useBlur) ? Params.blur.iterations : 0;
+
+    ForEachRegionRows(Pool, GrowTile(Region, radius * iterations, radius * iterations, width, height), [&](const Tile &Band)
+    {
+        SSAOEngine::ComputeTile(NormalDepth, Params.ssao, Band, Occlusion);
+    });
+
+    auto occlusionSource = [&](int X, int Y){return Occlusion.At(X, Y);};
+    auto intermediateSource = [&](int X, int Y){return Intermediate.At(X, Y);};
+
+    for(int i = 0; i < iterations; i++){
+
+        int outer = (iterations - i) * radius, inner = (iterations - i - 1) * radius;
+
+        ForEachRegionRows(Pool, GrowTile(Region, outer, inner, width, height), [&](const Tile &Band)
+        {
+            for(int y = Band.top; y < Band.bottom; y++)
+                for(int x = Band.left; x < Band.right; x++)
+                    Intermediate.At(x, y) = EdgeSavingBlurPixel(NormalDepth, Params.blur, true, x, y, occlusionSource);
+        });
+
+        ForEachRegionRows(Pool, GrowTile(Region, inner, inner, width, height), [&](const Tile &Band)
+        {
+            for(int y = Band.top; y < Band.bottom; y++)
+                for(int x = Band.left; x < Band.right; x++)
+                    Occlusion.At(x, y) = EdgeSavingBlurPixel(NormalDepth, Params.blur, false, x, y, intermediateSource);
+        });
+    }
+}
+
+struct FarmJob
+{
+    uint32_t view = 0;
+    Tile region;
+    int attempts = 0;
+};
+
+//Queue and assembly state shared by the connection threads
+struct FarmState
+{
+    const CameraPath &views;
+    const RenderFarmParams &params;
+    const RenderFarmCoordinator::ViewCallback &output;
+    int width, height;
+    std::vector<FarmJob> jobs;
+    std::deque<size_t> queue;
+    //created by the first tile of the view, released when the view is handed out
+    std::vector<std::shared_ptr<OcclusionImage> > images;
+    std::vector<size_t> remainingTiles;
+    size_t doneJobs = 0;
+    bool failed = false;
+    std::exception_ptr error;
+    std::mutex mutex;
+    std::condition_variable condition;
+    RenderFarmCounters &counters;
+    FarmState(const CameraPath &Views, const RenderFarmParams &Params, const RenderFarmCoordinator::ViewCallback &Output,
+              int Width, int Height, RenderFarmCounters &Counters) :
+        views(Views), params(Params), output(Output), width(Width), height(Height), counters(Counters){}
+    void Fail(const std::exception_ptr &Error)
+    {
+        if(!failed){
+            failed = true;
+            error = Error;
+        }
+    }
+};
+
+static void ServeWorker(Socket &Connection, FarmState &State)
+{
+    std::vector<unsigned char> tile;
+
+    while(true){
+
+        size_t jobIndex = 0;
+        {
+            std::unique_lock<std::mutex> lock(State.mutex);
+            State.condition.wait(lock, [&]{return !State.queue.empty() || State.doneJobs == State.jobs.size() || State.failed;});
+
+            if(State.queue.empty() || State.failed)
+                break;
+
+            jobIndex = State.queue.front();
+            State.queue.pop_front();
+        }
+
+        const FarmJob &job = State.jobs[jobIndex];
+        size_t tileSize = (size_t)job.region.GetWidth() * job.region.GetHeight();
+
+        try{
+            FarmJobMessage message;
+            message.jobId = (uint32_t)jobIndex;
+            message.view = job.view;
+            message.left = job.region.left;
+            message.top = job.region.top;
+            message.right = job.region.right;
+            message.bottom = job.region.bottom;
+
+            const Matrix &view = State.views[job.view];
+            for(int i = 0; i < 16; i++)
+                message.viewMatrix[i] = view.m[i / 4][i % 4];
+
+            Connection.SendAll(&FarmMessageJob, sizeof(FarmMessageJob));
+            Connection.SendAll(&message, sizeof(message));
+
+            uint32_t type = 0;
+            FarmResultMessage result;
+            Connection.ReceiveAll(&type, sizeof(type));
+            Connection.ReceiveAll(&result, sizeof(result));
+
+            if(type != FarmMessageResult || result.jobId != jobIndex || result.size != tileSize)
+                throw CpuRenderingException("Unexpected render farm worker reply");
+
+            tile.resize(tileSize);
+            Connection.ReceiveAll(tile.data(), tile.size());
+        }catch(...){
+            std::lock_guard<std::mutex> lock(State.mutex);
+
+            State.counters.lostWorkers++;
+
+            if(++State.jobs[jobIndex].attempts >= State.params.maxAttempts)
+                State.Fail(std::make_exception_ptr(CpuRenderingException("Render farm job " + std::to_string(jobIndex) + " lost its worker " +
+                                                                         std::to_string(State.params.maxAttempts) + " times")));
+            else{
+                State.queue.push_front(jobIndex);
+                State.counters.requeued++;
+            }
+
+            State.condition.notify_all();
+            return;
+        }
+
+        std::shared_ptr<OcclusionImage> image;
+        {
+            std::lock_guard<std::mutex> lock(State.mutex);
+            if(!State.images[job.view])
+                State.images[job.view].reset(new OcclusionImage(State.width, State.height));
+            image = State.images[job.view];
+        }
+
+        //tiles of a view do not overlap, so they are decoded without the lock
+        const unsigned char *src = tile.data();
+        for(int y = job.region.top; y < job.region.bottom; y++){
+            float *row = image->GetRow(y);
+            for(int x = job.region.left; x < job.region.right; x++)
+                row[x] = DecodeOcclusion(*src++);
+        }
+
+        bool viewDone = false;
+        {
+            std::lock_guard<std::mutex> lock(State.mutex);
+            State.doneJobs++;
+            State.counters.resultBytes += tileSize;
+            viewDone = --State.remainingTiles[job.view] == 0;
+            if(viewDone)
+                State.images[job.view].reset();
+        }
+
+        if(viewDone){
+            try{
+                State.output(job.view, image);
+            }catch(...){
+                std::lock_guard<std::mutex> lock(State.mutex);
+                State.Fail(std::current_exception());
+            }
+        }
+
+        State.condition.notify_all();
+    }
+
+    try{
+        Connection.SendAll(&FarmMessageQuit, sizeof(FarmMessageQuit));
+    }catch(...){
+    }
+}
+
+void RenderFarmCoordinator::Render(const CameraPath &Views, int Width, int Height, const RenderFarmParams &Params,
+                                   const std::vector<std::vector<std::string> > &WorkerCommands, const ViewCallback &Output) throw (Exception)
+{
+    if(Width <= 0 || Height <= 0)
+        throw CpuRenderingException("Render farm view size must be positive");
+
+    if(WorkerCommands.empty())
+        throw CpuRenderingException("Render farm has no workers");
+
+    if(Params.tileSize < 0 || Params.maxAttempts < 1)
+        throw CpuRenderingException("Invalid render farm params");
+
+    counters = RenderFarmCounters();
+    counters.views = Views.size();
+
+    Stopwatch stopwatch;
+
+    FarmState state(Views, Params, Output, Width, Height, counters);
+    state.images.resize(Views.size());
+    state.remainingTiles.assign(Views.size(), 0);
+
+    TilesStorage tiles = (Params.tileSize > 0) ? SplitToTiles(Width, Height, Params.tileSize) : TilesStorage(1, Tile(0, 0, Width, Height));
+
+    for(size_t v = 0; v < Views.size(); v++)
+        for(const Tile &tile : tiles){
+            FarmJob job;
+            job.view = (uint32_t)v;
+            job.region = tile;
+            state.queue.push_back(state.jobs.size());
+            state.jobs.push_back(job);
+            state.remainingTiles[v]++;
+        }
+
+    counters.jobs = state.jobs.size();
+
+    if(state.jobs.empty())
+        return;
+
+    Socket listener;
+    listener.Listen();
+    std::string port = std::to_string(listener.GetPort());
+
+    std::vector<std::unique_ptr<ChildProcess> > workers;
+    for(const std::vector<std::string> &command : WorkerCommands){
+        std::vector<std::string> arguments = command;
+        arguments.push_back(port);
+
+        workers.push_back(std::unique_ptr<ChildProcess>(new ChildProcess()));
+        workers.back()->Start(arguments);
+    }
+
+    //workers that do not connect in time are dropped, the rest take their jobs
+    std::vector<Socket> connections;
+    Stopwatch connectStopwatch;
+
+    while(connections.size() < workers.size()){
+        int remainingMs = Params.connectTimeoutMs - (int)(connectStopwatch.GetSeconds() * 1000.0);
+
+        Socket connection;
+        if(remainingMs <= 0 || !listener.Accept(remainingMs, connection))
+            break;
+
+        connections.push_back(std::move(connection));
+    }
+
+    listener.Close();
+
+    counters.connectedWorkers = connections.size();
+
+    if(connections.empty())
+        throw CpuRenderingException("No render farm worker connected");
+
+    std::vector<std::thread> threads;
+    for(Socket &connection : connections)
+        threads.push_back(std::thread(ServeWorker, std::ref(connection), std::ref(state)));
+
+    for(std::thread &thread : threads)
+        thread.join();
+
+    //the workers quit after the quit message, the lost ones are gone already
+    for(Socket &connection : connections)
+        connection.Close();
+
+    for(std::unique_ptr<ChildProcess> &worker : workers)
+        worker->Wait();
+
+    counters.seconds = stopwatch.GetSeconds();
+
+    if(state.error)
+        std::rethrow_exception(state.error);
+
+    if(state.doneJobs != state.jobs.size())
+        throw CpuRenderingException("All render farm workers are lost");
+}
+
+void RunRenderFarmWorker(unsigned short Port, const MeshView &Mesh, const BatchAOParams &Params, ThreadPool *Pool, int CrashAfterJobs) throw (Exception)
+{
+    Socket connection;
+    connection.Connect("127.0.0.1", Port);
+
+    NormalDepthRasterizer rasterizer(Pool);
+    NormalDepthImage normalDepth;
+    OcclusionImage occlusion, intermediate;
+    std::vector<unsigned char> tile;
+
+    bool hasPrepass = false;
+    uint32_t prepassView = 0;
+    int jobsCount = 0;
+
+    while(true){
+
+        uint32_t type = 0;
+        connection.ReceiveAll(&type, sizeof(type));
+
+        if(type == FarmMessageQuit)
+            break;
+
+        if(type != FarmMessageJob)
+            throw CpuRenderingException("Unexpected render farm coordinator message");
+
+        FarmJobMessage job;
+        connection.ReceiveAll(&job, sizeof(job));
+
+        if(++jobsCount == CrashAfterJobs)
+            ExitImmediately(3);
+
+        if(!hasPrepass || prepassView != job.view){
+            rasterizer.Clear(Params.width, Params.height, normalDepth);
+            rasterizer.Draw(Mesh, CreatePrepassTransforms(Matrix(), Matrix(job.viewMatrix), Params.ssao.proj), normalDepth);
+            hasPrepass = true;
+            prepassView = job.view;
+        }
+
+        Tile region(job.left, job.top, job.right, job.bottom);
+        RenderAOTile(normalDepth, Params, region, occlusion, intermediate, Pool);
+
+        tile.resize((size_t)region.GetWidth() * region.GetHeight());
+        unsigned char *dst = tile.data();
+        for(int y = region.top; y < region.bottom; y++){
+            const float *row = occlusion.GetRow(y);
+            for(int x = region.left; x < region.right; x++)
+                *dst++ = EncodeOcclusion(row[x]);
+        }
+
+        FarmResultMessage result;
+        result.jobId = job.jobId;
+        result.size = (uint32_t)tile.size();
+
+        connection.SendAll(&FarmMessageResult, sizeof(FarmMessageResult));
+        connection.SendAll(&result, sizeof(result));
+        connection.SendAll(tile.data(), tile.size());
+    }
+}
+
+}
@@ -0,0 +1,317 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include <CpuRendering/SSAO.h>
+#include <CpuRendering/TemporalSSAO.h>
+#include <stdlib.h>
+#include <math.h>
+#include <algorithm>
+
+namespace CpuRendering
+{
+
+static const float Pi = 3.14159265f;
+
+KernelStorage CreateKernel(size_t KernelSize)
+{
+    KernelStorage kernel(KernelSize);
+
+    for(size_t i = 0; i < KernelSize; i++){
+        Float3 k;
+        k.x = 2.0f * ((float)rand() / (float)RAND_MAX) - 1.0f;
+        k.y = 2.0f * ((float)rand() / (float)RAND_MAX) - 1.0f;
+        k.z = 2.0f * ((float)rand() / (float)RAND_MAX) - 1.0f;
+
+        float factor = (float)i / KernelSize;
+
+        kernel[i] = Float4(Normalize(k) * Lerp(0.1f, 0.9f, factor), 0.0f);
+    }
+
+    return kernel;
+}
+
+static float RadicalInverse(unsigned int Index, unsigned int Base)
+{
+    float inverse = 0.0f, digitWeight = 1.0f / Base;
+
+    for(; Index > 0; Index /= Base, digitWeight /= Base)
+        inverse += (Index % Base) * digitWeight;
+
+    return inverse;
+}
+
+KernelStorage CreateKernel(size_t KernelSize, KernelSequence Sequence)
+{
+    if(Sequence == KERNEL_SEQUENCE_RANDOM)
+        return CreateKernel(KernelSize);
+
+    KernelStorage kernel(KernelSize);
+
+    for(size_t i = 0; i < KernelSize; i++){
+
+        float u, v, w;
+        if(Sequence == KERNEL_SEQUENCE_HAMMERSLEY){
+            u = (i + 0.5f) / KernelSize;
+            v = RadicalInverse((unsigned int)i, 2);
+            w = RadicalInverse((unsigned int)i, 3);
+        }else{
+            //index 0 is the origin in every base
+            u = RadicalInverse((unsigned int)i + 1, 2);
+            v = RadicalInverse((unsigned int)i + 1, 3);
+            w = RadicalInverse((unsigned int)i + 1, 5);
+        }
+
+        //Malley's method: uniform disk point lifted to the hemisphere
+        float r = sqrtf(u), phi = 2.0f * Pi * v;
+        Float3 direction(r * cosf(phi), r * sinf(phi), sqrtf(1.0f - u));
+
+        //squared so the samples gather close to the pixel where the occluders weigh more
+        kernel[i] = Float4(direction * Lerp(0.1f, 0.9f, w * w), 0.0f);
+    }
+
+    return kernel;
+}
+
+RandomOffsetsImage CreateRandomOffsets(int Width, int Height, std::vector<unsigned char> *Bytes)
+{
+    std::vector<unsigned char> bytes((size_t)Width * Height * 4);
+
+    for(unsigned char &b : bytes)
+        b = rand() % 255;
+
+    if(Bytes != NULL)
+        *Bytes = bytes;
+
+    return RandomOffsetsFromBytes(Width, Height, bytes.data());
+}
+
+RandomOffsetsImage RandomOffsetsFromBytes(int Width, int Height, const unsigned char *Bytes)
+{
+    RandomOffsetsImage offsets(Width, Height);
+
+    for(int y = 0; y < Height; y++)
+        for(int x = 0; x < Width; x++){
+            const unsigned char *px = Bytes + ((size_t)y * Width + x) * 4;
+            offsets.At(x, y) = Float3(px[0] / 255.0f, px[1] / 255.0f, px[2] / 255.0f);
+        }
+
+    return offsets;
+}
+
+float SampleDepthLinear(const NormalDepthImage &NormalDepth, const Float2 &TexCoord)
+{
+    return SampleLinear(NormalDepth, TexCoord, [](const Float4 &Pixel){return Pixel.w;});
+}
+
+float SSAOEngine::ComputePixel(const NormalDepthImage &NormalDepth, const SSAOParams &Params, int X, int Y, const DepthPyramid *Pyramid)
+{
+    //pow(x, 2) is compiled by fxc to x * x, so negative bases are squared as well
+    float visibility = ComputeVisibility(NormalDepth, Params, X, Y, Pyramid);
+
+    return visibility * visibility;
+}
+
+float SSAOEngine::ComputeVisibility(const NormalDepthImage &NormalDepth, const SSAOParams &Params, int X, int Y, const DepthPyramid *Pyramid)
+{
+    if(Pyramid != NULL)
+        return ComputeSSAOVisibility(NormalDepth, Params, X, Y, PyramidDepthSampler(*Pyramid));
+
+    return ComputeSSAOVisibility(NormalDepth, Params, X, Y, FlatDepthSampler(NormalDepth));
+}
+
+void SSAOEngine::ComputeTile(const NormalDepthImage &NormalDepth, const SSAOParams &Params, const Tile &Region, OcclusionImage &Occlusion, const DepthPyramid *Pyramid)
+{
+    for(int y = Region.top; y < Region.bottom; y++){
+        float *row = Occlusion.GetRow(y);
+        for(int x = Region.left; x < Region.right; x++)
+            row[x] = ComputePixel(NormalDepth, Params, x, y, Pyramid);
+    }
+}
+
+void SSAOEngine::SetResolutionScale(int Scale) throw (Exception)
+{
+    if(Scale != 1 && Scale != 2 && Scale != 4)
+        throw CpuRenderingException("SSAO resolution scale must be 1, 2 or 4");
+
+    resolutionScale = Scale;
+}
+
+void SSAOEngine::ComputeDeinterleaved(const NormalDepthImage &NormalDepth, const SSAOParams &Params, OcclusionImage &Occlusion,
+                                      const TileClassification *Classification) const throw (Exception)
+{
+    if(Params.randomOffsets.GetWidth() != DeinterleaveFactor || Params.randomOffsets.GetHeight() != DeinterleaveFactor)
+        throw CpuRenderingException("Deinterleaved SSAO needs 4x4 random offsets");
+
+    DeinterleavedDepth depth;
+    depth.Build(NormalDepth, pool);
+
+    int layerWidth = depth.GetLayerWidth(), layerHeight = depth.GetLayerHeight();
+
+    //tiles of the atlas of 4 x 4 layers SSAOv3.ps draws, no tile crosses a layer border
+    TilesStorage tiles;
+    for(int layer = 0; layer < DeinterleavedLayersCount; layer++){
+        int atlasX = (layer % DeinterleaveFactor) * layerWidth, atlasY = (layer / DeinterleaveFactor) * layerHeight;
+
+        for(const Tile &tile : SplitToTiles(layerWidth, layerHeight, tileSize))
+            tiles.push_back(Tile(tile.left + atlasX, tile.top + atlasY, tile.right + atlasX, tile.bottom + atlasY));
+    }
+
+    SSAOParams reducedParams = Params;
+    if(Classification != NULL)
+        reducedParams.kernel = GetKernelSubset(Params.kernel, 0, Classification->GetReducedSampleStep());
+
+    ForEachTile(pool, tiles, [&](const Tile &Region)
+    {
+        int layerX = Region.left / layerWidth, layerY = Region.top / layerHeight;
+        LayerDepthSampler sampler(depth, layerX + layerY * DeinterleaveFactor);
+
+        for(int y = Region.top; y < Region.bottom; y++)
+            for(int x = Region.left; x < Region.right; x++){
+
+                //reinterleaving: the result goes straight to the pixel the layer texel was taken from
+                int pixelX = (x - layerX * layerWidth) * DeinterleaveFactor + layerX;
+                int pixelY = (y - layerY * layerHeight) * DeinterleaveFactor + layerY;
+
+                if(pixelX >= NormalDepth.GetWidth() || pixelY >= NormalDepth.GetHeight())
+                    continue;
+
+                TileClass tileClass = (Classification != NULL) ?
+                                      Classification->GetClass(pixelX / TileClassificationTileSize, pixelY / TileClassificationTileSize) : TILE_CLASS_FULL;
+
+                if(tileClass == TILE_CLASS_SKIPPED){
+                    Occlusion.At(pixelX, pixelY) = 1.0f;
+                    continue;
+                }
+
+                float visibility = ComputeSSAOVisibility(NormalDepth, (tileClass == TILE_CLASS_REDUCED) ? reducedParams : Params, pixelX, pixelY, sampler);
+                Occlusion.At(pixelX, pixelY) = visibility * visibility;
+            }
+    });
+}
+
+void SSAOEngine::ComputeTiles(const NormalDepthImage &NormalDepth, const SSAOParams &Params, OcclusionImage &Occlusion) const throw (Exception)
+{
+    if(!Occlusion.IsSameSize(NormalDepth))
+        Occlusion.Init(NormalDepth.GetWidth(), NormalDepth.GetHeight());
+
+    TileClassification classification;
+    if(adaptiveSampling)
+        classification.Build(NormalDepth, Params, classificationParams, pool);
+
+    if(deinterleaved){
+        ComputeDeinterleaved(NormalDepth, Params, Occlusion, (adaptiveSampling) ? &classification : NULL);
+        return;
+    }
+
+    DepthPyramid pyramid;
+    if(useDepthPyramid)
+        pyramid.Build(NormalDepth, DepthPyramidMaxLevelsCount, pool);
+
+    const DepthPyramid *pyramidPtr = (useDepthPyramid) ? &pyramid : NULL;
+
+    if(adaptiveSampling){
+        ComputeClassified(NormalDepth, Params, Occlusion, classification, pyramidPtr);
+        return;
+    }
+
+    ForEachTile(pool, SplitToTiles(NormalDepth.GetWidth(), NormalDepth.GetHeight(), tileSize), [&](const Tile &Region)
+    {
+        ComputeTile(NormalDepth, Params, Region, Occlusion, pyramidPtr);
+    });
+}
+
+void SSAOEngine::ComputeClassified(const NormalDepthImage &NormalDepth, const SSAOParams &Params, OcclusionImage &Occlusion,
+                                   const TileClassification &Classification, const DepthPyramid *Pyramid) const
+{
+    for(const Tile &tile : Classification.GetTiles(TILE_CLASS_SKIPPED))
+        for(int y = tile.top; y < tile.bottom; y++)
+            std::fill(Occlusion.GetRow(y) + tile.left, Occlusion.GetRow(y) + tile.right, 1.0f);
+
+    SSAOParams reducedParams = Params;
+    reducedParams.kernel = GetKernelSubset(Params.kernel, 0, Classification.GetReducedSampleStep());
+
+    ForEachTile(pool, Classification.GetTiles(TILE_CLASS_REDUCED), [&](const Tile &Region)
+    {
+        ComputeTile(NormalDepth, reducedParams, Region, Occlusion, Pyramid);
+    });
+
+    ForEachTile(pool, Classification.GetTiles(TILE_CLASS_FULL), [&](const Tile &Region)
+    {
+        ComputeTile(NormalDepth, Params, Region, Occlusion, Pyramid);
+    });
+}
+
+void SSAOEngine::CheckParams(const SSAOParams &Params) const throw (Exception)
+{
+    if(Params.kernel.empty())
+        throw CpuRenderingException("SSAO kernel is empty");
+
+    if(Params.randomOffsets.GetWidth() == 0 || Params.randomOffsets.GetHeight() == 0)
+        throw CpuRenderingException("SSAO random offsets are not set");
+}
+
+void SSAOEngine::Compute(const NormalDepthImage &NormalDepth, const SSAOParams &Params, OcclusionImage &Occlusion) const throw (Exception)
+{
+    CheckParams(Params);
+
+    if(resolutionScale == 1){
+        ComputeTiles(NormalDepth, Params, Occlusion);
+        return;
+    }
+
+    NormalDepthImage lowNormalDepth;
+    OcclusionImage lowOcclusion;
+
+    DownsampleNormalDepth(NormalDepth, resolutionScale, lowNormalDepth, pool);
+    ComputeTiles(lowNormalDepth, Params, lowOcclusion);
+    BilateralUpsample(lowOcclusion, lowNormalDepth, NormalDepth, Occlusion, upsampleParams, pool);
+}
+
+template<class TDepthSampler>
+static void ComputeBentNormalsTile(const NormalDepthImage &NormalDepth, const SSAOParams &Params, const Tile &Region, const TDepthSampler &Sampler,
+                                   OcclusionImage &Occlusion, BentNormalImage &BentNormals)
+{
+    for(int y = Region.top; y < Region.bottom; y++){
+        float *occlusionRow = Occlusion.GetRow(y);
+        Float3 *bentRow = BentNormals.GetRow(y);
+
+        for(int x = Region.left; x < Region.right; x++){
+            float visibility = ComputeSSAOVisibility(NormalDepth, Params, x, y, Sampler, &bentRow[x]);
+            occlusionRow[x] = visibility * visibility;
+        }
+    }
+}
+
+void SSAOEngine::ComputeWithBentNormals(const NormalDepthImage &NormalDepth, const SSAOParams &Params, OcclusionImage &Occlusion,
+                                        BentNormalImage &BentNormals) const throw (Exception)
+{
+    CheckParams(Params);
+
+    if(resolutionScale != 1 || deinterleaved || adaptiveSampling)
+        throw CpuRenderingException("Bent normals need the full resolution, interleaved and non adaptive SSAO");
+
+    if(!Occlusion.IsSameSize(NormalDepth))
+        Occlusion.Init(NormalDepth.GetWidth(), NormalDepth.GetHeight());
+
+    if(!BentNormals.IsSameSize(NormalDepth))
+        BentNormals.Init(NormalDepth.GetWidth(), NormalDepth.GetHeight());
+
+    DepthPyramid pyramid;
+    if(useDepthPyramid)
+        pyramid.Build(NormalDepth, DepthPyramidMaxLevelsCount, pool);
+
+    ForEachTile(pool, SplitToTiles(NormalDepth.GetWidth(), NormalDepth.GetHeight(), tileSize), [&](const Tile &Region)
+    {
+        if(useDepthPyramid)
+            ComputeBentNormalsTile(NormalDepth, Params, Region, PyramidDepthSampler(pyramid), Occlusion, BentNormals);
+        else
+            ComputeBentNormalsTile(NormalDepth, Params, Region, FlatDepthSampler(NormalDepth), Occlusion, BentNormals);
+    });
+}
+
+
+}
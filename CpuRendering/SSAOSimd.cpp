@@ -0,0 +1,258 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include <CpuRendering/SSAOSimd.h>
+#include <CpuRendering/SSAOSimdKernels.h>
+#include <algorithm>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace CpuRendering
+{
+
+static SimdLevel DetectSimdLevel()
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    int maxLeaf = info[0];
+
+    __cpuid(info, 1);
+    bool sse41 = (info[2] & (1 << 19)) != 0;
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+
+    bool avx2 = false;
+    if(maxLeaf >= 7 && osxsave && avx){
+        //ymm state must be enabled by the OS
+        bool ymmEnabled = (_xgetbv(0) & 6) == 6;
+        __cpuidex(info, 7, 0);
+        avx2 = ymmEnabled && (info[1] & (1 << 5)) != 0;
+    }
+
+    if(avx2)
+        return SIMD_AVX2;
+    return sse41 ? SIMD_SSE41 : SIMD_SCALAR;
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2"))
+        return SIMD_AVX2;
+    return __builtin_cpu_supports("sse4.1") ? SIMD_SSE41 : SIMD_SCALAR;
+#else
+    return SIMD_SCALAR;
+#endif
+}
+
+SimdLevel GetSupportedSimdLevel()
+{
+    static SimdLevel level = DetectSimdLevel();
+    return level;
+}
+
+std::string GetSimdLevelName(SimdLevel Level)
+{
+    if(Level == SIMD_AVX2)
+        return "AVX2";
+    else if(Level == SIMD_SSE41)
+        return "SSE4.1";
+    return "scalar";
+}
+
+void NormalDepthPlanes::Init(const NormalDepthImage &NormalDepth)
+{
+    width = NormalDepth.GetWidth();
+    height = NormalDepth.GetHeight();
+
+    size_t pixelsCount = (size_t)width * height;
+    nx.resize(pixelsCount);
+    ny.resize(pixelsCount);
+    nz.resize(pixelsCount);
+    depth.resize(pixelsCount);
+
+    const Float4 *src = NormalDepth.GetData();
+
+    for(size_t i = 0; i < pixelsCount; i++){
+        Float3 n = Normalize(src[i].Xyz());
+        nx[i] = n.x;
+        ny[i] = n.y;
+        nz[i] = n.z;
+        depth[i] = src[i].w;
+    }
+}
+
+static float SampleDepthPlane(const float *Depths, int Width, int Height, float U, float V)
+{
+    float tx = U * Width - 0.5f;
+    float ty = V * Height - 0.5f;
+
+    float fx0 = floorf(tx), fy0 = floorf(ty);
+    float fracX = tx - fx0, fracY = ty - fy0;
+
+    int x0 = std::min(std::max((int)fx0, 0), Width - 1);
+    int y0 = std::min(std::max((int)fy0, 0), Height - 1);
+    int x1 = std::min(std::max((int)fx0 + 1, 0), Width - 1);
+    int y1 = std::min(std::max((int)fy0 + 1, 0), Height - 1);
+
+    float d00 = Depths[(size_t)y0 * Width + x0];
+    float d10 = Depths[(size_t)y0 * Width + x1];
+    float d01 = Depths[(size_t)y1 * Width + x0];
+    float d11 = Depths[(size_t)y1 * Width + x1];
+
+    float top = d00 + (d10 - d00) * fracX;
+    float bottom = d01 + (d11 - d01) * fracX;
+
+    return top + (bottom - top) * fracY;
+}
+
+float ComputeSSAOPixelScalar(const SimdSSAOContext &Context, int X, int Y)
+{
+    const NormalDepthPlanes &planes = *Context.planes;
+    const SSAOParams &params = *Context.params;
+
+    int width = planes.GetWidth(), height = planes.GetHeight();
+    size_t index = (size_t)Y * width + X;
+
+    Float3 normalV(planes.GetNormalsX()[index], planes.GetNormalsY()[index], planes.GetNormalsZ()[index]);
+    float depth = planes.GetDepths()[index];
+
+    Float4 eyeRayN(2.0f * (X + 0.5f) / width - 1.0f, 1.0f - 2.0f * (Y + 0.5f) / height, 1.0f, 1.0f);
+    Float3 viewRay = Transform(eyeRayN, params.invProj).Xyz() * depth;
+
+    int rndWidth = params.randomOffsets.GetWidth();
+    const Float3 &offset = Context.offsets[(Y % params.randomOffsets.GetHeight()) * rndWidth + X % rndWidth];
+
+    float totalOcclusion = 0.0f;
+
+    for(const Float4 &k : params.kernel){
+        Float3 samplingRayL = Reflect(k.Xyz(), offset);
+        samplingRayL *= Sign(Dot(samplingRayL, normalV));
+
+        Float3 samplingPosV = viewRay + samplingRayL * params.occlusionRadius;
+
+        Float4 samplingPosH = Transform(Float4(samplingPosV, 1.0f), params.proj);
+
+        float u = 0.5f * (samplingPosH.x / samplingPosH.w) + 0.5f;
+        float v = -0.5f * (samplingPosH.y / samplingPosH.w) + 0.5f;
+
+        float sampledDepth = SampleDepthPlane(planes.GetDepths(), width, height, u, v);
+
+        if(sampledDepth - samplingPosV.z < 0.0f)
+            totalOcclusion += (1.0f - Saturate(fabsf(viewRay.z - sampledDepth) / params.occlusionRadius)) * params.harshness;
+    }
+
+    float ao = 1.0f - totalOcclusion / params.kernel.size();
+
+    return ao * ao;
+}
+
+void ComputeSSAOTileScalar(const SimdSSAOContext &Context, const Tile &Region)
+{
+    for(int y = Region.top; y < Region.bottom; y++){
+        float *row = Context.occlusion->GetRow(y);
+        for(int x = Region.left; x < Region.right; x++)
+            row[x] = ComputeSSAOPixelScalar(Context, x, y);
+    }
+}
+
+static_assert(sizeof(Float3) == 3 * sizeof(float) && sizeof(Float4) == 4 * sizeof(float), "Math types must be plain floats");
+
+static SimdSSAOKernelData GetKernelData(const SimdSSAOContext &Context)
+{
+    const NormalDepthPlanes &planes = *Context.planes;
+    const SSAOParams &params = *Context.params;
+
+    SimdSSAOKernelData data;
+    data.normalsX = planes.GetNormalsX();
+    data.normalsY = planes.GetNormalsY();
+    data.normalsZ = planes.GetNormalsZ();
+    data.depths = planes.GetDepths();
+    data.width = planes.GetWidth();
+    data.height = planes.GetHeight();
+    data.proj = &params.proj.m[0][0];
+    data.invProj = &params.invProj.m[0][0];
+    data.kernel = &params.kernel[0].x;
+    data.kernelSize = (int)params.kernel.size();
+    data.offsets = &Context.offsets[0].x;
+    data.rndWidth = params.randomOffsets.GetWidth();
+    data.rndHeight = params.randomOffsets.GetHeight();
+    data.occlusionRadius = params.occlusionRadius;
+    data.harshness = params.harshness;
+    data.occlusion = Context.occlusion->GetData();
+    return data;
+}
+
+//The vector kernels leave the last pixels of the rows that don't fill a vector
+static void ComputeSSAOTileTail(const SimdSSAOContext &Context, const Tile &Region, int Lanes)
+{
+    int left = Region.left + (Region.right - Region.left) / Lanes * Lanes;
+
+    for(int y = Region.top; y < Region.bottom; y++){
+        float *row = Context.occlusion->GetRow(y);
+        for(int x = left; x < Region.right; x++)
+            row[x] = ComputeSSAOPixelScalar(Context, x, y);
+    }
+}
+
+void ComputeSSAOTileSSE41(const SimdSSAOContext &Context, const Tile &Region)
+{
+    ComputeSSAOVectorsSSE41(GetKernelData(Context), Region.left, Region.top, Region.right, Region.bottom);
+    ComputeSSAOTileTail(Context, Region, SSE41Lanes);
+}
+
+void ComputeSSAOTileAVX2(const SimdSSAOContext &Context, const Tile &Region)
+{
+    ComputeSSAOVectorsAVX2(GetKernelData(Context), Region.left, Region.top, Region.right, Region.bottom);
+    ComputeSSAOTileTail(Context, Region, AVX2Lanes);
+}
+
+void SimdSSAOEngine::SetSimdLevel(SimdLevel Level)
+{
+    level = std::min(Level, GetSupportedSimdLevel());
+}
+
+void SimdSSAOEngine::Compute(const NormalDepthPlanes &Planes, const SSAOParams &Params, OcclusionImage &Occlusion) const throw (Exception)
+{
+    if(Params.kernel.empty())
+        throw CpuRenderingException("SSAO kernel is empty");
+
+    const RandomOffsetsImage &rnd = Params.randomOffsets;
+
+    if(rnd.GetWidth() == 0 || rnd.GetHeight() == 0)
+        throw CpuRenderingException("SSAO random offsets are not set");
+
+    if(!Occlusion.IsSameSize(Planes.GetWidth(), Planes.GetHeight()))
+        Occlusion.Init(Planes.GetWidth(), Planes.GetHeight());
+
+    SimdSSAOContext context;
+    context.planes = &Planes;
+    context.params = &Params;
+    context.occlusion = &Occlusion;
+
+    for(int y = 0; y < rnd.GetHeight(); y++)
+        for(int x = 0; x < rnd.GetWidth(); x++)
+            context.offsets.push_back(Normalize(rnd.At(x, y) * 2.0f - Float3(1.0f, 1.0f, 1.0f)));
+
+    SimdSSAOFunction function = ComputeSSAOTileScalar;
+    if(level == SIMD_AVX2)
+        function = ComputeSSAOTileAVX2;
+    else if(level == SIMD_SSE41)
+        function = ComputeSSAOTileSSE41;
+
+    TilesStorage tiles = SplitToTiles(Planes.GetWidth(), Planes.GetHeight(), tileSize);
+
+    if(pool == NULL){
+        for(const Tile &tile : tiles)
+            function(context, tile);
+        return;
+    }
+
+    pool->ExecuteForTiles(tiles, [&](const Tile &Region){function(context, Region);});
+}
+
+}
@@ -0,0 +1,151 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+//Compiled with /arch:AVX2 (see CpuRendering.vcxproj) or -mavx2 (see CMakeLists.txt), only called after GetSupportedSimdLevel() reported AVX2
+
+#include <CpuRendering/SSAOSimdKernels.h>
+#include <immintrin.h>
+#include <cstddef>
+
+namespace CpuRendering
+{
+
+typedef float Matrix4x4[4][4];
+
+void ComputeSSAOVectorsAVX2(const SimdSSAOKernelData &Data, int Left, int Top, int Right, int Bottom)
+{
+    const int Lanes = AVX2Lanes;
+
+    const Matrix4x4 &ip = *reinterpret_cast<const Matrix4x4*>(Data.invProj);
+    const Matrix4x4 &p = *reinterpret_cast<const Matrix4x4*>(Data.proj);
+
+    const int width = Data.width, height = Data.height;
+    const int rndWidth = Data.rndWidth, rndHeight = Data.rndHeight;
+    const float *depths = Data.depths;
+
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 minusOne = _mm256_set1_ps(-1.0f);
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    const __m256 radius = _mm256_set1_ps(Data.occlusionRadius);
+    const __m256 invRadius = _mm256_set1_ps(1.0f / Data.occlusionRadius);
+    const __m256 harshness = _mm256_set1_ps(Data.harshness);
+    const __m256 kernelSize = _mm256_set1_ps((float)Data.kernelSize);
+    const __m256 widthF = _mm256_set1_ps((float)width), heightF = _mm256_set1_ps((float)height);
+    const __m256i maxX = _mm256_set1_epi32(width - 1), maxY = _mm256_set1_epi32(height - 1);
+    const __m256i widthI = _mm256_set1_epi32(width);
+    const __m256i zeroI = _mm256_setzero_si256(), oneI = _mm256_set1_epi32(1);
+    const __m256 laneOffsets = _mm256_set_ps(7.5f, 6.5f, 5.5f, 4.5f, 3.5f, 2.5f, 1.5f, 0.5f);
+
+    const __m256 p00 = _mm256_set1_ps(p[0][0]), p10 = _mm256_set1_ps(p[1][0]), p20 = _mm256_set1_ps(p[2][0]), p30 = _mm256_set1_ps(p[3][0]);
+    const __m256 p01 = _mm256_set1_ps(p[0][1]), p11 = _mm256_set1_ps(p[1][1]), p21 = _mm256_set1_ps(p[2][1]), p31 = _mm256_set1_ps(p[3][1]);
+    const __m256 p03 = _mm256_set1_ps(p[0][3]), p13 = _mm256_set1_ps(p[1][3]), p23 = _mm256_set1_ps(p[2][3]), p33 = _mm256_set1_ps(p[3][3]);
+
+    for(int y = Top; y < Bottom; y++){
+
+        float ndcY = 1.0f - 2.0f * (y + 0.5f) / height;
+        __m256 rowRayX = _mm256_set1_ps(ndcY * ip[1][0] + ip[2][0] + ip[3][0]);
+        __m256 rowRayY = _mm256_set1_ps(ndcY * ip[1][1] + ip[2][1] + ip[3][1]);
+        __m256 rowRayZ = _mm256_set1_ps(ndcY * ip[1][2] + ip[2][2] + ip[3][2]);
+
+        const float *rowOffsets = Data.offsets + (size_t)(y % rndHeight) * rndWidth * 3;
+        float *outRow = Data.occlusion + (size_t)y * width;
+
+        for(int x = Left; x + Lanes <= Right; x += Lanes){
+
+            size_t index = (size_t)y * width + x;
+
+            __m256 nx = _mm256_loadu_ps(Data.normalsX + index);
+            __m256 ny = _mm256_loadu_ps(Data.normalsY + index);
+            __m256 nz = _mm256_loadu_ps(Data.normalsZ + index);
+            __m256 depth = _mm256_loadu_ps(depths + index);
+
+            __m256 ndcX = _mm256_sub_ps(_mm256_div_ps(_mm256_mul_ps(_mm256_set1_ps(2.0f), _mm256_add_ps(_mm256_set1_ps((float)x), laneOffsets)), widthF), one);
+
+            __m256 rayX = _mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(ndcX, _mm256_set1_ps(ip[0][0])), rowRayX), depth);
+            __m256 rayY = _mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(ndcX, _mm256_set1_ps(ip[0][1])), rowRayY), depth);
+            __m256 rayZ = _mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(ndcX, _mm256_set1_ps(ip[0][2])), rowRayZ), depth);
+
+            float offsetsX[Lanes], offsetsY[Lanes], offsetsZ[Lanes];
+            for(int l = 0; l < Lanes; l++){
+                const float *o = rowOffsets + ((x + l) % rndWidth) * 3;
+                offsetsX[l] = o[0];
+                offsetsY[l] = o[1];
+                offsetsZ[l] = o[2];
+            }
+            __m256 ox = _mm256_loadu_ps(offsetsX), oy = _mm256_loadu_ps(offsetsY), oz = _mm256_loadu_ps(offsetsZ);
+
+            __m256 totalOcclusion = zero;
+
+            for(int i = 0; i < Data.kernelSize; i++){
+
+                const float *k = Data.kernel + i * 4;
+                __m256 kx = _mm256_set1_ps(k[0]), ky = _mm256_set1_ps(k[1]), kz = _mm256_set1_ps(k[2]);
+
+                //reflect(kernel[i].xyz, offset)
+                __m256 kDotO2 = _mm256_mul_ps(_mm256_set1_ps(2.0f), _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(kx, ox), _mm256_mul_ps(ky, oy)), _mm256_mul_ps(kz, oz)));
+                __m256 sx = _mm256_sub_ps(kx, _mm256_mul_ps(ox, kDotO2));
+                __m256 sy = _mm256_sub_ps(ky, _mm256_mul_ps(oy, kDotO2));
+                __m256 sz = _mm256_sub_ps(kz, _mm256_mul_ps(oz, kDotO2));
+
+                //*= sign(dot(samplingRayL, normalV))
+                __m256 sDotN = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(sx, nx), _mm256_mul_ps(sy, ny)), _mm256_mul_ps(sz, nz));
+                __m256 sign = _mm256_or_ps(_mm256_and_ps(_mm256_cmp_ps(sDotN, zero, _CMP_GT_OQ), one),
+                                           _mm256_and_ps(_mm256_cmp_ps(sDotN, zero, _CMP_LT_OQ), minusOne));
+                __m256 scale = _mm256_mul_ps(sign, radius);
+
+                __m256 px = _mm256_add_ps(rayX, _mm256_mul_ps(sx, scale));
+                __m256 py = _mm256_add_ps(rayY, _mm256_mul_ps(sy, scale));
+                __m256 pz = _mm256_add_ps(rayZ, _mm256_mul_ps(sz, scale));
+
+                __m256 hx = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(px, p00), _mm256_mul_ps(py, p10)), _mm256_add_ps(_mm256_mul_ps(pz, p20), p30));
+                __m256 hy = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(px, p01), _mm256_mul_ps(py, p11)), _mm256_add_ps(_mm256_mul_ps(pz, p21), p31));
+                __m256 hw = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(px, p03), _mm256_mul_ps(py, p13)), _mm256_add_ps(_mm256_mul_ps(pz, p23), p33));
+
+                __m256 u = _mm256_add_ps(_mm256_mul_ps(half, _mm256_div_ps(hx, hw)), half);
+                __m256 v = _mm256_sub_ps(half, _mm256_mul_ps(half, _mm256_div_ps(hy, hw)));
+
+                //bilinear fetch with clamp addressing
+                __m256 tx = _mm256_sub_ps(_mm256_mul_ps(u, widthF), half);
+                __m256 ty = _mm256_sub_ps(_mm256_mul_ps(v, heightF), half);
+                __m256 fx0 = _mm256_floor_ps(tx), fy0 = _mm256_floor_ps(ty);
+                __m256 fracX = _mm256_sub_ps(tx, fx0), fracY = _mm256_sub_ps(ty, fy0);
+
+                __m256i x0 = _mm256_cvttps_epi32(fx0), y0 = _mm256_cvttps_epi32(fy0);
+                __m256i x1 = _mm256_min_epi32(_mm256_max_epi32(_mm256_add_epi32(x0, oneI), zeroI), maxX);
+                __m256i y1 = _mm256_min_epi32(_mm256_max_epi32(_mm256_add_epi32(y0, oneI), zeroI), maxY);
+                x0 = _mm256_min_epi32(_mm256_max_epi32(x0, zeroI), maxX);
+                y0 = _mm256_min_epi32(_mm256_max_epi32(y0, zeroI), maxY);
+
+                __m256i row0 = _mm256_mullo_epi32(y0, widthI), row1 = _mm256_mullo_epi32(y1, widthI);
+
+                __m256 d00 = _mm256_i32gather_ps(depths, _mm256_add_epi32(row0, x0), 4);
+                __m256 d10 = _mm256_i32gather_ps(depths, _mm256_add_epi32(row0, x1), 4);
+                __m256 d01 = _mm256_i32gather_ps(depths, _mm256_add_epi32(row1, x0), 4);
+                __m256 d11 = _mm256_i32gather_ps(depths, _mm256_add_epi32(row1, x1), 4);
+
+                __m256 top = _mm256_add_ps(d00, _mm256_mul_ps(_mm256_sub_ps(d10, d00), fracX));
+                __m256 bottom = _mm256_add_ps(d01, _mm256_mul_ps(_mm256_sub_ps(d11, d01), fracX));
+                __m256 sampledDepth = _mm256_add_ps(top, _mm256_mul_ps(_mm256_sub_ps(bottom, top), fracY));
+
+                __m256 occluded = _mm256_cmp_ps(_mm256_sub_ps(sampledDepth, pz), zero, _CMP_LT_OQ);
+
+                __m256 distance = _mm256_and_ps(_mm256_sub_ps(rayZ, sampledDepth), absMask);
+                __m256 distanceFactor = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(distance, invRadius), zero), one);
+                distanceFactor = _mm256_mul_ps(_mm256_sub_ps(one, distanceFactor), harshness);
+
+                totalOcclusion = _mm256_add_ps(totalOcclusion, _mm256_and_ps(occluded, distanceFactor));
+            }
+
+            __m256 ao = _mm256_sub_ps(one, _mm256_div_ps(totalOcclusion, kernelSize));
+            _mm256_storeu_ps(outRow + x, _mm256_mul_ps(ao, ao));
+        }
+    }
+}
+
+}
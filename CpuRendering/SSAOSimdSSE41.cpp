@@ -0,0 +1,152 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+//Compiled with -msse4.1 on GCC and clang (see CMakeLists.txt), only called after GetSupportedSimdLevel() reported SSE4.1
+
+#include <CpuRendering/SSAOSimdKernels.h>
+#include <smmintrin.h>
+#include <cstddef>
+
+namespace CpuRendering
+{
+
+typedef float Matrix4x4[4][4];
+
+void ComputeSSAOVectorsSSE41(const SimdSSAOKernelData &Data, int Left, int Top, int Right, int Bottom)
+{
+    const int Lanes = SSE41Lanes;
+
+    const Matrix4x4 &ip = *reinterpret_cast<const Matrix4x4*>(Data.invProj);
+    const Matrix4x4 &p = *reinterpret_cast<const Matrix4x4*>(Data.proj);
+
+    const int width = Data.width, height = Data.height;
+    const int rndWidth = Data.rndWidth, rndHeight = Data.rndHeight;
+    const float *depths = Data.depths;
+
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 minusOne = _mm_set1_ps(-1.0f);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    const __m128 radius = _mm_set1_ps(Data.occlusionRadius);
+    const __m128 invRadius = _mm_set1_ps(1.0f / Data.occlusionRadius);
+    const __m128 harshness = _mm_set1_ps(Data.harshness);
+    const __m128 kernelSize = _mm_set1_ps((float)Data.kernelSize);
+    const __m128 widthF = _mm_set1_ps((float)width), heightF = _mm_set1_ps((float)height);
+    const __m128i maxX = _mm_set1_epi32(width - 1), maxY = _mm_set1_epi32(height - 1);
+    const __m128i widthI = _mm_set1_epi32(width);
+    const __m128i zeroI = _mm_setzero_si128(), oneI = _mm_set1_epi32(1);
+
+    for(int y = Top; y < Bottom; y++){
+
+        float ndcY = 1.0f - 2.0f * (y + 0.5f) / height;
+        __m128 rowRayX = _mm_set1_ps(ndcY * ip[1][0] + ip[2][0] + ip[3][0]);
+        __m128 rowRayY = _mm_set1_ps(ndcY * ip[1][1] + ip[2][1] + ip[3][1]);
+        __m128 rowRayZ = _mm_set1_ps(ndcY * ip[1][2] + ip[2][2] + ip[3][2]);
+
+        const float *rowOffsets = Data.offsets + (size_t)(y % rndHeight) * rndWidth * 3;
+        float *outRow = Data.occlusion + (size_t)y * width;
+
+        for(int x = Left; x + Lanes <= Right; x += Lanes){
+
+            size_t index = (size_t)y * width + x;
+
+            __m128 nx = _mm_loadu_ps(Data.normalsX + index);
+            __m128 ny = _mm_loadu_ps(Data.normalsY + index);
+            __m128 nz = _mm_loadu_ps(Data.normalsZ + index);
+            __m128 depth = _mm_loadu_ps(depths + index);
+
+            __m128 ndcX = _mm_set_ps(2.0f * (x + 3.5f) / width - 1.0f, 2.0f * (x + 2.5f) / width - 1.0f,
+                                     2.0f * (x + 1.5f) / width - 1.0f, 2.0f * (x + 0.5f) / width - 1.0f);
+
+            __m128 rayX = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(ndcX, _mm_set1_ps(ip[0][0])), rowRayX), depth);
+            __m128 rayY = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(ndcX, _mm_set1_ps(ip[0][1])), rowRayY), depth);
+            __m128 rayZ = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(ndcX, _mm_set1_ps(ip[0][2])), rowRayZ), depth);
+
+            const float *o0 = rowOffsets + (x % rndWidth) * 3, *o1 = rowOffsets + ((x + 1) % rndWidth) * 3;
+            const float *o2 = rowOffsets + ((x + 2) % rndWidth) * 3, *o3 = rowOffsets + ((x + 3) % rndWidth) * 3;
+            __m128 ox = _mm_set_ps(o3[0], o2[0], o1[0], o0[0]);
+            __m128 oy = _mm_set_ps(o3[1], o2[1], o1[1], o0[1]);
+            __m128 oz = _mm_set_ps(o3[2], o2[2], o1[2], o0[2]);
+
+            __m128 totalOcclusion = zero;
+
+            for(int i = 0; i < Data.kernelSize; i++){
+
+                const float *k = Data.kernel + i * 4;
+                __m128 kx = _mm_set1_ps(k[0]), ky = _mm_set1_ps(k[1]), kz = _mm_set1_ps(k[2]);
+
+                //reflect(kernel[i].xyz, offset)
+                __m128 kDotO2 = _mm_mul_ps(_mm_set1_ps(2.0f), _mm_add_ps(_mm_add_ps(_mm_mul_ps(kx, ox), _mm_mul_ps(ky, oy)), _mm_mul_ps(kz, oz)));
+                __m128 sx = _mm_sub_ps(kx, _mm_mul_ps(ox, kDotO2));
+                __m128 sy = _mm_sub_ps(ky, _mm_mul_ps(oy, kDotO2));
+                __m128 sz = _mm_sub_ps(kz, _mm_mul_ps(oz, kDotO2));
+
+                //*= sign(dot(samplingRayL, normalV))
+                __m128 sDotN = _mm_add_ps(_mm_add_ps(_mm_mul_ps(sx, nx), _mm_mul_ps(sy, ny)), _mm_mul_ps(sz, nz));
+                __m128 sign = _mm_or_ps(_mm_and_ps(_mm_cmpgt_ps(sDotN, zero), one), _mm_and_ps(_mm_cmplt_ps(sDotN, zero), minusOne));
+                __m128 scale = _mm_mul_ps(sign, radius);
+
+                __m128 px = _mm_add_ps(rayX, _mm_mul_ps(sx, scale));
+                __m128 py = _mm_add_ps(rayY, _mm_mul_ps(sy, scale));
+                __m128 pz = _mm_add_ps(rayZ, _mm_mul_ps(sz, scale));
+
+                __m128 hx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(px, _mm_set1_ps(p[0][0])), _mm_mul_ps(py, _mm_set1_ps(p[1][0]))),
+                                       _mm_add_ps(_mm_mul_ps(pz, _mm_set1_ps(p[2][0])), _mm_set1_ps(p[3][0])));
+                __m128 hy = _mm_add_ps(_mm_add_ps(_mm_mul_ps(px, _mm_set1_ps(p[0][1])), _mm_mul_ps(py, _mm_set1_ps(p[1][1]))),
+                                       _mm_add_ps(_mm_mul_ps(pz, _mm_set1_ps(p[2][1])), _mm_set1_ps(p[3][1])));
+                __m128 hw = _mm_add_ps(_mm_add_ps(_mm_mul_ps(px, _mm_set1_ps(p[0][3])), _mm_mul_ps(py, _mm_set1_ps(p[1][3]))),
+                                       _mm_add_ps(_mm_mul_ps(pz, _mm_set1_ps(p[2][3])), _mm_set1_ps(p[3][3])));
+
+                __m128 u = _mm_add_ps(_mm_mul_ps(half, _mm_div_ps(hx, hw)), half);
+                __m128 v = _mm_sub_ps(half, _mm_mul_ps(half, _mm_div_ps(hy, hw)));
+
+                //bilinear fetch with clamp addressing
+                __m128 tx = _mm_sub_ps(_mm_mul_ps(u, widthF), half);
+                __m128 ty = _mm_sub_ps(_mm_mul_ps(v, heightF), half);
+                __m128 fx0 = _mm_floor_ps(tx), fy0 = _mm_floor_ps(ty);
+                __m128 fracX = _mm_sub_ps(tx, fx0), fracY = _mm_sub_ps(ty, fy0);
+
+                __m128i x0 = _mm_cvttps_epi32(fx0), y0 = _mm_cvttps_epi32(fy0);
+                __m128i x1 = _mm_min_epi32(_mm_max_epi32(_mm_add_epi32(x0, oneI), zeroI), maxX);
+                __m128i y1 = _mm_min_epi32(_mm_max_epi32(_mm_add_epi32(y0, oneI), zeroI), maxY);
+                x0 = _mm_min_epi32(_mm_max_epi32(x0, zeroI), maxX);
+                y0 = _mm_min_epi32(_mm_max_epi32(y0, zeroI), maxY);
+
+                __m128i row0 = _mm_mullo_epi32(y0, widthI), row1 = _mm_mullo_epi32(y1, widthI);
+
+                int i00[Lanes], i10[Lanes], i01[Lanes], i11[Lanes];
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(i00), _mm_add_epi32(row0, x0));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(i10), _mm_add_epi32(row0, x1));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(i01), _mm_add_epi32(row1, x0));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(i11), _mm_add_epi32(row1, x1));
+
+                __m128 d00 = _mm_set_ps(depths[i00[3]], depths[i00[2]], depths[i00[1]], depths[i00[0]]);
+                __m128 d10 = _mm_set_ps(depths[i10[3]], depths[i10[2]], depths[i10[1]], depths[i10[0]]);
+                __m128 d01 = _mm_set_ps(depths[i01[3]], depths[i01[2]], depths[i01[1]], depths[i01[0]]);
+                __m128 d11 = _mm_set_ps(depths[i11[3]], depths[i11[2]], depths[i11[1]], depths[i11[0]]);
+
+                __m128 top = _mm_add_ps(d00, _mm_mul_ps(_mm_sub_ps(d10, d00), fracX));
+                __m128 bottom = _mm_add_ps(d01, _mm_mul_ps(_mm_sub_ps(d11, d01), fracX));
+                __m128 sampledDepth = _mm_add_ps(top, _mm_mul_ps(_mm_sub_ps(bottom, top), fracY));
+
+                __m128 occluded = _mm_cmplt_ps(_mm_sub_ps(sampledDepth, pz), zero);
+
+                __m128 distance = _mm_and_ps(_mm_sub_ps(rayZ, sampledDepth), absMask);
+                __m128 distanceFactor = _mm_min_ps(_mm_max_ps(_mm_mul_ps(distance, invRadius), zero), one);
+                distanceFactor = _mm_mul_ps(_mm_sub_ps(one, distanceFactor), harshness);
+
+                totalOcclusion = _mm_add_ps(totalOcclusion, _mm_and_ps(occluded, distanceFactor));
+            }
+
+            __m128 ao = _mm_sub_ps(one, _mm_div_ps(totalOcclusion, kernelSize));
+            _mm_storeu_ps(outRow + x, _mm_mul_ps(ao, ao));
+        }
+    }
+}
+
+}
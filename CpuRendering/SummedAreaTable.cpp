@@ -0,0 +1,72 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include <CpuRendering/SummedAreaTable.h>
+#include <algorithm>
+#include <math.h>
+
+namespace CpuRendering
+{
+
+static const int BoxFilterTileSize = 64;
+
+void BoxFilterEngine::Build(const OcclusionImage &Occlusion, const NormalDepthImage &NormalDepth) throw (Exception)
+{
+    if(!Occlusion.IsSameSize(NormalDepth))
+        throw CpuRenderingException("Box filter occlusion and normal/depth sizes differ");
+
+    occlusionTable.Build(Occlusion, [](float Value){return Value;}, pool);
+    depthTable.Build(NormalDepth, [](const Float4 &Value){return Value.w;}, pool);
+}
+
+void BoxFilterEngine::Filter(const BoxFilterParams &Params, OcclusionImage &Destination) const throw (Exception)
+{
+    if(occlusionTable.GetWidth() == 0)
+        throw CpuRenderingException("Box filter tables are not built");
+
+    if(Params.radius < 1)
+        throw CpuRenderingException("Box filter radius must be positive");
+
+    if(Params.depthTolerance < 0.0f)
+        throw CpuRenderingException("Box filter depth tolerance must not be negative");
+
+    int width = occlusionTable.GetWidth(), height = occlusionTable.GetHeight();
+
+    if(!Destination.IsSameSize(width, height))
+        Destination.Init(width, height);
+
+    ForEachTile(pool, SplitToTiles(width, height, BoxFilterTileSize), [&](const Tile &Region)
+    {
+        for(int y = Region.top; y < Region.bottom; y++){
+
+            int minY = std::max(y - Params.radius, 0), maxY = std::min(y + Params.radius, height - 1);
+            float *dst = Destination.GetRow(y);
+
+            for(int x = Region.left; x < Region.right; x++){
+
+                int minX = std::max(x - Params.radius, 0), maxX = std::min(x + Params.radius, width - 1);
+                double area = (double)(maxX - minX + 1) * (maxY - minY + 1);
+
+                float occlusion = (float)(occlusionTable.GetBoxSum(minX, minY, maxX, maxY) / area);
+
+                if(Params.depthTolerance > 0.0f){
+
+                    float center = (float)occlusionTable.GetBoxSum(x, y, x, y);
+                    float meanDepth = (float)(depthTable.GetBoxSum(minX, minY, maxX, maxY) / area);
+                    float weight = 1.0f - fabsf(meanDepth - (float)depthTable.GetBoxSum(x, y, x, y)) / Params.depthTolerance;
+
+                    weight = (weight < 0.0f) ? 0.0f : weight;
+                    occlusion = center + (occlusion - center) * weight;
+                }
+
+                dst[x] = occlusion;
+            }
+        }
+    });
+}
+
+}
@@ -0,0 +1,159 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include <CpuRendering/TemporalSSAO.h>
+#include <algorithm>
+#include <atomic>
+#include <utility>
+
+namespace CpuRendering
+{
+
+KernelStorage GetKernelSubset(const KernelStorage &Kernel, int Subset, int SubsetsCount)
+{
+    KernelStorage subset;
+
+    for(size_t i = Subset; i < Kernel.size(); i += SubsetsCount)
+        subset.push_back(Kernel[i]);
+
+    return subset;
+}
+
+struct ReprojectionData
+{
+    Matrix viewToPrevView, proj, invProj;
+    TemporalParams params;
+};
+
+//Mirrors Accumulate from TemporalSSAO.ps, returns false if the history of the pixel is rejected
+static bool Reproject(const NormalDepthImage &NormalDepth, const NormalDepthImage &PrevNormalDepth, const ReprojectionData &Data, int X, int Y, int &PrevX, int &PrevY)
+{
+    const Float4 &normalDepth = NormalDepth.At(X, Y);
+
+    //background has no position, its history is kept while the pixel stays background
+    if(normalDepth.w <= 0.0f){
+        PrevX = X;
+        PrevY = Y;
+        return PrevNormalDepth.At(X, Y).w <= 0.0f;
+    }
+
+    Float4 eyeRayN(2.0f * (X + 0.5f) / NormalDepth.GetWidth() - 1.0f, 1.0f - 2.0f * (Y + 0.5f) / NormalDepth.GetHeight(), 1.0f, 1.0f);
+    Float3 posV = Transform(eyeRayN, Data.invProj).Xyz() * normalDepth.w;
+
+    Float3 prevPosV = Transform(Float4(posV, 1.0f), Data.viewToPrevView).Xyz();
+    Float4 prevPosH = Transform(Float4(prevPosV, 1.0f), Data.proj);
+
+    if(prevPosH.w <= 0.0f)
+        return false;
+
+    Float2 prevTc(0.5f * prevPosH.x / prevPosH.w + 0.5f, -0.5f * prevPosH.y / prevPosH.w + 0.5f);
+
+    if(prevTc.x < 0.0f || prevTc.x >= 1.0f || prevTc.y < 0.0f || prevTc.y >= 1.0f)
+        return false;
+
+    PrevX = std::min((int)(prevTc.x * PrevNormalDepth.GetWidth()), PrevNormalDepth.GetWidth() - 1);
+    PrevY = std::min((int)(prevTc.y * PrevNormalDepth.GetHeight()), PrevNormalDepth.GetHeight() - 1);
+
+    const Float4 &prevNormalDepth = PrevNormalDepth.At(PrevX, PrevY);
+
+    if(fabsf(prevNormalDepth.w - prevPosV.z) > Data.params.depthThreshold * prevPosV.z)
+        return false;
+
+    Float3 prevNormal = Normalize(Transform(Float4(Normalize(normalDepth.Xyz()), 0.0f), Data.viewToPrevView).Xyz());
+
+    return Dot(prevNormal, Normalize(prevNormalDepth.Xyz())) >= Data.params.normalThreshold;
+}
+
+void TemporalSSAOEngine::Reset()
+{
+    hasHistory = false;
+    frameIndex = 0;
+    historyAcceptance = 0.0f;
+}
+
+void TemporalSSAOEngine::Compute(const NormalDepthImage &NormalDepth, const Matrix &View, const SSAOParams &Params, OcclusionImage &Occlusion) throw (Exception)
+{
+    if(Params.randomOffsets.GetWidth() == 0 || Params.randomOffsets.GetHeight() == 0)
+        throw CpuRenderingException("SSAO random offsets are not set");
+
+    if(Params.kernel.size() < (size_t)TemporalSubsetsCount)
+        throw CpuRenderingException("SSAO kernel is smaller than the temporal subsets count");
+
+    if(hasHistory && !prevNormalDepth.IsSameSize(NormalDepth))
+        Reset();
+
+    int subset = frameIndex % TemporalSubsetsCount;
+
+    SSAOParams frameParams = Params;
+    frameParams.kernel = GetKernelSubset(Params.kernel, subset);
+
+    std::swap(history, prevHistory);
+
+    if(!history.IsSameSize(NormalDepth))
+        history.Init(NormalDepth.GetWidth(), NormalDepth.GetHeight());
+
+    if(!Occlusion.IsSameSize(NormalDepth))
+        Occlusion.Init(NormalDepth.GetWidth(), NormalDepth.GetHeight());
+
+    ReprojectionData reprojection;
+    reprojection.viewToPrevView = Mul(Inverse(View), prevView);
+    reprojection.proj = Params.proj;
+    reprojection.invProj = Params.invProj;
+    reprojection.params = temporalParams;
+
+    std::atomic<size_t> acceptedPixels(0);
+
+    ForEachTile(pool, SplitToTiles(NormalDepth.GetWidth(), NormalDepth.GetHeight(), tileSize), [&](const Tile &Region)
+    {
+        size_t tileAcceptedPixels = 0;
+
+        for(int y = Region.top; y < Region.bottom; y++)
+            for(int x = Region.left; x < Region.right; x++){
+
+                float channels[TemporalSubsetsCount];
+                for(float &channel : channels)
+                    channel = TemporalHistoryEmpty;
+
+                int prevX, prevY;
+                if(hasHistory && Reproject(NormalDepth, prevNormalDepth, reprojection, x, y, prevX, prevY)){
+                    const Float4 &prev = prevHistory.At(prevX, prevY);
+                    channels[0] = prev.x;
+                    channels[1] = prev.y;
+                    channels[2] = prev.z;
+                    channels[3] = prev.w;
+                    tileAcceptedPixels++;
+                }
+
+                channels[subset] = SSAOEngine::ComputeVisibility(NormalDepth, frameParams, x, y);
+
+                history.At(x, y) = Float4(channels[0], channels[1], channels[2], channels[3]);
+
+                //subsets of a kernel whose size is divisible by TemporalSubsetsCount are of the same size,
+                //so the mean of their visibilities is the visibility of the whole kernel
+                float totalVisibility = 0.0f;
+                int count = 0;
+                for(float channel : channels)
+                    if(channel != TemporalHistoryEmpty){
+                        totalVisibility += channel;
+                        count++;
+                    }
+
+                float visibility = totalVisibility / count;
+                Occlusion.At(x, y) = visibility * visibility;
+            }
+
+        acceptedPixels += tileAcceptedPixels;
+    });
+
+    prevNormalDepth = NormalDepth;
+    prevView = View;
+    hasHistory = true;
+    frameIndex++;
+    historyAcceptance = (float)((double)acceptedPixels / ((double)NormalDepth.GetWidth() * NormalDepth.GetHeight()));
+}
+
+}
@@ -0,0 +1,136 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include <CpuRendering/ThreadPool.h>
+#include <algorithm>
+
+namespace CpuRendering
+{
+
+TilesStorage SplitToTiles(int Width, int Height, int TileSize)
+{
+    TilesStorage tiles;
+
+    for(int y = 0; y < Height; y += TileSize)
+        for(int x = 0; x < Width; x += TileSize)
+            tiles.push_back(Tile(x, y, std::min(x + TileSize, Width), std::min(y + TileSize, Height)));
+
+    return tiles;
+}
+
+TilesStorage SplitToRows(int Width, int Height, int RowsCount)
+{
+    TilesStorage tiles;
+
+    for(int y = 0; y < Height; y += RowsCount)
+        tiles.push_back(Tile(0, y, Width, std::min(y + RowsCount, Height)));
+
+    return tiles;
+}
+
+void ThreadPool::Init(size_t ThreadsCount)
+{
+    Release();
+
+    if(ThreadsCount == 0)
+        ThreadsCount = std::max(std::thread::hardware_concurrency(), 1u);
+
+    stopping = false;
+
+    for(size_t t = 1; t < ThreadsCount; t++)
+        workers.push_back(std::thread(&ThreadPool::WorkerLoop, this));
+}
+
+void ThreadPool::Release()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeUpCondition.notify_all();
+
+    for(std::thread &worker : workers)
+        worker.join();
+
+    workers.clear();
+}
+
+void ThreadPool::RunTasks()
+{
+    for(size_t index = nextTask++; index < tasksCount; index = nextTask++){
+        try{
+            (*task)(index);
+        }catch(...){
+            std::lock_guard<std::mutex> lock(mutex);
+            if(!taskException)
+                taskException = std::current_exception();
+        }
+    }
+}
+
+void ThreadPool::WorkerLoop()
+{
+    unsigned int lastGeneration = 0;
+
+    while(true){
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeUpCondition.wait(lock, [&]{return stopping || generation != lastGeneration;});
+
+            if(stopping)
+                return;
+
+            lastGeneration = generation;
+            busyWorkers++;
+        }
+
+        RunTasks();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            busyWorkers--;
+        }
+        doneCondition.notify_one();
+    }
+}
+
+void ThreadPool::Execute(size_t TasksCount, const Task &Function)
+{
+    if(TasksCount == 0)
+        return;
+
+    if(workers.empty() || TasksCount == 1){
+        for(size_t t = 0; t < TasksCount; t++)
+            Function(t);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        task = &Function;
+        tasksCount = TasksCount;
+        nextTask = 0;
+        taskException = std::exception_ptr();
+        generation++;
+    }
+    wakeUpCondition.notify_all();
+
+    RunTasks();
+
+    std::exception_ptr exception;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        doneCondition.wait(lock, [&]{return busyWorkers == 0 && nextTask >= tasksCount;});
+        task = NULL;
+        exception = taskException;
+    }
+
+    if(exception)
+        std::rethrow_exception(exception);
+}
+
+}
@@ -0,0 +1,124 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include <CpuRendering/TileClassification.h>
+#include <CpuRendering/SSAO.h>
+#include <algorithm>
+
+namespace CpuRendering
+{
+
+//tiles of the classification grid a task takes
+static const int ClassificationTaskSize = 16;
+
+TileStats GetTileStats(const NormalDepthImage &NormalDepth, const Tile &Region)
+{
+    TileStats stats;
+    Float3 normalSum;
+    int count = 0;
+
+    for(int y = Region.top; y < Region.bottom; y++){
+        const Float4 *row = NormalDepth.GetRow(y);
+
+        for(int x = Region.left; x < Region.right; x++){
+
+            if(row[x].w <= 0.0f)
+                continue;
+
+            stats.minDepth = (count == 0) ? row[x].w : std::min(stats.minDepth, row[x].w);
+            stats.maxDepth = std::max(stats.maxDepth, row[x].w);
+            normalSum += Normalize(row[x].Xyz());
+            count++;
+        }
+    }
+
+    if(count > 0)
+        stats.normalVariance = 1.0f - Length(normalSum) / count;
+
+    return stats;
+}
+
+float GetProjectedRadius(const SSAOParams &Params, float Depth, int Height)
+{
+    return Params.occlusionRadius * Params.proj.m[1][1] * 0.5f * Height / Depth;
+}
+
+TileClass ClassifyTile(const TileStats &Stats, const SSAOParams &Params, const TileClassificationParams &ClassificationParams, int Height)
+{
+    if(Stats.maxDepth <= 0.0f || GetProjectedRadius(Params, Stats.minDepth, Height) < ClassificationParams.minScreenRadius)
+        return TILE_CLASS_SKIPPED;
+
+    if(Stats.normalVariance < ClassificationParams.maxFlatNormalVariance &&
+       Stats.maxDepth - Stats.minDepth < ClassificationParams.maxFlatDepthRange * Params.occlusionRadius)
+        return TILE_CLASS_REDUCED;
+
+    return TILE_CLASS_FULL;
+}
+
+void TileClassification::Build(const NormalDepthImage &NormalDepth, const SSAOParams &Params, const TileClassificationParams &ClassificationParams,
+                               ThreadPool *Pool) throw (Exception)
+{
+    if(NormalDepth.GetWidth() == 0 || NormalDepth.GetHeight() == 0)
+        throw CpuRenderingException("Tile classification source is empty");
+
+    if(ClassificationParams.reducedSampleStep < 1)
+        throw CpuRenderingException("Reduced sample step must be positive");
+
+    const int tileSize = TileClassificationTileSize;
+
+    tilesX = (NormalDepth.GetWidth() + tileSize - 1) / tileSize;
+    tilesY = (NormalDepth.GetHeight() + tileSize - 1) / tileSize;
+    reducedSampleStep = ClassificationParams.reducedSampleStep;
+
+    stats.resize((size_t)tilesX * tilesY);
+    classes.resize((size_t)tilesX * tilesY);
+
+    ForEachTile(Pool, SplitToTiles(tilesX, tilesY, ClassificationTaskSize), [&](const Tile &Region)
+    {
+        for(int tileY = Region.top; tileY < Region.bottom; tileY++)
+            for(int tileX = Region.left; tileX < Region.right; tileX++){
+
+                Tile tile(tileX * tileSize, tileY * tileSize,
+                          std::min((tileX + 1) * tileSize, NormalDepth.GetWidth()), std::min((tileY + 1) * tileSize, NormalDepth.GetHeight()));
+
+                size_t index = (size_t)tileY * tilesX + tileX;
+                stats[index] = GetTileStats(NormalDepth, tile);
+                classes[index] = ClassifyTile(stats[index], Params, ClassificationParams, NormalDepth.GetHeight());
+            }
+    });
+
+    for(TilesStorage &list : lists)
+        list.clear();
+
+    for(int tileY = 0; tileY < tilesY; tileY++)
+        for(int tileX = 0; tileX < tilesX; tileX++)
+            lists[GetClass(tileX, tileY)].push_back(Tile(tileX * tileSize, tileY * tileSize,
+                                                         std::min((tileX + 1) * tileSize, NormalDepth.GetWidth()),
+                                                         std::min((tileY + 1) * tileSize, NormalDepth.GetHeight())));
+}
+
+TileClassificationCounters TileClassification::GetCounters(int KernelSize) const
+{
+    TileClassificationCounters counters;
+
+    for(int c = 0; c < TILE_CLASSES_COUNT; c++){
+        counters.tiles[c] = lists[c].size();
+
+        for(const Tile &tile : lists[c])
+            counters.pixels[c] += (size_t)tile.GetWidth() * tile.GetHeight();
+    }
+
+    //the reduced kernel is every reducedSampleStep sample starting from the first one
+    size_t reducedSamples = (size_t)(KernelSize + reducedSampleStep - 1) / reducedSampleStep;
+
+    counters.samples = counters.pixels[TILE_CLASS_REDUCED] * reducedSamples + counters.pixels[TILE_CLASS_FULL] * KernelSize;
+    counters.fullSamples = (counters.pixels[TILE_CLASS_SKIPPED] + counters.pixels[TILE_CLASS_REDUCED] + counters.pixels[TILE_CLASS_FULL]) * KernelSize;
+
+    return counters;
+}
+
+}
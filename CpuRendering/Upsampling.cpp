@@ -0,0 +1,116 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include <CpuRendering/Upsampling.h>
+#include <math.h>
+#include <algorithm>
+
+namespace CpuRendering
+{
+
+static const int UpsamplingTileSize = 64;
+
+void DownsampleNormalDepth(const NormalDepthImage &NormalDepth, int Scale, NormalDepthImage &Downsampled, ThreadPool *Pool) throw (Exception)
+{
+    if(Scale < 1)
+        throw CpuRenderingException("Invalid downsampling scale");
+
+    int width = GetScaledSize(NormalDepth.GetWidth(), Scale);
+    int height = GetScaledSize(NormalDepth.GetHeight(), Scale);
+
+    if(!Downsampled.IsSameSize(width, height))
+        Downsampled.Init(width, height);
+
+    ForEachTile(Pool, SplitToTiles(width, height, UpsamplingTileSize), [&](const Tile &Region)
+    {
+        for(int y = Region.top; y < Region.bottom; y++)
+            for(int x = Region.left; x < Region.right; x++){
+
+                Float4 result(1.0f, 1.0f, 1.0f, 0.0f);
+
+                for(int by = 0; by < Scale; by++)
+                    for(int bx = 0; bx < Scale; bx++){
+                        const Float4 &nd = NormalDepth.AtClamped(x * Scale + bx, y * Scale + by);
+                        if(nd.w > 0.0f && (result.w == 0.0f || nd.w < result.w))
+                            result = nd;
+                    }
+
+                Downsampled.At(x, y) = result;
+            }
+    });
+}
+
+void BilateralUpsample(const OcclusionImage &LowOcclusion,
+                       const NormalDepthImage &LowNormalDepth,
+                       const NormalDepthImage &NormalDepth,
+                       OcclusionImage &Occlusion,
+                       const BilateralUpsampleParams &Params,
+                       ThreadPool *Pool) throw (Exception)
+{
+    if(!LowOcclusion.IsSameSize(LowNormalDepth))
+        throw CpuRenderingException("Low resolution occlusion and normal/depth sizes differ");
+
+    if(LowOcclusion.GetWidth() == 0 || LowOcclusion.GetHeight() == 0)
+        throw CpuRenderingException("Low resolution occlusion is empty");
+
+    if(!Occlusion.IsSameSize(NormalDepth))
+        Occlusion.Init(NormalDepth.GetWidth(), NormalDepth.GetHeight());
+
+    float scaleX = (float)LowOcclusion.GetWidth() / NormalDepth.GetWidth();
+    float scaleY = (float)LowOcclusion.GetHeight() / NormalDepth.GetHeight();
+
+    ForEachTile(Pool, SplitToTiles(NormalDepth.GetWidth(), NormalDepth.GetHeight(), UpsamplingTileSize), [&](const Tile &Region)
+    {
+        for(int y = Region.top; y < Region.bottom; y++){
+
+            float ly = (y + 0.5f) * scaleY - 0.5f;
+            float fy0 = floorf(ly);
+            float fracY = ly - fy0;
+
+            for(int x = Region.left; x < Region.right; x++){
+
+                const Float4 &nd = NormalDepth.At(x, y);
+                Float3 normal = Normalize(nd.Xyz());
+                //background depth is zero
+                float depthScale = 1.0f / (Params.depthTolerance * std::max(nd.w, 1e-4f));
+
+                float lx = (x + 0.5f) * scaleX - 0.5f;
+                float fx0 = floorf(lx);
+                float fracX = lx - fx0;
+
+                float totalWeight = 0.0f, totalOcclusion = 0.0f;
+                float nearestDiff = -1.0f, nearestOcclusion = 1.0f;
+
+                for(int t = 0; t < 4; t++){
+                    int tx = (int)fx0 + (t & 1), ty = (int)fy0 + (t >> 1);
+
+                    const Float4 &lowNd = LowNormalDepth.AtClamped(tx, ty);
+                    float lowOcclusion = LowOcclusion.AtClamped(tx, ty);
+
+                    float bilinearWeight = ((t & 1) ? fracX : 1.0f - fracX) * ((t >> 1) ? fracY : 1.0f - fracY);
+                    float depthDiff = fabsf(lowNd.w - nd.w);
+                    float depthWeight = expf(-depthDiff * depthScale);
+                    float normalWeight = powf(Saturate(Dot(Normalize(lowNd.Xyz()), normal)), Params.normalPower);
+
+                    float weight = bilinearWeight * depthWeight * normalWeight;
+                    totalWeight += weight;
+                    totalOcclusion += lowOcclusion * weight;
+
+                    if(nearestDiff < 0.0f || depthDiff < nearestDiff){
+                        nearestDiff = depthDiff;
+                        nearestOcclusion = lowOcclusion;
+                    }
+                }
+
+                //none of the low resolution texels belongs to the surface, take the closest by depth
+                Occlusion.At(x, y) = (totalWeight > 1e-4f) ? totalOcclusion / totalWeight : nearestOcclusion;
+            }
+        }
+    });
+}
+
+}
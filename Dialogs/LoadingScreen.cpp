@@ -21,12 +21,12 @@ void SyncLoadingScreen::SetProgress(FLOAT NewProgress, const MessagesStorage &Me
     color[2] = 0.9;//Blue
     color[3] = 0;//Alpha
 
-    DeviceKeeper::GetDeviceContext()->ClearRenderTargetView(DeviceKeeper::GetRenderTargetView(), color);
-    DeviceKeeper::GetDeviceContext()->ClearDepthStencilView(DeviceKeeper::GetDepthStencilView(), D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.0f, 0);
+    DeviceKeeper::GetRenderContext()->ClearRenderTargetView(DeviceKeeper::GetRenderTargetView(), color);
+    DeviceKeeper::GetRenderContext()->ClearDepthStencilView(DeviceKeeper::GetDepthStencilView(), D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.0f, 0);
 
     Render();
 
-    HR(DeviceKeeper::GetSwapChain()->Present(0, 0));
+    HR(DeviceKeeper::GetRenderContext()->Present(0, 0));
 }
 
 }
\ No newline at end of file
@@ -19,6 +19,7 @@ void BlurredMenu::Init() throw (Exception)
     std::wstring vertexShaderPath = L"../Resources/Shaders/SimplePostProcess.vs";
     std::wstring pixelShaderPath = L"../Resources/Shaders/Blur.ps";
     blur.Init(vertexShaderPath, pixelShaderPath, &screenQuad, backgroundRt);
+    blur.SetIterationsFusion(true);
 
     showBlurVs.Load(L"../Resources/Shaders/SimplePostProcess.vs", "ProcessVertex", screenQuad.GetVertexMetadata());
     showBlurPs.Load(L"../Resources/Shaders/SimplePostProcess.ps", "ProcessPixel");
@@ -146,7 +146,7 @@ void Manager::Draw(const ControlsStorage &Controls) throw (Exception)
         return;
 
     D3D11_MAPPED_SUBRESOURCE rawData;
-    HR(DeviceKeeper::GetDeviceContext()->Map(dataVb, 0, D3D11_MAP_WRITE_DISCARD, 0, &rawData));
+    HR(DeviceKeeper::GetRenderContext()->Map(dataVb, 0, D3D11_MAP_WRITE_DISCARD, 0, &rawData));
 
     TransformedRect *rects = reinterpret_cast<TransformedRect*>(rawData.pData);
 
@@ -183,7 +183,7 @@ void Manager::Draw(const ControlsStorage &Controls) throw (Exception)
 
     rectsGroups.push_back(lastGroup);
 
-    DeviceKeeper::GetDeviceContext()->Unmap(dataVb, 0);
+    DeviceKeeper::GetRenderContext()->Unmap(dataVb, 0);
 
     vs.Apply();
     ps.Apply();
@@ -192,8 +192,8 @@ void Manager::Draw(const ControlsStorage &Controls) throw (Exception)
     UINT offset = 0;
     UINT stride = sizeof(TransformedRect);
 
-    DeviceKeeper::GetDeviceContext()->IASetVertexBuffers(0, 1, &dataVb, &stride, &offset);
-    DeviceKeeper::GetDeviceContext()->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_POINTLIST);
+    DeviceKeeper::GetRenderContext()->IASetVertexBuffers(0, 1, &dataVb, &stride, &offset);
+    DeviceKeeper::GetRenderContext()->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_POINTLIST);
     
     RenderStatesManager::GetInstance()->ProcessWithStates({"DisableDepthForGUI", "StandardAlfaBlendForGUI"}, [&]()
     {
@@ -209,7 +209,7 @@ void Manager::Draw(const ControlsStorage &Controls) throw (Exception)
                 defSmpStateSet = true;
             }
 
-            DeviceKeeper::GetDeviceContext()->Draw(grp.count, grp.offset);
+            DeviceKeeper::GetRenderContext()->Draw(grp.count, grp.offset);
         }
     });
 
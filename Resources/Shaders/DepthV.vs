@@ -0,0 +1,34 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+//depth only prepass, NormalVDepthV.vs without the normal transform and interpolants
+cbuffer Data : register(b0)
+{
+    matrix worldViewProj;
+    matrix worldView;
+};
+
+struct VIn
+{
+    float3 posL : POSITION;
+    float3 normalL : NORMAL;
+    float2 tex : TEXCOORD0;
+};
+
+struct VOut
+{
+    float4 posH : SV_POSITION;
+    float depthV : TEXCOORD0;
+};
+
+VOut ProcessVertex(VIn input)
+{
+    VOut output;
+    output.posH = mul(float4(input.posL, 1.0f), worldViewProj);
+    output.depthV = mul(float4(input.posL, 1.0f), worldView).z;
+    return output;
+}
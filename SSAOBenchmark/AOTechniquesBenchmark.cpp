@@ -0,0 +1,119 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include "Benchmark.h"
+#include "SyntheticScene.h"
+#include <stdio.h>
+#include <memory>
+#include <vector>
+
+namespace Benchmark
+{
+
+using namespace CpuRendering;
+
+struct TechniqueEntry
+{
+    std::string name;
+    std::shared_ptr<IAOEngine> engine;
+    int kernelSize;
+};
+
+static TechniqueEntry CreateSSAOEntry(ThreadPool *Pool, int KernelSize)
+{
+    char name[32];
+    sprintf(name, "SSAO %d", KernelSize);
+
+    TechniqueEntry entry;
+    entry.name = name;
+    entry.engine = std::make_shared<SSAOEngine>(Pool);
+    entry.kernelSize = KernelSize;
+
+    return entry;
+}
+
+static TechniqueEntry CreateHBAOEntry(ThreadPool *Pool, int DirectionsCount, int StepsCount)
+{
+    HBAOParams hbaoParams;
+    hbaoParams.directionsCount = DirectionsCount;
+    hbaoParams.stepsCount = StepsCount;
+
+    char name[32];
+    sprintf(name, "HBAO %dx%d", DirectionsCount, StepsCount);
+
+    TechniqueEntry entry;
+    entry.name = name;
+    entry.engine = std::make_shared<HBAOEngine>(Pool, hbaoParams);
+    entry.kernelSize = 16;
+
+    return entry;
+}
+
+static SSAOParams CreateTechniqueParams(const SyntheticScene &Scene, int KernelSize)
+{
+    SSAOParams params = CreateDefaultSSAOParams(Scene);
+
+    if(params.kernel.size() != (size_t)KernelSize)
+        params.kernel = CreateKernel(KernelSize);
+
+    return params;
+}
+
+void RunAOTechniques(const Settings &Settings)
+{
+    const Resolution timingRes = FullHDResolution;
+    const Resolution qualityRes = {640, 360};
+
+    std::vector<TechniqueEntry> techniques;
+    techniques.push_back(CreateSSAOEntry(Settings.pool, 16));
+    techniques.push_back(CreateSSAOEntry(Settings.pool, 8));
+    techniques.push_back(CreateHBAOEntry(Settings.pool, 8, 4));
+    techniques.push_back(CreateHBAOEntry(Settings.pool, 4, 4));
+    techniques.push_back(CreateHBAOEntry(Settings.pool, 4, 3));
+    techniques.push_back(CreateHBAOEntry(Settings.pool, 4, 2));
+    techniques.push_back(CreateHBAOEntry(Settings.pool, 2, 4));
+
+    SyntheticScene timingScene = CreateSyntheticScene(timingRes.width, timingRes.height);
+    SyntheticScene qualityScene = CreateSyntheticScene(qualityRes.width, qualityRes.height);
+
+    SSAOParams defaultParams = CreateDefaultSSAOParams(qualityScene);
+    OcclusionImage reference = CreateReferenceOcclusion(qualityScene, defaultParams.occlusionRadius, 8, Settings.pool);
+
+    printf("AO techniques, time at %dx%d, quality at %dx%d against 64 traced rays per pixel, %u threads\n",
+           timingRes.width, timingRes.height, qualityRes.width, qualityRes.height, (unsigned int)Settings.pool->GetThreadsCount());
+    printf("%-12s %8s %10s %12s %12s %12s\n", "technique", "fetches", "ms", "Mpixels/s", "mean diff", "correlation");
+
+    const TechniqueEntry *cheapest = NULL;
+    double cheapestSeconds = 0.0;
+
+    for(const TechniqueEntry &technique : techniques){
+
+        SSAOParams timingParams = CreateTechniqueParams(timingScene, technique.kernelSize);
+        SSAOParams qualityParams = CreateTechniqueParams(qualityScene, technique.kernelSize);
+
+        OcclusionImage occlusion;
+        double seconds = MeasureSeconds([&]{technique.engine->Compute(timingScene.normalDepth, timingParams, occlusion);}, Settings.iterations);
+
+        technique.engine->Compute(qualityScene.normalDepth, qualityParams, occlusion);
+        Quality quality = GetQuality(reference, occlusion, qualityScene.normalDepth);
+
+        printf("%-12s %8d %10.2f %12.2f %12.6f %12.4f\n", technique.name.c_str(), technique.engine->GetDepthFetchesCount(timingParams),
+               seconds * 1000.0, GetMegapixelsPerSecond(timingRes.width, timingRes.height, seconds), quality.meanDiff, quality.correlation);
+
+        if(quality.correlation >= Settings.qualityTarget && (cheapest == NULL || seconds < cheapestSeconds)){
+            cheapest = &technique;
+            cheapestSeconds = seconds;
+        }
+    }
+
+    if(cheapest != NULL)
+        printf("cheapest technique with correlation >= %.2f: %s\n", Settings.qualityTarget, cheapest->name.c_str());
+    else
+        printf("no technique reaches correlation %.2f\n", Settings.qualityTarget);
+}
+
+}
@@ -0,0 +1,82 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include "Benchmark.h"
+#include "SyntheticScene.h"
+#include <stdio.h>
+
+namespace Benchmark
+{
+
+using namespace CpuRendering;
+
+void RunAdaptiveSampling(const Settings &Settings)
+{
+    const Resolution res = {640, 360};
+
+    TileClassificationParams classificationParams;
+
+    printf("Adaptive SSAO sampling %dx%d, %dx%d tiles, reduced tiles take every %d sample, %u threads\n", res.width, res.height,
+           TileClassificationTileSize, TileClassificationTileSize, classificationParams.reducedSampleStep, (unsigned int)Settings.pool->GetThreadsCount());
+    printf("%-12s %8s %9s %9s %9s %14s %8s %9s %11s %9s %10s\n", "path", "frames", "skipped", "reduced", "full",
+           "samples/frame", "saved", "full ms", "adaptive ms", "class ms", "mean diff");
+
+    for(const NamedCameraPath &camera : CreateCameraPaths(Settings)){
+
+        SSAOEngine engine(Settings.pool);
+        SSAOEngine adaptiveEngine(Settings.pool);
+        adaptiveEngine.SetAdaptiveSampling(true, classificationParams);
+
+        double fullSeconds = 0.0, adaptiveSeconds = 0.0, classificationSeconds = 0.0, totalDiff = 0.0;
+        TileClassificationCounters total;
+
+        for(const Matrix &view : camera.path){
+
+            SyntheticScene scene = CreateSyntheticScene(res.width, res.height, view);
+            SSAOParams params = CreateDefaultSSAOParams(scene);
+
+            OcclusionImage reference, occlusion;
+
+            Stopwatch stopwatch;
+            engine.Compute(scene.normalDepth, params, reference);
+            fullSeconds += stopwatch.GetSeconds();
+
+            stopwatch.Restart();
+            adaptiveEngine.Compute(scene.normalDepth, params, occlusion);
+            adaptiveSeconds += stopwatch.GetSeconds();
+
+            //the classification the adaptive engine has built, rebuilt for the counters
+            TileClassification classification;
+            stopwatch.Restart();
+            classification.Build(scene.normalDepth, params, classificationParams, Settings.pool);
+            classificationSeconds += stopwatch.GetSeconds();
+
+            TileClassificationCounters counters = classification.GetCounters((int)params.kernel.size());
+            for(int c = 0; c < TILE_CLASSES_COUNT; c++)
+                total.tiles[c] += counters.tiles[c];
+            total.samples += counters.samples;
+            total.fullSamples += counters.fullSamples;
+
+            //background pixels of the skipped tiles are never shown
+            totalDiff += GetQuality(reference, occlusion, scene.normalDepth).meanDiff;
+        }
+
+        size_t framesCount = camera.path.size();
+        if(framesCount == 0)
+            continue;
+
+        double tilesCount = (double)(total.tiles[TILE_CLASS_SKIPPED] + total.tiles[TILE_CLASS_REDUCED] + total.tiles[TILE_CLASS_FULL]);
+
+        printf("%-12s %8u %8.1f%% %8.1f%% %8.1f%% %14.0f %7.1f%% %9.2f %11.2f %9.2f %10.6f\n", camera.name.c_str(), (unsigned int)framesCount,
+               total.tiles[TILE_CLASS_SKIPPED] * 100.0 / tilesCount, total.tiles[TILE_CLASS_REDUCED] * 100.0 / tilesCount,
+               total.tiles[TILE_CLASS_FULL] * 100.0 / tilesCount, (double)total.samples / framesCount,
+               100.0 - total.samples * 100.0 / total.fullSamples, fullSeconds * 1000.0 / framesCount,
+               adaptiveSeconds * 1000.0 / framesCount, classificationSeconds * 1000.0 / framesCount, totalDiff / framesCount);
+    }
+}
+
+}
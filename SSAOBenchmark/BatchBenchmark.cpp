@@ -0,0 +1,109 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include "Benchmark.h"
+#include "SyntheticScene.h"
+#include <stdio.h>
+#include <math.h>
+
+namespace Benchmark
+{
+
+using namespace CpuRendering;
+
+static const float Pi = 3.14159265f;
+
+static const int BatchViewsCount = 32;
+
+//views around the middle of the synthetic hall, looking at its center
+static CameraPath CreateOrbitViews(int ViewsCount)
+{
+    CameraPath views;
+    Float3 center(0.0f, 1.0f, 10.0f);
+
+    for(int v = 0; v < ViewsCount; v++){
+        float angle = 2.0f * Pi * v / ViewsCount;
+        Float3 pos(6.0f * sinf(angle), 1.5f, center.z - 6.0f * cosf(angle));
+        views.push_back(CreateTargetCameraView(pos, center));
+    }
+
+    return views;
+}
+
+void RunBatchAO(const Settings &Settings)
+{
+    const Resolution res = {640, 360};
+    const size_t threadsCounts[] = {1, 2, 4, 8};
+
+    struct SplitMode
+    {
+        const char *name;
+        BatchSplit split;
+    };
+
+    const SplitMode splits[] = {{"views", BATCH_SPLIT_VIEWS}, {"tiles", BATCH_SPLIT_TILES}};
+
+    TriangleMesh mesh = CreateSyntheticSceneMesh();
+    SyntheticScene scene = CreateSyntheticScene(res.width, res.height);
+    CameraPath views = CreateOrbitViews(BatchViewsCount);
+
+    BatchAOParams params;
+    params.width = res.width;
+    params.height = res.height;
+    params.ssao = CreateDefaultSSAOParams(scene);
+
+    printf("Batch AO of %d views %dx%d of the synthetic hall, prepass, 16 tap SSAO and edge saving blur per view\n",
+           BatchViewsCount, res.width, res.height);
+    printf("  %-6s %7s %10s %9s %9s %11s %10s\n", "split", "threads", "batch ms", "views/s", "scaling", "efficiency", "scratch");
+
+    for(const SplitMode &mode : splits){
+
+        double singleThreadSeconds = 0.0;
+
+        for(size_t threadsCount : threadsCounts){
+
+            ThreadPool pool;
+            pool.Init(threadsCount);
+
+            BatchAORenderer renderer(&pool);
+
+            //the images are dropped, the output queue is out of the measured time
+            double seconds = MeasureSeconds([&]
+            {
+                renderer.Render(mesh, views, params, mode.split, [](size_t ViewIndex, const std::shared_ptr<OcclusionImage> &Occlusion){});
+            }, Settings.iterations);
+
+            if(threadsCount == 1)
+                singleThreadSeconds = seconds;
+
+            double scaling = singleThreadSeconds / seconds;
+
+            printf("  %-6s %7u %10.2f %9.2f %8.2fx %10.1f%% %10u\n", mode.name, (unsigned int)threadsCount, seconds * 1000.0,
+                   BatchViewsCount / seconds, scaling, 100.0 * scaling / threadsCount, (unsigned int)renderer.GetScratchCount());
+        }
+    }
+
+    //cost of handing the images to the writer thread, the jobs keep the images alive without saving them
+    ThreadPool &pool = *Settings.pool;
+    BatchAORenderer renderer(&pool);
+    OutputQueue output(pool.GetThreadsCount() * 2);
+
+    double queuedSeconds = MeasureSeconds([&]
+    {
+        renderer.Render(mesh, views, params, BATCH_SPLIT_VIEWS, [&](size_t ViewIndex, const std::shared_ptr<OcclusionImage> &Occlusion)
+        {
+            output.Push([=]{(void)Occlusion->GetWidth();});
+        });
+    }, Settings.iterations);
+
+    output.Finish();
+
+    printf("\nwith the output queue, %u threads: %.2f views/s, %u jobs done\n", (unsigned int)pool.GetThreadsCount(),
+           BatchViewsCount / queuedSeconds, (unsigned int)output.GetDoneJobsCount());
+}
+
+}
@@ -0,0 +1,131 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include "Benchmark.h"
+#include <algorithm>
+#include <math.h>
+
+namespace Benchmark
+{
+
+using namespace CpuRendering;
+
+static const int PathFramesCount = 16;
+
+static Matrix GetPathView(const Float3 &Eye, float Yaw)
+{
+    return LookAtLH(Eye, Eye + Float3(sinf(Yaw), -0.05f, cosf(Yaw)), Float3(0.0f, 1.0f, 0.0f));
+}
+
+std::vector<NamedCameraPath> CreateCameraPaths(const Settings &Settings) throw (Exception)
+{
+    std::vector<NamedCameraPath> paths;
+
+    if(!Settings.cameraPath.empty()){
+        NamedCameraPath recorded;
+        recorded.name = Settings.cameraPath;
+        recorded.path = LoadCameraPath(Settings.cameraPath);
+        paths.push_back(recorded);
+        return paths;
+    }
+
+    NamedCameraPath staticPath, panPath, walkPath;
+    staticPath.name = "static";
+    panPath.name = "pan";
+    walkPath.name = "walk";
+
+    for(int f = 0; f < PathFramesCount; f++){
+        staticPath.path.push_back(GetPathView(Float3(0.0f, 0.0f, 0.0f), 0.1f));
+        panPath.path.push_back(GetPathView(Float3(0.0f, 0.0f, 0.0f), 0.1f + f * 0.01f));
+        walkPath.path.push_back(GetPathView(Float3(f * 0.02f, 0.0f, f * 0.1f), 0.1f));
+    }
+
+    paths.push_back(staticPath);
+    paths.push_back(panPath);
+    paths.push_back(walkPath);
+
+    return paths;
+}
+
+double MeasureSeconds(const std::function<void()> &Function, int Iterations)
+{
+    Function();
+
+    double best = 0.0;
+    for(int i = 0; i < Iterations; i++){
+        Stopwatch stopwatch;
+        Function();
+        double seconds = stopwatch.GetSeconds();
+        best = (i == 0) ? seconds : std::min(best, seconds);
+    }
+
+    return best;
+}
+
+double GetMegapixelsPerSecond(int Width, int Height, double Seconds)
+{
+    return (double)Width * Height / Seconds / 1000000.0;
+}
+
+Difference GetDifference(const CpuRendering::OcclusionImage &A, const CpuRendering::OcclusionImage &B)
+{
+    Difference difference;
+
+    double total = 0.0;
+
+    for(int y = 0; y < A.GetHeight(); y++)
+        for(int x = 0; x < A.GetWidth(); x++){
+            float diff = fabsf(A.At(x, y) - B.At(x, y));
+            difference.max = std::max(difference.max, diff);
+            total += diff;
+        }
+
+    difference.mean = (float)(total / ((double)A.GetWidth() * A.GetHeight()));
+
+    return difference;
+}
+
+Quality GetQuality(const CpuRendering::OcclusionImage &Reference, const CpuRendering::OcclusionImage &Occlusion, const CpuRendering::NormalDepthImage &NormalDepth)
+{
+    double sumRef = 0.0, sumOcc = 0.0, sumRefSq = 0.0, sumOccSq = 0.0, sumProducts = 0.0, sumDiff = 0.0;
+    size_t count = 0;
+
+    for(int y = 0; y < Reference.GetHeight(); y++)
+        for(int x = 0; x < Reference.GetWidth(); x++){
+
+            if(NormalDepth.At(x, y).w <= 0.0f)
+                continue;
+
+            double ref = Reference.At(x, y), occ = Occlusion.At(x, y);
+
+            sumRef += ref;
+            sumOcc += occ;
+            sumRefSq += ref * ref;
+            sumOccSq += occ * occ;
+            sumProducts += ref * occ;
+            sumDiff += fabs(ref - occ);
+            count++;
+        }
+
+    Quality quality;
+
+    if(count == 0)
+        return quality;
+
+    double covariance = sumProducts / count - (sumRef / count) * (sumOcc / count);
+    double varianceRef = sumRefSq / count - (sumRef / count) * (sumRef / count);
+    double varianceOcc = sumOccSq / count - (sumOcc / count) * (sumOcc / count);
+
+    quality.meanDiff = (float)(sumDiff / count);
+
+    if(varianceRef > 0.0 && varianceOcc > 0.0)
+        quality.correlation = (float)(covariance / sqrt(varianceRef * varianceOcc));
+
+    return quality;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,90 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#pragma once
+#include <functional>
+#include <string>
+#include <CpuRendering.h>
+
+namespace Benchmark
+{
+
+using CpuRendering::Stopwatch;
+
+struct Settings
+{
+    CpuRendering::ThreadPool *pool = NULL;
+    int iterations = 5;
+    //recorded by the demo (F2), synthetic paths are used if empty
+    std::string cameraPath;
+    //correlation with the ray traced reference the AO technique has to reach
+    float qualityTarget = 0.8f;
+};
+
+//best time of Iterations runs, one warm up run is not measured
+double MeasureSeconds(const std::function<void()> &Function, int Iterations);
+
+double GetMegapixelsPerSecond(int Width, int Height, double Seconds);
+
+struct Difference
+{
+    float mean = 0.0f, max = 0.0f;
+};
+
+//per pixel absolute difference of two images of the same size
+Difference GetDifference(const CpuRendering::OcclusionImage &A, const CpuRendering::OcclusionImage &B);
+
+//AO image against the reference of CreateReferenceOcclusion, background pixels are skipped
+struct Quality
+{
+    float meanDiff = 0.0f;
+    //Pearson correlation, does not depend on the intensity scale of a technique
+    float correlation = 0.0f;
+};
+
+Quality GetQuality(const CpuRendering::OcclusionImage &Reference, const CpuRendering::OcclusionImage &Occlusion, const CpuRendering::NormalDepthImage &NormalDepth);
+
+struct NamedCameraPath
+{
+    std::string name;
+    CpuRendering::CameraPath path;
+};
+
+//the path of Settings.cameraPath, or static, pan and walk paths through the synthetic hall
+std::vector<NamedCameraPath> CreateCameraPaths(const Settings &Settings) throw (Exception);
+
+struct Resolution
+{
+    int width, height;
+};
+
+const Resolution HDResolution = {1280, 720};
+const Resolution FullHDResolution = {1920, 1080};
+const Resolution UltraHDResolution = {3840, 2160};
+
+void RunSimdSSAO(const Settings &Settings);
+void RunResolutionScale(const Settings &Settings);
+void RunTemporalSSAO(const Settings &Settings);
+void RunDepthPyramid(const Settings &Settings);
+void RunAOTechniques(const Settings &Settings);
+void RunKernelSamples(const Settings &Settings);
+void RunDeinterleave(const Settings &Settings);
+void RunFormats(const Settings &Settings);
+void RunNormalReconstruction(const Settings &Settings);
+void RunAdaptiveSampling(const Settings &Settings);
+void RunMultiScale(const Settings &Settings);
+void RunBentNormals(const Settings &Settings);
+void RunFusedSSAO(const Settings &Settings);
+void RunEdgeSavingBlur(const Settings &Settings);
+void RunLinearBlur(const Settings &Settings);
+void RunBlurFusion(const Settings &Settings);
+void RunRecursiveBlur(const Settings &Settings);
+void RunSummedAreaTable(const Settings &Settings);
+void RunRasterizer(const Settings &Settings);
+void RunBatchAO(const Settings &Settings);
+
+}
@@ -0,0 +1,130 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include "Benchmark.h"
+#include "SyntheticScene.h"
+#include <stdio.h>
+#include <math.h>
+#include <algorithm>
+
+namespace Benchmark
+{
+
+using namespace CpuRendering;
+
+static const float Pi = 3.14159265f;
+
+//overhead of the bent normal output the AO pass may have
+static const double MaxOverhead = 0.05;
+
+static float GetAngle(const Float3 &A, const Float3 &B)
+{
+    return atan2f(Length(Cross(A, B)), Dot(A, B)) * 180.0f / Pi;
+}
+
+//Bent normals against the surface normals and their R8G8 packing, over the surface pixels
+struct BentNormalStats
+{
+    float meanBend = 0.0f;
+    float behindSurface = 0.0f;
+    float packingMean = 0.0f, packingMax = 0.0f;
+};
+
+static BentNormalStats GetBentNormalStats(const NormalDepthImage &NormalDepth, const BentNormalImage &BentNormals, ThreadPool *Pool)
+{
+    PackedBentNormalImage packed;
+    BentNormalImage unpacked;
+    PackBentNormals(BentNormals, packed, Pool);
+    UnpackBentNormals(packed, unpacked, Pool);
+
+    BentNormalStats stats;
+    double bendTotal = 0.0, packingTotal = 0.0;
+    size_t count = 0, behindCount = 0;
+
+    for(int y = 0; y < NormalDepth.GetHeight(); y++)
+        for(int x = 0; x < NormalDepth.GetWidth(); x++){
+
+            if(NormalDepth.At(x, y).w <= 0.0f)
+                continue;
+
+            Float3 normal = Normalize(NormalDepth.At(x, y).Xyz()), bent = BentNormals.At(x, y);
+
+            bendTotal += GetAngle(normal, bent);
+            if(Dot(normal, bent) < 0.0f)
+                behindCount++;
+
+            float packingError = GetAngle(bent, unpacked.At(x, y));
+            packingTotal += packingError;
+            stats.packingMax = std::max(stats.packingMax, packingError);
+
+            count++;
+        }
+
+    if(count == 0)
+        return stats;
+
+    stats.meanBend = (float)(bendTotal / count);
+    stats.behindSurface = 100.0f * behindCount / count;
+    stats.packingMean = (float)(packingTotal / count);
+
+    return stats;
+}
+
+void RunBentNormals(const Settings &Settings)
+{
+    const Resolution res = FullHDResolution;
+
+    SyntheticScene scene = CreateSyntheticScene(res.width, res.height);
+    SSAOParams params = CreateDefaultSSAOParams(scene);
+
+    printf("Bent normals of the SSAO taps %dx%d, %d samples, %u threads\n", res.width, res.height,
+           (int)params.kernel.size(), (unsigned int)Settings.pool->GetThreadsCount());
+    printf("  %-14s %9s %13s %9s %10s %10s %10s %10s %10s\n", "depth", "AO ms", "AO + bent ms", "overhead",
+           "AO diff", "bend deg", "behind", "pack deg", "pack max");
+
+    bool withinBudget = true;
+
+    for(int usePyramid = 0; usePyramid < 2; usePyramid++){
+
+        SSAOEngine engine(Settings.pool);
+        engine.SetDepthPyramidMode(usePyramid != 0);
+
+        OcclusionImage occlusion, bentOcclusion;
+        BentNormalImage bentNormals;
+
+        engine.Compute(scene.normalDepth, params, occlusion);
+        engine.ComputeWithBentNormals(scene.normalDepth, params, bentOcclusion, bentNormals);
+
+        //runs alternate so both outputs see the same machine load, the best time of each is taken
+        double aoSeconds = 0.0, bentSeconds = 0.0;
+        for(int i = 0; i < Settings.iterations; i++){
+            Stopwatch stopwatch;
+            engine.Compute(scene.normalDepth, params, occlusion);
+            double seconds = stopwatch.GetSeconds();
+            aoSeconds = (i == 0) ? seconds : std::min(aoSeconds, seconds);
+
+            stopwatch.Restart();
+            engine.ComputeWithBentNormals(scene.normalDepth, params, bentOcclusion, bentNormals);
+            seconds = stopwatch.GetSeconds();
+            bentSeconds = (i == 0) ? seconds : std::min(bentSeconds, seconds);
+        }
+
+        double overhead = bentSeconds / aoSeconds - 1.0;
+        withinBudget = withinBudget && overhead < MaxOverhead;
+
+        BentNormalStats stats = GetBentNormalStats(scene.normalDepth, bentNormals, Settings.pool);
+
+        printf("  %-14s %9.2f %13.2f %8.2f%% %10.6f %10.2f %9.3f%% %10.3f %10.3f\n", (usePyramid) ? "pyramid" : "full resolution",
+               aoSeconds * 1000.0, bentSeconds * 1000.0, overhead * 100.0, GetDifference(occlusion, bentOcclusion).max,
+               stats.meanBend, stats.behindSurface, stats.packingMean, stats.packingMax);
+    }
+
+    printf("\nbent normal output per pixel: %d bytes, overhead %s %.0f%% of the AO time\n", (int)sizeof(PackedBentNormal),
+           (withinBudget) ? "within" : "OVER", MaxOverhead * 100.0);
+}
+
+}
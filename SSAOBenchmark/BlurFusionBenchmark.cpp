@@ -0,0 +1,107 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include "Benchmark.h"
+#include "SyntheticScene.h"
+#include <stdio.h>
+#include <math.h>
+
+namespace Benchmark
+{
+
+using namespace CpuRendering;
+
+//Blur.ps passes with the bilinear taps, Iterations pairs of the vertical and the horizontal pass
+static void BlurLinear(OcclusionImage &Occlusion, const BlurKernel &Kernel, int Iterations, OcclusionImage &Intermediate, ThreadPool *Pool)
+{
+    for(int i = 0; i < Iterations; i++){
+        LinearBlurPass(Occlusion, Kernel, true, 0, Intermediate, Pool);
+        LinearBlurPass(Intermediate, Kernel, false, 0, Occlusion, Pool);
+    }
+}
+
+//max difference of the pixels farther than Border from the image borders
+static float GetInteriorDifference(const OcclusionImage &A, const OcclusionImage &B, int Border)
+{
+    float maxDiff = 0.0f;
+
+    for(int y = Border; y < A.GetHeight() - Border; y++)
+        for(int x = Border; x < A.GetWidth() - Border; x++){
+            float diff = fabsf(A.At(x, y) - B.At(x, y));
+            maxDiff = (diff > maxDiff) ? diff : maxDiff;
+        }
+
+    return maxDiff;
+}
+
+void RunBlurFusion(const Settings &Settings)
+{
+    const Resolution res = FullHDResolution;
+    const int radius = 5;
+    const int maxIterations = 6;
+
+    SyntheticScene scene = CreateSyntheticScene(res.width, res.height);
+    SSAOEngine engine(Settings.pool);
+
+    OcclusionImage occlusion;
+    engine.Compute(scene.normalDepth, CreateDefaultSSAOParams(scene), occlusion);
+
+    BlurKernel kernel = CreateGaussianBlurKernel(radius);
+    int singleFetches = (int)CreateLinearBlurKernel(kernel).size();
+
+    //R8 AO target, every pass reads and writes the screen once
+    double passMegabytes = 2.0 * res.width * res.height / (1024.0 * 1024.0);
+
+    printf("Blur iterations fused to one pass of the iterated kernel, gaussian of radius %d, bilinear taps, %dx%d, %u threads\n",
+           radius, res.width, res.height, (unsigned int)Settings.pool->GetThreadsCount());
+    printf("  %5s | %6s %8s %8s %9s | %6s %8s %8s %9s | %10s %10s | %10s %10s\n", "iters", "passes", "fetches", "R8 MB", "ms",
+           "passes", "fetches", "R8 MB", "ms", "max diff", "interior", "edge max", "edge mean");
+
+    for(int iterations = 1; iterations <= maxIterations; iterations++){
+
+        BlurKernel iteratedKernel = CreateIteratedBlurKernel(kernel, iterations);
+        int fusedFetches = (int)CreateLinearBlurKernel(iteratedKernel).size();
+
+        OcclusionImage iterated, fused, intermediate;
+
+        double iteratedSeconds = MeasureSeconds([&]
+        {
+            iterated = occlusion;
+            BlurLinear(iterated, kernel, iterations, intermediate, Settings.pool);
+        }, Settings.iterations);
+
+        double fusedSeconds = MeasureSeconds([&]
+        {
+            fused = occlusion;
+            BlurLinear(fused, iteratedKernel, 1, intermediate, Settings.pool);
+        }, Settings.iterations);
+
+        //the edge saving blur is not a convolution, the single wide pass is not its iterations
+        EdgeSavingBlurParams edgeParams;
+        edgeParams.kernel = kernel;
+        edgeParams.iterations = iterations;
+
+        OcclusionImage edgeIterated = occlusion, edgeFused = occlusion;
+        EdgeSavingBlur(edgeIterated, scene.normalDepth, edgeParams, intermediate, Settings.pool);
+
+        edgeParams.kernel = iteratedKernel;
+        edgeParams.iterations = 1;
+        EdgeSavingBlur(edgeFused, scene.normalDepth, edgeParams, intermediate, Settings.pool);
+
+        Difference edgeDiff = GetDifference(edgeIterated, edgeFused);
+
+        printf("  %5d | %6d %8d %8.1f %9.2f | %6d %8d %8.1f %9.2f | %10.6f %10.6f | %10.6f %10.6f\n", iterations,
+               2 * iterations, 2 * iterations * singleFetches, 2 * iterations * passMegabytes, iteratedSeconds * 1000.0,
+               2, 2 * fusedFetches, 2 * passMegabytes, fusedSeconds * 1000.0,
+               GetDifference(iterated, fused).max, GetInteriorDifference(iterated, fused, radius * iterations),
+               edgeDiff.max, edgeDiff.mean);
+    }
+
+    printf("\nfetches per pixel of all passes, the clamped borders differ within the iterated radius, the interior is the rest\n");
+}
+
+}
@@ -0,0 +1,59 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include "CacheSimulator.h"
+
+namespace Benchmark
+{
+
+CacheSimulator::CacheSimulator(size_t Size, size_t WaysCount, size_t LineSize) : lineSize(LineSize), waysCount(WaysCount)
+{
+    setsCount = Size / (LineSize * WaysCount);
+    if(setsCount == 0)
+        setsCount = 1;
+
+    Reset();
+}
+
+void CacheSimulator::Reset()
+{
+    tags.assign(setsCount * waysCount, 0);
+    usedWays.assign(setsCount, 0);
+    accesses = misses = 0;
+}
+
+void CacheSimulator::Access(const void *Address)
+{
+    size_t line = reinterpret_cast<size_t>(Address) / lineSize;
+    size_t set = line % setsCount;
+
+    size_t *setTags = &tags[set * waysCount];
+    size_t &used = usedWays[set];
+
+    accesses++;
+
+    size_t way = 0;
+    while(way < used && setTags[way] != line)
+        way++;
+
+    if(way == used){
+        misses++;
+
+        if(used < waysCount)
+            used++;
+
+        //the least recently used line is evicted
+        way = used - 1;
+    }
+
+    for(; way > 0; way--)
+        setTags[way] = setTags[way - 1];
+
+    setTags[0] = line;
+}
+
+}
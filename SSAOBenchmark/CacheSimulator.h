@@ -0,0 +1,66 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#pragma once
+#include <vector>
+#include <stddef.h>
+#include <math.h>
+#include <CpuRendering.h>
+
+namespace Benchmark
+{
+
+//Set associative LRU cache model fed with the addresses of traced texel fetches.
+//Hardware counters are not portable (and not available on every machine the benchmark runs on),
+//so memory access patterns are compared by the misses of this model
+class CacheSimulator
+{
+private:
+    size_t lineSize, waysCount, setsCount;
+    //tags of every set, the most recently used first
+    std::vector<size_t> tags;
+    std::vector<size_t> usedWays;
+    size_t accesses = 0, misses = 0;
+public:
+    //default is a 32KB 8-way cache with 64 byte lines, the size of a texture L1 of a GPU core
+    CacheSimulator(size_t Size = 32 * 1024, size_t WaysCount = 8, size_t LineSize = 64);
+    void Access(const void *Address);
+    void Reset();
+    size_t GetAccessesCount() const {return accesses;}
+    size_t GetMissesCount() const {return misses;}
+    double GetMissRate() const {return (accesses != 0) ? (double)misses / accesses : 0.0;}
+};
+
+//feeds the cache with the four texels a bilinear fetch reads
+template<class TPixel>
+void TraceBilinearFetch(const CpuRendering::Image<TPixel> &Source, const CpuRendering::Float2 &TexCoord, CacheSimulator &Cache)
+{
+    int x0 = (int)floorf(TexCoord.x * Source.GetWidth() - 0.5f);
+    int y0 = (int)floorf(TexCoord.y * Source.GetHeight() - 0.5f);
+
+    Cache.Access(&Source.AtClamped(x0, y0));
+    Cache.Access(&Source.AtClamped(x0 + 1, y0));
+    Cache.Access(&Source.AtClamped(x0, y0 + 1));
+    Cache.Access(&Source.AtClamped(x0 + 1, y0 + 1));
+}
+
+//Depth sampler of ComputeSSAOVisibility reading the full resolution normal/depth buffer through the cache model
+class TracingFlatSampler
+{
+private:
+    const CpuRendering::NormalDepthImage &normalDepth;
+    CacheSimulator &cache;
+public:
+    TracingFlatSampler(const CpuRendering::NormalDepthImage &NormalDepth, CacheSimulator &Cache) : normalDepth(NormalDepth), cache(Cache){}
+    float Sample(const CpuRendering::Float2 &TexCoord, const CpuRendering::Float2 &OriginTexCoord) const
+    {
+        TraceBilinearFetch(normalDepth, TexCoord, cache);
+        return CpuRendering::SampleDepthLinear(normalDepth, TexCoord);
+    }
+};
+
+}
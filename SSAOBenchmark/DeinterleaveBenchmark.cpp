@@ -0,0 +1,111 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include "Benchmark.h"
+#include "SyntheticScene.h"
+#include "CacheSimulator.h"
+#include <stdio.h>
+
+namespace Benchmark
+{
+
+using namespace CpuRendering;
+
+class TracingLayerSampler
+{
+private:
+    LayerDepthSampler sampler;
+    CacheSimulator &cache;
+public:
+    TracingLayerSampler(const DeinterleavedDepth &Depth, int Layer, CacheSimulator &Cache) : sampler(Depth, Layer), cache(Cache){}
+    float Sample(const Float2 &TexCoord, const Float2 &OriginTexCoord) const
+    {
+        const DepthImage &layer = sampler.GetLayer();
+        Float2 texel = sampler.GetLayerTexel(TexCoord);
+
+        TraceBilinearFetch(layer, Float2((texel.x + 0.5f) / layer.GetWidth(), (texel.y + 0.5f) / layer.GetHeight()), cache);
+        return sampler.Sample(TexCoord, OriginTexCoord);
+    }
+};
+
+//single thread walk over the pixels in the order SSAOEngine shades them
+static void TraceInterleaved(const NormalDepthImage &NormalDepth, const SSAOParams &Params, CacheSimulator &Cache)
+{
+    TracingFlatSampler sampler(NormalDepth, Cache);
+
+    for(const Tile &tile : SplitToTiles(NormalDepth.GetWidth(), NormalDepth.GetHeight(), SSAOEngine().GetTileSize()))
+        for(int y = tile.top; y < tile.bottom; y++)
+            for(int x = tile.left; x < tile.right; x++)
+                ComputeSSAOVisibility(NormalDepth, Params, x, y, sampler);
+}
+
+static void TraceDeinterleaved(const NormalDepthImage &NormalDepth, const SSAOParams &Params, const DeinterleavedDepth &Depth, CacheSimulator &Cache)
+{
+    int layerWidth = Depth.GetLayerWidth(), layerHeight = Depth.GetLayerHeight();
+
+    for(int layer = 0; layer < DeinterleavedLayersCount; layer++){
+
+        int layerX = layer % DeinterleaveFactor, layerY = layer / DeinterleaveFactor;
+        TracingLayerSampler sampler(Depth, layer, Cache);
+
+        for(const Tile &tile : SplitToTiles(layerWidth, layerHeight, SSAOEngine().GetTileSize()))
+            for(int y = tile.top; y < tile.bottom; y++)
+                for(int x = tile.left; x < tile.right; x++){
+                    int pixelX = x * DeinterleaveFactor + layerX, pixelY = y * DeinterleaveFactor + layerY;
+
+                    if(pixelX < NormalDepth.GetWidth() && pixelY < NormalDepth.GetHeight())
+                        ComputeSSAOVisibility(NormalDepth, Params, pixelX, pixelY, sampler);
+                }
+    }
+}
+
+void RunDeinterleave(const Settings &Settings)
+{
+    const Resolution res = FullHDResolution;
+    const float radiuses[] = {0.8f, 2.0f, 5.0f};
+
+    SyntheticScene scene = CreateSyntheticScene(res.width, res.height);
+    SSAOParams params = CreateDefaultSSAOParams(scene);
+
+    DeinterleavedDepth depth;
+    double buildSeconds = MeasureSeconds([&]{depth.Build(scene.normalDepth, Settings.pool);}, Settings.iterations);
+
+    CacheSimulator cache;
+
+    printf("Deinterleaved SSAO %dx%d, %d layers of %dx%d split in %.2f ms, %u threads\n", res.width, res.height, DeinterleavedLayersCount,
+           depth.GetLayerWidth(), depth.GetLayerHeight(), buildSeconds * 1000.0, (unsigned int)Settings.pool->GetThreadsCount());
+    printf("cache model: 32KB 8-way LRU, 64 byte lines, tap fetches of one thread\n");
+    printf("%-8s %-14s %10s %10s %14s %10s %12s\n", "radius", "layout", "ms", "speedup", "misses/pixel", "miss rate", "mean diff");
+
+    for(float radius : radiuses){
+
+        params.occlusionRadius = radius;
+
+        SSAOEngine interleavedEngine(Settings.pool), deinterleavedEngine(Settings.pool);
+        deinterleavedEngine.SetDeinterleavedMode(true);
+
+        OcclusionImage interleavedOcclusion, deinterleavedOcclusion;
+        double interleavedSeconds = MeasureSeconds([&]{interleavedEngine.Compute(scene.normalDepth, params, interleavedOcclusion);}, Settings.iterations);
+        double deinterleavedSeconds = MeasureSeconds([&]{deinterleavedEngine.Compute(scene.normalDepth, params, deinterleavedOcclusion);}, Settings.iterations);
+
+        double pixelsCount = (double)res.width * res.height;
+
+        cache.Reset();
+        TraceInterleaved(scene.normalDepth, params, cache);
+
+        printf("%-8.1f %-14s %10.2f %10.2f %14.2f %9.2f%% %12s\n", radius, "interleaved", interleavedSeconds * 1000.0, 1.0,
+               cache.GetMissesCount() / pixelsCount, cache.GetMissRate() * 100.0, "-");
+
+        cache.Reset();
+        TraceDeinterleaved(scene.normalDepth, params, depth, cache);
+
+        printf("%-8.1f %-14s %10.2f %10.2f %14.2f %9.2f%% %12.6f\n", radius, "deinterleaved", deinterleavedSeconds * 1000.0, interleavedSeconds / deinterleavedSeconds,
+               cache.GetMissesCount() / pixelsCount, cache.GetMissRate() * 100.0, GetDifference(interleavedOcclusion, deinterleavedOcclusion).mean);
+    }
+}
+
+}
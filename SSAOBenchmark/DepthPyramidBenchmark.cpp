@@ -0,0 +1,103 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include "Benchmark.h"
+#include "SyntheticScene.h"
+#include "CacheSimulator.h"
+#include <stdio.h>
+
+namespace Benchmark
+{
+
+using namespace CpuRendering;
+
+class TracingPyramidSampler
+{
+private:
+    const DepthPyramid &pyramid;
+    PyramidDepthSampler sampler;
+    CacheSimulator &cache;
+    size_t *levelTaps;
+public:
+    TracingPyramidSampler(const DepthPyramid &Pyramid, CacheSimulator &Cache, size_t *LevelTaps) : pyramid(Pyramid), sampler(Pyramid), cache(Cache), levelTaps(LevelTaps){}
+    float Sample(const Float2 &TexCoord, const Float2 &OriginTexCoord) const
+    {
+        int level = sampler.GetLevel(TexCoord, OriginTexCoord);
+        levelTaps[level]++;
+
+        TraceBilinearFetch(pyramid.GetDepth(level), TexCoord, cache);
+        return SampleDepthLinear(pyramid.GetDepth(level), TexCoord);
+    }
+};
+
+//single thread walk over the tiles in the order SSAOEngine hands them to a worker
+template<class TSampler>
+static void TraceSSAO(const NormalDepthImage &NormalDepth, const SSAOParams &Params, const TSampler &Sampler)
+{
+    for(const Tile &tile : SplitToTiles(NormalDepth.GetWidth(), NormalDepth.GetHeight(), SSAOEngine().GetTileSize()))
+        for(int y = tile.top; y < tile.bottom; y++)
+            for(int x = tile.left; x < tile.right; x++)
+                ComputeSSAOVisibility(NormalDepth, Params, x, y, Sampler);
+}
+
+void RunDepthPyramid(const Settings &Settings)
+{
+    const Resolution res = FullHDResolution;
+    const float radiuses[] = {0.8f, 2.0f, 5.0f};
+
+    SyntheticScene scene = CreateSyntheticScene(res.width, res.height);
+    SSAOParams params = CreateDefaultSSAOParams(scene);
+
+    DepthPyramid pyramid;
+    double buildSeconds = MeasureSeconds([&]{pyramid.Build(scene.normalDepth, DepthPyramidMaxLevelsCount, Settings.pool);}, Settings.iterations);
+
+    CacheSimulator cache;
+
+    printf("SSAO depth pyramid %dx%d, %d levels built in %.2f ms, %u threads\n", res.width, res.height,
+           pyramid.GetLevelsCount(), buildSeconds * 1000.0, (unsigned int)Settings.pool->GetThreadsCount());
+    printf("cache model: 32KB 8-way LRU, 64 byte lines, tap fetches of one thread\n");
+    printf("%-8s %-8s %10s %10s %14s %10s %12s   %s\n", "radius", "lookup", "ms", "speedup", "misses/pixel", "miss rate", "mean diff", "taps per level");
+
+    for(float radius : radiuses){
+
+        params.occlusionRadius = radius;
+
+        SSAOEngine flatEngine(Settings.pool), pyramidEngine(Settings.pool);
+        pyramidEngine.SetDepthPyramidMode(true);
+
+        OcclusionImage flatOcclusion, pyramidOcclusion;
+        double flatSeconds = MeasureSeconds([&]{flatEngine.Compute(scene.normalDepth, params, flatOcclusion);}, Settings.iterations);
+        double pyramidSeconds = MeasureSeconds([&]{pyramidEngine.Compute(scene.normalDepth, params, pyramidOcclusion);}, Settings.iterations);
+
+        double pixelsCount = (double)res.width * res.height;
+
+        cache.Reset();
+        TraceSSAO(scene.normalDepth, params, TracingFlatSampler(scene.normalDepth, cache));
+
+        printf("%-8.1f %-8s %10.2f %10.2f %14.2f %9.2f%% %12s\n", radius, "flat", flatSeconds * 1000.0, 1.0,
+               cache.GetMissesCount() / pixelsCount, cache.GetMissRate() * 100.0, "-");
+
+        size_t levelTaps[DepthPyramidMaxLevelsCount] = {};
+
+        cache.Reset();
+        TraceSSAO(scene.normalDepth, params, TracingPyramidSampler(pyramid, cache, levelTaps));
+
+        printf("%-8.1f %-8s %10.2f %10.2f %14.2f %9.2f%% %12.6f  ", radius, "pyramid", pyramidSeconds * 1000.0, flatSeconds / pyramidSeconds,
+               cache.GetMissesCount() / pixelsCount, cache.GetMissRate() * 100.0, GetDifference(flatOcclusion, pyramidOcclusion).mean);
+
+        size_t totalTaps = 0;
+        for(int level = 0; level < pyramid.GetLevelsCount(); level++)
+            totalTaps += levelTaps[level];
+
+        for(int level = 0; level < pyramid.GetLevelsCount(); level++)
+            printf(" %5.1f%%", levelTaps[level] * 100.0 / totalTaps);
+
+        printf("\n");
+    }
+}
+
+}
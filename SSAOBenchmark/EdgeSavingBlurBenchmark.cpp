@@ -0,0 +1,69 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include "Benchmark.h"
+#include "SyntheticScene.h"
+#include <stdio.h>
+
+namespace Benchmark
+{
+
+using namespace CpuRendering;
+
+void RunEdgeSavingBlur(const Settings &Settings)
+{
+    const Resolution resolutions[] = {FullHDResolution, UltraHDResolution};
+    const int radiuses[] = {3, 5, 8};
+
+    printf("Edge saving blur, the EdgeSavingBlur.ps port against the transposed row engine, 1 iteration, %u threads\n",
+           (unsigned int)Settings.pool->GetThreadsCount());
+    printf("  %-10s %6s %9s %9s %11s %9s %11s %11s %8s %9s\n", "resolution", "radius", "V ms", "H ms", "shader ms", "engine ms",
+           "shader MP/s", "engine MP/s", "speedup", "max diff");
+
+    for(const Resolution &res : resolutions){
+
+        SyntheticScene scene = CreateSyntheticScene(res.width, res.height);
+        SSAOEngine ssao(Settings.pool);
+
+        OcclusionImage occlusion;
+        ssao.Compute(scene.normalDepth, CreateDefaultSSAOParams(scene), occlusion);
+
+        char name[32];
+        sprintf(name, "%dx%d", res.width, res.height);
+
+        for(int radius : radiuses){
+
+            EdgeSavingBlurParams params;
+            params.kernel = CreateGaussianBlurKernel(radius);
+
+            OcclusionImage intermediate, reference, blurred;
+
+            double vertical = MeasureSeconds([&]{EdgeSavingBlurPass(occlusion, scene.normalDepth, params, true, intermediate, Settings.pool);},
+                                             Settings.iterations);
+            double horizontal = MeasureSeconds([&]{EdgeSavingBlurPass(intermediate, scene.normalDepth, params, false, reference, Settings.pool);},
+                                               Settings.iterations);
+
+            EdgeSavingBlurEngine engine(Settings.pool);
+            double engineSeconds = MeasureSeconds([&]
+            {
+                blurred = occlusion;
+                engine.Blur(blurred, scene.normalDepth, params);
+            }, Settings.iterations);
+
+            double shaderSeconds = vertical + horizontal;
+
+            printf("  %-10s %6d %9.2f %9.2f %11.2f %9.2f %11.1f %11.1f %7.2fx %9.6f\n", name, radius, vertical * 1000.0, horizontal * 1000.0,
+                   shaderSeconds * 1000.0, engineSeconds * 1000.0, GetMegapixelsPerSecond(res.width, res.height, shaderSeconds),
+                   GetMegapixelsPerSecond(res.width, res.height, engineSeconds), shaderSeconds / engineSeconds,
+                   GetDifference(reference, blurred).max);
+        }
+    }
+
+    printf("\nengine time includes the normalization of the normals, the copy of the AO and 3 transposes per iteration\n");
+}
+
+}
@@ -0,0 +1,243 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include "Benchmark.h"
+#include "SyntheticScene.h"
+#include <stdio.h>
+#include <math.h>
+#include <algorithm>
+
+namespace Benchmark
+{
+
+using namespace CpuRendering;
+
+static const float Pi = 3.14159265f;
+
+//round trip error bounds, a codec change that breaks them fails the run
+static const float MaxNormalErrorDegrees = 0.01f;
+static const float MaxDepth16Error = 0.5f * PackedMaxDepth / 65535.0f + 1e-4f;
+static const float MaxDepth32Error = 1e-4f;
+static const float MaxOcclusionError = 0.5f / 255.0f + 1e-6f;
+
+struct RoundTripError
+{
+    float maxNormalDegrees = 0.0f;
+    float maxDepth = 0.0f;
+};
+
+static void AccumulateError(const Float4 &Source, const Float4 &Decoded, RoundTripError &Error)
+{
+    //acos of the dot product has no precision left at the angles the 16 bit encoding gives
+    Float3 source = Normalize(Source.Xyz()), decoded = Decoded.Xyz();
+    Error.maxNormalDegrees = std::max(Error.maxNormalDegrees, atan2f(Length(Cross(source, decoded)), Dot(source, decoded)) * 180.0f / Pi);
+    Error.maxDepth = std::max(Error.maxDepth, fabsf(Source.w - Decoded.w));
+}
+
+//Fibonacci sphere directions and the axis aligned ones the octahedron folds at, depths over the whole range
+static RoundTripError GetSweepError(DepthPrecision Precision)
+{
+    const int directionsCount = 1 << 20;
+
+    RoundTripError error;
+
+    for(int i = 0; i < directionsCount; i++){
+
+        float z = 1.0f - (2.0f * i + 1.0f) / directionsCount;
+        float r = sqrtf(1.0f - z * z);
+        float phi = i * Pi * (3.0f - sqrtf(5.0f));
+
+        Float4 source(Float3(r * cosf(phi), r * sinf(phi), z), 0.1f + (PackedMaxDepth - 0.1f) * i / (directionsCount - 1));
+        AccumulateError(source, DecodeNormalDepth(EncodeNormalDepth(source, Precision)), error);
+    }
+
+    const Float3 axes[] = {{1.0f, 0.0f, 0.0f}, {-1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f},
+                           {0.0f, -1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, -1.0f}};
+
+    for(const Float3 &axis : axes){
+        Float4 source(axis, 1.0f);
+        AccumulateError(source, DecodeNormalDepth(EncodeNormalDepth(source, Precision)), error);
+    }
+
+    return error;
+}
+
+static RoundTripError GetImageError(const NormalDepthImage &Source, const NormalDepthImage &Decoded)
+{
+    RoundTripError error;
+
+    for(int y = 0; y < Source.GetHeight(); y++)
+        for(int x = 0; x < Source.GetWidth(); x++)
+            if(Source.At(x, y).w > 0.0f)
+                AccumulateError(Source.At(x, y), Decoded.At(x, y), error);
+
+    return error;
+}
+
+//background AO is never shown and the packed background has no normal, so it is skipped
+static Difference GetSurfaceDifference(const OcclusionImage &A, const OcclusionImage &B, const NormalDepthImage &NormalDepth)
+{
+    Difference difference;
+
+    double total = 0.0;
+    size_t count = 0;
+
+    for(int y = 0; y < A.GetHeight(); y++)
+        for(int x = 0; x < A.GetWidth(); x++){
+
+            if(NormalDepth.At(x, y).w <= 0.0f)
+                continue;
+
+            float diff = fabsf(A.At(x, y) - B.At(x, y));
+            difference.max = std::max(difference.max, diff);
+            total += diff;
+            count++;
+        }
+
+    difference.mean = (count > 0) ? (float)(total / count) : 0.0f;
+
+    return difference;
+}
+
+static void CheckBound(const char *Name, float Error, float Bound) throw (Exception)
+{
+    printf("  %-34s %12.3g %12.3g %s\n", Name, Error, Bound, (Error <= Bound) ? "ok" : "FAILED");
+
+    if(!(Error <= Bound))
+        throw CpuRenderingException(std::string("Codec round trip check failed: ") + Name);
+}
+
+//Texels of the normal/depth and AO buffers a pass reads and writes per pixel
+struct PassTraffic
+{
+    const char *name;
+    int normalDepthReads;
+    int occlusionReads;
+    int occlusionWrites;
+    int normalDepthWrites;
+};
+
+void RunFormats(const Settings &Settings)
+{
+    const Resolution res = FullHDResolution;
+    const Resolution qualityRes = {640, 360};
+
+    SyntheticScene scene = CreateSyntheticScene(res.width, res.height);
+    SyntheticScene qualityScene = CreateSyntheticScene(qualityRes.width, qualityRes.height);
+
+    printf("Packed normal/depth (octahedral 2x16 bits + 16/32 bit depth) and R8 AO, %u threads\n", (unsigned int)Settings.pool->GetThreadsCount());
+    printf("round trip checks:\n  %-34s %12s %12s\n", "value", "max error", "bound");
+
+    for(DepthPrecision precision : {DEPTH_PRECISION_16, DEPTH_PRECISION_32}){
+
+        const char *depthName = (precision == DEPTH_PRECISION_16) ? "16" : "32";
+        char name[64];
+
+        RoundTripError sweep = GetSweepError(precision);
+
+        PackedNormalDepthImage packed;
+        NormalDepthImage decoded;
+        PackNormalDepth(scene.normalDepth, precision, packed, Settings.pool);
+        UnpackNormalDepth(packed, decoded, Settings.pool);
+
+        RoundTripError image = GetImageError(scene.normalDepth, decoded);
+
+        bool backgroundKept = true;
+        for(int y = 0; y < res.height; y++)
+            for(int x = 0; x < res.width; x++)
+                if((scene.normalDepth.At(x, y).w <= 0.0f) != (decoded.At(x, y).w <= 0.0f))
+                    backgroundKept = false;
+
+        sprintf(name, "normal sweep, degrees (depth %s)", depthName);
+        CheckBound(name, sweep.maxNormalDegrees, MaxNormalErrorDegrees);
+        sprintf(name, "normal scene, degrees (depth %s)", depthName);
+        CheckBound(name, image.maxNormalDegrees, MaxNormalErrorDegrees);
+        sprintf(name, "depth %s sweep 0.1..%.0f", depthName, PackedMaxDepth);
+        CheckBound(name, sweep.maxDepth, (precision == DEPTH_PRECISION_16) ? MaxDepth16Error : MaxDepth32Error);
+        sprintf(name, "depth %s scene", depthName);
+        CheckBound(name, image.maxDepth, (precision == DEPTH_PRECISION_16) ? MaxDepth16Error : MaxDepth32Error);
+        sprintf(name, "background pixels (depth %s)", depthName);
+        CheckBound(name, backgroundKept ? 0.0f : 1.0f, 0.0f);
+    }
+
+    float maxOcclusionError = 0.0f;
+    for(int i = 0; i <= 1 << 16; i++){
+        float occlusion = i / 65536.0f;
+        maxOcclusionError = std::max(maxOcclusionError, fabsf(occlusion - DecodeOcclusion(EncodeOcclusion(occlusion))));
+    }
+
+    CheckBound("AO R8", maxOcclusionError, MaxOcclusionError);
+
+    //SSAO of the decoded buffer against the float one, the result stored as R8
+    SSAOEngine engine(Settings.pool);
+    SSAOParams params = CreateDefaultSSAOParams(qualityScene);
+
+    OcclusionImage reference;
+    engine.Compute(qualityScene.normalDepth, params, reference);
+
+    printf("\nSSAO at %dx%d on the packed buffers against float4 normal/depth and float AO:\n", qualityRes.width, qualityRes.height);
+    printf("  %-34s %12s %12s\n", "format", "mean diff", "max diff");
+
+    for(DepthPrecision precision : {DEPTH_PRECISION_16, DEPTH_PRECISION_32}){
+
+        PackedNormalDepthImage packed;
+        NormalDepthImage decoded;
+        PackNormalDepth(qualityScene.normalDepth, precision, packed, Settings.pool);
+        UnpackNormalDepth(packed, decoded, Settings.pool);
+
+        OcclusionImage occlusion;
+        engine.Compute(decoded, params, occlusion);
+
+        PackedOcclusionImage packedOcclusion;
+        PackOcclusion(occlusion, packedOcclusion, Settings.pool);
+        UnpackOcclusion(packedOcclusion, occlusion, Settings.pool);
+
+        Difference difference = GetSurfaceDifference(reference, occlusion, qualityScene.normalDepth);
+        printf("  %-34s %12.6f %12.6f\n", (precision == DEPTH_PRECISION_16) ? "oct16 + depth 16, R8 AO" : "oct16 + depth 32, R8 AO",
+               difference.mean, difference.max);
+    }
+
+    PackedNormalDepthImage packed;
+    NormalDepthImage decoded;
+    double packSeconds = MeasureSeconds([&]{PackNormalDepth(scene.normalDepth, DEPTH_PRECISION_32, packed, Settings.pool);}, Settings.iterations);
+    double unpackSeconds = MeasureSeconds([&]{UnpackNormalDepth(packed, decoded, Settings.pool);}, Settings.iterations);
+
+    printf("\nCPU codec at %dx%d: pack %.2f ms, unpack %.2f ms\n", res.width, res.height, packSeconds * 1000.0, unpackSeconds * 1000.0);
+
+    //GPU chain at the default settings: depth pass, 16 tap SSAO, one iteration of the 11 tap EdgeSavingBlur
+    //(two passes reading normal/depth and AO), point light reading AO
+    const int oldNormalDepthBytes = 16, newNormalDepthBytes = (int)sizeof(PackedNormalDepth);
+    const int oldOcclusionBytes = 16, newOcclusionBytes = (int)sizeof(unsigned char);
+
+    const PassTraffic passes[] = {
+        {"NormalVDepthV", 0, 0, 0, 1},
+        {"SSAOv3", 1 + 16, 0, 1, 0},
+        {"EdgeSavingBlur vertical", 1 + 11, 11, 1, 0},
+        {"EdgeSavingBlur horizontal", 1 + 11, 11, 1, 0},
+        {"PointLightSSAO", 0, 1, 0, 0}
+    };
+
+    printf("\nbytes per pixel of the SSAO chain (texel fetches, caches not modelled):\n");
+    printf("  %-34s %12s %12s %8s\n", "pass", "float4", "packed", "ratio");
+
+    int oldTotal = 0, newTotal = 0;
+
+    for(const PassTraffic &pass : passes){
+
+        int oldBytes = (pass.normalDepthReads + pass.normalDepthWrites) * oldNormalDepthBytes + (pass.occlusionReads + pass.occlusionWrites) * oldOcclusionBytes;
+        int newBytes = (pass.normalDepthReads + pass.normalDepthWrites) * newNormalDepthBytes + (pass.occlusionReads + pass.occlusionWrites) * newOcclusionBytes;
+
+        printf("  %-34s %12d %12d %7.2fx\n", pass.name, oldBytes, newBytes, (float)oldBytes / newBytes);
+
+        oldTotal += oldBytes;
+        newTotal += newBytes;
+    }
+
+    printf("  %-34s %12d %12d %7.2fx\n", "total", oldTotal, newTotal, (float)oldTotal / newTotal);
+}
+
+}
@@ -0,0 +1,261 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include "Benchmark.h"
+#include "SyntheticScene.h"
+#include <algorithm>
+#include <stdio.h>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace Benchmark
+{
+
+using namespace CpuRendering;
+
+//bands are raised to twice the blur apron, so the seams of neighbour borders do not overlap
+static const int FusedBandHeight = 32;
+static const int FusedChunkWidth = 64;
+
+//Rows of the band window of the columns [originX, originX + stride), (x, y) are the image coordinates
+class BandBuffer
+{
+private:
+    std::vector<float> data;
+    int originX = 0, originY = 0, stride = 0;
+public:
+    void Init(int Width, int Height){data.resize((size_t)Width * Height); stride = Width;}
+    void SetOrigin(int X, int Y){originX = X; originY = Y;}
+    float &At(int X, int Y) {return data[(size_t)(Y - originY) * stride + X - originX];}
+    float operator()(int X, int Y) const {return data[(size_t)(Y - originY) * stride + X - originX];}
+};
+
+//Slot of the row in the seams image, -1 for the rows away from the inner band borders
+static int GetSeamSlot(int Y, int BandRows, int BandsCount, int Apron)
+{
+    if(Apron == 0)
+        return -1;
+
+    int border = (Y + Apron) / BandRows;
+    int borderY = border * BandRows;
+
+    if(border < 1 || border >= BandsCount || Y < borderY - Apron || Y >= borderY + Apron)
+        return -1;
+
+    return (border - 1) * 2 * Apron + Y - (borderY - Apron);
+}
+
+static void ShadeSeams(ThreadPool *Pool, const NormalDepthImage &NormalDepth, const SSAOParams &Params, int BandRows, int Apron,
+                       OcclusionImage &Seams)
+{
+    ForEachTile(Pool, SplitToTiles(Seams.GetWidth(), Seams.GetHeight(), FusedChunkWidth), [&](const Tile &Region)
+    {
+        for(int slot = Region.top; slot < Region.bottom; slot++){
+
+            int y = (slot / (2 * Apron) + 1) * BandRows - Apron + slot % (2 * Apron);
+            //the last band may be shorter than the apron
+            if(y >= NormalDepth.GetHeight())
+                continue;
+
+            float *row = Seams.GetRow(slot);
+            for(int x = Region.left; x < Region.right; x++)
+                row[x] = SSAOEngine::ComputePixel(NormalDepth, Params, x, y);
+        }
+    });
+}
+
+//SSAOEngine::Compute followed by EdgeSavingBlur in one pass over the screen. The screen is split to bands of rows, a task goes over
+//its band chunk by chunk of columns: the AO of the chunk and of its blur apron is shaded to a buffer of the chunk size and both blur
+//passes run on the chunk while it is in the cache. The AO of the rows within the apron of the band borders is shaded up front
+//and shared by both bands, so every pixel is shaded once.
+//The shading is compute bound and takes about 90% of the time, the saved round trips do not pay for the apron passes,
+//so the pipeline is kept here as a measurement rather than in CpuRendering
+static void ComputeFusedSSAO(ThreadPool *Pool, const NormalDepthImage &NormalDepth, const SSAOParams &Params,
+                             const EdgeSavingBlurParams &BlurParams, OcclusionImage &Blurred) throw (Exception)
+{
+    if(Params.kernel.empty())
+        throw CpuRenderingException("SSAO kernel is empty");
+
+    if(Params.randomOffsets.GetWidth() == 0 || Params.randomOffsets.GetHeight() == 0)
+        throw CpuRenderingException("SSAO random offsets are not set");
+
+    if(BlurParams.kernel.size() % 2 == 0 || BlurParams.iterations < 1)
+        throw CpuRenderingException("Blur kernel size must be odd and iterations count positive");
+
+    const int width = NormalDepth.GetWidth(), height = NormalDepth.GetHeight();
+
+    if(width == 0 || height == 0)
+        throw CpuRenderingException("Fused SSAO source is empty");
+
+    if(!Blurred.IsSameSize(NormalDepth))
+        Blurred.Init(width, height);
+
+    const int radius = GetBlurRadius(BlurParams);
+    const int apron = radius * BlurParams.iterations;
+    const int bandRows = std::max(FusedBandHeight, 2 * apron);
+    const int bandsCount = (height + bandRows - 1) / bandRows;
+
+    OcclusionImage seams;
+    if(bandsCount > 1 && apron > 0){
+        seams.Init(width, (bandsCount - 1) * 2 * apron);
+        ShadeSeams(Pool, NormalDepth, Params, bandRows, apron, seams);
+    }
+
+    ForEachTile(Pool, SplitToRows(width, height, bandRows), [&](const Tile &Band)
+    {
+        int windowTop = std::max(Band.top - apron, 0), windowBottom = std::min(Band.bottom + apron, height);
+        int windowRows = windowBottom - windowTop;
+
+        //every buffer holds the chunk and its aprons only, so the working set of a chunk stays in the cache
+        BandBuffer occlusion, prevOcclusion, vertical, horizontal;
+        occlusion.Init(FusedChunkWidth + 2 * apron, windowRows);
+        prevOcclusion.Init(FusedChunkWidth + 2 * apron, windowRows);
+        vertical.Init(FusedChunkWidth + 2 * apron, windowRows);
+        horizontal.Init(FusedChunkWidth + 2 * apron, windowRows);
+
+        int shadedColumns = 0;
+
+        for(int chunkLeft = 0; chunkLeft < width; chunkLeft += FusedChunkWidth){
+            int chunkRight = std::min(chunkLeft + FusedChunkWidth, width);
+
+            //AO of the chunk and of its right apron is shaded, the columns on the left shaded for the previous chunk
+            //are taken from its window
+            int left = std::max(chunkLeft - apron, 0), shadeRight = std::min(chunkRight + apron, width);
+
+            std::swap(occlusion, prevOcclusion);
+            occlusion.SetOrigin(left, windowTop);
+
+            for(int y = windowTop; y < windowBottom; y++){
+                int slot = GetSeamSlot(y, bandRows, bandsCount, apron);
+
+                for(int x = left; x < shadedColumns; x++)
+                    occlusion.At(x, y) = prevOcclusion(x, y);
+
+                for(int x = shadedColumns; x < shadeRight; x++)
+                    occlusion.At(x, y) = (slot >= 0) ? seams.At(x, slot) : SSAOEngine::ComputePixel(NormalDepth, Params, x, y);
+            }
+
+            shadedColumns = shadeRight;
+
+            //every pass shrinks the valid area by the radius on the sides away from the screen borders
+            int right = shadeRight;
+            int top = windowTop, bottom = windowBottom;
+
+            vertical.SetOrigin(left, windowTop);
+            horizontal.SetOrigin(left, windowTop);
+
+            for(int i = 0; i < BlurParams.iterations; i++){
+
+                top = (top == 0) ? 0 : top + radius;
+                bottom = (bottom == height) ? height : bottom - radius;
+
+                for(int y = top; y < bottom; y++)
+                    for(int x = left; x < right; x++)
+                        vertical.At(x, y) = (i == 0) ? EdgeSavingBlurPixel(NormalDepth, BlurParams, true, x, y, occlusion) :
+                                                       EdgeSavingBlurPixel(NormalDepth, BlurParams, true, x, y, horizontal);
+
+                left = (left == 0) ? 0 : left + radius;
+                right = (right == width) ? width : right - radius;
+
+                for(int y = top; y < bottom; y++)
+                    for(int x = left; x < right; x++)
+                        horizontal.At(x, y) = EdgeSavingBlurPixel(NormalDepth, BlurParams, false, x, y, vertical);
+            }
+
+            for(int y = Band.top; y < Band.bottom; y++){
+                float *row = Blurred.GetRow(y);
+                for(int x = chunkLeft; x < chunkRight; x++)
+                    row[x] = horizontal(x, y);
+            }
+        }
+    });
+}
+
+
+struct FusedTimings
+{
+    double ao = 0.0, vertical = 0.0, horizontal = 0.0, unfused = 0.0, fused = 0.0;
+    float maxDiff = 0.0f;
+};
+
+static FusedTimings MeasureFused(const SyntheticScene &Scene, ThreadPool *Pool, int Iterations)
+{
+    SSAOParams params = CreateDefaultSSAOParams(Scene);
+    EdgeSavingBlurParams blurParams;
+
+    SSAOEngine engine(Pool);
+
+    OcclusionImage occlusion, intermediate, blurred, fused;
+
+    FusedTimings timings;
+    timings.ao = MeasureSeconds([&]{engine.Compute(Scene.normalDepth, params, occlusion);}, Iterations);
+    timings.vertical = MeasureSeconds([&]{EdgeSavingBlurPass(occlusion, Scene.normalDepth, blurParams, true, intermediate, Pool);}, Iterations);
+    timings.horizontal = MeasureSeconds([&]{EdgeSavingBlurPass(intermediate, Scene.normalDepth, blurParams, false, blurred, Pool);}, Iterations);
+
+    timings.unfused = MeasureSeconds([&]
+    {
+        engine.Compute(Scene.normalDepth, params, blurred);
+        EdgeSavingBlur(blurred, Scene.normalDepth, blurParams, intermediate, Pool);
+    }, Iterations);
+
+    timings.fused = MeasureSeconds([&]{ComputeFusedSSAO(Pool, Scene.normalDepth, params, blurParams, fused);}, Iterations);
+    timings.maxDiff = GetDifference(blurred, fused).max;
+
+    return timings;
+}
+
+void RunFusedSSAO(const Settings &Settings)
+{
+    const Resolution resolutions[] = {FullHDResolution, UltraHDResolution};
+
+    printf("SSAO + edge saving blur, three full screen passes against the fused band pipeline, %u threads\n",
+           (unsigned int)Settings.pool->GetThreadsCount());
+    printf("  %-10s %9s %9s %9s %11s %9s %8s %9s\n", "resolution", "AO ms", "V ms", "H ms", "unfused ms", "fused ms", "speedup", "max diff");
+
+    for(const Resolution &res : resolutions){
+
+        SyntheticScene scene = CreateSyntheticScene(res.width, res.height);
+        FusedTimings timings = MeasureFused(scene, Settings.pool, Settings.iterations);
+
+        char name[32];
+        sprintf(name, "%dx%d", res.width, res.height);
+
+        printf("  %-10s %9.2f %9.2f %9.2f %11.2f %9.2f %7.2fx %9.6f\n", name, timings.ao * 1000.0, timings.vertical * 1000.0,
+               timings.horizontal * 1000.0, timings.unfused * 1000.0, timings.fused * 1000.0, timings.unfused / timings.fused, timings.maxDiff);
+    }
+
+    //every count runs on a pool of its own, up to twice the hardware threads
+    const Resolution scalingRes = FullHDResolution;
+    size_t hardwareThreads = std::thread::hardware_concurrency();
+    size_t maxThreads = (hardwareThreads > 2) ? hardwareThreads * 2 : 4;
+
+    SyntheticScene scene = CreateSyntheticScene(scalingRes.width, scalingRes.height);
+
+    printf("\nThread scaling at %dx%d, %u hardware threads\n", scalingRes.width, scalingRes.height, std::thread::hardware_concurrency());
+    printf("  %-8s %11s %9s %9s %11s %11s\n", "threads", "unfused ms", "fused ms", "speedup", "unfused x1", "fused x1");
+
+    double unfusedSingle = 0.0, fusedSingle = 0.0;
+
+    for(size_t threads = 1; threads <= maxThreads; threads *= 2){
+
+        ThreadPool pool;
+        pool.Init(threads);
+
+        FusedTimings timings = MeasureFused(scene, &pool, Settings.iterations);
+
+        if(threads == 1){
+            unfusedSingle = timings.unfused;
+            fusedSingle = timings.fused;
+        }
+
+        printf("  %-8u %11.2f %9.2f %8.2fx %10.2fx %10.2fx\n", (unsigned int)threads, timings.unfused * 1000.0, timings.fused * 1000.0,
+               timings.unfused / timings.fused, unfusedSingle / timings.unfused, fusedSingle / timings.fused);
+    }
+}
+
+}
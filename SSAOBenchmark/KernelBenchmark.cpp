@@ -0,0 +1,98 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include "Benchmark.h"
+#include "SyntheticScene.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+namespace Benchmark
+{
+
+using namespace CpuRendering;
+
+struct SamplesCountEntry
+{
+    int samplesCount;
+    KernelStorage (*createKernel)(KernelSequence Sequence);
+};
+
+//the sample counts SSAOv3.ps permutations exist for
+static const SamplesCountEntry SamplesCounts[] = {
+    {4, CreateKernel<4>},
+    {8, CreateKernel<8>},
+    {16, CreateKernel<16>},
+    {32, CreateKernel<32>},
+    {64, CreateKernel<64>}
+};
+
+struct SequenceEntry
+{
+    const char *name;
+    KernelSequence sequence;
+};
+
+static const SequenceEntry Sequences[] = {
+    {"random", KERNEL_SEQUENCE_RANDOM},
+    {"hammersley", KERNEL_SEQUENCE_HAMMERSLEY},
+    {"halton", KERNEL_SEQUENCE_HALTON}
+};
+
+//random kernels differ from seed to seed, their quality is the mean over a few seeds
+static const int RandomSeedsCount = 4;
+
+void RunKernelSamples(const Settings &Settings)
+{
+    const Resolution timingRes = FullHDResolution;
+    const Resolution qualityRes = {640, 360};
+
+    SyntheticScene timingScene = CreateSyntheticScene(timingRes.width, timingRes.height);
+    SyntheticScene qualityScene = CreateSyntheticScene(qualityRes.width, qualityRes.height);
+
+    SSAOParams timingParams = CreateDefaultSSAOParams(timingScene);
+    SSAOParams qualityParams = CreateDefaultSSAOParams(qualityScene);
+
+    OcclusionImage reference = CreateReferenceOcclusion(qualityScene, qualityParams.occlusionRadius, 8, Settings.pool);
+
+    SSAOEngine engine(Settings.pool);
+
+    printf("SSAO kernels, time at %dx%d, quality at %dx%d against 64 traced rays per pixel, %u threads\n",
+           timingRes.width, timingRes.height, qualityRes.width, qualityRes.height, (unsigned int)Settings.pool->GetThreadsCount());
+    printf("%-8s %-12s %10s %12s %12s %12s\n", "samples", "sequence", "ms", "Mpixels/s", "mean diff", "correlation");
+
+    for(const SamplesCountEntry &count : SamplesCounts){
+
+        timingParams.kernel = count.createKernel(KERNEL_SEQUENCE_HAMMERSLEY);
+
+        OcclusionImage occlusion;
+        double seconds = MeasureSeconds([&]{engine.Compute(timingScene.normalDepth, timingParams, occlusion);}, Settings.iterations);
+
+        for(const SequenceEntry &sequence : Sequences){
+
+            int runsCount = (sequence.sequence == KERNEL_SEQUENCE_RANDOM) ? RandomSeedsCount : 1;
+
+            Quality quality;
+            for(int run = 0; run < runsCount; run++){
+
+                srand(run + 1);
+                qualityParams.kernel = count.createKernel(sequence.sequence);
+
+                engine.Compute(qualityScene.normalDepth, qualityParams, occlusion);
+                Quality runQuality = GetQuality(reference, occlusion, qualityScene.normalDepth);
+
+                quality.meanDiff += runQuality.meanDiff / runsCount;
+                quality.correlation += runQuality.correlation / runsCount;
+            }
+
+            //the cost depends on the samples count only
+            printf("%-8d %-12s %10.2f %12.2f %12.6f %12.4f\n", count.samplesCount, sequence.name, seconds * 1000.0,
+                   GetMegapixelsPerSecond(timingRes.width, timingRes.height, seconds), quality.meanDiff, quality.correlation);
+        }
+    }
+}
+
+}
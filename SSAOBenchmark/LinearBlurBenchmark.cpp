@@ -0,0 +1,85 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include "Benchmark.h"
+#include "SyntheticScene.h"
+#include <stdio.h>
+
+namespace Benchmark
+{
+
+using namespace CpuRendering;
+
+//vertical and horizontal passes of Blur.ps, discrete or with the merged taps
+static void BlurPlain(const OcclusionImage &Source, const BlurKernel &Kernel, bool Linear, int SubtexelBits, OcclusionImage &Destination, ThreadPool *Pool)
+{
+    OcclusionImage intermediate;
+
+    if(Linear){
+        LinearBlurPass(Source, Kernel, true, SubtexelBits, intermediate, Pool);
+        LinearBlurPass(intermediate, Kernel, false, SubtexelBits, Destination, Pool);
+    }else{
+        GaussianBlurPass(Source, Kernel, true, intermediate, Pool);
+        GaussianBlurPass(intermediate, Kernel, false, Destination, Pool);
+    }
+}
+
+static void BlurEdgeSaving(const OcclusionImage &Source, const NormalDepthImage &NormalDepth, const EdgeSavingBlurParams &Params, int SubtexelBits,
+                           OcclusionImage &Destination, ThreadPool *Pool)
+{
+    OcclusionImage intermediate;
+    EdgeSavingLinearBlurPass(Source, NormalDepth, Params, true, SubtexelBits, intermediate, Pool);
+    EdgeSavingLinearBlurPass(intermediate, NormalDepth, Params, false, SubtexelBits, Destination, Pool);
+}
+
+void RunLinearBlur(const Settings &Settings)
+{
+    const Resolution res = HDResolution;
+    const int radiuses[] = {2, 3, 5, 8, 12, 16, 24, 31};
+
+    SyntheticScene scene = CreateSyntheticScene(res.width, res.height);
+    SSAOEngine engine(Settings.pool);
+
+    OcclusionImage occlusion;
+    engine.Compute(scene.normalDepth, CreateDefaultSSAOParams(scene), occlusion);
+
+    printf("Bilinear blur taps against the discrete gaussian kernel, SSAO at %dx%d, vertical and horizontal pass\n", res.width, res.height);
+    printf("max diff of the exact bilinear fetch and of the fetch with %d subtexel bits of the D3D11 filter\n", HardwareSubtexelBits);
+    printf("  %6s %9s %9s %12s %12s %12s %12s %12s\n", "radius", "discrete", "bilinear", "plain exact", "plain 8 bit",
+           "edge exact", "edge 8 bit", "edge mean");
+
+    for(int radius : radiuses){
+
+        EdgeSavingBlurParams params;
+        params.kernel = CreateGaussianBlurKernel(radius);
+
+        OcclusionImage discrete, exact, rounded;
+
+        BlurPlain(occlusion, params.kernel, false, 0, discrete, Settings.pool);
+        BlurPlain(occlusion, params.kernel, true, 0, exact, Settings.pool);
+        BlurPlain(occlusion, params.kernel, true, HardwareSubtexelBits, rounded, Settings.pool);
+
+        float plainExact = GetDifference(discrete, exact).max, plainRounded = GetDifference(discrete, rounded).max;
+
+        OcclusionImage intermediate;
+        discrete = occlusion;
+        EdgeSavingBlur(discrete, scene.normalDepth, params, intermediate, Settings.pool);
+
+        BlurEdgeSaving(occlusion, scene.normalDepth, params, 0, exact, Settings.pool);
+        BlurEdgeSaving(occlusion, scene.normalDepth, params, HardwareSubtexelBits, rounded, Settings.pool);
+
+        Difference edgeRounded = GetDifference(discrete, rounded);
+
+        printf("  %6d %9d %9d %12.7f %12.7f %12.7f %12.7f %12.7f\n", radius, 2 * radius + 1, (int)CreateLinearBlurKernel(params.kernel).size(),
+               plainExact, plainRounded, GetDifference(discrete, exact).max, edgeRounded.max, edgeRounded.mean);
+    }
+
+    printf("\nfetches of the AO texture per pixel and pass, the edge saving variant keeps 2 normal/depth fetches per bilinear tap\n"
+           "and falls back to the point fetch of the accepted texel where the tap straddles an edge\n");
+}
+
+}
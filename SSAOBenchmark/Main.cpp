@@ -0,0 +1,100 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include "Benchmark.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+struct BenchmarkEntry
+{
+    const char *name;
+    const char *description;
+    void (*function)(const Benchmark::Settings &Settings);
+};
+
+static const BenchmarkEntry Benchmarks[] = {
+    {"simd", "SSAO inner loop: reference, scalar SoA, SSE4.1 and AVX2 paths", Benchmark::RunSimdSSAO},
+    {"scale", "SSAO at full, half and quarter resolution with bilateral upsampling", Benchmark::RunResolutionScale},
+    {"temporal", "temporal SSAO on camera paths against the full kernel", Benchmark::RunTemporalSSAO},
+    {"pyramid", "flat depth lookup against the depth pyramid at radiuses 0.8, 2 and 5", Benchmark::RunDepthPyramid},
+    {"techniques", "cost and quality of the AO techniques against the ray traced reference", Benchmark::RunAOTechniques},
+    {"kernels", "SSAO quality and cost for 4 to 64 samples of random and low discrepancy kernels", Benchmark::RunKernelSamples},
+    {"deinterleave", "SSAO on the interleaved buffer against 16 deinterleaved layers", Benchmark::RunDeinterleave},
+    {"formats", "round trip precision of the packed normal/depth and R8 AO formats and the SSAO chain traffic", Benchmark::RunFormats},
+    {"normals", "normals reconstructed from depth against the true normals and their SSAO", Benchmark::RunNormalReconstruction},
+    {"adaptive", "per 8x8 tile adaptive SSAO sampling on camera paths, samples saved per frame", Benchmark::RunAdaptiveSampling},
+    {"multiscale", "multi-scale SSAO against the single full resolution 16 tap pass", Benchmark::RunMultiScale},
+    {"bentnormals", "bent normal output of the SSAO pass, its cost and R8G8 packing error", Benchmark::RunBentNormals},
+    {"fused", "SSAO and edge saving blur fused in one band pipeline against three passes, thread scaling", Benchmark::RunFusedSSAO},
+    {"blur", "edge saving blur, the EdgeSavingBlur.ps port against the multi threaded transposed engine", Benchmark::RunEdgeSavingBlur},
+    {"lineartaps", "bilinear blur taps merged from the gaussian kernel against the discrete taps, plain and edge saving", Benchmark::RunLinearBlur},
+    {"blurfusion", "blur iterations fused to one pass of the iterated kernel against the iterated passes", Benchmark::RunBlurFusion},
+    {"iir", "recursive gaussian against the FIR kernel for the deviations from 2 to 64", Benchmark::RunRecursiveBlur},
+    {"sat", "summed area table box filter against the edge saving blur, float and fixed point table errors", Benchmark::RunSummedAreaTable},
+    {"raster", "tile binned software rasterizer of the normal/depth prepass against the ray cast one", Benchmark::RunRasterizer},
+    {"batch", "batch AO of many views split by views or by tiles, views per second and thread scaling", Benchmark::RunBatchAO},
+};
+
+static void PrintUsage()
+{
+    printf("SSAOBenchmark [--threads N] [--iterations N] [--camera-path FILE] [--quality-target R] [benchmark...]\n\nbenchmarks:\n");
+    for(const BenchmarkEntry &entry : Benchmarks)
+        printf("  %-16s %s\n", entry.name, entry.description);
+}
+
+int main(int argc, char *argv[])
+{
+    size_t threadsCount = 0;
+    Benchmark::Settings settings;
+    std::vector<const BenchmarkEntry *> selected;
+
+    for(int a = 1; a < argc; a++){
+        if(strcmp(argv[a], "--threads") == 0 && a + 1 < argc)
+            threadsCount = (size_t)atoi(argv[++a]);
+        else if(strcmp(argv[a], "--iterations") == 0 && a + 1 < argc)
+            settings.iterations = atoi(argv[++a]);
+        else if(strcmp(argv[a], "--camera-path") == 0 && a + 1 < argc)
+            settings.cameraPath = argv[++a];
+        else if(strcmp(argv[a], "--quality-target") == 0 && a + 1 < argc)
+            settings.qualityTarget = (float)atof(argv[++a]);
+        else{
+            const BenchmarkEntry *found = NULL;
+            for(const BenchmarkEntry &entry : Benchmarks)
+                if(strcmp(argv[a], entry.name) == 0)
+                    found = &entry;
+
+            if(found == NULL){
+                PrintUsage();
+                return 1;
+            }
+
+            selected.push_back(found);
+        }
+    }
+
+    if(selected.empty())
+        for(const BenchmarkEntry &entry : Benchmarks)
+            selected.push_back(&entry);
+
+    try{
+        CpuRendering::ThreadPool pool;
+        pool.Init(threadsCount);
+        settings.pool = &pool;
+
+        for(const BenchmarkEntry *entry : selected){
+            entry->function(settings);
+            printf("\n");
+        }
+    }catch(const Exception &ex){
+        fprintf(stderr, "%s\n", ex.What().c_str());
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,159 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include "Benchmark.h"
+#include "SyntheticScene.h"
+#include <stdio.h>
+#include <memory>
+#include <vector>
+
+namespace Benchmark
+{
+
+using namespace CpuRendering;
+
+struct MultiScaleEntry
+{
+    std::string name;
+    std::shared_ptr<IAOEngine> engine;
+};
+
+static MultiScaleEntry CreateMultiScaleEntry(ThreadPool *Pool, MultiScaleCombine Combine, const char *Name)
+{
+    MultiScaleParams multiScaleParams;
+    multiScaleParams.combine = Combine;
+
+    std::shared_ptr<MultiScaleSSAOEngine> engine = std::make_shared<MultiScaleSSAOEngine>(Pool);
+    engine->SetMultiScaleParams(multiScaleParams);
+
+    MultiScaleEntry entry;
+    entry.name = Name;
+    entry.engine = engine;
+
+    return entry;
+}
+
+void RunMultiScale(const Settings &Settings)
+{
+    const Resolution timingRes = FullHDResolution;
+    const Resolution qualityRes = {640, 360};
+
+    std::vector<MultiScaleEntry> entries;
+
+    MultiScaleEntry single;
+    single.name = "SSAO 16";
+    single.engine = std::make_shared<SSAOEngine>(Settings.pool);
+    entries.push_back(single);
+
+    entries.push_back(CreateMultiScaleEntry(Settings.pool, MULTI_SCALE_COMBINE_MAX_OCCLUSION, "multi max"));
+    entries.push_back(CreateMultiScaleEntry(Settings.pool, MULTI_SCALE_COMBINE_MULTIPLY, "multi multiply"));
+
+    SyntheticScene timingScene = CreateSyntheticScene(timingRes.width, timingRes.height);
+    SyntheticScene qualityScene = CreateSyntheticScene(qualityRes.width, qualityRes.height);
+
+    SSAOParams timingParams = CreateDefaultSSAOParams(timingScene);
+    SSAOParams qualityParams = CreateDefaultSSAOParams(qualityScene);
+
+    //one reference per layer radius, a single radius can not match the contact and the room scale at once
+    MultiScaleParams defaultMultiScale;
+    std::vector<OcclusionImage> references;
+
+    for(const MultiScaleLayer &layer : defaultMultiScale.layers)
+        references.push_back(CreateReferenceOcclusion(qualityScene, qualityParams.occlusionRadius * layer.radiusScale, 8, Settings.pool));
+
+    printf("Multi-scale SSAO, time at %dx%d, correlation at %dx%d with 64 traced rays per pixel of the layer radii, %u threads\n",
+           timingRes.width, timingRes.height, qualityRes.width, qualityRes.height, (unsigned int)Settings.pool->GetThreadsCount());
+
+    printf("layers:");
+    for(const MultiScaleLayer &layer : defaultMultiScale.layers)
+        printf(" (radius x%.2f, 1/%d resolution, %d samples)", layer.radiusScale, layer.resolutionScale,
+               (int)(timingParams.kernel.size() + layer.sampleStep - 1) / layer.sampleStep);
+    printf("\n");
+
+    printf("%-16s %8s %10s %8s", "technique", "fetches", "ms", "cost");
+    for(const MultiScaleLayer &layer : defaultMultiScale.layers)
+        printf("   corr r x%-5.2f", layer.radiusScale);
+    printf("\n");
+
+    double singleSeconds = 0.0, defaultSeconds = 0.0;
+
+    for(const MultiScaleEntry &entry : entries){
+
+        OcclusionImage occlusion;
+        double seconds = MeasureSeconds([&]{entry.engine->Compute(timingScene.normalDepth, timingParams, occlusion);}, Settings.iterations);
+
+        if(entry.engine.get() == single.engine.get())
+            singleSeconds = seconds;
+        else if(static_cast<const MultiScaleSSAOEngine*>(entry.engine.get())->GetMultiScaleParams().combine == defaultMultiScale.combine)
+            defaultSeconds = seconds;
+
+        entry.engine->Compute(qualityScene.normalDepth, qualityParams, occlusion);
+
+        printf("%-16s %8d %10.2f %7.1f%%", entry.name.c_str(), entry.engine->GetDepthFetchesCount(timingParams),
+               seconds * 1000.0, 100.0 * seconds / singleSeconds);
+
+        for(const OcclusionImage &reference : references)
+            printf(" %16.4f", GetQuality(reference, occlusion, qualityScene.normalDepth).correlation);
+        printf("\n");
+    }
+
+    //the references of the layer radii combined by the rules bound the correlations of the multi-scale results,
+    //the room scale occlusion of the combined image is not in the contact reference
+    const MultiScaleCombine combines[] = {MULTI_SCALE_COMBINE_MAX_OCCLUSION, MULTI_SCALE_COMBINE_MULTIPLY};
+    const char *combineNames[] = {"traced max", "traced multiply"};
+
+    for(int c = 0; c < 2; c++){
+
+        OcclusionImage combined = references[0];
+        for(size_t l = 1; l < references.size(); l++)
+            for(int y = 0; y < combined.GetHeight(); y++)
+                for(int x = 0; x < combined.GetWidth(); x++)
+                    combined.At(x, y) = CombineMultiScale(combined.At(x, y), references[l].At(x, y), combines[c]);
+
+        printf("%-16s %8s %10s %8s", combineNames[c], "-", "-", "-");
+        for(const OcclusionImage &reference : references)
+            printf(" %16.4f", GetQuality(reference, combined, qualityScene.normalDepth).correlation);
+        printf("\n");
+    }
+
+    //layer times tell where the budget goes, the rest is the downsampling, upsampling and combining.
+    //The correlation of a layer is taken against the reference of its radius
+    MultiScaleSSAOEngine layersEngine(Settings.pool);
+
+    for(int l = 0; l < MultiScaleLayersCount; l++){
+        const MultiScaleLayer &layer = defaultMultiScale.layers[l];
+
+        NormalDepthImage layerNormalDepth;
+        if(layer.resolutionScale > 1)
+            DownsampleNormalDepth(timingScene.normalDepth, layer.resolutionScale, layerNormalDepth, Settings.pool);
+
+        const NormalDepthImage &normalDepth = (layer.resolutionScale > 1) ? layerNormalDepth : timingScene.normalDepth;
+
+        OcclusionImage occlusion;
+        double seconds = MeasureSeconds([&]{layersEngine.ComputeLayer(normalDepth, timingParams, l, occlusion);}, Settings.iterations);
+
+        NormalDepthImage qualityLayerNormalDepth;
+        if(layer.resolutionScale > 1)
+            DownsampleNormalDepth(qualityScene.normalDepth, layer.resolutionScale, qualityLayerNormalDepth, Settings.pool);
+
+        OcclusionImage layerOcclusion, upsampled;
+        layersEngine.ComputeLayer((layer.resolutionScale > 1) ? qualityLayerNormalDepth : qualityScene.normalDepth, qualityParams, l, layerOcclusion);
+
+        if(layer.resolutionScale > 1)
+            BilateralUpsample(layerOcclusion, qualityLayerNormalDepth, qualityScene.normalDepth, upsampled, BilateralUpsampleParams(), Settings.pool);
+
+        float correlation = GetQuality(references[l], (layer.resolutionScale > 1) ? upsampled : layerOcclusion, qualityScene.normalDepth).correlation;
+
+        printf("  layer %d %10.2f ms, corr %.4f\n", l, seconds * 1000.0, correlation);
+    }
+
+    //the multi-scale mode replaces the single scale pass, its default must not cost more
+    if(defaultSeconds >= singleSeconds)
+        throw CpuRenderingException("Default multi-scale SSAO costs more than the single scale SSAO");
+}
+
+}
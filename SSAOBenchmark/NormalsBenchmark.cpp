@@ -0,0 +1,166 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include "Benchmark.h"
+#include "SyntheticScene.h"
+#include <stdio.h>
+#include <math.h>
+#include <algorithm>
+#include <vector>
+
+namespace Benchmark
+{
+
+using namespace CpuRendering;
+
+static const float Pi = 3.14159265f;
+
+struct ReconstructionMethod
+{
+    const char *name;
+    NormalReconstruction method;
+};
+
+static const ReconstructionMethod Methods[] = {
+    {"simple (right, bottom)", NORMAL_RECONSTRUCTION_SIMPLE},
+    {"nearest depth", NORMAL_RECONSTRUCTION_NEAREST},
+    {"best of neighbours", NORMAL_RECONSTRUCTION_BEST_OF_NEIGHBOURS},
+};
+
+//Angles between the reconstructed and the true normals in degrees, edges are the pixels
+//with a neighbour of another plane or the background, where the neighbour choice matters
+struct AngleError
+{
+    float mean = 0.0f, percentile95 = 0.0f, max = 0.0f;
+    float edgeMean = 0.0f;
+    float over10Degrees = 0.0f;
+};
+
+static bool IsEdgePixel(const NormalDepthImage &NormalDepth, int X, int Y)
+{
+    const int offsets[][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+
+    Float3 normal = NormalDepth.At(X, Y).Xyz();
+
+    for(const int *offset : offsets){
+        const Float4 &neighbour = NormalDepth.AtClamped(X + offset[0], Y + offset[1]);
+        if(neighbour.w <= 0.0f || Dot(neighbour.Xyz(), normal) < 0.999f)
+            return true;
+    }
+
+    return false;
+}
+
+static AngleError GetAngleError(const NormalDepthImage &Truth, const NormalDepthImage &Reconstructed)
+{
+    std::vector<float> angles;
+    double edgeTotal = 0.0;
+    size_t edgeCount = 0, over10Count = 0;
+
+    for(int y = 0; y < Truth.GetHeight(); y++)
+        for(int x = 0; x < Truth.GetWidth(); x++){
+
+            if(Truth.At(x, y).w <= 0.0f)
+                continue;
+
+            Float3 truth = Normalize(Truth.At(x, y).Xyz()), reconstructed = Reconstructed.At(x, y).Xyz();
+            float angle = atan2f(Length(Cross(truth, reconstructed)), Dot(truth, reconstructed)) * 180.0f / Pi;
+
+            angles.push_back(angle);
+
+            if(angle > 10.0f)
+                over10Count++;
+
+            if(IsEdgePixel(Truth, x, y)){
+                edgeTotal += angle;
+                edgeCount++;
+            }
+        }
+
+    AngleError error;
+
+    if(angles.empty())
+        return error;
+
+    double total = 0.0;
+    for(float angle : angles){
+        total += angle;
+        error.max = std::max(error.max, angle);
+    }
+
+    size_t percentileIndex = angles.size() * 95 / 100;
+    std::nth_element(angles.begin(), angles.begin() + percentileIndex, angles.end());
+
+    error.mean = (float)(total / angles.size());
+    error.percentile95 = angles[percentileIndex];
+    error.edgeMean = (edgeCount > 0) ? (float)(edgeTotal / edgeCount) : 0.0f;
+    error.over10Degrees = 100.0f * over10Count / angles.size();
+
+    return error;
+}
+
+void RunNormalReconstruction(const Settings &Settings)
+{
+    const Resolution res = FullHDResolution;
+    const Resolution qualityRes = {640, 360};
+
+    SyntheticScene scene = CreateSyntheticScene(res.width, res.height);
+    SyntheticScene qualityScene = CreateSyntheticScene(qualityRes.width, qualityRes.height);
+
+    DepthImage depth, qualityDepth;
+    ExtractDepth(scene.normalDepth, depth, Settings.pool);
+    ExtractDepth(qualityScene.normalDepth, qualityDepth, Settings.pool);
+
+    printf("Normals reconstructed from view space depth against the normals of the scene %dx%d, %u threads\n",
+           res.width, res.height, (unsigned int)Settings.pool->GetThreadsCount());
+    printf("  %-24s %9s %9s %9s %9s %9s %10s\n", "method", "mean deg", "p95 deg", "max deg", "edge deg", "> 10 deg", "time ms");
+
+    for(const ReconstructionMethod &method : Methods){
+
+        NormalDepthImage reconstructed;
+        double seconds = MeasureSeconds([&]{ReconstructNormals(depth, scene.invProj, method.method, reconstructed, Settings.pool);}, Settings.iterations);
+
+        AngleError error = GetAngleError(scene.normalDepth, reconstructed);
+
+        printf("  %-24s %9.4f %9.4f %9.2f %9.3f %8.3f%% %10.2f\n", method.name, error.mean, error.percentile95, error.max,
+               error.edgeMean, error.over10Degrees, seconds * 1000.0);
+    }
+
+    //SSAO taps take the depth only, the normal orients the kernel hemisphere
+    SSAOEngine engine(Settings.pool);
+    SSAOParams params = CreateDefaultSSAOParams(qualityScene);
+
+    OcclusionImage reference = CreateReferenceOcclusion(qualityScene, params.occlusionRadius, 8, Settings.pool);
+
+    OcclusionImage trueNormalsOcclusion;
+    engine.Compute(qualityScene.normalDepth, params, trueNormalsOcclusion);
+
+    Quality trueNormalsQuality = GetQuality(reference, trueNormalsOcclusion, qualityScene.normalDepth);
+
+    printf("\nSSAO at %dx%d, against the SSAO of the true normals and the ray traced reference:\n", qualityRes.width, qualityRes.height);
+    printf("  %-24s %12s %12s %12s\n", "normals", "mean diff", "ref diff", "correlation");
+    printf("  %-24s %12.6f %12.4f %12.4f\n", "true", 0.0f, trueNormalsQuality.meanDiff, trueNormalsQuality.correlation);
+
+    for(const ReconstructionMethod &method : Methods){
+
+        NormalDepthImage reconstructed;
+        ReconstructNormals(qualityDepth, qualityScene.invProj, method.method, reconstructed, Settings.pool);
+
+        OcclusionImage occlusion;
+        engine.Compute(reconstructed, params, occlusion);
+
+        Quality quality = GetQuality(reference, occlusion, qualityScene.normalDepth);
+
+        //background pixels keep the visibility of 1 in both images
+        printf("  %-24s %12.6f %12.4f %12.4f\n", method.name, GetDifference(trueNormalsOcclusion, occlusion).mean, quality.meanDiff, quality.correlation);
+    }
+
+    printf("\nprepass output per pixel: %d bytes of the packed normal/depth, %d bytes of R32 depth\n",
+           (int)sizeof(PackedNormalDepth), (int)sizeof(float));
+}
+
+}
@@ -0,0 +1,139 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include "Benchmark.h"
+#include "SyntheticScene.h"
+#include <stdio.h>
+#include <math.h>
+
+namespace Benchmark
+{
+
+using namespace CpuRendering;
+
+static const float Pi = 3.14159265f;
+
+//Rasterized normal/depth against the ray cast one of the same geometry. Coverage differs on the silhouettes,
+//the depth and the normals differ by the tessellation of the spheres
+struct RasterizationError
+{
+    float coverageMismatch = 0.0f;
+    float meanDepthError = 0.0f, over1PercentDepth = 0.0f;
+    float meanNormalAngle = 0.0f;
+};
+
+static RasterizationError GetRasterizationError(const NormalDepthImage &Truth, const NormalDepthImage &Rasterized)
+{
+    RasterizationError error;
+    size_t mismatches = 0, surfaceCount = 0, over1Percent = 0;
+    double depthTotal = 0.0, angleTotal = 0.0;
+
+    for(int y = 0; y < Truth.GetHeight(); y++)
+        for(int x = 0; x < Truth.GetWidth(); x++){
+
+            const Float4 &truth = Truth.At(x, y), &rasterized = Rasterized.At(x, y);
+
+            if((truth.w > 0.0f) != (rasterized.w > 0.0f)){
+                mismatches++;
+                continue;
+            }
+
+            if(truth.w <= 0.0f)
+                continue;
+
+            float depthError = fabsf(rasterized.w - truth.w) / truth.w;
+            float cosAngle = Saturate(Dot(Normalize(truth.Xyz()), rasterized.Xyz()));
+
+            depthTotal += depthError;
+            angleTotal += acosf(cosAngle) * 180.0f / Pi;
+            over1Percent += (depthError > 0.01f) ? 1 : 0;
+            surfaceCount++;
+        }
+
+    size_t pixelsCount = (size_t)Truth.GetWidth() * Truth.GetHeight();
+
+    error.coverageMismatch = 100.0f * mismatches / pixelsCount;
+
+    if(surfaceCount > 0){
+        error.meanDepthError = (float)(100.0 * depthTotal / surfaceCount);
+        error.over1PercentDepth = 100.0f * over1Percent / surfaceCount;
+        error.meanNormalAngle = (float)(angleTotal / surfaceCount);
+    }
+
+    return error;
+}
+
+void RunRasterizer(const Settings &Settings)
+{
+    const Resolution resolutions[] = {HDResolution, FullHDResolution};
+    const size_t threadsCounts[] = {1, 2, 4, 8};
+
+    TriangleMesh mesh = CreateSyntheticSceneMesh();
+    NormalDepthRasterizer rasterizer;
+
+    printf("Normal/depth prepass rasterized on the CPU, %u triangles of the synthetic hall, %dx%d tiles\n",
+           (unsigned int)mesh.GetTrianglesCount(), NormalDepthRasterizer::TileSize, NormalDepthRasterizer::TileSize);
+    printf("  %-10s %7s %9s %8s %9s %9s %9s %12s\n", "resolution", "threads", "time ms", "fps", "culled", "clipped", "binned", "bins/tri");
+
+    for(const Resolution &res : resolutions){
+
+        SyntheticScene scene = CreateSyntheticScene(res.width, res.height);
+        PrepassTransforms transforms = CreatePrepassTransforms(Matrix(), scene.view, scene.proj);
+
+        char name[32];
+        sprintf(name, "%dx%d", res.width, res.height);
+
+        for(size_t threadsCount : threadsCounts){
+
+            ThreadPool pool;
+            pool.Init(threadsCount);
+            rasterizer.SetThreadPool(&pool);
+
+            NormalDepthImage normalDepth;
+            double seconds = MeasureSeconds([&]
+            {
+                rasterizer.Clear(res.width, res.height, normalDepth);
+                rasterizer.Draw(mesh, transforms, normalDepth);
+            }, Settings.iterations);
+
+            const RasterizerCounters &counters = rasterizer.GetCounters();
+            size_t drawn = counters.triangles - counters.culled;
+
+            printf("  %-10s %7u %9.2f %8.1f %9u %9u %9u %12.2f\n", name, (unsigned int)threadsCount, seconds * 1000.0, 1.0 / seconds,
+                   (unsigned int)counters.culled, (unsigned int)counters.clipped, (unsigned int)counters.binned,
+                   (drawn > 0) ? (double)counters.binned / drawn : 0.0);
+        }
+    }
+
+    //quality at 720p, the SSAO of the rasterized prepass against the one of the ray cast prepass
+    const Resolution qualityRes = HDResolution;
+
+    SyntheticScene scene = CreateSyntheticScene(qualityRes.width, qualityRes.height);
+    NormalDepthImage normalDepth;
+
+    rasterizer.SetThreadPool(Settings.pool);
+    rasterizer.Clear(qualityRes.width, qualityRes.height, normalDepth);
+    rasterizer.Draw(mesh, CreatePrepassTransforms(Matrix(), scene.view, scene.proj), normalDepth);
+
+    RasterizationError error = GetRasterizationError(scene.normalDepth, normalDepth);
+
+    SSAOEngine ssao(Settings.pool);
+    SSAOParams params = CreateDefaultSSAOParams(scene);
+
+    OcclusionImage rayCastOcclusion, rasterizedOcclusion;
+    ssao.Compute(scene.normalDepth, params, rayCastOcclusion);
+    ssao.Compute(normalDepth, params, rasterizedOcclusion);
+
+    Difference aoDifference = GetDifference(rayCastOcclusion, rasterizedOcclusion);
+
+    printf("\nagainst the ray cast prepass at %dx%d:\n", qualityRes.width, qualityRes.height);
+    printf("  coverage mismatch %.3f%%, depth error mean %.4f%%, over 1%% %.3f%%, normal error mean %.3f deg\n",
+           error.coverageMismatch, error.meanDepthError, error.over1PercentDepth, error.meanNormalAngle);
+    printf("  SSAO difference mean %.6f, max %.4f\n", aoDifference.mean, aoDifference.max);
+}
+
+}
@@ -0,0 +1,66 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include "Benchmark.h"
+#include "SyntheticScene.h"
+#include <stdio.h>
+#include <math.h>
+
+namespace Benchmark
+{
+
+using namespace CpuRendering;
+
+void RunRecursiveBlur(const Settings &Settings)
+{
+    const Resolution res = FullHDResolution;
+    const float deviations[] = {2.0f, 4.0f, 8.0f, 16.0f, 32.0f, 64.0f};
+
+    SyntheticScene scene = CreateSyntheticScene(res.width, res.height);
+    SSAOEngine engine(Settings.pool);
+
+    OcclusionImage occlusion;
+    engine.Compute(scene.normalDepth, CreateDefaultSSAOParams(scene), occlusion);
+
+    printf("Gaussian blur of the SSAO at %dx%d, FIR kernel of 3 deviations against the recursive filter, %u threads\n",
+           res.width, res.height, (unsigned int)Settings.pool->GetThreadsCount());
+    printf("  %6s %6s %10s %10s %10s %10s %8s %10s %10s\n", "sigma", "radius", "FIR ms", "FIR MP/s", "IIR ms", "IIR MP/s", "speedup",
+           "max diff", "mean diff");
+
+    for(float deviation : deviations){
+
+        GaussianBlur blur(Settings.pool);
+        blur.SetDeviation(deviation);
+
+        OcclusionImage fir, iir;
+
+        blur.SetMethod(GAUSSIAN_BLUR_FIR);
+        double firSeconds = MeasureSeconds([&]
+        {
+            fir = occlusion;
+            blur.Draw(fir);
+        }, Settings.iterations);
+
+        blur.SetMethod(GAUSSIAN_BLUR_RECURSIVE);
+        double iirSeconds = MeasureSeconds([&]
+        {
+            iir = occlusion;
+            blur.Draw(iir);
+        }, Settings.iterations);
+
+        Difference diff = GetDifference(fir, iir);
+
+        printf("  %6.0f %6d %10.2f %10.1f %10.2f %10.1f %7.2fx %10.6f %10.6f\n", deviation, (int)ceilf(3.0f * deviation),
+               firSeconds * 1000.0, GetMegapixelsPerSecond(res.width, res.height, firSeconds),
+               iirSeconds * 1000.0, GetMegapixelsPerSecond(res.width, res.height, iirSeconds), firSeconds / iirSeconds,
+               diff.max, diff.mean);
+    }
+
+    printf("\nIIR: Young - van Vliet 3rd order forward and backward, columns 4 at once with SSE, rows as the columns of the transposed image\n");
+}
+
+}
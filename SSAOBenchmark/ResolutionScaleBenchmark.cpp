@@ -0,0 +1,113 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include "Benchmark.h"
+#include "SyntheticScene.h"
+#include <stdio.h>
+#include <math.h>
+
+namespace Benchmark
+{
+
+using namespace CpuRendering;
+
+//pixels with a neighbour farther than 0.2 by depth, the threshold of EdgeSavingBlur.ps
+static float GetMeanEdgeDifference(const NormalDepthImage &NormalDepth, const OcclusionImage &A, const OcclusionImage &B)
+{
+    double total = 0.0;
+    int count = 0;
+
+    for(int y = 0; y < A.GetHeight(); y++)
+        for(int x = 0; x < A.GetWidth(); x++){
+
+            float depth = NormalDepth.At(x, y).w;
+            bool isEdge = false;
+
+            for(int n = 0; n < 4 && !isEdge; n++){
+                int nx = x + ((n == 0) ? -1 : (n == 1) ? 1 : 0);
+                int ny = y + ((n == 2) ? -1 : (n == 3) ? 1 : 0);
+                isEdge = fabsf(NormalDepth.AtClamped(nx, ny).w - depth) > 0.2f;
+            }
+
+            if(isEdge){
+                total += fabsf(A.At(x, y) - B.At(x, y));
+                count++;
+            }
+        }
+
+    return (count != 0) ? (float)(total / count) : 0.0f;
+}
+
+void RunResolutionScale(const Settings &Settings)
+{
+    printf("SSAO resolution scale, %u threads\n", (unsigned int)Settings.pool->GetThreadsCount());
+    printf("%-12s %-10s %-10s %12s %10s %12s %12s %12s\n", "resolution", "scale", "upsample", "Mpixels/s", "speedup", "mean diff", "edge diff", "max diff");
+
+    //the same filter with disabled depth and normal weights is a plain bilinear upsampling
+    BilateralUpsampleParams bilinearParams;
+    bilinearParams.depthTolerance = 1e6f;
+    bilinearParams.normalPower = 0.0f;
+
+    struct Mode
+    {
+        int scale;
+        const char *scaleName, *upsampleName;
+        bool bilateral;
+    };
+
+    const Mode modes[] = {
+        {2, "1/2", "bilinear", false},
+        {2, "1/2", "bilateral", true},
+        {4, "1/4", "bilinear", false},
+        {4, "1/4", "bilateral", true},
+    };
+
+    const Resolution resolutions[] = {FullHDResolution, UltraHDResolution};
+
+    for(const Resolution &res : resolutions){
+
+        SyntheticScene scene = CreateSyntheticScene(res.width, res.height);
+        SSAOParams params = CreateDefaultSSAOParams(scene);
+
+        char resName[32];
+        sprintf(resName, "%dx%d", res.width, res.height);
+
+        SSAOEngine engine(Settings.pool);
+
+        float bilinearEdgeDifference = 0.0f;
+
+        OcclusionImage reference;
+        double fullSeconds = MeasureSeconds([&]{engine.Compute(scene.normalDepth, params, reference);}, Settings.iterations);
+
+        printf("%-12s %-10s %-10s %12.2f %10.2f %12s %12s %12s\n", resName, "1", "-",
+               GetMegapixelsPerSecond(res.width, res.height, fullSeconds), 1.0, "-", "-", "-");
+
+        for(const Mode &mode : modes){
+
+            engine.SetResolutionScale(mode.scale);
+            engine.SetUpsampleParams(mode.bilateral ? BilateralUpsampleParams() : bilinearParams);
+
+            OcclusionImage occlusion;
+            double seconds = MeasureSeconds([&]{engine.Compute(scene.normalDepth, params, occlusion);}, Settings.iterations);
+
+            Difference difference = GetDifference(reference, occlusion);
+            float edgeDifference = GetMeanEdgeDifference(scene.normalDepth, reference, occlusion);
+
+            printf("%-12s %-10s %-10s %12.2f %10.2f %12.6f %12.6f %12.6f\n", resName, mode.scaleName, mode.upsampleName,
+                   GetMegapixelsPerSecond(res.width, res.height, seconds), fullSeconds / seconds,
+                   difference.mean, edgeDifference, difference.max);
+
+            //the modes of a scale go from the bilinear to the bilateral one, the depth and normal weights must stop the bleeding
+            if(!mode.bilateral)
+                bilinearEdgeDifference = edgeDifference;
+            else if(edgeDifference >= bilinearEdgeDifference)
+                throw CpuRenderingException(std::string("Bilateral upsampling bleeds over the edges more than the bilinear one at ") + mode.scaleName);
+        }
+    }
+}
+
+}
@@ -0,0 +1,136 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include "Benchmark.h"
+#include "SyntheticScene.h"
+#include <stdio.h>
+#include <math.h>
+
+namespace Benchmark
+{
+
+using namespace CpuRendering;
+
+//Same constants as in SATCommon.fxh
+static const float AOSteps = 255.0f;
+static const float DepthSteps = 256.0f;
+
+struct TableError
+{
+    double occlusion = 0.0, depth = 0.0;
+};
+
+//max errors of the box means of the tables against the double ones, Scale turns the sums to the source units
+template<class TValue>
+static TableError GetTableError(const SummedAreaTable<TValue> &Occlusion, const SummedAreaTable<TValue> &Depth,
+                                const BoxFilterEngine &Reference, int Radius, double OcclusionScale, double DepthScale)
+{
+    TableError error;
+    int width = Occlusion.GetWidth(), height = Occlusion.GetHeight();
+
+    for(int y = 0; y < height; y++)
+        for(int x = 0; x < width; x++){
+
+            int minX = (x > Radius) ? x - Radius : 0, maxX = (x + Radius < width) ? x + Radius : width - 1;
+            int minY = (y > Radius) ? y - Radius : 0, maxY = (y + Radius < height) ? y + Radius : height - 1;
+            double area = (double)(maxX - minX + 1) * (maxY - minY + 1);
+
+            double occlusion = Occlusion.GetBoxSum(minX, minY, maxX, maxY) * OcclusionScale / area;
+            double depth = Depth.GetBoxSum(minX, minY, maxX, maxY) * DepthScale / area;
+
+            double occlusionError = fabs(occlusion - Reference.GetOcclusionTable().GetBoxSum(minX, minY, maxX, maxY) / area);
+            double depthError = fabs(depth - Reference.GetDepthTable().GetBoxSum(minX, minY, maxX, maxY) / area);
+
+            error.occlusion = (occlusionError > error.occlusion) ? occlusionError : error.occlusion;
+            error.depth = (depthError > error.depth) ? depthError : error.depth;
+        }
+
+    return error;
+}
+
+void RunSummedAreaTable(const Settings &Settings)
+{
+    const Resolution resolutions[] = {FullHDResolution, UltraHDResolution};
+    const int radiuses[] = {2, 4, 8, 16, 32};
+
+    printf("Box filter by the summed area tables against the edge saving blur of the same radius, %u threads\n",
+           (unsigned int)Settings.pool->GetThreadsCount());
+    printf("  %-10s %6s %9s %10s %9s %9s %11s %8s\n", "resolution", "radius", "build ms", "filter ms", "box ms", "blur ms", "box MP/s", "speedup");
+
+    SyntheticScene errorScene;
+    OcclusionImage errorOcclusion;
+    BoxFilterEngine reference(Settings.pool);
+
+    for(const Resolution &res : resolutions){
+
+        SyntheticScene scene = CreateSyntheticScene(res.width, res.height);
+        SSAOEngine ssao(Settings.pool);
+
+        OcclusionImage occlusion;
+        ssao.Compute(scene.normalDepth, CreateDefaultSSAOParams(scene), occlusion);
+
+        char name[32];
+        sprintf(name, "%dx%d", res.width, res.height);
+
+        //the tables do not depend on the radius
+        BoxFilterEngine engine(Settings.pool);
+        double buildSeconds = MeasureSeconds([&]{engine.Build(occlusion, scene.normalDepth);}, Settings.iterations);
+
+        for(int radius : radiuses){
+
+            BoxFilterParams params;
+            params.radius = radius;
+
+            OcclusionImage filtered;
+            double filterSeconds = MeasureSeconds([&]{engine.Filter(params, filtered);}, Settings.iterations);
+
+            EdgeSavingBlurParams blurParams;
+            blurParams.kernel = CreateGaussianBlurKernel(radius);
+
+            EdgeSavingBlurEngine blur(Settings.pool);
+            OcclusionImage blurred;
+            double blurSeconds = MeasureSeconds([&]
+            {
+                blurred = occlusion;
+                blur.Blur(blurred, scene.normalDepth, blurParams);
+            }, Settings.iterations);
+
+            double boxSeconds = buildSeconds + filterSeconds;
+
+            printf("  %-10s %6d %9.2f %10.2f %9.2f %9.2f %11.1f %7.2fx\n", name, radius, buildSeconds * 1000.0, filterSeconds * 1000.0,
+                   boxSeconds * 1000.0, blurSeconds * 1000.0, GetMegapixelsPerSecond(res.width, res.height, boxSeconds), blurSeconds / boxSeconds);
+        }
+
+        errorScene = scene;
+        errorOcclusion = occlusion;
+        reference = engine;
+    }
+
+    const int errorRadius = radiuses[sizeof(radiuses) / sizeof(radiuses[0]) - 1];
+
+    SummedAreaTable<float> floatOcclusion, floatDepth;
+    floatOcclusion.Build(errorOcclusion, [](float Value){return Value;}, Settings.pool);
+    floatDepth.Build(errorScene.normalDepth, [](const Float4 &Value){return Value.w;}, Settings.pool);
+
+    //fixed point of SATBuild.ps, the sums wrap around 2^32 as the uint of the shader
+    SummedAreaTable<unsigned int> fixedOcclusion, fixedDepth;
+    fixedOcclusion.Build(errorOcclusion, [](float Value){return (unsigned int)floorf(Value * AOSteps + 0.5f);}, Settings.pool);
+    fixedDepth.Build(errorScene.normalDepth, [](const Float4 &Value){return (unsigned int)floorf(Value.w * DepthSteps + 0.5f);}, Settings.pool);
+
+    TableError floatError = GetTableError(floatOcclusion, floatDepth, reference, errorRadius, 1.0, 1.0);
+    TableError fixedError = GetTableError(fixedOcclusion, fixedDepth, reference, errorRadius, 1.0 / AOSteps, 1.0 / DepthSteps);
+
+    printf("\nbox means of radius %d at %dx%d against the double tables:\n", errorRadius, errorScene.normalDepth.GetWidth(), errorScene.normalDepth.GetHeight());
+    printf("  %-18s %12s %12s\n", "table", "AO max err", "depth max err");
+    printf("  %-18s %12.6f %12.6f\n", "float", floatError.occlusion, floatError.depth);
+    printf("  %-18s %12.6f %12.6f\n", "uint fixed point", fixedError.occlusion, fixedError.depth);
+
+    printf("\nfixed point errors are the rounding of the source to 1/%.0f of the AO and 1/%.0f of the depth,\n"
+           "the wrapped uint differences of the box are exact\n", AOSteps, DepthSteps);
+}
+
+}
@@ -0,0 +1,66 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include "Benchmark.h"
+#include "SyntheticScene.h"
+#include <stdio.h>
+
+namespace Benchmark
+{
+
+using namespace CpuRendering;
+
+//Every path does the reference mul and add sequence, only the order of the additions
+//of the MSVC /fp:precise and GCC builds may differ
+static const float MaxSimdDifference = 1e-4f;
+
+void RunSimdSSAO(const Settings &Settings)
+{
+    printf("SSAO inner loop, %u threads\n", (unsigned int)Settings.pool->GetThreadsCount());
+    printf("%-12s %-10s %12s %14s\n", "resolution", "path", "Mpixels/s", "max diff");
+
+    const Resolution resolutions[] = {HDResolution, FullHDResolution};
+
+    for(const Resolution &res : resolutions){
+
+        SyntheticScene scene = CreateSyntheticScene(res.width, res.height);
+        SSAOParams params = CreateDefaultSSAOParams(scene);
+
+        char resName[32];
+        sprintf(resName, "%dx%d", res.width, res.height);
+
+        OcclusionImage reference;
+        SSAOEngine engine(Settings.pool);
+
+        double seconds = MeasureSeconds([&]{engine.Compute(scene.normalDepth, params, reference);}, Settings.iterations);
+        printf("%-12s %-10s %12.2f %14s\n", resName, "reference", GetMegapixelsPerSecond(res.width, res.height, seconds), "-");
+
+        NormalDepthPlanes planes;
+        seconds = MeasureSeconds([&]{planes.Init(scene.normalDepth);}, Settings.iterations);
+        printf("%-12s %-10s %12.2f %14s\n", resName, "to SoA", GetMegapixelsPerSecond(res.width, res.height, seconds), "-");
+
+        SimdSSAOEngine simdEngine(Settings.pool);
+
+        for(int level = SIMD_SCALAR; level <= GetSupportedSimdLevel(); level++){
+
+            simdEngine.SetSimdLevel((SimdLevel)level);
+
+            OcclusionImage occlusion;
+            seconds = MeasureSeconds([&]{simdEngine.Compute(planes, params, occlusion);}, Settings.iterations);
+
+            float maxDiff = GetDifference(reference, occlusion).max;
+
+            printf("%-12s %-10s %12.2f %14.6f\n", resName, GetSimdLevelName((SimdLevel)level).c_str(),
+                   GetMegapixelsPerSecond(res.width, res.height, seconds), maxDiff);
+
+            if(!(maxDiff <= MaxSimdDifference))
+                throw CpuRenderingException("SSAO " + GetSimdLevelName((SimdLevel)level) + " path differs from the reference");
+        }
+    }
+}
+
+}
@@ -0,0 +1,311 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include "SyntheticScene.h"
+#include <float.h>
+#include <stdlib.h>
+
+namespace Benchmark
+{
+
+using namespace CpuRendering;
+
+struct Box
+{
+    Float3 minPos, maxPos;
+};
+
+struct Sphere
+{
+    Float3 center;
+    float radius;
+};
+
+static const Box SceneBoxes[] = {
+    {{-8.0f, -2.5f, -4.0f}, {8.0f, -2.0f, 40.0f}},  //floor
+    {{-8.5f, -2.0f, -4.0f}, {-8.0f, 4.0f, 40.0f}},  //left wall
+    {{8.0f, -2.0f, -4.0f}, {8.5f, 4.0f, 40.0f}},    //right wall
+    {{-8.5f, -2.0f, 40.0f}, {8.5f, 4.0f, 40.5f}},   //back wall
+    {{-5.6f, -2.0f, 7.4f}, {-4.4f, 4.0f, 8.6f}},    //columns
+    {{4.4f, -2.0f, 7.4f}, {5.6f, 4.0f, 8.6f}},
+    {{-5.6f, -2.0f, 15.4f}, {-4.4f, 4.0f, 16.6f}},
+    {{4.4f, -2.0f, 15.4f}, {5.6f, 4.0f, 16.6f}},
+    {{-5.6f, -2.0f, 23.4f}, {-4.4f, 4.0f, 24.6f}},
+    {{4.4f, -2.0f, 23.4f}, {5.6f, 4.0f, 24.6f}},
+    {{-5.6f, -2.0f, 31.4f}, {-4.4f, 4.0f, 32.6f}},
+    {{4.4f, -2.0f, 31.4f}, {5.6f, 4.0f, 32.6f}},
+    {{-3.0f, -2.0f, 5.0f}, {-1.0f, -1.5f, 7.0f}},   //steps
+    {{-3.0f, -1.5f, 5.5f}, {-1.0f, -1.0f, 7.0f}},
+};
+
+static const Sphere SceneSpheres[] = {
+    {{0.0f, -1.0f, 10.0f}, 1.0f},
+    {{2.5f, -1.5f, 14.0f}, 0.5f},
+    {{-2.0f, -1.2f, 20.0f}, 0.8f},
+    {{1.0f, -1.0f, 28.0f}, 1.0f},
+};
+
+static void IntersectBox(const Box &B, const Float3 &Origin, const Float3 &Dir, float &NearestT, Float3 &Normal)
+{
+    float o[3] = {Origin.x, Origin.y, Origin.z}, d[3] = {Dir.x, Dir.y, Dir.z};
+    float mn[3] = {B.minPos.x, B.minPos.y, B.minPos.z}, mx[3] = {B.maxPos.x, B.maxPos.y, B.maxPos.z};
+
+    float tNear = -FLT_MAX, tFar = FLT_MAX;
+    int axis = 0;
+    float axisSign = 1.0f;
+
+    for(int a = 0; a < 3; a++){
+        if(fabsf(d[a]) < 1e-12f){
+            if(o[a] < mn[a] || o[a] > mx[a])
+                return;
+            continue;
+        }
+
+        float t0 = (mn[a] - o[a]) / d[a], t1 = (mx[a] - o[a]) / d[a];
+        float entrySign = -1.0f;
+        if(t0 > t1){
+            float tmp = t0; t0 = t1; t1 = tmp;
+            entrySign = 1.0f;
+        }
+
+        if(t0 > tNear){
+            tNear = t0;
+            axis = a;
+            axisSign = entrySign;
+        }
+        if(t1 < tFar)
+            tFar = t1;
+    }
+
+    if(tNear > tFar || tNear <= 0.0f || tNear >= NearestT)
+        return;
+
+    NearestT = tNear;
+    float n[3] = {0.0f, 0.0f, 0.0f};
+    n[axis] = axisSign;
+    Normal = Float3(n[0], n[1], n[2]);
+}
+
+static void IntersectSphere(const Sphere &S, const Float3 &Origin, const Float3 &Dir, float &NearestT, Float3 &Normal)
+{
+    Float3 oc = Origin - S.center;
+    float b = Dot(oc, Dir);
+    float c = Dot(oc, oc) - S.radius * S.radius;
+    float discriminant = b * b - c;
+
+    if(discriminant < 0.0f)
+        return;
+
+    float t = -b - sqrtf(discriminant);
+    if(t <= 0.0f || t >= NearestT)
+        return;
+
+    NearestT = t;
+    Normal = Normalize(Origin + Dir * t - S.center);
+}
+
+static float TraceScene(const Float3 &Origin, const Float3 &Dir, Float3 &Normal)
+{
+    float nearestT = FLT_MAX;
+
+    for(const Box &box : SceneBoxes)
+        IntersectBox(box, Origin, Dir, nearestT, Normal);
+
+    for(const Sphere &sphere : SceneSpheres)
+        IntersectSphere(sphere, Origin, Dir, nearestT, Normal);
+
+    return nearestT;
+}
+
+SyntheticScene CreateSyntheticScene(int Width, int Height, const Matrix &View)
+{
+    SyntheticScene scene;
+    scene.view = View;
+    scene.proj = PerspectiveFovLH(0.25f * 3.14159265f, 0.1f, 1000.0f, (float)Width / (float)Height);
+    scene.invProj = Inverse(scene.proj);
+    scene.normalDepth.Init(Width, Height, Float4(1.0f, 1.0f, 1.0f, 0.0f));
+
+    Matrix invView = Inverse(View);
+    Float3 origin = Transform(Float4(0.0f, 0.0f, 0.0f, 1.0f), invView).Xyz();
+
+    for(int y = 0; y < Height; y++)
+        for(int x = 0; x < Width; x++){
+            float ndcX = 2.0f * (x + 0.5f) / Width - 1.0f;
+            float ndcY = 1.0f - 2.0f * (y + 0.5f) / Height;
+
+            Float3 dirV(ndcX / scene.proj.m[0][0], ndcY / scene.proj.m[1][1], 1.0f);
+            Float3 dir = Normalize(Transform(Float4(dirV, 0.0f), invView).Xyz());
+
+            Float3 normal;
+            float nearestT = TraceScene(origin, dir, normal);
+
+            if(nearestT == FLT_MAX)
+                continue;
+
+            Float3 posV = Transform(Float4(origin + dir * nearestT, 1.0f), View).Xyz();
+            Float3 normalV = Normalize(Transform(Float4(normal, 0.0f), View).Xyz());
+
+            scene.normalDepth.At(x, y) = Float4(normalV, posV.z);
+        }
+
+    return scene;
+}
+
+OcclusionImage CreateReferenceOcclusion(const SyntheticScene &Scene, float Radius, int RaysSqrtCount, ThreadPool *Pool)
+{
+    const NormalDepthImage &normalDepth = Scene.normalDepth;
+
+    OcclusionImage reference(normalDepth.GetWidth(), normalDepth.GetHeight(), 1.0f);
+
+    Matrix invView = Inverse(Scene.view);
+    int raysCount = RaysSqrtCount * RaysSqrtCount;
+
+    ForEachTile(Pool, SplitToTiles(normalDepth.GetWidth(), normalDepth.GetHeight(), 32), [&](const Tile &Region)
+    {
+        for(int y = Region.top; y < Region.bottom; y++)
+            for(int x = Region.left; x < Region.right; x++){
+
+                const Float4 &normalDepthData = normalDepth.At(x, y);
+                if(normalDepthData.w <= 0.0f)
+                    continue;
+
+                Float4 eyeRayN(2.0f * (x + 0.5f) / normalDepth.GetWidth() - 1.0f, 1.0f - 2.0f * (y + 0.5f) / normalDepth.GetHeight(), 1.0f, 1.0f);
+                Float3 posV = Transform(eyeRayN, Scene.invProj).Xyz() * normalDepthData.w;
+
+                Float3 normal = Normalize(Transform(Float4(Normalize(normalDepthData.Xyz()), 0.0f), invView).Xyz());
+                Float3 origin = Transform(Float4(posV, 1.0f), invView).Xyz() + normal * 1e-3f;
+
+                Float3 tangent = Normalize(Cross((fabsf(normal.y) < 0.9f) ? Float3(0.0f, 1.0f, 0.0f) : Float3(1.0f, 0.0f, 0.0f), normal));
+                Float3 bitangent = Cross(normal, tangent);
+
+                //the stratified pattern is rotated per pixel, so the strata do not show up as bands
+                float rotation = (float)(((unsigned int)(x * 73856093) ^ (unsigned int)(y * 19349663)) % 1024) / 1024.0f;
+
+                float obscurance = 0.0f;
+
+                for(int r = 0; r < raysCount; r++){
+
+                    //cosine weighted hemisphere direction from the stratum center
+                    float u = ((r % RaysSqrtCount) + 0.5f) / RaysSqrtCount;
+                    float v = ((r / RaysSqrtCount) + 0.5f) / RaysSqrtCount;
+
+                    float phi = 2.0f * 3.14159265f * (v + rotation);
+                    float sinTheta = sqrtf(u);
+
+                    Float3 dir = tangent * (sinTheta * cosf(phi)) + bitangent * (sinTheta * sinf(phi)) + normal * sqrtf(1.0f - u);
+
+                    Float3 hitNormal;
+                    float t = TraceScene(origin, dir, hitNormal);
+
+                    if(t < Radius)
+                        obscurance += 1.0f - t / Radius;
+                }
+
+                reference.At(x, y) = 1.0f - obscurance / raysCount;
+            }
+    });
+
+    return reference;
+}
+
+static void AddQuad(TriangleMesh &Mesh, const Float3 &A, const Float3 &B, const Float3 &C, const Float3 &D,
+                    const Float3 &NormalA, const Float3 &NormalB, const Float3 &NormalC, const Float3 &NormalD)
+{
+    unsigned int base = (unsigned int)Mesh.vertices.size();
+
+    const Float3 positions[] = {A, B, C, D}, normals[] = {NormalA, NormalB, NormalC, NormalD};
+
+    for(int v = 0; v < 4; v++){
+        MeshVertex vertex;
+        vertex.pos = positions[v];
+        vertex.normal = normals[v];
+        Mesh.vertices.push_back(vertex);
+    }
+
+    const unsigned int indices[] = {0, 1, 2, 0, 2, 3};
+    for(unsigned int index : indices)
+        Mesh.indices.push_back(base + index);
+}
+
+static void AddBox(TriangleMesh &Mesh, const Box &B)
+{
+    float mn[3] = {B.minPos.x, B.minPos.y, B.minPos.z}, mx[3] = {B.maxPos.x, B.maxPos.y, B.maxPos.z};
+
+    for(int axis = 0; axis < 3; axis++){
+        int u = (axis + 1) % 3, v = (axis + 2) % 3;
+
+        for(int side = 0; side < 2; side++){
+            float corners[4][2] = {{mn[u], mn[v]}, {mx[u], mn[v]}, {mx[u], mx[v]}, {mn[u], mx[v]}};
+            Float3 quad[4];
+
+            for(int c = 0; c < 4; c++){
+                float p[3];
+                p[axis] = (side) ? mx[axis] : mn[axis];
+                p[u] = corners[c][0];
+                p[v] = corners[c][1];
+                quad[c] = Float3(p[0], p[1], p[2]);
+            }
+
+            float n[3] = {0.0f, 0.0f, 0.0f};
+            n[axis] = (side) ? 1.0f : -1.0f;
+            Float3 normal(n[0], n[1], n[2]);
+
+            AddQuad(Mesh, quad[0], quad[1], quad[2], quad[3], normal, normal, normal, normal);
+        }
+    }
+}
+
+static void AddSphere(TriangleMesh &Mesh, const Sphere &S, int Slices)
+{
+    const float pi = 3.14159265f;
+    int stacks = Slices / 2;
+
+    auto getNormal = [&](int Slice, int Stack) -> Float3
+    {
+        float theta = pi * Stack / stacks, phi = 2.0f * pi * Slice / Slices;
+        return Float3(sinf(theta) * cosf(phi), cosf(theta), sinf(theta) * sinf(phi));
+    };
+
+    for(int stack = 0; stack < stacks; stack++)
+        for(int slice = 0; slice < Slices; slice++){
+            Float3 n00 = getNormal(slice, stack), n10 = getNormal(slice + 1, stack);
+            Float3 n11 = getNormal(slice + 1, stack + 1), n01 = getNormal(slice, stack + 1);
+
+            AddQuad(Mesh, S.center + n00 * S.radius, S.center + n10 * S.radius, S.center + n11 * S.radius, S.center + n01 * S.radius,
+                    n00, n10, n11, n01);
+        }
+}
+
+TriangleMesh CreateSyntheticSceneMesh(int SphereSlices)
+{
+    TriangleMesh mesh;
+
+    for(const Box &box : SceneBoxes)
+        AddBox(mesh, box);
+
+    for(const Sphere &sphere : SceneSpheres)
+        AddSphere(mesh, sphere, SphereSlices);
+
+    return mesh;
+}
+
+SSAOParams CreateDefaultSSAOParams(const SyntheticScene &Scene)
+{
+    srand(1);
+
+    SSAOParams params;
+    params.randomOffsets = CreateRandomOffsets(4, 4);
+    params.kernel = CreateKernel<16>(KERNEL_SEQUENCE_HAMMERSLEY);
+    params.proj = Scene.proj;
+    params.invProj = Scene.invProj;
+    params.occlusionRadius = 0.8f;
+    params.harshness = 1.5f;
+
+    return params;
+}
+
+}
@@ -0,0 +1,37 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#pragma once
+#include <CpuRendering.h>
+
+namespace Benchmark
+{
+
+//Ray cast hall-like room (walls, columns, spheres) written the way NormalVDepthV.ps fills ndRt,
+//so the benchmarks do not depend on the mesh files and a GPU
+struct SyntheticScene
+{
+    CpuRendering::NormalDepthImage normalDepth;
+    CpuRendering::Matrix proj, invProj;
+    CpuRendering::Matrix view;
+};
+
+SyntheticScene CreateSyntheticScene(int Width, int Height, const CpuRendering::Matrix &View = CpuRendering::Matrix());
+
+//Ground truth for the quality of the AO techniques: obscurance with the linear falloff within Radius,
+//RaysSqrtCount^2 cosine weighted rays are traced against the scene geometry for every pixel. Background is 1
+CpuRendering::OcclusionImage CreateReferenceOcclusion(const SyntheticScene &Scene, float Radius, int RaysSqrtCount = 8,
+                                                      CpuRendering::ThreadPool *Pool = NULL);
+
+//Triangles of the scene geometry in the world space for the rasterizer, the boxes have flat faces and the spheres
+//take SphereSlices x SphereSlices / 2 quads with the smooth normals, 256 slices give the triangles count of the hall
+CpuRendering::TriangleMesh CreateSyntheticSceneMesh(int SphereSlices = 256);
+
+//Default SSAO parameters of the demo: 16 samples Hammersley kernel, 4x4 random offsets, radius 0.8, harshness 1.5
+CpuRendering::SSAOParams CreateDefaultSSAOParams(const SyntheticScene &Scene);
+
+}
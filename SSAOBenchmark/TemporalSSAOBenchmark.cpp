@@ -0,0 +1,64 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include "Benchmark.h"
+#include "SyntheticScene.h"
+#include <stdio.h>
+#include <math.h>
+
+namespace Benchmark
+{
+
+using namespace CpuRendering;
+
+void RunTemporalSSAO(const Settings &Settings)
+{
+    const Resolution res = {640, 360};
+
+    printf("Temporal SSAO %dx%d, %d of 16 samples per frame, %u threads\n", res.width, res.height,
+           16 / TemporalSubsetsCount, (unsigned int)Settings.pool->GetThreadsCount());
+    printf("%-12s %8s %12s %12s %10s %12s %12s %12s\n", "path", "frames", "full ms", "temporal ms", "speedup", "history", "mean diff", "last diff");
+
+    for(const NamedCameraPath &camera : CreateCameraPaths(Settings)){
+
+        SSAOEngine engine(Settings.pool);
+        TemporalSSAOEngine temporalEngine(Settings.pool);
+
+        double fullSeconds = 0.0, temporalSeconds = 0.0, totalAcceptance = 0.0, totalDiff = 0.0;
+        float lastDiff = 0.0f;
+
+        for(const Matrix &view : camera.path){
+
+            SyntheticScene scene = CreateSyntheticScene(res.width, res.height, view);
+            SSAOParams params = CreateDefaultSSAOParams(scene);
+
+            OcclusionImage reference, occlusion;
+
+            Stopwatch stopwatch;
+            engine.Compute(scene.normalDepth, params, reference);
+            fullSeconds += stopwatch.GetSeconds();
+
+            stopwatch.Restart();
+            temporalEngine.Compute(scene.normalDepth, view, params, occlusion);
+            temporalSeconds += stopwatch.GetSeconds();
+
+            lastDiff = GetDifference(reference, occlusion).mean;
+            totalDiff += lastDiff;
+            totalAcceptance += temporalEngine.GetHistoryAcceptance();
+        }
+
+        size_t framesCount = camera.path.size();
+        if(framesCount == 0)
+            continue;
+
+        printf("%-12s %8u %12.2f %12.2f %10.2f %11.1f%% %12.6f %12.6f\n", camera.name.c_str(), (unsigned int)framesCount,
+               fullSeconds * 1000.0 / framesCount, temporalSeconds * 1000.0 / framesCount, fullSeconds / temporalSeconds,
+               totalAcceptance * 100.0 / framesCount, totalDiff / framesCount, lastDiff);
+    }
+}
+
+}
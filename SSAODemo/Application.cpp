@@ -12,6 +12,13 @@
 #include <InitFunctions.h>
 #include <Utils/ToString.h>
 #include <MathHelpers.h>
+#include <CpuRendering/SSAO.h>
+#include <CpuRendering/TemporalSSAO.h>
+#include <CpuRendering/DepthPyramid.h>
+#include <CpuRendering/Deinterleave.h>
+#include <CpuRendering/HBAO.h>
+#include <CpuRendering/TileClassification.h>
+#include <CpuRendering/CameraPath.h>
 #include <algorithm>
 #include "Application.h"
 #include "LoadingScreen.h"
@@ -19,6 +26,17 @@
 namespace Demo
 {
 
+//Packed normal/depth of NormalDepthCodec.fxh and single channel AO. Visibility of a temporal subset
+//is averaged with the history before squaring, so it keeps 16 bits, the history needs the negative empty marker
+static const DXGI_FORMAT NormalDepthFormat = DXGI_FORMAT_R16G16B16A16_UNORM;
+static const DXGI_FORMAT OcclusionFormat = DXGI_FORMAT_R8_UNORM;
+static const DXGI_FORMAT VisibilityFormat = DXGI_FORMAT_R16_UNORM;
+static const DXGI_FORMAT HistoryFormat = DXGI_FORMAT_R16G16B16A16_FLOAT;
+//view space depth of the depth only prepass
+static const DXGI_FORMAT DepthFormat = DXGI_FORMAT_R32_FLOAT;
+//octahedral view space bent normal of the SSAO pass
+static const DXGI_FORMAT BentNormalFormat = DXGI_FORMAT_R8G8_UNORM;
+
 class LoadingProcess
 {
 private:
@@ -51,15 +69,16 @@ public:
 };
 
 Application *Application::instance = NULL;
+const WCHAR *const Application::AOEventName = L"AO";
 
 static void DrawPreloadingMessage(const std::wstring &Message) throw (Exception)
 {
     float color[4] = {0.9,0.9,0.9,0};
 
-    DeviceKeeper::GetDeviceContext()->ClearRenderTargetView(DeviceKeeper::GetRenderTargetView(), color);
-    DeviceKeeper::GetDeviceContext()->ClearDepthStencilView(DeviceKeeper::GetDepthStencilView(), D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.0f, 0);
+    DeviceKeeper::GetRenderContext()->ClearRenderTargetView(DeviceKeeper::GetRenderTargetView(), color);
+    DeviceKeeper::GetRenderContext()->ClearDepthStencilView(DeviceKeeper::GetDepthStencilView(), D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.0f, 0);
 
-    HR(DeviceKeeper::GetSwapChain()->Present(0, 0), []{return D3DException("swap chain present failed");});
+    HR(DeviceKeeper::GetRenderContext()->Present(0, 0), []{return D3DException("swap chain present failed");});
         
     HDC wdc = GetWindowDC(CommonParams::GetWindow());
 
@@ -71,28 +90,24 @@ static void DrawPreloadingMessage(const std::wstring &Message) throw (Exception)
     DeleteDC(wdc);
 }
 
-static std::vector<D3DXVECTOR4> CreateKernel(UINT KernelSize)
+static D3D11_VIEWPORT GetRenderTargetViewport(const Texture::RenderTarget &Rt)
 {
-    std::vector<D3DXVECTOR4> kernel(KernelSize);
-
-    int i = 0;
-
-    for(D3DXVECTOR4 &k : kernel){
-        k.x = Math::RandSNorm();
-        k.y = Math::RandSNorm();
-        k.z = Math::RandSNorm();
-        k.w = 0.0f;
-
-        D3DXVec4Normalize(&k, &k);
-
-        FLOAT factor = (float)i / KernelSize;
+    D3D11_VIEWPORT viewport = {};
+    viewport.Width = (FLOAT)Rt.GetWidth();
+    viewport.Height = (FLOAT)Rt.GetHeight();
+    viewport.MaxDepth = 1.0f;
 
-        k *= Math::Lerp(0.1f, 0.9f, factor);
+    return viewport;
+}
 
-        i++;
-    }
+static D3D11_VIEWPORT GetRenderTargetViewport(const Texture::RenderTargetMips &Rt, UINT MipLevel)
+{
+    D3D11_VIEWPORT viewport = {};
+    viewport.Width = (FLOAT)Rt.GetWidth(MipLevel);
+    viewport.Height = (FLOAT)Rt.GetHeight(MipLevel);
+    viewport.MaxDepth = 1.0f;
 
-    return kernel;
+    return viewport;
 }
 
 void Application::CreateRenderStates()
@@ -155,17 +170,13 @@ void Application::LoadResources() throw (Exception)
     });
     ldPrc.AddStage([this]()
     {
-        ndRt.Init(DXGI_FORMAT_R32G32B32A32_FLOAT);
-        ssaoRt.Init(DXGI_FORMAT_R32G32B32A32_FLOAT);
+        ndRt.Init(NormalDepthFormat);
+        ssaoRt.Init(OcclusionFormat);
 
-        kernelOffsetsSRV = Texture::CreateTexture2D(KernelOffsetsTexSize, DXGI_FORMAT_R8G8B8A8_UNORM,
-        [](UCHAR *Px, const POINT &Pt)
-        {
-            Px[0] = rand() % 255; //b
-            Px[1] = rand() % 255; //g
-            Px[2] = rand() % 255; //r
-            Px[3] = rand() % 255; //a
-        });
+        std::vector<UCHAR> kernelOffsets;
+        CpuRendering::CreateRandomOffsets(KernelOffsetsTexSize.width, KernelOffsetsTexSize.height, &kernelOffsets);
+
+        kernelOffsetsSRV = Texture::CreateTexture2D(KernelOffsetsTexSize, DXGI_FORMAT_R8G8B8A8_UNORM, reinterpret_cast<const char*>(&kernelOffsets[0]));
     });
     ldPrc.AddStage([this]()
     {
@@ -182,36 +193,164 @@ void Application::LoadResources() throw (Exception)
     {
         Shaders::ShadersSet ssao;
         ssao.vs.Load(L"../Resources/Shaders/SSAOv3.vs", "ProcessVertex", screenQuad.GetVertexMetadata());
-        ssao.ps.Load(L"../Resources/Shaders/SSAOv3.ps", "ProcessPixel");
+        ssao.ps.Load(L"../Resources/Shaders/SSAOv3.ps", "ProcessPixel", {{"SAMPLES_COUNT", Utils::to_string(SSAOSamplesCount)}});
+
+        Shaders::ShadersSet ssaoDeinterleaved;
+        ssaoDeinterleaved.vs.Load(L"../Resources/Shaders/SSAOv3.vs", "ProcessVertex", screenQuad.GetVertexMetadata());
+        ssaoDeinterleaved.ps.Load(L"../Resources/Shaders/SSAOv3.ps", "ProcessPixel", {{"SAMPLES_COUNT", Utils::to_string(SSAOSamplesCount)}, {"DEINTERLEAVED", "1"}});
+
+        Shaders::ShadersSet ssaoDepthOnly;
+        ssaoDepthOnly.vs.Load(L"../Resources/Shaders/SSAOv3.vs", "ProcessVertex", screenQuad.GetVertexMetadata());
+        ssaoDepthOnly.ps.Load(L"../Resources/Shaders/SSAOv3.ps", "ProcessPixel", {{"SAMPLES_COUNT", Utils::to_string(SSAOSamplesCount)}, {"DEPTH_ONLY", "1"}});
+
+        Shaders::ShadersSet ssaoBentNormals;
+        ssaoBentNormals.vs.Load(L"../Resources/Shaders/SSAOv3.vs", "ProcessVertex", screenQuad.GetVertexMetadata());
+        ssaoBentNormals.ps.Load(L"../Resources/Shaders/SSAOv3.ps", "ProcessPixel", {{"SAMPLES_COUNT", Utils::to_string(SSAOSamplesCount)}, {"BENT_NORMALS", "1"}});
     
         Shaders::ShadersSet nd;
         nd.vs.Load(L"../Resources/Shaders/NormalVDepthV.vs", "ProcessVertex", meshes.GetMesh(hallMeshId)->GetVertexMetadata());
         nd.ps.Load(L"../Resources/Shaders/NormalVDepthV.ps", "ProcessPixel");
 
+        Shaders::ShadersSet depthOnly;
+        depthOnly.vs.Load(L"../Resources/Shaders/DepthV.vs", "ProcessVertex", meshes.GetMesh(hallMeshId)->GetVertexMetadata());
+        depthOnly.ps.Load(L"../Resources/Shaders/DepthV.ps", "ProcessPixel");
+
+        Shaders::ShadersSet downsampleNd;
+        downsampleNd.vs.Load(L"../Resources/Shaders/SimplePostProcess.vs", "ProcessVertex", screenQuad.GetVertexMetadata());
+        downsampleNd.ps.Load(L"../Resources/Shaders/DownsampleNormalDepth.ps", "ProcessPixel");
+
+        downsampleNd.ps.CreateVariable<INT>("scale", 0, 0, ssaoResolutionScale);
+        downsampleNd.ps.CreateVariable("padding", 0, 1, D3DXVECTOR3());
+        downsampleNd.ps.ApplyVariables();
+
+        Shaders::ShadersSet upsampleSsao;
+        upsampleSsao.vs.Load(L"../Resources/Shaders/SimplePostProcess.vs", "ProcessVertex", screenQuad.GetVertexMetadata());
+        upsampleSsao.ps.Load(L"../Resources/Shaders/BilateralUpsample.ps", "ProcessPixel");
+
+        CpuRendering::BilateralUpsampleParams upsampleParams;
+        upsampleSsao.ps.CreateVariable<float>("depthTolerance", 0, 0, upsampleParams.depthTolerance);
+        upsampleSsao.ps.CreateVariable<float>("normalPower", 0, 1, upsampleParams.normalPower);
+        upsampleSsao.ps.CreateVariable("padding", 0, 2, D3DXVECTOR2());
+        upsampleSsao.ps.ApplyVariables();
+
+        Shaders::ShadersSet combineScales;
+        combineScales.vs.Load(L"../Resources/Shaders/SimplePostProcess.vs", "ProcessVertex", screenQuad.GetVertexMetadata());
+        combineScales.ps.Load(L"../Resources/Shaders/MultiScaleCombine.ps", "ProcessPixel");
+
+        combineScales.ps.CreateVariable<float>("depthTolerance", 0, 0, upsampleParams.depthTolerance);
+        combineScales.ps.CreateVariable<float>("normalPower", 0, 1, upsampleParams.normalPower);
+        combineScales.ps.CreateVariable<INT>("combine", 0, 2, multiScaleParams.combine);
+        combineScales.ps.CreateVariable<float>("padding", 0, 3, 0.0f);
+        combineScales.ps.ApplyVariables();
+
+        Shaders::ShadersSet temporalAccumulate;
+        temporalAccumulate.vs.Load(L"../Resources/Shaders/SimplePostProcess.vs", "ProcessVertex", screenQuad.GetVertexMetadata());
+        temporalAccumulate.ps.Load(L"../Resources/Shaders/TemporalSSAO.ps", "ProcessPixel");
+
+        CpuRendering::TemporalParams temporalParams;
+        temporalAccumulate.ps.CreateVariable<D3DXMATRIX>("viewToPrevView", 0, 0);
+        temporalAccumulate.ps.CreateVariable("proj", 0, 1, eyeCamera.GetProjMatrix());
+        temporalAccumulate.ps.CreateVariable("invProj", 0, 2, Math::Inverse(eyeCamera.GetProjMatrix()));
+        temporalAccumulate.ps.CreateVariable<INT>("subset", 0, 3, 0);
+        temporalAccumulate.ps.CreateVariable<INT>("historyValid", 0, 4, false);
+        temporalAccumulate.ps.CreateVariable<float>("depthThreshold", 0, 5, temporalParams.depthThreshold);
+        temporalAccumulate.ps.CreateVariable<float>("normalThreshold", 0, 6, temporalParams.normalThreshold);
+        temporalAccumulate.ps.ApplyVariables();
+
+        Shaders::ShadersSet temporalResolve;
+        temporalResolve.vs.Load(L"../Resources/Shaders/SimplePostProcess.vs", "ProcessVertex", screenQuad.GetVertexMetadata());
+        temporalResolve.ps.Load(L"../Resources/Shaders/TemporalSSAOResolve.ps", "ProcessPixel");
+
+        Shaders::ShadersSet buildDepthPyramid;
+        buildDepthPyramid.vs.Load(L"../Resources/Shaders/SimplePostProcess.vs", "ProcessVertex", screenQuad.GetVertexMetadata());
+        buildDepthPyramid.ps.Load(L"../Resources/Shaders/DepthPyramid.ps", "ProcessPixel");
+
+        buildDepthPyramid.ps.CreateVariable<INT>("copyDepth", 0, 0, true);
+        buildDepthPyramid.ps.CreateVariable("padding", 0, 1, D3DXVECTOR3());
+        buildDepthPyramid.ps.ApplyVariables();
+
+        Shaders::ShadersSet deinterleaveDepth;
+        deinterleaveDepth.vs.Load(L"../Resources/Shaders/SimplePostProcess.vs", "ProcessVertex", screenQuad.GetVertexMetadata());
+        deinterleaveDepth.ps.Load(L"../Resources/Shaders/Deinterleave.ps", "ProcessPixel");
+
+        Shaders::ShadersSet reinterleaveSsao;
+        reinterleaveSsao.vs.Load(L"../Resources/Shaders/SimplePostProcess.vs", "ProcessVertex", screenQuad.GetVertexMetadata());
+        reinterleaveSsao.ps.Load(L"../Resources/Shaders/Reinterleave.ps", "ProcessPixel");
+
+        Shaders::ShadersSet classifyTiles;
+        classifyTiles.vs.Load(L"../Resources/Shaders/SimplePostProcess.vs", "ProcessVertex", screenQuad.GetVertexMetadata());
+        classifyTiles.ps.Load(L"../Resources/Shaders/TileClassification.ps", "ProcessPixel");
+
+        CpuRendering::TileClassificationParams classificationParams;
+        classifyTiles.ps.CreateVariable("proj", 0, 0, eyeCamera.GetProjMatrix());
+        classifyTiles.ps.CreateVariable<float>("occlusionRadius", 0, 1, 0.8f);
+        classifyTiles.ps.CreateVariable<float>("minScreenRadius", 0, 2, classificationParams.minScreenRadius);
+        classifyTiles.ps.CreateVariable<float>("maxFlatNormalVariance", 0, 3, classificationParams.maxFlatNormalVariance);
+        classifyTiles.ps.CreateVariable<float>("maxFlatDepthRange", 0, 4, classificationParams.maxFlatDepthRange);
+        classifyTiles.ps.ApplyVariables();
+
         Shaders::ShadersSet drawBlurRes;
         drawBlurRes.vs.Load(L"../Resources/Shaders/SimplePostProcess.vs", "ProcessVertex", screenQuad.GetVertexMetadata());
-        drawBlurRes.ps.Load(L"../Resources/Shaders/SimplePostProcess.ps", "ProcessPixel");
+        drawBlurRes.ps.Load(L"../Resources/Shaders/DrawOcclusion.ps", "ProcessPixel");
     
         drawBlurRes.ps.CreateSamplerState(0, {D3D11_FILTER_MIN_MAG_MIP_POINT, D3D11_TEXTURE_ADDRESS_WRAP});
 
-        ssao.ps.CreateSamplerState(0, {D3D11_FILTER_MIN_MAG_MIP_LINEAR, D3D11_TEXTURE_ADDRESS_CLAMP});
-        ssao.ps.CreateSamplerState(1, {D3D11_FILTER_MIN_MAG_MIP_POINT, D3D11_TEXTURE_ADDRESS_WRAP});
-        
-        const UINT kernelSize = 16;
+        //all permutations take the same kernel
+        CpuRendering::KernelStorage ssaoKernel = CpuRendering::CreateKernel<SSAOSamplesCount>(CpuRendering::KERNEL_SEQUENCE_HAMMERSLEY);
+
+        for(Shaders::ShadersSet *ssaoSet : {&ssao, &ssaoDeinterleaved, &ssaoDepthOnly, &ssaoBentNormals}){
+            ssaoSet->ps.CreateSamplerState(0, {D3D11_FILTER_MIN_MAG_MIP_LINEAR, D3D11_TEXTURE_ADDRESS_CLAMP});
+            ssaoSet->ps.CreateSamplerState(1, {D3D11_FILTER_MIN_MAG_MIP_POINT, D3D11_TEXTURE_ADDRESS_WRAP});
+
+            ssaoSet->ps.CreateVariable("kernel", 0, 0, ssaoKernel);
+            ssaoSet->ps.CreateVariable("proj", 0, 1, eyeCamera.GetProjMatrix());
+            ssaoSet->ps.CreateVariable("invProj", 0, 2, Math::Inverse(eyeCamera.GetProjMatrix()));
+            ssaoSet->ps.CreateVariable<float>("occlusionRadius", 0, 3, 0.8f);
+            ssaoSet->ps.CreateVariable("rndTexFactor", 0, 4, D3DXVECTOR2(CommonParams::GetScreenWidth() / (float)KernelOffsetsTexSize.width, CommonParams::GetScreenHeight() / (float)KernelOffsetsTexSize.height));
+            ssaoSet->ps.CreateVariable<float>("harshness", 0, 5, 1.5f);
+            ssaoSet->ps.CreateVariable<INT>("sampleOffset", 0, 6, 0);
+            ssaoSet->ps.CreateVariable<INT>("sampleStep", 0, 7, 1);
+            ssaoSet->ps.CreateVariable<INT>("outputVisibility", 0, 8, false);
+            ssaoSet->ps.CreateVariable<INT>("useDepthPyramid", 0, 9, false);
+            ssaoSet->ps.CreateVariable<INT>("useTileClasses", 0, 10, false);
+            ssaoSet->ps.CreateVariable<INT>("reducedSampleStep", 0, 11, classificationParams.reducedSampleStep);
+            ssaoSet->ps.ApplyVariables();
+        }
 
-        ssao.ps.CreateVariable("kernel", 0, 0, CreateKernel(kernelSize));
-        ssao.ps.CreateVariable("proj", 0, 1, eyeCamera.GetProjMatrix());
-        ssao.ps.CreateVariable("invProj", 0, 2, Math::Inverse(eyeCamera.GetProjMatrix()));
-        ssao.ps.CreateVariable<float>("occlusionRadius", 0, 3, 0.8f);
-        ssao.ps.CreateVariable("rndTexFactor", 0, 4, D3DXVECTOR2(CommonParams::GetScreenWidth() / (float)KernelOffsetsTexSize.width, CommonParams::GetScreenHeight() / (float)KernelOffsetsTexSize.height));
-        ssao.ps.CreateVariable<float>("harshness", 0, 5, 1.5f);
-        ssao.ps.ApplyVariables();
+        Shaders::ShadersSet hbao;
+        hbao.vs.Load(L"../Resources/Shaders/SSAOv3.vs", "ProcessVertex", screenQuad.GetVertexMetadata());
+        hbao.ps.Load(L"../Resources/Shaders/HBAO.ps", "ProcessPixel");
+
+        hbao.ps.CreateSamplerState(0, {D3D11_FILTER_MIN_MAG_MIP_LINEAR, D3D11_TEXTURE_ADDRESS_CLAMP});
+        hbao.ps.CreateSamplerState(1, {D3D11_FILTER_MIN_MAG_MIP_POINT, D3D11_TEXTURE_ADDRESS_WRAP});
+
+        CpuRendering::HBAOParams hbaoParams;
+        hbao.ps.CreateVariable("proj", 0, 0, eyeCamera.GetProjMatrix());
+        hbao.ps.CreateVariable("invProj", 0, 1, Math::Inverse(eyeCamera.GetProjMatrix()));
+        hbao.ps.CreateVariable<float>("occlusionRadius", 0, 2, 0.8f);
+        hbao.ps.CreateVariable("rndTexFactor", 0, 3, D3DXVECTOR2(CommonParams::GetScreenWidth() / (float)KernelOffsetsTexSize.width, CommonParams::GetScreenHeight() / (float)KernelOffsetsTexSize.height));
+        hbao.ps.CreateVariable<float>("harshness", 0, 4, 1.5f);
+        hbao.ps.CreateVariable<INT>("sampleOffset", 0, 5, 0);
+        hbao.ps.CreateVariable<INT>("sampleStep", 0, 6, 1);
+        hbao.ps.CreateVariable<INT>("outputVisibility", 0, 7, false);
+        hbao.ps.CreateVariable<INT>("useDepthPyramid", 0, 8, false);
+        hbao.ps.CreateVariable<INT>("directionsCount", 0, 9, hbaoParams.directionsCount);
+        hbao.ps.CreateVariable<INT>("stepsCount", 0, 10, hbaoParams.stepsCount);
+        hbao.ps.CreateVariable<float>("angleBias", 0, 11, hbaoParams.angleBias);
+        hbao.ps.CreateVariable<float>("padding", 0, 12, 0.0f);
+        hbao.ps.ApplyVariables();
 
         nd.vs.CreateVariable<D3DXMATRIX>("worldViewProj", 0, 0);
         nd.vs.CreateVariable<D3DXMATRIX>("worldInvTransView", 0, 1);
         nd.vs.CreateVariable<D3DXMATRIX>("worldView", 0, 2);
 
-        ssaoDrawer.Init(nd, ssao, drawBlurRes, ndRt, ssaoRt, kernelOffsetsSRV);
+        depthOnly.vs.CreateVariable<D3DXMATRIX>("worldViewProj", 0, 0);
+        depthOnly.vs.CreateVariable<D3DXMATRIX>("worldView", 0, 1);
+
+        ssaoDrawer.Init(nd, depthOnly, ssao, ssaoDeinterleaved, ssaoDepthOnly, ssaoBentNormals, hbao, drawBlurRes, downsampleNd, upsampleSsao, temporalAccumulate, temporalResolve,
+                        buildDepthPyramid, deinterleaveDepth, reinterleaveSsao, classifyTiles, combineScales, ndRt, ssaoRt, kernelOffsetsSRV);
+
+        CreateLowResolutionTargets();
     });
     ldPrc.AddStage([this]()
     {
@@ -236,12 +375,17 @@ void Application::LoadResources() throw (Exception)
 
         pl.ps.CreateVariable<INT>("useSsao", 3, 0, true);
         pl.ps.CreateVariable<INT>("useColorTexture", 3, 1, false);
-        pl.ps.CreateVariable<D3DXVECTOR2>("padding3", 3, 2);
+        pl.ps.CreateVariable<INT>("useBentNormals", 3, 2, false);
+        pl.ps.CreateVariable<FLOAT>("padding3", 3, 3);
+
+        pl.ps.CreateVariable<D3DXMATRIX>("invView", 4, 0);
 
         pl.ps.CreateSamplerState(0, {D3D11_FILTER_MIN_MAG_MIP_LINEAR, D3D11_TEXTURE_ADDRESS_CLAMP});
         pl.ps.CreateSamplerState(1, {D3D11_FILTER_MIN_MAG_MIP_LINEAR, D3D11_TEXTURE_ADDRESS_CLAMP});
 
         pointLight.Init(pl, ssaoRt);
+
+        CreateBentNormalTarget();
     });
     ldPrc.AddStage([this]()
     {
@@ -252,6 +396,36 @@ void Application::LoadResources() throw (Exception)
         blur.SetKernel(PostProcess::Blur::GetGaussianKernel(5.0f));
 
         blur.GetPixelShader().CreateSamplerState(1, {D3D11_FILTER_MIN_MAG_MIP_POINT, D3D11_TEXTURE_ADDRESS_CLAMP});
+
+        //edges of the depth only prepass are found by the depth alone
+        depthOnlyBlur.Init(blurVsPath, blurPsPath, &screenQuad, ssaoRt, 1, PostProcess::Blur::KernelStorage(), {{"DEPTH_ONLY", "1"}});
+        depthOnlyBlur.SetKernel(PostProcess::Blur::GetGaussianKernel(5.0f));
+
+        depthOnlyBlur.GetPixelShader().CreateSamplerState(1, {D3D11_FILTER_MIN_MAG_MIP_POINT, D3D11_TEXTURE_ADDRESS_CLAMP});
+
+        //bent normals take the same edges, the blur is set to bentNormalRt by CreateBentNormalTarget.
+        //Its intermediate target takes the format of the target it is initialized with
+        Texture::RenderTarget bentNormalFormatRt;
+        bentNormalFormatRt.Init(BentNormalFormat, (USHORT)CommonParams::GetScreenWidth(), (USHORT)CommonParams::GetScreenHeight());
+
+        bentNormalBlur.Init(blurVsPath, blurPsPath, &screenQuad, bentNormalFormatRt, 1, PostProcess::Blur::KernelStorage(), {{"BENT_NORMALS", "1"}});
+        bentNormalBlur.SetKernel(PostProcess::Blur::GetGaussianKernel(5.0f));
+        bentNormalBlur.SetDataRenderTarget(bentNormalRt);
+
+        bentNormalBlur.GetPixelShader().CreateSamplerState(1, {D3D11_FILTER_MIN_MAG_MIP_POINT, D3D11_TEXTURE_ADDRESS_CLAMP});
+    });
+    ldPrc.AddStage([this]()
+    {
+        std::wstring boxFilterVsPath = L"../Resources/Shaders/SimplePostProcess.vs";
+        std::wstring satBuildPsPath = L"../Resources/Shaders/SATBuild.ps";
+        std::wstring boxFilterPsPath = L"../Resources/Shaders/BoxFilter.ps";
+
+        //depth tolerance of the edge saving blur
+        boxFilter.Init(boxFilterVsPath, satBuildPsPath, boxFilterPsPath, &screenQuad, ssaoRt, 4);
+        boxFilter.SetDepthTolerance(0.2f);
+
+        depthOnlyBoxFilter.Init(boxFilterVsPath, satBuildPsPath, boxFilterPsPath, &screenQuad, ssaoRt, 4, {{"DEPTH_ONLY", "1"}});
+        depthOnlyBoxFilter.SetDepthTolerance(0.2f);
     });
     ldPrc.AddStage([this]()
     {
@@ -287,6 +461,12 @@ void Application::Invalidate(float Tf)
     if(optionsMenu->GetState() == Dialogs::MENU_STATE_CLOSED){
         eyeCamera.Invalidate(Tf);
 
+        if(DirectInput::GetInsance()->IsKeyboardPress(DIK_F2))
+            RecordCameraPath();
+
+        if(isRecordingPath)
+            recordedPath.push_back(CpuRendering::Matrix(static_cast<const FLOAT*>(eyeCamera.GetViewMatrix())));
+
         fpsLabel->SetCaption(Utils::to_wstring(timer.GetFps()));
 
         if(optionsMenu->GetPointLightMode()){
@@ -344,6 +524,16 @@ void Application::OnChangeResolution()
     FLOAT harshness = optionsMenu->GetHarshness();
     bool pointLightMode = optionsMenu->GetPointLightMode();
     bool ssaoMode = optionsMenu->GetSsaoMode();
+    INT resolutionScale = optionsMenu->GetSsaoResolutionScale();
+    bool temporalMode = optionsMenu->GetTemporalSsaoMode();
+    bool depthPyramidMode = optionsMenu->GetDepthPyramidMode();
+    bool deinterleavedSsaoMode = optionsMenu->GetDeinterleavedSsaoMode();
+    bool depthOnlyPrepassMode = optionsMenu->GetDepthOnlyPrepassMode();
+    bool adaptiveSamplingMode = optionsMenu->GetAdaptiveSamplingMode();
+    bool multiScaleSsaoMode = optionsMenu->GetMultiScaleSsaoMode();
+    bool bentNormalsMode = optionsMenu->GetBentNormalsMode();
+    bool boxFilterMode = optionsMenu->GetBoxFilterMode();
+    INT aoTechnique = optionsMenu->GetAOTechnique();
 
     ReleaseGUI();
 
@@ -358,10 +548,15 @@ void Application::OnChangeResolution()
     LoadingProcess ldPrc;
     ldPrc.AddStage([&, this]()
     {
-        ssaoDrawer.GetSSAOSHadersSet().ps.UpdateVariable("rndTexFactor", D3DXVECTOR2(CommonParams::GetScreenWidth() / (float)KernelOffsetsTexSize.width, CommonParams::GetScreenHeight() / (float)KernelOffsetsTexSize.height));
-        ssaoDrawer.GetSSAOSHadersSet().ps.UpdateVariable("proj", eyeCamera.GetProjMatrix());
-        ssaoDrawer.GetSSAOSHadersSet().ps.UpdateVariable("invProj", Math::Inverse(eyeCamera.GetProjMatrix()));
-        ssaoDrawer.GetSSAOSHadersSet().ps.ApplyVariables();
+        ssaoDrawer.UpdateAOVariable("proj", eyeCamera.GetProjMatrix());
+        ssaoDrawer.UpdateAOVariable("invProj", Math::Inverse(eyeCamera.GetProjMatrix()));
+
+        ssaoDrawer.GetTemporalAccumulateShadersSet().ps.UpdateVariable("proj", eyeCamera.GetProjMatrix());
+        ssaoDrawer.GetTemporalAccumulateShadersSet().ps.UpdateVariable("invProj", Math::Inverse(eyeCamera.GetProjMatrix()));
+        ssaoDrawer.GetTemporalAccumulateShadersSet().ps.ApplyVariables();
+
+        ssaoDrawer.GetClassifyTilesShadersSet().ps.UpdateVariable("proj", eyeCamera.GetProjMatrix());
+        ssaoDrawer.GetClassifyTilesShadersSet().ps.ApplyVariables();
     });
     ldPrc.AddStage([&, this]()
     {
@@ -373,23 +568,51 @@ void Application::OnChangeResolution()
         optionsMenu->SetHarshness(harshness);
         optionsMenu->SetPointLightMode(pointLightMode);
         optionsMenu->SetSsaoMode(ssaoMode);
+        optionsMenu->SetSsaoResolutionScale(resolutionScale);
+        optionsMenu->SetTemporalSsaoMode(temporalMode);
+        optionsMenu->SetDepthPyramidMode(depthPyramidMode);
+        optionsMenu->SetDeinterleavedSsaoMode(deinterleavedSsaoMode);
+        optionsMenu->SetDepthOnlyPrepassMode(depthOnlyPrepassMode);
+        optionsMenu->SetAdaptiveSamplingMode(adaptiveSamplingMode);
+        optionsMenu->SetMultiScaleSsaoMode(multiScaleSsaoMode);
+        optionsMenu->SetBentNormalsMode(bentNormalsMode);
+        optionsMenu->SetBoxFilterMode(boxFilterMode);
+        optionsMenu->SetAOTechnique(aoTechnique);
         
     });
     ldPrc.AddStage([&, this]()
     {
         Texture::RenderTarget newNdRt, newSsaoRt;
 
-        newNdRt.Init(DXGI_FORMAT_R32G32B32A32_FLOAT, (USHORT)CommonParams::GetScreenWidth(), (USHORT)CommonParams::GetScreenHeight());
-        newSsaoRt.Init(DXGI_FORMAT_R32G32B32A32_FLOAT, (USHORT)CommonParams::GetScreenWidth(), (USHORT)CommonParams::GetScreenHeight());
+        newNdRt.Init(NormalDepthFormat, (USHORT)CommonParams::GetScreenWidth(), (USHORT)CommonParams::GetScreenHeight());
+        newSsaoRt.Init(OcclusionFormat, (USHORT)CommonParams::GetScreenWidth(), (USHORT)CommonParams::GetScreenHeight());
 
         blur.OnResolutionChanged();
         blur.SetDataRenderTarget(newSsaoRt);
 
+        depthOnlyBlur.OnResolutionChanged();
+        depthOnlyBlur.SetDataRenderTarget(newSsaoRt);
+
+        bentNormalBlur.OnResolutionChanged();
+
+        boxFilter.OnResolutionChanged();
+        boxFilter.SetDataRenderTarget(newSsaoRt);
+
+        depthOnlyBoxFilter.OnResolutionChanged();
+        depthOnlyBoxFilter.SetDataRenderTarget(newSsaoRt);
+
         ssaoDrawer.SetNewRenderTargets(newNdRt, newSsaoRt);
         pointLight.SetNewSSAORenderTarget(newSsaoRt);
         
         ndRt = newNdRt;
         ssaoRt = newSsaoRt;
+
+        CreateLowResolutionTargets();
+        CreateTemporalTargets();
+        CreateDepthOnlyTarget();
+        CreateBentNormalTarget();
+
+        InvalidateAOCache();
     });
     ldPrc.Excecute();
 
@@ -398,25 +621,489 @@ void Application::OnChangeResolution()
     DisplaySettings::AdapterManager::GetInstance()->ChangeResolution(newRes);
 }
 
-void Application::CalculateSSAO()
+void Application::CreateLowResolutionTargets() throw (Exception)
 {
-    ssaoDrawer.SetPass(SSAODrawer::PASS_DRAW_DEPTH);
+    SizeUS ssaoSize(CommonParams::GetScreenWidth(), CommonParams::GetScreenHeight());
+
+    if(ssaoResolutionScale > 1){
+        ssaoSize.width = (ssaoSize.width + ssaoResolutionScale - 1) / ssaoResolutionScale;
+        ssaoSize.height = (ssaoSize.height + ssaoResolutionScale - 1) / ssaoResolutionScale;
+
+        Texture::RenderTarget newNdLowRt, newSsaoLowRt;
+
+        newNdLowRt.Init(NormalDepthFormat, ssaoSize.width, ssaoSize.height);
+        newSsaoLowRt.Init(OcclusionFormat, ssaoSize.width, ssaoSize.height);
+
+        ndLowRt = newNdLowRt;
+        ssaoLowRt = newSsaoLowRt;
+    }else{
+        ndLowRt = Texture::RenderTarget();
+        ssaoLowRt = Texture::RenderTarget();
+    }
+
+    ssaoDrawer.SetResolutionScale(ssaoResolutionScale, ndLowRt, ssaoLowRt);
+
+    ssaoDrawer.UpdateAOVariable("rndTexFactor", D3DXVECTOR2(ssaoSize.width / (float)KernelOffsetsTexSize.width, ssaoSize.height / (float)KernelOffsetsTexSize.height));
+
+    CreateDepthPyramidTarget();
+    CreateDeinterleavedTargets();
+    CreateTileClassesTarget();
+    CreateMultiScaleTargets();
+}
+
+void Application::CreateDeinterleavedTargets() throw (Exception)
+{
+    depthAtlasRt = Texture::RenderTarget();
+    ssaoAtlasRt = Texture::RenderTarget();
+
+    //atlases of 4 x 4 layers of the normal/depth buffer SSAO pass reads, layer size is rounded up
+    if(deinterleavedSsao){
+        const Texture::RenderTarget &normalDepth = (ssaoResolutionScale > 1) ? ndLowRt : ndRt;
+        USHORT layerWidth = (normalDepth.GetWidth() + CpuRendering::DeinterleaveFactor - 1) / CpuRendering::DeinterleaveFactor;
+        USHORT layerHeight = (normalDepth.GetHeight() + CpuRendering::DeinterleaveFactor - 1) / CpuRendering::DeinterleaveFactor;
+
+        depthAtlasRt.Init(DXGI_FORMAT_R32_FLOAT, layerWidth * CpuRendering::DeinterleaveFactor, layerHeight * CpuRendering::DeinterleaveFactor);
+        ssaoAtlasRt.Init(OcclusionFormat, layerWidth * CpuRendering::DeinterleaveFactor, layerHeight * CpuRendering::DeinterleaveFactor);
+    }
+
+    ssaoDrawer.SetDeinterleavedRenderTargets(depthAtlasRt, ssaoAtlasRt);
+}
+
+void Application::DrawSSAO(const Texture::RenderTarget &SsaoTarget)
+{
+    if(ssaoDrawer.IsBentNormals()){
+        ssaoDrawer.SetPass(SSAODrawer::PASS_DRAW_SSAO);
+
+        PostProcess::RenderPass pass({SsaoTarget.GetRenderTargetView(), bentNormalRt.GetRenderTargetView()}, NULL, GetRenderTargetViewport(SsaoTarget));
+        drawingContainer.Draw({&screenQuad}, &eyeCamera);
+        return;
+    }
+
+    if(!ssaoDrawer.IsDeinterleaved()){
+        ssaoDrawer.SetPass(SSAODrawer::PASS_DRAW_SSAO);
+
+        PostProcess::RenderPass pass(SsaoTarget.GetRenderTargetView(), NULL, GetRenderTargetViewport(SsaoTarget));
+        drawingContainer.Draw({&screenQuad}, &eyeCamera);
+        return;
+    }
+
+    ssaoDrawer.SetPass(SSAODrawer::PASS_DEINTERLEAVE_DEPTH);
 
     {
-        PostProcess::RenderPass pass(ndRt.GetRenderTargetView());
-        drawingContainer.Draw({&hallObject}, &eyeCamera);
+        PostProcess::RenderPass pass(depthAtlasRt.GetRenderTargetView(), NULL, GetRenderTargetViewport(depthAtlasRt));
+        drawingContainer.Draw({&screenQuad}, &eyeCamera);
     }
 
     ssaoDrawer.SetPass(SSAODrawer::PASS_DRAW_SSAO);
 
     {
-        PostProcess::RenderPass pass(ssaoRt.GetRenderTargetView());
+        PostProcess::RenderPass pass(ssaoAtlasRt.GetRenderTargetView(), NULL, GetRenderTargetViewport(ssaoAtlasRt));
+        drawingContainer.Draw({&screenQuad}, &eyeCamera);
+    }
+
+    ssaoDrawer.SetPass(SSAODrawer::PASS_REINTERLEAVE_SSAO);
+
+    {
+        PostProcess::RenderPass pass(SsaoTarget.GetRenderTargetView(), NULL, GetRenderTargetViewport(SsaoTarget));
+        drawingContainer.Draw({&screenQuad}, &eyeCamera);
+    }
+}
+
+void Application::CreateDepthOnlyTarget() throw (Exception)
+{
+    depthRt = Texture::RenderTarget();
+
+    if(depthOnlyPrepass)
+        depthRt.Init(DepthFormat, (USHORT)CommonParams::GetScreenWidth(), (USHORT)CommonParams::GetScreenHeight());
+
+    ssaoDrawer.SetDepthOnlyRenderTarget(depthRt);
+}
+
+bool Application::IsDepthOnlyPrepass() const
+{
+    //low resolution, temporal, pyramid, deinterleaved, tile classification, multi-scale and bent normal passes and HBAO read ndRt
+    return depthOnlyPrepass && ssaoResolutionScale == 1 && !temporalSsao && !depthPyramid && !deinterleavedSsao && !adaptiveSampling &&
+           !IsMultiScaleSsao() && !IsBentNormalsOutput() && ssaoDrawer.GetTechnique() == SSAODrawer::TECHNIQUE_SSAO;
+}
+
+void Application::CreateBentNormalTarget() throw (Exception)
+{
+    bentNormalRt = Texture::RenderTarget();
+
+    if(bentNormals)
+        bentNormalRt.Init(BentNormalFormat, (USHORT)CommonParams::GetScreenWidth(), (USHORT)CommonParams::GetScreenHeight());
+
+    pointLight.SetNewBentNormalRenderTarget(bentNormalRt);
+    bentNormalBlur.SetDataRenderTarget(bentNormalRt);
+}
+
+bool Application::IsBentNormalsOutput() const
+{
+    //the output goes along with the AO of the screen size, the passes merging several AO results have no single tap set
+    return bentNormals && ssaoResolutionScale == 1 && !temporalSsao && !deinterleavedSsao && !adaptiveSampling && !IsMultiScaleSsao() &&
+           ssaoDrawer.GetTechnique() == SSAODrawer::TECHNIQUE_SSAO;
+}
+
+void Application::CreateMultiScaleTargets() throw (Exception)
+{
+    for(INT l = 0; l < CpuRendering::MultiScaleLayersCount; l++){
+        multiScaleNdRt[l] = Texture::RenderTarget();
+        multiScaleAoRt[l] = Texture::RenderTarget();
+        multiScaleCombinedRt[l] = Texture::RenderTarget();
+    }
+
+    if(!multiScaleSsao)
+        return;
+
+    for(INT l = 0; l < CpuRendering::MultiScaleLayersCount; l++){
+        INT scale = multiScaleParams.layers[l].resolutionScale;
+        USHORT width = (USHORT)CpuRendering::GetScaledSize(CommonParams::GetScreenWidth(), scale);
+        USHORT height = (USHORT)CpuRendering::GetScaledSize(CommonParams::GetScreenHeight(), scale);
+
+        if(scale > 1)
+            multiScaleNdRt[l].Init(NormalDepthFormat, width, height);
+
+        multiScaleAoRt[l].Init(OcclusionFormat, width, height);
+
+        if(l > 0 && l < CpuRendering::MultiScaleLayersCount - 1)
+            multiScaleCombinedRt[l].Init(OcclusionFormat, width, height);
+    }
+}
+
+bool Application::IsMultiScaleSsao() const
+{
+    //layers have their own resolutions and kernel subsets
+    return multiScaleSsao && ssaoResolutionScale == 1 && !temporalSsao && !depthPyramid && !deinterleavedSsao && !adaptiveSampling &&
+           ssaoDrawer.GetTechnique() == SSAODrawer::TECHNIQUE_SSAO;
+}
+
+void Application::SetRndTexFactor(const Texture::RenderTarget &SsaoTarget)
+{
+    ssaoDrawer.UpdateAOVariable("rndTexFactor", D3DXVECTOR2(SsaoTarget.GetWidth() / (float)KernelOffsetsTexSize.width,
+                                                            SsaoTarget.GetHeight() / (float)KernelOffsetsTexSize.height));
+}
+
+void Application::DrawMultiScaleSSAO(const Texture::RenderTarget &SsaoTarget)
+{
+    const INT layersCount = CpuRendering::MultiScaleLayersCount;
+
+    for(INT l = 0; l < layersCount; l++){
+        const CpuRendering::MultiScaleLayer &layer = multiScaleParams.layers[l];
+
+        ssaoDrawer.SetResolutionScale(layer.resolutionScale, multiScaleNdRt[l], multiScaleAoRt[l]);
+
+        if(layer.resolutionScale > 1){
+            ssaoDrawer.SetPass(SSAODrawer::PASS_DOWNSAMPLE_DEPTH);
+
+            PostProcess::RenderPass pass(multiScaleNdRt[l].GetRenderTargetView(), NULL, GetRenderTargetViewport(multiScaleNdRt[l]));
+            drawingContainer.Draw({&screenQuad}, &eyeCamera);
+        }
+
+        ssaoDrawer.UpdateAOVariable("occlusionRadius", occlusionRadius * layer.radiusScale);
+        ssaoDrawer.UpdateAOVariable("sampleStep", layer.sampleStep);
+        SetRndTexFactor(multiScaleAoRt[l]);
+
+        DrawSSAO(multiScaleAoRt[l]);
+    }
+
+    ssaoDrawer.SetResolutionScale(ssaoResolutionScale, ndLowRt, ssaoLowRt);
+    ssaoDrawer.UpdateAOVariable("occlusionRadius", occlusionRadius);
+    ssaoDrawer.UpdateAOVariable("sampleStep", 1);
+    SetRndTexFactor(SsaoTarget);
+
+    //the coarser layers are upsampled to the next finer one, only the last pass runs at full resolution
+    ssaoDrawer.SetPass(SSAODrawer::PASS_COMBINE_SCALES);
+
+    for(INT l = layersCount - 2; l >= 0; l--){
+        const Texture::RenderTarget &coarseAoRt = (l + 1 == layersCount - 1) ? multiScaleAoRt[l + 1] : multiScaleCombinedRt[l + 1];
+        const Texture::RenderTarget &targetRt = (l == 0) ? SsaoTarget : multiScaleCombinedRt[l];
+
+        ssaoDrawer.SetCombineScalesSources(multiScaleAoRt[l], (l == 0) ? ndRt : multiScaleNdRt[l], coarseAoRt, multiScaleNdRt[l + 1]);
+
+        PostProcess::RenderPass pass(targetRt.GetRenderTargetView(), NULL, GetRenderTargetViewport(targetRt));
+        drawingContainer.Draw({&screenQuad}, &eyeCamera);
+    }
+}
+
+void Application::CreateDepthPyramidTarget() throw (Exception)
+{
+    depthPyramidRt = Texture::RenderTargetMips();
+
+    //pyramid is of the size of the normal/depth buffer SSAO pass reads
+    if(depthPyramid){
+        const Texture::RenderTarget &normalDepth = (ssaoResolutionScale > 1) ? ndLowRt : ndRt;
+        depthPyramidRt.Init(DXGI_FORMAT_R32_FLOAT, normalDepth.GetWidth(), normalDepth.GetHeight(), CpuRendering::DepthPyramidMaxLevelsCount);
+    }
+
+    ssaoDrawer.SetDepthPyramidRenderTarget(depthPyramidRt);
+
+    ssaoDrawer.UpdateAOVariable<INT>("useDepthPyramid", depthPyramid);
+}
+
+void Application::BuildDepthPyramid()
+{
+    ssaoDrawer.SetPass(SSAODrawer::PASS_BUILD_DEPTH_PYRAMID);
+
+    for(UINT level = 0; level < depthPyramidRt.GetMipLevelsCount(); level++){
+
+        ssaoDrawer.SetDepthPyramidLevel(level);
+
+        PostProcess::RenderPass pass(depthPyramidRt.GetRenderTargetView(level), NULL, GetRenderTargetViewport(depthPyramidRt, level));
         drawingContainer.Draw({&screenQuad}, &eyeCamera);
     }
+}
+
+void Application::CreateTileClassesTarget() throw (Exception)
+{
+    tileClassesRt = Texture::RenderTarget();
+
+    //one texel per tile of the normal/depth buffer SSAO pass reads
+    if(adaptiveSampling){
+        const Texture::RenderTarget &normalDepth = (ssaoResolutionScale > 1) ? ndLowRt : ndRt;
+        USHORT tilesX = (normalDepth.GetWidth() + CpuRendering::TileClassificationTileSize - 1) / CpuRendering::TileClassificationTileSize;
+        USHORT tilesY = (normalDepth.GetHeight() + CpuRendering::TileClassificationTileSize - 1) / CpuRendering::TileClassificationTileSize;
+
+        tileClassesRt.Init(DXGI_FORMAT_R8_UNORM, tilesX, tilesY);
+    }
+
+    ssaoDrawer.SetTileClassesRenderTarget(tileClassesRt);
+}
+
+void Application::ClassifyTiles()
+{
+    ssaoDrawer.SetPass(SSAODrawer::PASS_CLASSIFY_TILES);
+
+    PostProcess::RenderPass pass(tileClassesRt.GetRenderTargetView(), NULL, GetRenderTargetViewport(tileClassesRt));
+    drawingContainer.Draw({&screenQuad}, &eyeCamera);
+}
+
+void Application::RecordCameraPath()
+{
+    if(!isRecordingPath){
+        recordedPath.clear();
+        isRecordingPath = true;
+        return;
+    }
+
+    isRecordingPath = false;
+
+    try{
+        CpuRendering::SaveCameraPath("CameraPath.txt", recordedPath);
+    }catch(const Exception &ex){
+        MessageBoxA(0, ex.What().c_str(), 0, 0);
+    }
+}
+
+void Application::CreateTemporalTargets() throw (Exception)
+{
+    ndPrevRt = visibilityRt = historyRt[0] = historyRt[1] = Texture::RenderTarget();
+
+    if(temporalSsao){
+        USHORT width = (USHORT)CommonParams::GetScreenWidth(), height = (USHORT)CommonParams::GetScreenHeight();
+
+        ndPrevRt.Init(NormalDepthFormat, width, height);
+        visibilityRt.Init(VisibilityFormat, width, height);
+        historyRt[0].Init(HistoryFormat, width, height);
+        historyRt[1].Init(HistoryFormat, width, height);
+    }
+
+    temporalHistoryValid = false;
+    temporalFrame = 0;
+}
+
+void Application::UpdateTemporalVariables()
+{
+    ssaoDrawer.UpdateAOVariable("sampleOffset", (temporalSsao) ? temporalFrame % CpuRendering::TemporalSubsetsCount : 0);
+    ssaoDrawer.UpdateAOVariable("sampleStep", (temporalSsao) ? CpuRendering::TemporalSubsetsCount : 1);
+    ssaoDrawer.UpdateAOVariable<INT>("outputVisibility", temporalSsao);
+
+    if(!temporalSsao)
+        return;
+
+    Shaders::PixelShader &accumulatePs = ssaoDrawer.GetTemporalAccumulateShadersSet().ps;
+    accumulatePs.UpdateVariable("viewToPrevView", Math::Inverse(eyeCamera.GetViewMatrix()) * eyeCamera.GetPrevViewMatrix());
+    accumulatePs.UpdateVariable("subset", temporalFrame % CpuRendering::TemporalSubsetsCount);
+    accumulatePs.UpdateVariable<INT>("historyValid", temporalHistoryValid);
+    accumulatePs.ApplyVariables();
+}
+
+void Application::CalculateSSAO()
+{
+    //previous frame normals and depths are kept for the history rejection
+    if(temporalSsao){
+        std::swap(ndRt, ndPrevRt);
+        std::swap(historyRt[0], historyRt[1]);
+
+        ssaoDrawer.SetNewRenderTargets(ndRt, ssaoRt);
+        ssaoDrawer.SetTemporalRenderTargets(ndPrevRt, visibilityRt, historyRt[0], historyRt[1]);
+    }
+
+    UpdateTemporalVariables();
+
+    bool depthOnly = IsDepthOnlyPrepass();
+    ssaoDrawer.SetDepthOnlyMode(depthOnly);
+
+    bool bentNormalsOutput = IsBentNormalsOutput();
+    ssaoDrawer.SetBentNormalsMode(bentNormalsOutput);
+    pointLight.SetBentNormalsMode(bentNormalsOutput);
+
+    ssaoDrawer.SetPass(SSAODrawer::PASS_DRAW_DEPTH);
+
+    {
+        //zero texel is the background of the packed buffer and of the depth
+        FLOAT backgroundColor[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+
+        PostProcess::RenderPass pass(((depthOnly) ? depthRt : ndRt).GetRenderTargetView(), backgroundColor);
+        drawingContainer.Draw({&hallObject}, &eyeCamera);
+    }
+
+    const Texture::RenderTarget &ssaoTarget = (temporalSsao) ? visibilityRt : ssaoRt;
+
+    if(ssaoResolutionScale > 1){
+
+        //depth buffer is of the screen size, so low resolution passes go without it
+        ssaoDrawer.SetPass(SSAODrawer::PASS_DOWNSAMPLE_DEPTH);
+
+        {
+            PostProcess::RenderPass pass(ndLowRt.GetRenderTargetView(), NULL, GetRenderTargetViewport(ndLowRt));
+            drawingContainer.Draw({&screenQuad}, &eyeCamera);
+        }
+
+        if(depthPyramid)
+            BuildDepthPyramid();
+
+        if(adaptiveSampling)
+            ClassifyTiles();
+
+        DrawSSAO(ssaoLowRt);
+
+        ssaoDrawer.SetPass(SSAODrawer::PASS_UPSAMPLE_SSAO);
+
+        {
+            PostProcess::RenderPass pass(ssaoTarget.GetRenderTargetView());
+            drawingContainer.Draw({&screenQuad}, &eyeCamera);
+        }
+    }else{
+        if(depthPyramid)
+            BuildDepthPyramid();
+
+        if(adaptiveSampling)
+            ClassifyTiles();
+
+        if(IsMultiScaleSsao())
+            DrawMultiScaleSSAO(ssaoTarget);
+        else
+            DrawSSAO(ssaoTarget);
+    }
+
+    if(temporalSsao){
+        ssaoDrawer.SetPass(SSAODrawer::PASS_TEMPORAL_ACCUMULATE);
+
+        {
+            PostProcess::RenderPass pass(historyRt[0].GetRenderTargetView());
+            drawingContainer.Draw({&screenQuad}, &eyeCamera);
+        }
+
+        ssaoDrawer.SetPass(SSAODrawer::PASS_TEMPORAL_RESOLVE);
+
+        {
+            PostProcess::RenderPass pass(ssaoRt.GetRenderTargetView());
+            drawingContainer.Draw({&screenQuad}, &eyeCamera);
+        }
+
+        temporalHistoryValid = true;
+        temporalFrame++;
+    }
+
+    eyeCamera.StorePrevViewMatrix();
+
+    //the bent normals are reloaded per pixel by the point light, so they take the edge saving blur whatever the AO filter is
+    if(bentNormalsOutput){
+        bentNormalBlur.GetPixelShader().SetResource(1, ndRt.GetSahderResourceView());
+        bentNormalBlur.Draw();
+        bentNormalBlur.GetPixelShader().SetResource(1, NULL);
+    }
+
+    if(boxFiltering){
+        PostProcess::BoxFilter &filter = (depthOnly) ? depthOnlyBoxFilter : boxFilter;
+
+        filter.SetNormalDepth(((depthOnly) ? depthRt : ndRt).GetSahderResourceView());
+        filter.Draw();
+
+        return;
+    }
+
+    PostProcess::Blur &edgeSavingBlur = (depthOnly) ? depthOnlyBlur : blur;
+
+    edgeSavingBlur.GetPixelShader().SetResource(1, ((depthOnly) ? depthRt : ndRt).GetSahderResourceView());
+    edgeSavingBlur.Draw();
+    edgeSavingBlur.GetPixelShader().SetResource(1, NULL);
+}
+
+std::vector<Application::AOPass> Application::GetAOPasses() const throw (Exception)
+{
+    if(temporalSsao || ssaoResolutionScale > 1 || depthPyramid || adaptiveSampling || ssaoDrawer.IsDeinterleaved() ||
+       IsMultiScaleSsao() || boxFiltering)
+        throw Exception("AO passes are listed for the default AO chain only");
+
+    std::vector<AOPass> passes;
+
+    AOPass prepass = {"depth prepass", (UINT)meshes.GetMesh(hallMeshId)->GetSubsetCount()};
+    passes.push_back(prepass);
+
+    AOPass ssao = {"SSAO", 1};
+    passes.push_back(ssao);
+
+    //vertical and horizontal pass of every iteration
+    const PostProcess::Blur &edgeSavingBlur = (IsDepthOnlyPrepass()) ? depthOnlyBlur : blur;
+    std::vector<const PostProcess::Blur*> blurs = {&edgeSavingBlur};
+
+    if(IsBentNormalsOutput())
+        blurs.insert(blurs.begin(), &bentNormalBlur);
+
+    for(const PostProcess::Blur *b : blurs){
+        size_t iterations = (b->IsIterationsFused()) ? 1 : b->GetIterationsCount();
+
+        for(size_t i = 0; i < iterations; i++){
+            AOPass vertical = {"vertical blur", 1}, horizontal = {"horizontal blur", 1};
+            passes.push_back(vertical);
+            passes.push_back(horizontal);
+        }
+    }
+
+    return passes;
+}
+
+bool Application::AOCacheKey::operator==(const AOCacheKey &Key) const
+{
+    return view == Key.view && proj == Key.proj && occlusionRadius == Key.occlusionRadius &&
+           harshness == Key.harshness && sceneVersion == Key.sceneVersion;
+}
+
+Application::AOCacheKey Application::GetAOCacheKey() const
+{
+    AOCacheKey key;
+    key.view = eyeCamera.GetViewMatrix();
+    key.proj = eyeCamera.GetProjMatrix();
+    key.occlusionRadius = optionsMenu->GetOcclusionRadius();
+    key.harshness = optionsMenu->GetHarshness();
+    key.sceneVersion = drawingContainer.GetSceneVersion();
+
+    return key;
+}
+
+bool Application::NeedAOCalculation()
+{
+    AOCacheKey key = GetAOCacheKey();
+
+    if(!(key == aoCacheKey)){
+        aoCacheKey = key;
+        aoCacheFrames = 0;
+    }
+
+    INT convergenceFrames = (temporalSsao) ? CpuRendering::TemporalSubsetsCount : 1;
 
-    blur.GetPixelShader().SetResource(1, ndRt.GetSahderResourceView());
-    blur.Draw();
-    blur.GetPixelShader().SetResource(1, NULL);
+    return aoCacheFrames < convergenceFrames;
 }
 
 void Application::DrawObjects()
@@ -440,11 +1127,15 @@ void Application::Draw()
     color[2] = 0.9;//Blue
     color[3] = 0;//Alpha
 
-    DeviceKeeper::GetDeviceContext()->ClearRenderTargetView(DeviceKeeper::GetRenderTargetView(), color);
-    DeviceKeeper::GetDeviceContext()->ClearDepthStencilView(DeviceKeeper::GetDepthStencilView(), D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.0f, 0);
+    DeviceKeeper::GetRenderContext()->ClearRenderTargetView(DeviceKeeper::GetRenderTargetView(), color);
+    DeviceKeeper::GetRenderContext()->ClearDepthStencilView(DeviceKeeper::GetDepthStencilView(), D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.0f, 0);
 
-    if(optionsMenu->GetSsaoMode())
+    if(optionsMenu->GetSsaoMode() && NeedAOCalculation()){
+        DeviceKeeper::GetRenderContext()->BeginEvent(AOEventName);
         CalculateSSAO();
+        DeviceKeeper::GetRenderContext()->EndEvent();
+        aoCacheFrames++;
+    }
 
     if(optionsMenu->GetState() != Dialogs::MENU_STATE_CLOSED){
 
@@ -456,7 +1147,7 @@ void Application::Draw()
     }else
         DrawObjects();
 
-    HR(DeviceKeeper::GetSwapChain()->Present(0, 0));
+    HR(DeviceKeeper::GetRenderContext()->Present(0, 0));
 }
 
 void Application::Run()
@@ -518,18 +1209,109 @@ void Application::SetSsaoMode(bool Mode)
 {
     pointLight.GetShaders().ps.UpdateVariable("useSsao", static_cast<INT>(Mode));
     pointLight.GetShaders().ps.ApplyVariables();
+
+    InvalidateAOCache();
 }
 
 void Application::ChangeOcclusionRadius(FLOAT NewRadius)
 {
-    ssaoDrawer.GetSSAOSHadersSet().ps.UpdateVariable("occlusionRadius", NewRadius);
-    ssaoDrawer.GetSSAOSHadersSet().ps.ApplyVariables();
+    occlusionRadius = NewRadius;
+
+    ssaoDrawer.UpdateAOVariable("occlusionRadius", NewRadius);
+
+    ssaoDrawer.GetClassifyTilesShadersSet().ps.UpdateVariable("occlusionRadius", NewRadius);
+    ssaoDrawer.GetClassifyTilesShadersSet().ps.ApplyVariables();
 }
 
 void Application::ChangeHarshness(FLOAT NewHarshness)
 {
-    ssaoDrawer.GetSSAOSHadersSet().ps.UpdateVariable("harshness", NewHarshness);
-    ssaoDrawer.GetSSAOSHadersSet().ps.ApplyVariables();
+    ssaoDrawer.UpdateAOVariable("harshness", NewHarshness);
+}
+
+void Application::ChangeSsaoResolutionScale(INT NewScale)
+{
+    ssaoResolutionScale = NewScale;
+
+    CreateLowResolutionTargets();
+
+    InvalidateAOCache();
+}
+
+void Application::SetTemporalSsaoMode(bool Mode)
+{
+    temporalSsao = Mode;
+
+    CreateTemporalTargets();
+
+    InvalidateAOCache();
+}
+
+void Application::ChangeAOTechnique(INT NewTechnique)
+{
+    ssaoDrawer.SetTechnique((SSAODrawer::Technique)NewTechnique);
+
+    InvalidateAOCache();
+}
+
+void Application::SetDepthPyramidMode(bool Mode)
+{
+    depthPyramid = Mode;
+
+    CreateDepthPyramidTarget();
+
+    InvalidateAOCache();
+}
+
+void Application::SetDeinterleavedSsaoMode(bool Mode)
+{
+    deinterleavedSsao = Mode;
+
+    CreateDeinterleavedTargets();
+
+    InvalidateAOCache();
+}
+
+void Application::SetDepthOnlyPrepassMode(bool Mode)
+{
+    depthOnlyPrepass = Mode;
+
+    CreateDepthOnlyTarget();
+
+    InvalidateAOCache();
+}
+
+void Application::SetAdaptiveSamplingMode(bool Mode)
+{
+    adaptiveSampling = Mode;
+
+    CreateTileClassesTarget();
+
+    InvalidateAOCache();
+}
+
+void Application::SetMultiScaleSsaoMode(bool Mode)
+{
+    multiScaleSsao = Mode;
+
+    CreateMultiScaleTargets();
+
+    InvalidateAOCache();
+}
+
+void Application::SetBentNormalsMode(bool Mode)
+{
+    bentNormals = Mode;
+
+    CreateBentNormalTarget();
+
+    InvalidateAOCache();
+}
+
+void Application::SetBoxFilterMode(bool Mode)
+{
+    boxFiltering = Mode;
+
+    InvalidateAOCache();
 }
 
 void Application::SetPointLightMode(bool Mode)
@@ -13,6 +13,8 @@
 #include <Camera.h>
 #include <SceneManagement.h>
 #include <PostProcess.h>
+#include <CpuRendering/CameraPath.h>
+#include <CpuRendering/MultiScaleSSAO.h>
 #include "OptionsMenu.h"
 #include "SSAODrawer.h"
 #include "PointLight.h"
@@ -29,8 +31,54 @@ private:
     Meshes::MeshesContainer meshes;
     Scene::Object hallObject;
     Texture::RenderTarget ndRt, ssaoRt;
+    Texture::RenderTarget ndLowRt, ssaoLowRt;
+    INT ssaoResolutionScale = 1;
+    Texture::RenderTarget ndPrevRt, visibilityRt, historyRt[2];
+    bool temporalSsao = false;
+    bool temporalHistoryValid = false;
+    INT temporalFrame = 0;
+    Texture::RenderTargetMips depthPyramidRt;
+    //off by default: at the default radius 0.8 the taps stay near the pixel, the build and the per tap level
+    //selection cost more than the cache misses saved (0.9x of the flat lookup on the CPU path), it pays from radius 2 up
+    bool depthPyramid = false;
+    Texture::RenderTarget depthAtlasRt, ssaoAtlasRt;
+    bool deinterleavedSsao = false;
+    Texture::RenderTarget depthRt;
+    bool depthOnlyPrepass = false;
+    Texture::RenderTarget tileClassesRt;
+    bool adaptiveSampling = false;
+    //layer 0 reads ndRt, combined targets of the layers between the first and the last one hold the coarser layers
+    Texture::RenderTarget multiScaleNdRt[CpuRendering::MultiScaleLayersCount];
+    Texture::RenderTarget multiScaleAoRt[CpuRendering::MultiScaleLayersCount];
+    Texture::RenderTarget multiScaleCombinedRt[CpuRendering::MultiScaleLayersCount];
+    CpuRendering::MultiScaleParams multiScaleParams;
+    bool multiScaleSsao = false;
+    //base radius of the multi-scale layers
+    FLOAT occlusionRadius = 0.8f;
+    Texture::RenderTarget bentNormalRt;
+    bool bentNormals = false;
+    //Key of the AO result kept in ssaoRt. The kernel is generated once in LoadResources,
+    //the options recreating the AO targets or switching the passes drop the cache
+    struct AOCacheKey
+    {
+        D3DXMATRIX view, proj;
+        FLOAT occlusionRadius = 0.0f, harshness = 0.0f;
+        UINT sceneVersion = 0;
+        bool operator==(const AOCacheKey &Key) const;
+    };
+    AOCacheKey aoCacheKey;
+    //frames calculated with aoCacheKey, temporal SSAO needs one per kernel subset to converge
+    INT aoCacheFrames = 0;
+    CpuRendering::CameraPath recordedPath;
+    bool isRecordingPath = false;
     PostProcess::DefaultScreenQuad screenQuad; 
     PostProcess::Blur blur;
+    PostProcess::Blur depthOnlyBlur;
+    PostProcess::Blur bentNormalBlur;
+    //summed area table filter replacing the edge saving blur, same cost for every box size
+    PostProcess::BoxFilter boxFilter;
+    PostProcess::BoxFilter depthOnlyBoxFilter;
+    bool boxFiltering = false;
     GUI::Label *fpsLabel = NULL, *helpLabel = NULL;
     ID3D11ShaderResourceView *kernelOffsetsSRV;
     Time::Timer timer;
@@ -40,6 +88,8 @@ private:
     BOOL newFullscreenState = false;
     BOOL newResolution = false;
     SizeUS KernelOffsetsTexSize = {4, 4};
+    //4, 8, 16, 32 or 64, selects the SSAOv3.ps permutation and the kernel generated for it
+    static const INT SSAOSamplesCount = 16;
     static Application *instance;
     Application(){}
     ~Application(){Stop();}
@@ -49,10 +99,35 @@ private:
     void LoadResources() throw (Exception);
     void ReleaseGUI();
     void Invalidate(FLOAT Tf);
-    void Draw();
     void CalculateSSAO();
+    AOCacheKey GetAOCacheKey() const;
+    //false while the camera, the AO parameters and the scene stay the same and ssaoRt holds the converged result
+    bool NeedAOCalculation();
+    void InvalidateAOCache() {aoCacheFrames = 0;}
     void DrawObjects();
     void OnChangeResolution();
+    void CreateLowResolutionTargets() throw (Exception);
+    void CreateTemporalTargets() throw (Exception);
+    void UpdateTemporalVariables();
+    void CreateDepthPyramidTarget() throw (Exception);
+    void BuildDepthPyramid();
+    void CreateTileClassesTarget() throw (Exception);
+    void ClassifyTiles();
+    void CreateDeinterleavedTargets() throw (Exception);
+    //deinterleaved mode splits the depth to the atlas before PASS_DRAW_SSAO and merges the result to SsaoTarget after it
+    void DrawSSAO(const Texture::RenderTarget &SsaoTarget);
+    void CreateDepthOnlyTarget() throw (Exception);
+    //depth only prepass is used when none of the enabled passes needs the normals of ndRt
+    bool IsDepthOnlyPrepass() const;
+    void CreateMultiScaleTargets() throw (Exception);
+    //multi-scale mode replaces the single SSAO pass of the full resolution interleaved SSAO technique
+    bool IsMultiScaleSsao() const;
+    void DrawMultiScaleSSAO(const Texture::RenderTarget &SsaoTarget);
+    void SetRndTexFactor(const Texture::RenderTarget &SsaoTarget);
+    void CreateBentNormalTarget() throw (Exception);
+    //bent normals are written by the full resolution interleaved SSAO pass alone, the point light falls back to the normals otherwise
+    bool IsBentNormalsOutput() const;
+    void RecordCameraPath();
 public:
     static Application *GetInstance()
     {
@@ -70,12 +145,33 @@ public:
     void Load() throw (Exception);
     void Run();
     void Stop();
+    //one frame ended by Present, the submission benchmark runs it alone
+    void Draw();
+    //render context event around the AO chain of the frames calculating the AO
+    static const WCHAR *const AOEventName;
+    struct AOPass
+    {
+        std::string name;
+        UINT drawCalls;
+    };
+    //render passes of the AO chain in their order. Listed for the chain of the default options, the other modes throw
+    std::vector<AOPass> GetAOPasses() const throw (Exception);
     bool ProcessMessage(HWND Hwnd, UINT Msg, WPARAM WParam, LPARAM LParam);
     void ChangeResolution();
     void ChangeFullscreenMode();
     void SetCursorVisibleState(BOOL IsVisible);
     void ChangeOcclusionRadius(FLOAT NewRadius);
     void ChangeHarshness(FLOAT NewHarshness);
+    void ChangeSsaoResolutionScale(INT NewScale);
+    void SetTemporalSsaoMode(bool Mode);
+    void SetDepthPyramidMode(bool Mode);
+    void ChangeAOTechnique(INT NewTechnique);
+    void SetDeinterleavedSsaoMode(bool Mode);
+    void SetDepthOnlyPrepassMode(bool Mode);
+    void SetAdaptiveSamplingMode(bool Mode);
+    void SetMultiScaleSsaoMode(bool Mode);
+    void SetBentNormalsMode(bool Mode);
+    void SetBoxFilterMode(bool Mode);
     void SetSsaoMode(bool Mode);
     void SetPointLightMode(bool Mode);
 };
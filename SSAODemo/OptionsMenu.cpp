@@ -35,6 +35,29 @@ static std::wstring GetResolutionString(const SizeUS &Resolution)
     return widthStr + L" x " + heightStr;
 }
 
+struct SsaoResolutionScale
+{
+    const wchar_t *caption;
+    INT scale;
+};
+
+static const SsaoResolutionScale SsaoResolutionScales[] = {
+    {L"Full", 1},
+    {L"Half", 2},
+    {L"Quarter", 4}
+};
+
+struct AOTechnique
+{
+    const wchar_t *caption;
+    INT technique;
+};
+
+static const AOTechnique AOTechniques[] = {
+    {L"SSAO", SSAODrawer::TECHNIQUE_SSAO},
+    {L"HBAO", SSAODrawer::TECHNIQUE_HBAO}
+};
+
 static GUI::FixedPanel *CreateParamTweaking(FLOAT MinVal,
                                             FLOAT MaxVal,
                                             FLOAT Val,
@@ -146,6 +169,86 @@ void OptionsMenu::Init() throw (Exception)
         Application::GetInstance()->SetSsaoMode(State == true);
     });
 
+    temporalSsaoChkB.Init();
+
+    onTemporalSsaoChngEventId = temporalSsaoChkB.AddEvent([&, this](const GUI::CheckBox *Owner, INT State)
+    {
+        Application::GetInstance()->SetTemporalSsaoMode(State == true);
+    });
+
+    depthPyramidChkB.Init();
+
+    onDepthPyramidChngEventId = depthPyramidChkB.AddEvent([&, this](const GUI::CheckBox *Owner, INT State)
+    {
+        Application::GetInstance()->SetDepthPyramidMode(State == true);
+    });
+
+    deinterleavedSsaoChkB.Init();
+
+    onDeinterleavedSsaoChngEventId = deinterleavedSsaoChkB.AddEvent([&, this](const GUI::CheckBox *Owner, INT State)
+    {
+        Application::GetInstance()->SetDeinterleavedSsaoMode(State == true);
+    });
+
+    depthOnlyPrepassChkB.Init();
+
+    onDepthOnlyPrepassChngEventId = depthOnlyPrepassChkB.AddEvent([&, this](const GUI::CheckBox *Owner, INT State)
+    {
+        Application::GetInstance()->SetDepthOnlyPrepassMode(State == true);
+    });
+
+    adaptiveSamplingChkB.Init();
+
+    onAdaptiveSamplingChngEventId = adaptiveSamplingChkB.AddEvent([&, this](const GUI::CheckBox *Owner, INT State)
+    {
+        Application::GetInstance()->SetAdaptiveSamplingMode(State == true);
+    });
+
+    multiScaleSsaoChkB.Init();
+
+    onMultiScaleSsaoChngEventId = multiScaleSsaoChkB.AddEvent([&, this](const GUI::CheckBox *Owner, INT State)
+    {
+        Application::GetInstance()->SetMultiScaleSsaoMode(State == true);
+    });
+
+    bentNormalsChkB.Init();
+
+    onBentNormalsChngEventId = bentNormalsChkB.AddEvent([&, this](const GUI::CheckBox *Owner, INT State)
+    {
+        Application::GetInstance()->SetBentNormalsMode(State == true);
+    });
+
+    boxFilterChkB.Init();
+
+    onBoxFilterChngEventId = boxFilterChkB.AddEvent([&, this](const GUI::CheckBox *Owner, INT State)
+    {
+        Application::GetInstance()->SetBoxFilterMode(State == true);
+    });
+
+    ssaoResolutionCb.Init();
+
+    for(const SsaoResolutionScale &scale : SsaoResolutionScales)
+        ssaoResolutionCb.AddItem(scale.caption);
+
+    ssaoResolutionCb.SetSelectedItem(SsaoResolutionScales[0].caption);
+
+    onSsaoResChngEventId = ssaoResolutionCb.AddEvent([this](const GUI::ComboBox *Owner, INT Index)
+    {
+        Application::GetInstance()->ChangeSsaoResolutionScale(GetSsaoResolutionScale());
+    });
+
+    aoTechniqueCb.Init();
+
+    for(const AOTechnique &technique : AOTechniques)
+        aoTechniqueCb.AddItem(technique.caption);
+
+    aoTechniqueCb.SetSelectedItem(AOTechniques[0].caption);
+
+    onAOTechniqueChngEventId = aoTechniqueCb.AddEvent([this](const GUI::ComboBox *Owner, INT Index)
+    {
+        Application::GetInstance()->ChangeAOTechnique(GetAOTechnique());
+    });
+
     auto occlRadEvent = [&,this](const GUI::ScrollBar *Sb, FLOAT NewFactor)
     {
         float value = Sb->GetMinVal() + (Sb->GetMaxVal() - Sb->GetMinVal()) * NewFactor;
@@ -180,6 +283,26 @@ void OptionsMenu::Init() throw (Exception)
     ssaoOptionsPanel.SetControl(&ssaoChkB, 1, 2);
     ssaoOptionsPanel.SetControl(NewLabel(L"Point light"), 0, 3, true);
     ssaoOptionsPanel.SetControl(&pointLightChkB, 1, 3);
+    ssaoOptionsPanel.SetControl(NewLabel(L"SSAO resolution"), 0, 4, true);
+    ssaoOptionsPanel.SetControl(&ssaoResolutionCb, 1, 4);
+    ssaoOptionsPanel.SetControl(NewLabel(L"Temporal SSAO"), 0, 5, true);
+    ssaoOptionsPanel.SetControl(&temporalSsaoChkB, 1, 5);
+    ssaoOptionsPanel.SetControl(NewLabel(L"Depth pyramid"), 0, 6, true);
+    ssaoOptionsPanel.SetControl(&depthPyramidChkB, 1, 6);
+    ssaoOptionsPanel.SetControl(NewLabel(L"AO technique"), 0, 7, true);
+    ssaoOptionsPanel.SetControl(&aoTechniqueCb, 1, 7);
+    ssaoOptionsPanel.SetControl(NewLabel(L"Deinterleaved SSAO"), 0, 8, true);
+    ssaoOptionsPanel.SetControl(&deinterleavedSsaoChkB, 1, 8);
+    ssaoOptionsPanel.SetControl(NewLabel(L"Depth only prepass"), 0, 9, true);
+    ssaoOptionsPanel.SetControl(&depthOnlyPrepassChkB, 1, 9);
+    ssaoOptionsPanel.SetControl(NewLabel(L"Adaptive sampling"), 0, 10, true);
+    ssaoOptionsPanel.SetControl(&adaptiveSamplingChkB, 1, 10);
+    ssaoOptionsPanel.SetControl(NewLabel(L"Multi-scale SSAO"), 0, 11, true);
+    ssaoOptionsPanel.SetControl(&multiScaleSsaoChkB, 1, 11);
+    ssaoOptionsPanel.SetControl(NewLabel(L"Bent normals"), 0, 12, true);
+    ssaoOptionsPanel.SetControl(&bentNormalsChkB, 1, 12);
+    ssaoOptionsPanel.SetControl(NewLabel(L"Box filter"), 0, 13, true);
+    ssaoOptionsPanel.SetControl(&boxFilterChkB, 1, 13);
 
     adapterInfoPanel.SetColSpacing(0.01f);
     adapterInfoPanel.SetRowSpacing(0.01f);
@@ -246,6 +369,156 @@ void OptionsMenu::SetSsaoMode(BOOL Enable)
     });
 }
 
+void OptionsMenu::SetSsaoResolutionScale(INT Scale) throw (Exception)
+{
+    ssaoResolutionCb.RemoveEvent(onSsaoResChngEventId);
+
+    for(const SsaoResolutionScale &scale : SsaoResolutionScales)
+        if(scale.scale == Scale)
+            ssaoResolutionCb.SetSelectedItem(scale.caption);
+
+    onSsaoResChngEventId = ssaoResolutionCb.AddEvent([this](const GUI::ComboBox *Owner, INT Index)
+    {
+        Application::GetInstance()->ChangeSsaoResolutionScale(GetSsaoResolutionScale());
+    });
+}
+
+void OptionsMenu::SetTemporalSsaoMode(BOOL Enable)
+{
+    temporalSsaoChkB.RemoveEvent(onTemporalSsaoChngEventId);
+
+    temporalSsaoChkB.SetChecked(Enable);
+
+    onTemporalSsaoChngEventId = temporalSsaoChkB.AddEvent([&, this](const GUI::CheckBox *Owner, INT State)
+    {
+        Application::GetInstance()->SetTemporalSsaoMode(State == true);
+    });
+}
+
+void OptionsMenu::SetDepthPyramidMode(BOOL Enable)
+{
+    depthPyramidChkB.RemoveEvent(onDepthPyramidChngEventId);
+
+    depthPyramidChkB.SetChecked(Enable);
+
+    onDepthPyramidChngEventId = depthPyramidChkB.AddEvent([&, this](const GUI::CheckBox *Owner, INT State)
+    {
+        Application::GetInstance()->SetDepthPyramidMode(State == true);
+    });
+}
+
+void OptionsMenu::SetDeinterleavedSsaoMode(BOOL Enable)
+{
+    deinterleavedSsaoChkB.RemoveEvent(onDeinterleavedSsaoChngEventId);
+
+    deinterleavedSsaoChkB.SetChecked(Enable);
+
+    onDeinterleavedSsaoChngEventId = deinterleavedSsaoChkB.AddEvent([&, this](const GUI::CheckBox *Owner, INT State)
+    {
+        Application::GetInstance()->SetDeinterleavedSsaoMode(State == true);
+    });
+}
+
+void OptionsMenu::SetDepthOnlyPrepassMode(BOOL Enable)
+{
+    depthOnlyPrepassChkB.RemoveEvent(onDepthOnlyPrepassChngEventId);
+
+    depthOnlyPrepassChkB.SetChecked(Enable);
+
+    onDepthOnlyPrepassChngEventId = depthOnlyPrepassChkB.AddEvent([&, this](const GUI::CheckBox *Owner, INT State)
+    {
+        Application::GetInstance()->SetDepthOnlyPrepassMode(State == true);
+    });
+}
+
+void OptionsMenu::SetAdaptiveSamplingMode(BOOL Enable)
+{
+    adaptiveSamplingChkB.RemoveEvent(onAdaptiveSamplingChngEventId);
+
+    adaptiveSamplingChkB.SetChecked(Enable);
+
+    onAdaptiveSamplingChngEventId = adaptiveSamplingChkB.AddEvent([&, this](const GUI::CheckBox *Owner, INT State)
+    {
+        Application::GetInstance()->SetAdaptiveSamplingMode(State == true);
+    });
+}
+
+void OptionsMenu::SetMultiScaleSsaoMode(BOOL Enable)
+{
+    multiScaleSsaoChkB.RemoveEvent(onMultiScaleSsaoChngEventId);
+
+    multiScaleSsaoChkB.SetChecked(Enable);
+
+    onMultiScaleSsaoChngEventId = multiScaleSsaoChkB.AddEvent([&, this](const GUI::CheckBox *Owner, INT State)
+    {
+        Application::GetInstance()->SetMultiScaleSsaoMode(State == true);
+    });
+}
+
+void OptionsMenu::SetBentNormalsMode(BOOL Enable)
+{
+    bentNormalsChkB.RemoveEvent(onBentNormalsChngEventId);
+
+    bentNormalsChkB.SetChecked(Enable);
+
+    onBentNormalsChngEventId = bentNormalsChkB.AddEvent([&, this](const GUI::CheckBox *Owner, INT State)
+    {
+        Application::GetInstance()->SetBentNormalsMode(State == true);
+    });
+}
+
+void OptionsMenu::SetBoxFilterMode(BOOL Enable)
+{
+    boxFilterChkB.RemoveEvent(onBoxFilterChngEventId);
+
+    boxFilterChkB.SetChecked(Enable);
+
+    onBoxFilterChngEventId = boxFilterChkB.AddEvent([&, this](const GUI::CheckBox *Owner, INT State)
+    {
+        Application::GetInstance()->SetBoxFilterMode(State == true);
+    });
+}
+
+void OptionsMenu::SetAOTechnique(INT Technique) throw (Exception)
+{
+    aoTechniqueCb.RemoveEvent(onAOTechniqueChngEventId);
+
+    for(const AOTechnique &technique : AOTechniques)
+        if(technique.technique == Technique)
+            aoTechniqueCb.SetSelectedItem(technique.caption);
+
+    onAOTechniqueChngEventId = aoTechniqueCb.AddEvent([this](const GUI::ComboBox *Owner, INT Index)
+    {
+        Application::GetInstance()->ChangeAOTechnique(GetAOTechnique());
+    });
+}
+
+INT OptionsMenu::GetAOTechnique() const
+{
+    std::wstring selItm;
+    if(!aoTechniqueCb.GetSelectedItem(selItm))
+        return SSAODrawer::TECHNIQUE_SSAO;
+
+    for(const AOTechnique &technique : AOTechniques)
+        if(selItm == technique.caption)
+            return technique.technique;
+
+    return SSAODrawer::TECHNIQUE_SSAO;
+}
+
+INT OptionsMenu::GetSsaoResolutionScale() const
+{
+    std::wstring selItm;
+    if(!ssaoResolutionCb.GetSelectedItem(selItm))
+        return 1;
+
+    for(const SsaoResolutionScale &scale : SsaoResolutionScales)
+        if(selItm == scale.caption)
+            return scale.scale;
+
+    return 1;
+}
+
 void OptionsMenu::SetOcclusionRadius(FLOAT NewRadius)
 {
     occlusionRadiusSb.RemoveEvent(onOcclRdChngEventId);
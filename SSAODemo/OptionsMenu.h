@@ -17,9 +17,19 @@ class OptionsMenu : public Dialogs::BlurredMenu
 {
 private:
     GUI::ComboBox resolutionCb;
+    GUI::ComboBox ssaoResolutionCb;
+    GUI::ComboBox aoTechniqueCb;
     GUI::CheckBox screenModeChkB;
     GUI::CheckBox pointLightChkB;
     GUI::CheckBox ssaoChkB;
+    GUI::CheckBox temporalSsaoChkB;
+    GUI::CheckBox depthPyramidChkB;
+    GUI::CheckBox deinterleavedSsaoChkB;
+    GUI::CheckBox depthOnlyPrepassChkB;
+    GUI::CheckBox adaptiveSamplingChkB;
+    GUI::CheckBox multiScaleSsaoChkB;
+    GUI::CheckBox bentNormalsChkB;
+    GUI::CheckBox boxFilterChkB;
     GUI::ScrollBar occlusionRadiusSb;
     GUI::Label occlusionRadiusLbl;
     GUI::ScrollBar harshnessSb;
@@ -40,6 +50,16 @@ protected:
     Utils::EventId onHarshnessChngEventId = 0;
     Utils::EventId onPtLightModeChngEventId = 0;
     Utils::EventId onSsaoModeChngEventId = 0;
+    Utils::EventId onSsaoResChngEventId = 0;
+    Utils::EventId onTemporalSsaoChngEventId = 0;
+    Utils::EventId onDepthPyramidChngEventId = 0;
+    Utils::EventId onAOTechniqueChngEventId = 0;
+    Utils::EventId onDeinterleavedSsaoChngEventId = 0;
+    Utils::EventId onDepthOnlyPrepassChngEventId = 0;
+    Utils::EventId onAdaptiveSamplingChngEventId = 0;
+    Utils::EventId onMultiScaleSsaoChngEventId = 0;
+    Utils::EventId onBentNormalsChngEventId = 0;
+    Utils::EventId onBoxFilterChngEventId = 0;
 public:
     virtual ~OptionsMenu();
     virtual void Init() throw (Exception);
@@ -55,6 +75,26 @@ public:
     BOOL GetPointLightMode() const {return pointLightChkB.IsChecked();}
     void SetSsaoMode(BOOL Enable);
     BOOL GetSsaoMode() const {return ssaoChkB.IsChecked();}
+    void SetSsaoResolutionScale(INT Scale) throw (Exception);
+    INT GetSsaoResolutionScale() const;
+    void SetTemporalSsaoMode(BOOL Enable);
+    BOOL GetTemporalSsaoMode() const {return temporalSsaoChkB.IsChecked();}
+    void SetDepthPyramidMode(BOOL Enable);
+    BOOL GetDepthPyramidMode() const {return depthPyramidChkB.IsChecked();}
+    void SetAOTechnique(INT Technique) throw (Exception);
+    INT GetAOTechnique() const;
+    void SetDeinterleavedSsaoMode(BOOL Enable);
+    BOOL GetDeinterleavedSsaoMode() const {return deinterleavedSsaoChkB.IsChecked();}
+    void SetDepthOnlyPrepassMode(BOOL Enable);
+    BOOL GetDepthOnlyPrepassMode() const {return depthOnlyPrepassChkB.IsChecked();}
+    void SetAdaptiveSamplingMode(BOOL Enable);
+    BOOL GetAdaptiveSamplingMode() const {return adaptiveSamplingChkB.IsChecked();}
+    void SetMultiScaleSsaoMode(BOOL Enable);
+    BOOL GetMultiScaleSsaoMode() const {return multiScaleSsaoChkB.IsChecked();}
+    void SetBentNormalsMode(BOOL Enable);
+    BOOL GetBentNormalsMode() const {return bentNormalsChkB.IsChecked();}
+    void SetBoxFilterMode(BOOL Enable);
+    BOOL GetBoxFilterMode() const {return boxFilterChkB.IsChecked();}
 };
 
 }
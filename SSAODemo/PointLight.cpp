@@ -27,13 +27,31 @@ void PointLight::SetMaterial(const Material &NewMaterial)
     shaders.ps.ApplyVariables();
 }
 
+void PointLight::SetBentNormalsMode(bool Mode)
+{
+    if(useBentNormals == Mode)
+        return;
+
+    useBentNormals = Mode;
+
+    shaders.ps.UpdateVariable<INT>("useBentNormals", Mode);
+    shaders.ps.ApplyVariables();
+}
+
 void PointLight::PrepareForDrawing(const Camera::ICamera * Camera)
 {
     shaders.ps.UpdateVariable("eyeW", Camera->GetPos());
     shaders.ps.UpdateVariable("pointLightPosW", pos);
+
+    if(useBentNormals)
+        shaders.ps.UpdateVariable("invView", Math::Inverse(Camera->GetViewMatrix()));
+
     shaders.ps.ApplyVariables();
 
     shaders.ps.SetResource(1, ssaoRt.GetSahderResourceView());
+
+    if(useBentNormals)
+        shaders.ps.SetResource(2, bentNormalRt.GetSahderResourceView());
 }
 
 void PointLight::BeginDraw(const Scene::IObject *Object, const Meshes::IMesh *Mesh, const Camera::ICamera * Camera)
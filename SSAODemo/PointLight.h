@@ -30,6 +30,8 @@ private:
     D3DXVECTOR3 pos;
     Shaders::ShadersSet shaders;
     Texture::RenderTarget ssaoRt;
+    Texture::RenderTarget bentNormalRt;
+    bool useBentNormals = false;
 public:
     void Init(const Shaders::ShadersSet &Shaders, const Texture::RenderTarget &SsaoRt);
     void SetPos(const D3DXVECTOR3 &NewPos){pos = NewPos;}
@@ -42,6 +44,9 @@ public:
     virtual void ProcessMaterial(const Scene::IObject *Object, const Meshes::MaterialData &Material);
     virtual void StopDrawing();
     void SetNewSSAORenderTarget(const Texture::RenderTarget &NewSsoaRt){ssaoRt = NewSsoaRt;}
+    //view space bent normals of the SSAO pass replace the normals of the diffuse term while the mode is on
+    void SetNewBentNormalRenderTarget(const Texture::RenderTarget &NewBentNormalRt){bentNormalRt = NewBentNormalRt;}
+    void SetBentNormalsMode(bool Mode);
 };
 
 }
\ No newline at end of file
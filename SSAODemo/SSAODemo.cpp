@@ -9,6 +9,7 @@
 #include "LoadingScreen.h"
 #include "OptionsMenu.h"
 #include "Application.h"
+#include "SubmissionBenchmark.h"
 #include <DeviceKeeper.h>
 #include <Meshes.h>
 #include <Timer.h>
@@ -18,9 +19,14 @@
 #include <RenderStatesManager.h>
 #include <AdapterManager.h>
 #include <GUI.h>
+#include <RecordingBackend.h>
+#include <memory>
+#include <stdio.h>
 
 ID3D11Device *DeviceKeeper::device = NULL;
 ID3D11DeviceContext *DeviceKeeper::context = NULL;
+RenderBackend::IRenderDevice *DeviceKeeper::renderDevice = NULL;
+RenderBackend::IRenderContext *DeviceKeeper::renderContext = NULL;
 ID3D11RenderTargetView* DeviceKeeper::renderTargetView = NULL;
 ID3D11DepthStencilView* DeviceKeeper::depthStencilView = NULL;
 IDXGISwapChain* DeviceKeeper::swapChain = NULL;
@@ -47,6 +53,27 @@ static LRESULT CALLBACK MsgProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lPara
     return DefWindowProc(hwnd, msg, wParam, lParam);
 }
 
+//appended, the report of a failed check is already written by then
+static void ReportBenchmarkFailure(const char *ReportFileName, const std::string &Message)
+{
+    FILE *report = fopen(ReportFileName, "a");
+    if(report){
+        fprintf(report, "ERROR: %s\n", Message.c_str());
+        fclose(report);
+    }
+
+    //console of the script starting the run, if there is one
+    if(AttachConsole(ATTACH_PARENT_PROCESS)){
+        FILE *console = fopen("CONOUT$", "w");
+        if(console){
+            fprintf(console, "Submission benchmark: %s\n", Message.c_str());
+            fclose(console);
+        }
+    }
+
+    OutputDebugStringA(Message.c_str());
+}
+
 int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE prevInstance,
 	PSTR cmdLine, int showCmd)
 {
@@ -55,6 +82,15 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE prevInstance,
 	const LONG width = 800;
 	const LONG height = 600;
 
+    //-submission-benchmark FRAMES [REPORT] draws the frames on the null driver and exits
+    INT benchmarkFrames = 0;
+    char reportFileName[MAX_PATH] = "SubmissionBenchmark.txt";
+    sscanf(cmdLine, "-submission-benchmark %d %259s", &benchmarkFrames, reportFileName);
+
+    RenderBackend::CommandLog commandLog;
+    std::unique_ptr<RenderBackend::IRenderDevice> d3dRenderDevice, renderDevice;
+    std::unique_ptr<RenderBackend::IRenderContext> renderContext;
+
 	try{
 		HWND hWindow = InitWindow(hInstance, width, height, L"SSAO Demo", MsgProc);
 		
@@ -65,10 +101,27 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE prevInstance,
 		params.window = hWindow;
 
         D3DData d3d;
-		d3d = InitD3D(params);
+
+        if(benchmarkFrames > 0){
+            d3d = InitNullD3D(width, height);
+
+            d3dRenderDevice.reset(new RenderBackend::D3DRenderDevice(d3d.device));
+            renderDevice.reset(new RenderBackend::RecordingRenderDevice(d3dRenderDevice.get(), &commandLog));
+            //context calls are not passed to the null driver, the frame time is the one of the engine
+            renderContext.reset(new RenderBackend::RecordingRenderContext(NULL, &commandLog));
+            //viewports are kept by the recording context itself
+            renderContext->RSSetViewports(1, &d3d.screenViewport);
+        }else{
+            d3d = InitD3D(params);
+
+            renderDevice.reset(new RenderBackend::D3DRenderDevice(d3d.device));
+            renderContext.reset(new RenderBackend::D3DRenderContext(d3d.context));
+        }
 
 		DeviceKeeper::SetDevice(d3d.device);
 		DeviceKeeper::SetDeviceContext(d3d.context);
+        DeviceKeeper::SetRenderDevice(renderDevice.get());
+        DeviceKeeper::SetRenderContext(renderContext.get());
         DeviceKeeper::SetDepthStencilView(d3d.depthStencilView);
         DeviceKeeper::SetRenderTargetView(d3d.renderTargetView);
         DeviceKeeper::SetSwapChain(d3d.swapChain);
@@ -82,7 +135,19 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE prevInstance,
 
         Demo::Application::GetInstance()->Load();
 
+        if(benchmarkFrames > 0){
+            Demo::RunSubmissionBenchmark(benchmarkFrames, commandLog, reportFileName);
+            Demo::Application::ReleaseInstance();
+            return 0;
+        }
+
 	}catch(const Exception &ex){
+        //benchmark runs are unattended, the failure is the exit code and the report, load errors included
+        if(benchmarkFrames > 0){
+            ReportBenchmarkFailure(reportFileName, ex.What());
+            return 1;
+        }
+
         MessageBoxA(0, ex.What().c_str(), 0, 0);
         return 0;
 	}		
@@ -13,8 +13,22 @@ namespace Demo
 {
 
 void SSAODrawer::Init(const Shaders::ShadersSet &DrawDepth,
+            const Shaders::ShadersSet &DrawDepthOnly,
             const Shaders::ShadersSet &DrawSsao,
+            const Shaders::ShadersSet &DrawSsaoDeinterleaved,
+            const Shaders::ShadersSet &DrawSsaoDepthOnly,
+            const Shaders::ShadersSet &DrawSsaoBentNormals,
+            const Shaders::ShadersSet &DrawHbao,
             const Shaders::ShadersSet &DrawBlurResult,
+            const Shaders::ShadersSet &DownsampleDepth,
+            const Shaders::ShadersSet &UpsampleSsao,
+            const Shaders::ShadersSet &TemporalAccumulate,
+            const Shaders::ShadersSet &TemporalResolve,
+            const Shaders::ShadersSet &BuildDepthPyramid,
+            const Shaders::ShadersSet &DeinterleaveDepth,
+            const Shaders::ShadersSet &ReinterleaveSsao,
+            const Shaders::ShadersSet &ClassifyTiles,
+            const Shaders::ShadersSet &CombineScales,
             const Texture::RenderTarget &NdRt,
             const Texture::RenderTarget &SsaoRt,
             ID3D11ShaderResourceView *KernelOffsetsSRV)
@@ -22,21 +36,109 @@ void SSAODrawer::Init(const Shaders::ShadersSet &DrawDepth,
     drawDepth.vs.ConstructAsRef(DrawDepth.vs);
     drawDepth.ps.ConstructAsRef(DrawDepth.ps);
 
+    drawDepthOnly.vs.ConstructAsRef(DrawDepthOnly.vs);
+    drawDepthOnly.ps.ConstructAsRef(DrawDepthOnly.ps);
+
     drawSsao.vs.ConstructAsRef(DrawSsao.vs);
     drawSsao.ps.ConstructAsRef(DrawSsao.ps);
 
+    drawSsaoDeinterleaved.vs.ConstructAsRef(DrawSsaoDeinterleaved.vs);
+    drawSsaoDeinterleaved.ps.ConstructAsRef(DrawSsaoDeinterleaved.ps);
+
+    drawSsaoDepthOnly.vs.ConstructAsRef(DrawSsaoDepthOnly.vs);
+    drawSsaoDepthOnly.ps.ConstructAsRef(DrawSsaoDepthOnly.ps);
+
+    drawSsaoBentNormals.vs.ConstructAsRef(DrawSsaoBentNormals.vs);
+    drawSsaoBentNormals.ps.ConstructAsRef(DrawSsaoBentNormals.ps);
+
+    drawHbao.vs.ConstructAsRef(DrawHbao.vs);
+    drawHbao.ps.ConstructAsRef(DrawHbao.ps);
+
     drawBlurResult.vs.ConstructAsRef(DrawBlurResult.vs);
     drawBlurResult.ps.ConstructAsRef(DrawBlurResult.ps);
 
+    downsampleDepth.vs.ConstructAsRef(DownsampleDepth.vs);
+    downsampleDepth.ps.ConstructAsRef(DownsampleDepth.ps);
+
+    upsampleSsao.vs.ConstructAsRef(UpsampleSsao.vs);
+    upsampleSsao.ps.ConstructAsRef(UpsampleSsao.ps);
+
+    temporalAccumulate.vs.ConstructAsRef(TemporalAccumulate.vs);
+    temporalAccumulate.ps.ConstructAsRef(TemporalAccumulate.ps);
+
+    temporalResolve.vs.ConstructAsRef(TemporalResolve.vs);
+    temporalResolve.ps.ConstructAsRef(TemporalResolve.ps);
+
+    buildDepthPyramid.vs.ConstructAsRef(BuildDepthPyramid.vs);
+    buildDepthPyramid.ps.ConstructAsRef(BuildDepthPyramid.ps);
+
+    deinterleaveDepth.vs.ConstructAsRef(DeinterleaveDepth.vs);
+    deinterleaveDepth.ps.ConstructAsRef(DeinterleaveDepth.ps);
+
+    reinterleaveSsao.vs.ConstructAsRef(ReinterleaveSsao.vs);
+    reinterleaveSsao.ps.ConstructAsRef(ReinterleaveSsao.ps);
+
+    classifyTiles.vs.ConstructAsRef(ClassifyTiles.vs);
+    classifyTiles.ps.ConstructAsRef(ClassifyTiles.ps);
+
+    combineScales.vs.ConstructAsRef(CombineScales.vs);
+    combineScales.ps.ConstructAsRef(CombineScales.ps);
+
     ndRt = NdRt;
     ssaoRt = SsaoRt;
 
     kernelOffsetsSRV = KernelOffsetsSRV;
 }
 
+Shaders::ShadersSet &SSAODrawer::GetDrawAOShadersSet()
+{
+    if(technique == TECHNIQUE_HBAO)
+        return drawHbao;
+
+    if(depthOnly)
+        return drawSsaoDepthOnly;
+
+    if(bentNormals)
+        return drawSsaoBentNormals;
+
+    return (deinterleaved) ? drawSsaoDeinterleaved : drawSsao;
+}
+
+void SSAODrawer::SetResolutionScale(INT Scale, const Texture::RenderTarget &NdLowRt, const Texture::RenderTarget &SsaoLowRt)
+{
+    resolutionScale = Scale;
+    ndLowRt = NdLowRt;
+    ssaoLowRt = SsaoLowRt;
+
+    downsampleDepth.ps.UpdateVariable("scale", Scale);
+    downsampleDepth.ps.ApplyVariables();
+}
+
+void SSAODrawer::SetTileClassesRenderTarget(const Texture::RenderTarget &TileClassesRt) throw (Exception)
+{
+    tileClassesRt = TileClassesRt;
+
+    for(Shaders::ShadersSet *shaders : {&drawSsao, &drawSsaoDeinterleaved, &drawSsaoDepthOnly, &drawSsaoBentNormals}){
+        shaders->ps.UpdateVariable<INT>("useTileClasses", TileClassesRt.GetWidth() != 0);
+        shaders->ps.ApplyVariables();
+    }
+}
+
 void SSAODrawer::BeginDraw(const Scene::IObject *Object, const Meshes::IMesh *Mesh, const Camera::ICamera * Camera)
 {
-    if(pass == PASS_DRAW_DEPTH){
+    if(pass == PASS_DRAW_DEPTH && depthOnly){
+
+        const D3DXMATRIX &worldMatrix = Object->GetWorldMatrix();
+
+        drawDepthOnly.vs.UpdateVariable("worldViewProj", worldMatrix * Camera->GetViewMatrix() * Camera->GetProjMatrix());
+        drawDepthOnly.vs.UpdateVariable("worldView", worldMatrix * Camera->GetViewMatrix());
+
+        drawDepthOnly.vs.ApplyVariables();
+
+        drawDepthOnly.vs.Apply();
+        drawDepthOnly.ps.Apply();
+
+    }else if(pass == PASS_DRAW_DEPTH){
 
         const D3DXMATRIX &worldMatrix = Object->GetWorldMatrix();
 
@@ -49,12 +151,85 @@ void SSAODrawer::BeginDraw(const Scene::IObject *Object, const Meshes::IMesh *Me
         drawDepth.vs.Apply();
         drawDepth.ps.Apply();
 
+    }else if(pass == PASS_DOWNSAMPLE_DEPTH){
+        downsampleDepth.ps.SetResource(0, ndRt.GetSahderResourceView());
+
+        downsampleDepth.vs.Apply();
+        downsampleDepth.ps.Apply();
+    }else if(pass == PASS_BUILD_DEPTH_PYRAMID){
+        const Texture::RenderTarget &normalDepth = (resolutionScale > 1) ? ndLowRt : ndRt;
+
+        if(depthPyramidLevel == 0)
+            buildDepthPyramid.ps.SetResource(0, normalDepth.GetSahderResourceView());
+        else
+            buildDepthPyramid.ps.SetResource(0, depthPyramidRt.GetShaderResourceView(depthPyramidLevel - 1));
+
+        buildDepthPyramid.ps.UpdateVariable<INT>("copyDepth", depthPyramidLevel == 0);
+        buildDepthPyramid.ps.ApplyVariables();
+
+        buildDepthPyramid.vs.Apply();
+        buildDepthPyramid.ps.Apply();
+    }else if(pass == PASS_CLASSIFY_TILES){
+        const Texture::RenderTarget &normalDepth = (resolutionScale > 1) ? ndLowRt : ndRt;
+
+        classifyTiles.ps.SetResource(0, normalDepth.GetSahderResourceView());
+
+        classifyTiles.vs.Apply();
+        classifyTiles.ps.Apply();
+    }else if(pass == PASS_DEINTERLEAVE_DEPTH){
+        const Texture::RenderTarget &normalDepth = (resolutionScale > 1) ? ndLowRt : ndRt;
+
+        deinterleaveDepth.ps.SetResource(0, normalDepth.GetSahderResourceView());
+
+        deinterleaveDepth.vs.Apply();
+        deinterleaveDepth.ps.Apply();
     }else if(pass == PASS_DRAW_SSAO){
-        drawSsao.ps.SetResource(0, ndRt.GetSahderResourceView());
-        drawSsao.ps.SetResource(1, kernelOffsetsSRV);
+        const Texture::RenderTarget &normalDepth = (depthOnly) ? depthRt : ((resolutionScale > 1) ? ndLowRt : ndRt);
+        Shaders::ShadersSet &drawAo = GetDrawAOShadersSet();
+
+        drawAo.ps.SetResource(0, normalDepth.GetSahderResourceView());
+        drawAo.ps.SetResource(1, kernelOffsetsSRV);
+        drawAo.ps.SetResource(2, depthPyramidRt.GetShaderResourceView());
+        drawAo.ps.SetResource(4, tileClassesRt.GetSahderResourceView());
+
+        if(IsDeinterleaved())
+            drawAo.ps.SetResource(3, depthAtlasRt.GetSahderResourceView());
         
-        drawSsao.vs.Apply();
-        drawSsao.ps.Apply();
+        drawAo.vs.Apply();
+        drawAo.ps.Apply();
+    }else if(pass == PASS_REINTERLEAVE_SSAO){
+        reinterleaveSsao.ps.SetResource(0, ssaoAtlasRt.GetSahderResourceView());
+
+        reinterleaveSsao.vs.Apply();
+        reinterleaveSsao.ps.Apply();
+    }else if(pass == PASS_UPSAMPLE_SSAO){
+        upsampleSsao.ps.SetResource(0, ssaoLowRt.GetSahderResourceView());
+        upsampleSsao.ps.SetResource(1, ndLowRt.GetSahderResourceView());
+        upsampleSsao.ps.SetResource(2, ndRt.GetSahderResourceView());
+
+        upsampleSsao.vs.Apply();
+        upsampleSsao.ps.Apply();
+    }else if(pass == PASS_COMBINE_SCALES){
+        combineScales.ps.SetResource(0, fineAoRt.GetSahderResourceView());
+        combineScales.ps.SetResource(1, coarseAoRt.GetSahderResourceView());
+        combineScales.ps.SetResource(2, coarseNdRt.GetSahderResourceView());
+        combineScales.ps.SetResource(3, fineNdRt.GetSahderResourceView());
+
+        combineScales.vs.Apply();
+        combineScales.ps.Apply();
+    }else if(pass == PASS_TEMPORAL_ACCUMULATE){
+        temporalAccumulate.ps.SetResource(0, visibilityRt.GetSahderResourceView());
+        temporalAccumulate.ps.SetResource(1, prevHistoryRt.GetSahderResourceView());
+        temporalAccumulate.ps.SetResource(2, ndRt.GetSahderResourceView());
+        temporalAccumulate.ps.SetResource(3, ndPrevRt.GetSahderResourceView());
+
+        temporalAccumulate.vs.Apply();
+        temporalAccumulate.ps.Apply();
+    }else if(pass == PASS_TEMPORAL_RESOLVE){
+        temporalResolve.ps.SetResource(0, historyRt.GetSahderResourceView());
+
+        temporalResolve.vs.Apply();
+        temporalResolve.ps.Apply();
     }else if(pass == PASS_DRAW_BLURRED_RESULT){
     
         drawBlurResult.ps.SetResource(0, ssaoRt.GetSahderResourceView());
@@ -66,8 +241,26 @@ void SSAODrawer::BeginDraw(const Scene::IObject *Object, const Meshes::IMesh *Me
 
 void SSAODrawer::EndDraw(const Scene::IObject *Object, const Meshes::IMesh *Mesh)
 {
-    if(pass == PASS_DRAW_SSAO)
-        drawSsao.ps.ResetResources();
+    if(pass == PASS_DOWNSAMPLE_DEPTH)
+        downsampleDepth.ps.ResetResources();
+    else if(pass == PASS_BUILD_DEPTH_PYRAMID)
+        buildDepthPyramid.ps.ResetResources();
+    else if(pass == PASS_CLASSIFY_TILES)
+        classifyTiles.ps.ResetResources();
+    else if(pass == PASS_DEINTERLEAVE_DEPTH)
+        deinterleaveDepth.ps.ResetResources();
+    else if(pass == PASS_DRAW_SSAO)
+        GetDrawAOShadersSet().ps.ResetResources();
+    else if(pass == PASS_REINTERLEAVE_SSAO)
+        reinterleaveSsao.ps.ResetResources();
+    else if(pass == PASS_UPSAMPLE_SSAO)
+        upsampleSsao.ps.ResetResources();
+    else if(pass == PASS_COMBINE_SCALES)
+        combineScales.ps.ResetResources();
+    else if(pass == PASS_TEMPORAL_ACCUMULATE)
+        temporalAccumulate.ps.ResetResources();
+    else if(pass == PASS_TEMPORAL_RESOLVE)
+        temporalResolve.ps.ResetResources();
     else if(pass == PASS_DRAW_BLURRED_RESULT)
         drawBlurResult.ps.ResetResources();
 }
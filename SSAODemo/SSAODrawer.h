@@ -20,20 +20,78 @@ public:
     enum Pass
     {
         PASS_DRAW_DEPTH,
+        PASS_DOWNSAMPLE_DEPTH,
+        PASS_BUILD_DEPTH_PYRAMID,
+        PASS_CLASSIFY_TILES,
+        PASS_DEINTERLEAVE_DEPTH,
         PASS_DRAW_SSAO,
+        PASS_REINTERLEAVE_SSAO,
+        PASS_UPSAMPLE_SSAO,
+        PASS_COMBINE_SCALES,
+        PASS_TEMPORAL_ACCUMULATE,
+        PASS_TEMPORAL_RESOLVE,
         PASS_DRAW_BLURRED_RESULT
     };
+    //AO technique of PASS_DRAW_SSAO, the rest of the passes do not depend on it
+    enum Technique
+    {
+        TECHNIQUE_SSAO,
+        TECHNIQUE_HBAO,
+        TECHNIQUES_COUNT
+    };
 private:
     Pass pass = PASS_DRAW_DEPTH;
+    Technique technique = TECHNIQUE_SSAO;
     Shaders::ShadersSet drawDepth;
+    Shaders::ShadersSet drawDepthOnly;
     Shaders::ShadersSet drawSsao;
+    Shaders::ShadersSet drawSsaoDeinterleaved;
+    Shaders::ShadersSet drawSsaoDepthOnly;
+    Shaders::ShadersSet drawSsaoBentNormals;
+    Shaders::ShadersSet drawHbao;
     Shaders::ShadersSet drawBlurResult;
+    Shaders::ShadersSet downsampleDepth;
+    Shaders::ShadersSet upsampleSsao;
+    Shaders::ShadersSet temporalAccumulate;
+    Shaders::ShadersSet temporalResolve;
+    Shaders::ShadersSet buildDepthPyramid;
+    Shaders::ShadersSet deinterleaveDepth;
+    Shaders::ShadersSet reinterleaveSsao;
+    Shaders::ShadersSet classifyTiles;
+    Shaders::ShadersSet combineScales;
     Texture::RenderTarget ndRt, ssaoRt;
+    Texture::RenderTarget ndLowRt, ssaoLowRt;
+    Texture::RenderTarget ndPrevRt, visibilityRt, historyRt, prevHistoryRt;
+    Texture::RenderTargetMips depthPyramidRt;
+    UINT depthPyramidLevel = 0;
+    Texture::RenderTarget depthAtlasRt, ssaoAtlasRt;
+    bool deinterleaved = false;
+    Texture::RenderTarget depthRt;
+    bool depthOnly = false;
+    bool bentNormals = false;
+    Texture::RenderTarget tileClassesRt;
+    Texture::RenderTarget fineAoRt, fineNdRt, coarseAoRt, coarseNdRt;
+    INT resolutionScale = 1;
     ID3D11ShaderResourceView *kernelOffsetsSRV = NULL;
+    Shaders::ShadersSet &GetDrawAOShadersSet();
 public:
     void Init(const Shaders::ShadersSet &DrawDepth, 
+              const Shaders::ShadersSet &DrawDepthOnly,
               const Shaders::ShadersSet &DrawSsao, 
+              const Shaders::ShadersSet &DrawSsaoDeinterleaved,
+              const Shaders::ShadersSet &DrawSsaoDepthOnly,
+              const Shaders::ShadersSet &DrawSsaoBentNormals,
+              const Shaders::ShadersSet &DrawHbao,
               const Shaders::ShadersSet &DrawBlurResult,
+              const Shaders::ShadersSet &DownsampleDepth,
+              const Shaders::ShadersSet &UpsampleSsao,
+              const Shaders::ShadersSet &TemporalAccumulate,
+              const Shaders::ShadersSet &TemporalResolve,
+              const Shaders::ShadersSet &BuildDepthPyramid,
+              const Shaders::ShadersSet &DeinterleaveDepth,
+              const Shaders::ShadersSet &ReinterleaveSsao,
+              const Shaders::ShadersSet &ClassifyTiles,
+              const Shaders::ShadersSet &CombineScales,
               const Texture::RenderTarget &NdRt,
               const Texture::RenderTarget &SsaoRt,
               ID3D11ShaderResourceView *KernelOffsetsSRV);
@@ -42,11 +100,87 @@ public:
     virtual void EndDraw(const Scene::IObject *Object, const Meshes::IMesh *Mesh);
     void SetPass(Pass NewPass) {pass = NewPass;}
     Shaders::ShadersSet &GetSSAOSHadersSet(){return drawSsao;}
+    Shaders::ShadersSet &GetHBAOShadersSet(){return drawHbao;}
+    void SetTechnique(Technique NewTechnique) {technique = NewTechnique;}
+    Technique GetTechnique() const {return technique;}
+    //Updates and applies a variable all techniques share (projection, radius, harshness, temporal and pyramid switches)
+    template<class TVar>
+    void UpdateAOVariable(const std::string &VarName, const TVar &Value) throw (Exception)
+    {
+        Shaders::ShadersSet *techniques[] = {&drawSsao, &drawSsaoDeinterleaved, &drawSsaoDepthOnly, &drawSsaoBentNormals, &drawHbao};
+
+        for(Shaders::ShadersSet *shaders : techniques){
+            shaders->ps.UpdateVariable(VarName, Value);
+            shaders->ps.ApplyVariables();
+        }
+    }
     void SetNewRenderTargets(const Texture::RenderTarget &NdRt, const Texture::RenderTarget &SsaoRt)
     {
         ndRt = NdRt;
         ssaoRt = SsaoRt;
     }
+    //Scale 1 draws SSAO directly to ssaoRt, 2 and 4 draw it to SsaoLowRt using the downsampled NdLowRt
+    //and upsample the result to ssaoRt with the joint bilateral filter
+    void SetResolutionScale(INT Scale, const Texture::RenderTarget &NdLowRt, const Texture::RenderTarget &SsaoLowRt);
+    INT GetResolutionScale() const {return resolutionScale;}
+    //Temporal mode: SSAO pass writes the visibility of one kernel subset to VisibilityRt,
+    //accumulation merges it with PrevHistoryRt reprojected with NdPrevRt to HistoryRt, resolve writes HistoryRt to ssaoRt
+    void SetTemporalRenderTargets(const Texture::RenderTarget &NdPrevRt,
+                                  const Texture::RenderTarget &VisibilityRt,
+                                  const Texture::RenderTarget &HistoryRt,
+                                  const Texture::RenderTarget &PrevHistoryRt)
+    {
+        ndPrevRt = NdPrevRt;
+        visibilityRt = VisibilityRt;
+        historyRt = HistoryRt;
+        prevHistoryRt = PrevHistoryRt;
+    }
+    Shaders::ShadersSet &GetTemporalAccumulateShadersSet(){return temporalAccumulate;}
+    //Pyramid of the normal/depth buffer SSAO pass reads, an empty target switches SSAO back to the flat lookup.
+    //PASS_BUILD_DEPTH_PYRAMID draws the level set by SetDepthPyramidLevel from the previous one
+    void SetDepthPyramidRenderTarget(const Texture::RenderTargetMips &DepthPyramidRt){depthPyramidRt = DepthPyramidRt;}
+    void SetDepthPyramidLevel(UINT Level) {depthPyramidLevel = Level;}
+    //Deinterleaved mode: PASS_DEINTERLEAVE_DEPTH splits the depth to the atlas of 4 x 4 layers in DepthAtlasRt,
+    //PASS_DRAW_SSAO draws the layers to SsaoAtlasRt with the rotation of every layer fixed,
+    //PASS_REINTERLEAVE_SSAO puts them back to the screen layout. Empty targets switch the mode off.
+    //HBAO has no deinterleaved permutation and is drawn interleaved
+    void SetDeinterleavedRenderTargets(const Texture::RenderTarget &DepthAtlasRt, const Texture::RenderTarget &SsaoAtlasRt)
+    {
+        depthAtlasRt = DepthAtlasRt;
+        ssaoAtlasRt = SsaoAtlasRt;
+        deinterleaved = DepthAtlasRt.GetWidth() != 0;
+    }
+    bool IsDeinterleaved() const {return deinterleaved && technique == TECHNIQUE_SSAO;}
+    //Depth only mode: PASS_DRAW_DEPTH writes the view space depth alone to DepthRt and the SSAO technique
+    //reconstructs the normals from it. Application switches the mode per frame, the rest of the passes
+    //read the normals of ndRt, so the mode only applies to the full resolution interleaved SSAO
+    void SetDepthOnlyRenderTarget(const Texture::RenderTarget &DepthRt){depthRt = DepthRt;}
+    void SetDepthOnlyMode(bool Mode) {depthOnly = Mode;}
+    bool IsDepthOnly() const {return depthOnly;}
+    //Bent normals mode: PASS_DRAW_SSAO writes the view space bent normal of the taps to the second render target
+    //Application binds along with the AO one. Switched per frame as the depth only mode, the full resolution
+    //interleaved SSAO is the only technique that has the permutation
+    void SetBentNormalsMode(bool Mode) {bentNormals = Mode;}
+    bool IsBentNormals() const {return bentNormals;}
+    //Adaptive sampling: PASS_CLASSIFY_TILES writes the class of every 8x8 tile of the normal/depth buffer
+    //SSAO pass reads to TileClassesRt, PASS_DRAW_SSAO skips the background and far tiles and shades the flat ones
+    //with the reduced kernel. An empty target switches the mode off, HBAO shades every tile
+    void SetTileClassesRenderTarget(const Texture::RenderTarget &TileClassesRt) throw (Exception);
+    Shaders::ShadersSet &GetClassifyTilesShadersSet(){return classifyTiles;}
+    //Multi-scale mode: every layer is drawn by PASS_DOWNSAMPLE_DEPTH and PASS_DRAW_SSAO with the resolution scale
+    //of the layer, PASS_COMBINE_SCALES upsamples CoarseAoRt guided by CoarseNdRt and FineNdRt and combines it with FineAoRt.
+    //Application combines the layers from the coarsest one
+    void SetCombineScalesSources(const Texture::RenderTarget &FineAoRt,
+                                 const Texture::RenderTarget &FineNdRt,
+                                 const Texture::RenderTarget &CoarseAoRt,
+                                 const Texture::RenderTarget &CoarseNdRt)
+    {
+        fineAoRt = FineAoRt;
+        fineNdRt = FineNdRt;
+        coarseAoRt = CoarseAoRt;
+        coarseNdRt = CoarseNdRt;
+    }
+    Shaders::ShadersSet &GetCombineScalesShadersSet(){return combineScales;}
 };
 
 }
\ No newline at end of file
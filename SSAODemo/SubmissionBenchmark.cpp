@@ -0,0 +1,164 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include "Application.h"
+#include "SubmissionBenchmark.h"
+
+namespace Demo
+{
+
+using namespace RenderBackend;
+
+static DOUBLE GetSeconds()
+{
+    LARGE_INTEGER counter, frequency;
+    QueryPerformanceCounter(&counter);
+    QueryPerformanceFrequency(&frequency);
+
+    return (DOUBLE)counter.QuadPart / (DOUBLE)frequency.QuadPart;
+}
+
+//calls per frame of the frames after the first one
+struct MeanCounters
+{
+    DOUBLE calls[COMMANDS_COUNT];
+    DOUBLE drawCalls = 0.0, bindCalls = 0.0, elements = 0.0, uploadedBytes = 0.0;
+    MeanCounters()
+    {
+        for(int c = 0; c < COMMANDS_COUNT; c++)
+            calls[c] = 0.0;
+    }
+};
+
+static void Check(bool Condition, const std::string &Failure, std::vector<std::string> &Failures)
+{
+    if(!Condition)
+        Failures.push_back(Failure);
+}
+
+void RunSubmissionBenchmark(INT FramesCount, const CommandLog &Log, const std::string &ReportFileName) throw (Exception)
+{
+    if(FramesCount < 2)
+        throw Exception("Submission benchmark needs 2 frames at least");
+
+    //loading screen presents its own frames
+    size_t firstFrame = Log.GetFramesCount();
+
+    std::vector<Application::AOPass> passes = Application::GetInstance()->GetAOPasses();
+
+    std::vector<DOUBLE> times;
+
+    for(INT f = 0; f < FramesCount; f++){
+        DOUBLE start = GetSeconds();
+        Application::GetInstance()->Draw();
+        times.push_back(GetSeconds() - start);
+    }
+
+    if(Log.GetFramesCount() != firstFrame + FramesCount)
+        throw Exception("Submission benchmark frames are not ended by Present");
+
+    CommandLogCounters first = Log.GetFrameCounters(firstFrame);
+    CommandLogCounters firstAO = Log.GetFrameEventCounters(firstFrame, Application::AOEventName);
+    MeanCounters mean;
+    std::vector<std::string> failures;
+
+    size_t expectedDraws = 0;
+    for(const Application::AOPass &pass : passes)
+        expectedDraws += pass.drawCalls;
+
+    //every render pass sets its target and restores the back buffer
+    size_t expectedTargets = passes.size() * 2;
+
+    Check(Log.GetFrameEventsCount(firstFrame, Application::AOEventName) == 1, "first frame does not calculate the AO", failures);
+    Check(firstAO.GetDrawCalls() == expectedDraws,
+          "first frame AO chain issues " + std::to_string(firstAO.GetDrawCalls()) + " draws, the passes expect " + std::to_string(expectedDraws), failures);
+    Check(firstAO.calls[COMMAND_SET_RENDER_TARGETS] == expectedTargets,
+          "first frame AO chain sets " + std::to_string(firstAO.calls[COMMAND_SET_RENDER_TARGETS]) + " render targets, the passes expect " +
+          std::to_string(expectedTargets), failures);
+
+    DOUBLE meanTime = 0.0, minTime = times[1];
+
+    for(INT f = 1; f < FramesCount; f++){
+        CommandLogCounters counters = Log.GetFrameCounters(firstFrame + f);
+        CommandLogCounters countersAO = Log.GetFrameEventCounters(firstFrame + f, Application::AOEventName);
+
+        std::string frameName = "cached AO frame " + std::to_string(f);
+
+        Check(Log.GetFrameEventsCount(firstFrame + f, Application::AOEventName) == 0 && countersAO.GetDrawCalls() == 0 &&
+              countersAO.uploadedBytes == 0, frameName + " issues AO pass draws or uploads", failures);
+        //the rest of the frame is the one of the first frame
+        Check(counters.GetDrawCalls() + firstAO.GetDrawCalls() == first.GetDrawCalls() &&
+              counters.GetBindCalls() + firstAO.GetBindCalls() == first.GetBindCalls(),
+              frameName + " draws and binds differ from the first frame without its AO chain", failures);
+
+        for(int c = 0; c < COMMANDS_COUNT; c++)
+            mean.calls[c] += counters.calls[c];
+
+        mean.drawCalls += counters.GetDrawCalls();
+        mean.bindCalls += counters.GetBindCalls();
+        mean.elements += (DOUBLE)counters.elements;
+        mean.uploadedBytes += (DOUBLE)counters.uploadedBytes;
+
+        meanTime += times[f];
+        minTime = (times[f] < minTime) ? times[f] : minTime;
+    }
+
+    DOUBLE framesScale = 1.0 / (FramesCount - 1);
+
+    for(int c = 0; c < COMMANDS_COUNT; c++)
+        mean.calls[c] *= framesScale;
+
+    mean.drawCalls *= framesScale;
+    mean.bindCalls *= framesScale;
+    mean.elements *= framesScale;
+    mean.uploadedBytes *= framesScale;
+    meanTime *= framesScale;
+
+    FILE *report = fopen(ReportFileName.c_str(), "w");
+    if(!report)
+        throw Exception("Cant open submission benchmark report " + ReportFileName);
+
+    fprintf(report, "Application::Draw on the null driver, %d frames, calls are recorded and dropped\n", FramesCount);
+    fprintf(report, "  %-22s %12s %12s\n", "", "first frame", "cached AO");
+    fprintf(report, "  %-22s %12.3f %12.3f\n", "CPU ms", times[0] * 1000.0, meanTime * 1000.0);
+    fprintf(report, "  %-22s %12s %12.3f\n", "min CPU ms", "", minTime * 1000.0);
+    fprintf(report, "  %-22s %12u %12.1f\n", "draw calls", (UINT)first.GetDrawCalls(), mean.drawCalls);
+    fprintf(report, "  %-22s %12u %12.1f\n", "bind calls", (UINT)first.GetBindCalls(), mean.bindCalls);
+    fprintf(report, "  %-22s %12.0f %12.1f\n", "vertices and indices", (DOUBLE)first.elements, mean.elements);
+    fprintf(report, "  %-22s %12.0f %12.1f\n", "uploaded bytes", (DOUBLE)first.uploadedBytes, mean.uploadedBytes);
+
+    fprintf(report, "\ncalls per frame:\n");
+
+    for(int c = 0; c < COMMANDS_COUNT; c++)
+        if(first.calls[c] > 0 || mean.calls[c] > 0.0)
+            fprintf(report, "  %-22s %12u %12.1f\n", CommandLog::GetCommandName((CommandType)c), (UINT)first.calls[c], mean.calls[c]);
+
+    fprintf(report, "\nAO chain of the first frame:\n");
+    fprintf(report, "  %-22s %12s %12s\n", "", "recorded", "expected");
+    fprintf(report, "  %-22s %12u %12u\n", "draw calls", (UINT)firstAO.GetDrawCalls(), (UINT)expectedDraws);
+    fprintf(report, "  %-22s %12u %12u\n", "render target sets", (UINT)firstAO.calls[COMMAND_SET_RENDER_TARGETS], (UINT)expectedTargets);
+
+    for(const Application::AOPass &pass : passes)
+        fprintf(report, "  %-22s %12s %12u\n", pass.name.c_str(), "", pass.drawCalls);
+
+    fprintf(report, "\nlog of %u commands, %u bytes per command\n", (UINT)Log.GetCommands().size(), (UINT)sizeof(Command));
+
+    for(const std::string &failure : failures)
+        fprintf(report, "FAILED: %s\n", failure.c_str());
+
+    fprintf(report, "%s\n", (failures.empty()) ? "PASSED" : "FAILED");
+
+    fclose(report);
+
+    if(!failures.empty())
+        throw Exception("Submission benchmark failed: " + failures[0]);
+}
+
+}
@@ -0,0 +1,21 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#pragma once
+#include <string>
+#include <Exception.h>
+#include <RecordingBackend.h>
+
+namespace Demo
+{
+
+//Draws FramesCount frames of the loaded Application on the recording backend and writes the CPU time
+//and the recorded calls of the frames to the report. The first frame calculates the AO, the rest take it from the cache.
+//Throws after writing the report when the first frame AO chain differs from Application::GetAOPasses or a cached frame runs the chain
+void RunSubmissionBenchmark(INT FramesCount, const RenderBackend::CommandLog &Log, const std::string &ReportFileName) throw (Exception);
+
+}
@@ -0,0 +1,426 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include <CpuRendering.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <functional>
+
+using namespace CpuRendering;
+
+static const float Pi = 3.14159265f;
+
+//Application::LoadResources
+static const char *DefaultMeshPath = "../Resources/Meshes/CryTecHall/hall.bin";
+static const Float3 DefaultCameraPos = {24.30f, 3.694f, 2.95f};
+static const Float3 DefaultCameraDir = {0.934f, 0.059f, -0.350f};
+
+struct RenderSettings
+{
+    int width = 1280, height = 720;
+    float occlusionRadius = 0.8f;
+    float harshness = 1.5f;
+    int samplesCount = 16;
+    size_t threadsCount = 0;
+    //best time of the compute stages over the iterations
+    int iterations = 1;
+    std::string meshPath = DefaultMeshPath;
+    //recorded by the demo (F2), the default camera pose is used if empty
+    std::string cameraPath;
+    int frame = 0;
+    //batch mode, the AO of every pose of the file (LoadCameraPoses)
+    std::string viewsPath;
+    BatchSplit split = BATCH_SPLIT_VIEWS;
+    //render farm coordinator with that many worker processes
+    int farmWorkers = 0;
+    int farmTileSize = 0;
+    size_t farmThreadsCount = 1;
+    //the first worker ends without a reply when that job comes, to test the re-queueing
+    int farmCrashAfterJobs = 0;
+    //render farm worker, set by the coordinator
+    std::string workerMeshCache;
+    unsigned short workerPort = 0;
+    //at the eye if not set
+    bool hasLightPos = false;
+    Float3 lightPos;
+    std::string output = "ssao-render";
+    bool savePfm = true, savePng = true;
+};
+
+static void PrintUsage()
+{
+    printf("ssao-render [--width N] [--height N] [--radius R] [--harshness H] [--samples 4|8|16|32|64] [--threads N]\n"
+           "            [--iterations N] [--mesh FILE] [--camera-path FILE] [--frame N] [--light X Y Z]\n"
+           "            [--views FILE] [--split views|tiles] [--farm N] [--farm-tile N] [--farm-threads N]\n"
+           "            [--farm-crash-after N] [--output PREFIX] [--format pfm|png|both]\n\n"
+           "Renders the prepass, SSAO, edge saving blur and point light passes of the demo on the CPU\n"
+           "and writes PREFIX_ao and PREFIX_lit images, the mesh is %s by default.\n"
+           "With --views renders the AO of every camera pose of FILE to PREFIX_NNNN_ao images, a view per\n"
+           "thread or every view split to tiles. With --farm the views or their tiles are rendered by N worker\n"
+           "processes on localhost, they map the mesh from PREFIX.meshcache\n", DefaultMeshPath);
+}
+
+static bool ParseSettings(int argc, char *argv[], RenderSettings &Settings)
+{
+    for(int a = 1; a < argc; a++){
+        if(strcmp(argv[a], "--width") == 0 && a + 1 < argc)
+            Settings.width = atoi(argv[++a]);
+        else if(strcmp(argv[a], "--height") == 0 && a + 1 < argc)
+            Settings.height = atoi(argv[++a]);
+        else if(strcmp(argv[a], "--radius") == 0 && a + 1 < argc)
+            Settings.occlusionRadius = (float)atof(argv[++a]);
+        else if(strcmp(argv[a], "--harshness") == 0 && a + 1 < argc)
+            Settings.harshness = (float)atof(argv[++a]);
+        else if(strcmp(argv[a], "--samples") == 0 && a + 1 < argc)
+            Settings.samplesCount = atoi(argv[++a]);
+        else if(strcmp(argv[a], "--threads") == 0 && a + 1 < argc)
+            Settings.threadsCount = (size_t)atoi(argv[++a]);
+        else if(strcmp(argv[a], "--iterations") == 0 && a + 1 < argc)
+            Settings.iterations = atoi(argv[++a]);
+        else if(strcmp(argv[a], "--mesh") == 0 && a + 1 < argc)
+            Settings.meshPath = argv[++a];
+        else if(strcmp(argv[a], "--camera-path") == 0 && a + 1 < argc)
+            Settings.cameraPath = argv[++a];
+        else if(strcmp(argv[a], "--frame") == 0 && a + 1 < argc)
+            Settings.frame = atoi(argv[++a]);
+        else if(strcmp(argv[a], "--views") == 0 && a + 1 < argc)
+            Settings.viewsPath = argv[++a];
+        else if(strcmp(argv[a], "--split") == 0 && a + 1 < argc){
+            std::string split = argv[++a];
+            if(split != "views" && split != "tiles")
+                return false;
+            Settings.split = (split == "views") ? BATCH_SPLIT_VIEWS : BATCH_SPLIT_TILES;
+        }
+        else if(strcmp(argv[a], "--farm") == 0 && a + 1 < argc)
+            Settings.farmWorkers = atoi(argv[++a]);
+        else if(strcmp(argv[a], "--farm-tile") == 0 && a + 1 < argc)
+            Settings.farmTileSize = atoi(argv[++a]);
+        else if(strcmp(argv[a], "--farm-threads") == 0 && a + 1 < argc)
+            Settings.farmThreadsCount = (size_t)atoi(argv[++a]);
+        else if(strcmp(argv[a], "--farm-crash-after") == 0 && a + 1 < argc)
+            Settings.farmCrashAfterJobs = atoi(argv[++a]);
+        else if(strcmp(argv[a], "--farm-worker") == 0 && a + 2 < argc){
+            Settings.workerMeshCache = argv[++a];
+            Settings.workerPort = (unsigned short)atoi(argv[++a]);
+        }
+        else if(strcmp(argv[a], "--light") == 0 && a + 3 < argc){
+            Settings.lightPos.x = (float)atof(argv[++a]);
+            Settings.lightPos.y = (float)atof(argv[++a]);
+            Settings.lightPos.z = (float)atof(argv[++a]);
+            Settings.hasLightPos = true;
+        }else if(strcmp(argv[a], "--output") == 0 && a + 1 < argc)
+            Settings.output = argv[++a];
+        else if(strcmp(argv[a], "--format") == 0 && a + 1 < argc){
+            std::string format = argv[++a];
+            Settings.savePfm = format == "pfm" || format == "both";
+            Settings.savePng = format == "png" || format == "both";
+            if(!Settings.savePfm && !Settings.savePng)
+                return false;
+        }else
+            return false;
+    }
+
+    return Settings.width > 0 && Settings.height > 0 && Settings.occlusionRadius > 0.0f && Settings.iterations > 0 &&
+           Settings.farmWorkers >= 0 && Settings.farmTileSize >= 0;
+}
+
+//SSAOv3.ps is compiled for these counts only
+static KernelStorage CreateSupportedKernel(int SamplesCount) throw (Exception)
+{
+    switch(SamplesCount){
+        case 4: return CreateKernel<4>();
+        case 8: return CreateKernel<8>();
+        case 16: return CreateKernel<16>();
+        case 32: return CreateKernel<32>();
+        case 64: return CreateKernel<64>();
+    }
+
+    throw CpuRenderingException("SSAO samples count must be 4, 8, 16, 32 or 64");
+}
+
+//best of Iterations runs
+static double MeasureMilliseconds(const std::function<void()> &Function, int Iterations)
+{
+    double best = 0.0;
+
+    for(int i = 0; i < Iterations; i++){
+        Stopwatch stopwatch;
+        Function();
+        double seconds = stopwatch.GetSeconds();
+        best = (i == 0 || seconds < best) ? seconds : best;
+    }
+
+    return best * 1000.0;
+}
+
+static SSAOParams CreateSSAOParams(const RenderSettings &Settings) throw (Exception)
+{
+    SSAOParams params;
+    params.kernel = CreateSupportedKernel(Settings.samplesCount);
+    params.randomOffsets = CreateRandomOffsets(4, 4);
+    params.proj = PerspectiveFovLH(0.25f * Pi, 0.1f, 1000.0f, (float)Settings.width / Settings.height);
+    params.invProj = Inverse(params.proj);
+    params.occlusionRadius = Settings.occlusionRadius;
+    params.harshness = Settings.harshness;
+
+    return params;
+}
+
+static BatchAOParams CreateBatchParams(const RenderSettings &Settings) throw (Exception)
+{
+    BatchAOParams params;
+    params.width = Settings.width;
+    params.height = Settings.height;
+    params.ssao = CreateSSAOParams(Settings);
+
+    return params;
+}
+
+//the frame of the camera path or the default camera pose
+static Matrix GetSingleView(const RenderSettings &Settings) throw (Exception)
+{
+    if(Settings.cameraPath.empty())
+        return CreateEyeCameraView(DefaultCameraPos, DefaultCameraDir);
+
+    CameraPath path = LoadCameraPath(Settings.cameraPath);
+
+    if(Settings.frame < 0 || (size_t)Settings.frame >= path.size())
+        throw CpuRenderingException("Camera path " + Settings.cameraPath + " has no frame " + std::to_string(Settings.frame));
+
+    return path[Settings.frame];
+}
+
+//PREFIX_NNNN_ao images of the view, saved on the writer thread
+static void PushAOImage(OutputQueue &Output, const RenderSettings &Settings, size_t ViewIndex, const std::shared_ptr<OcclusionImage> &Occlusion)
+{
+    char index[16];
+    sprintf(index, "_%04u", (unsigned int)ViewIndex);
+    std::string prefix = Settings.output + index;
+
+    bool savePfm = Settings.savePfm, savePng = Settings.savePng;
+
+    Output.Push([=]
+    {
+        if(savePfm)
+            SavePFM(prefix + "_ao.pfm", *Occlusion);
+        if(savePng)
+            SavePNG(prefix + "_ao.png", *Occlusion);
+    });
+}
+
+static void Render(const RenderSettings &Settings, const TriangleMesh &Mesh, double LoadMs, ThreadPool &Pool) throw (Exception)
+{
+    Matrix view = GetSingleView(Settings);
+
+    SSAOParams params = CreateSSAOParams(Settings);
+
+    PointLightParams light;
+    Matrix invView = Inverse(view);
+    light.pos = (Settings.hasLightPos) ? Settings.lightPos : Float3(invView.m[3][0], invView.m[3][1], invView.m[3][2]);
+
+    NormalDepthRasterizer rasterizer(&Pool);
+    SSAOEngine ssao(&Pool);
+    EdgeSavingBlurEngine blur(&Pool);
+    EdgeSavingBlurParams blurParams;
+
+    NormalDepthImage normalDepth;
+    OcclusionImage occlusion, blurred;
+    ColorImage color;
+
+    PrepassTransforms transforms = CreatePrepassTransforms(Matrix(), view, params.proj);
+
+    double prepassMs = MeasureMilliseconds([&]
+    {
+        rasterizer.Clear(Settings.width, Settings.height, normalDepth);
+        rasterizer.Draw(Mesh, transforms, normalDepth);
+    }, Settings.iterations);
+
+    double ssaoMs = MeasureMilliseconds([&]{ssao.Compute(normalDepth, params, occlusion);}, Settings.iterations);
+
+    //the blur works in place, every iteration starts from the same occlusion
+    double blurMs = MeasureMilliseconds([&]{blurred = occlusion; blur.Blur(blurred, normalDepth, blurParams);}, Settings.iterations);
+
+    double lightingMs = MeasureMilliseconds([&]{ShadePointLight(normalDepth, &blurred, view, params.invProj, light, color, &Pool);}, Settings.iterations);
+
+    Stopwatch stopwatch;
+
+    if(Settings.savePfm){
+        SavePFM(Settings.output + "_ao.pfm", blurred);
+        SavePFM(Settings.output + "_lit.pfm", color);
+    }
+
+    if(Settings.savePng){
+        SavePNG(Settings.output + "_ao.png", blurred);
+        SavePNG(Settings.output + "_lit.png", color);
+    }
+
+    double writeMs = stopwatch.GetSeconds() * 1000.0;
+
+    const RasterizerCounters &counters = rasterizer.GetCounters();
+
+    printf("%s %dx%d, %u triangles (%u culled), %d samples, radius %.2f, harshness %.2f, %u threads\n", Settings.meshPath.c_str(),
+           Settings.width, Settings.height, (unsigned int)counters.triangles, (unsigned int)counters.culled, Settings.samplesCount,
+           Settings.occlusionRadius, Settings.harshness, (unsigned int)Pool.GetThreadsCount());
+    printf("  %-10s %10s\n", "stage", "ms");
+    printf("  %-10s %10.2f\n", "load", LoadMs);
+    printf("  %-10s %10.2f\n", "prepass", prepassMs);
+    printf("  %-10s %10.2f\n", "ssao", ssaoMs);
+    printf("  %-10s %10.2f\n", "blur", blurMs);
+    printf("  %-10s %10.2f\n", "lighting", lightingMs);
+    printf("  %-10s %10.2f\n", "frame", prepassMs + ssaoMs + blurMs + lightingMs);
+    printf("  %-10s %10.2f\n", "write", writeMs);
+}
+
+static void RenderBatch(const RenderSettings &Settings, const TriangleMesh &Mesh, double LoadMs, ThreadPool &Pool) throw (Exception)
+{
+    CameraPath views = LoadCameraPoses(Settings.viewsPath);
+    BatchAOParams params = CreateBatchParams(Settings);
+
+    BatchAORenderer renderer(&Pool);
+    //a few images per thread in flight, the writer catches up while the views are rendered
+    OutputQueue output(Pool.GetThreadsCount() * 2);
+
+    renderer.Render(Mesh, views, params, Settings.split, [&](size_t ViewIndex, const std::shared_ptr<OcclusionImage> &Occlusion)
+    {
+        PushAOImage(output, Settings, ViewIndex, Occlusion);
+    });
+
+    Stopwatch stopwatch;
+    output.Finish();
+    double drainMs = stopwatch.GetSeconds() * 1000.0;
+
+    const BatchAOCounters &counters = renderer.GetCounters();
+    double viewsCount = (counters.views > 0) ? (double)counters.views : 1.0;
+
+    printf("%s %dx%d, %u views of %s, %d samples, radius %.2f, harshness %.2f, %u threads, split by %s\n", Settings.meshPath.c_str(),
+           Settings.width, Settings.height, (unsigned int)counters.views, Settings.viewsPath.c_str(), Settings.samplesCount,
+           Settings.occlusionRadius, Settings.harshness, (unsigned int)Pool.GetThreadsCount(),
+           (Settings.split == BATCH_SPLIT_VIEWS) ? "views" : "tiles");
+    printf("  %-10s %10s\n", "stage", "ms");
+    printf("  %-10s %10.2f\n", "load", LoadMs);
+    printf("  %-10s %10.2f\n", "prepass", counters.prepassSeconds * 1000.0 / viewsCount);
+    printf("  %-10s %10.2f\n", "ssao", counters.ssaoSeconds * 1000.0 / viewsCount);
+    printf("  %-10s %10.2f\n", "blur", counters.blurSeconds * 1000.0 / viewsCount);
+    printf("  %-10s %10.2f\n", "batch", counters.seconds * 1000.0);
+    //writes left when the last view was done
+    printf("  %-10s %10.2f\n", "drain", drainMs);
+    printf("\n  %.2f views/s, %u scratch sets, the stages are per view\n", counters.GetViewsPerSecond(), (unsigned int)renderer.GetScratchCount());
+}
+
+static void RenderWithFarm(const RenderSettings &Settings, const TriangleMesh &Mesh, double LoadMs) throw (Exception)
+{
+    CameraPath views = (Settings.viewsPath.empty()) ? CameraPath(1, GetSingleView(Settings)) : LoadCameraPoses(Settings.viewsPath);
+
+    //mapped by every worker, so the mesh is parsed once
+    std::string meshCachePath = Settings.output + ".meshcache";
+    SaveMeshCache(meshCachePath, Mesh);
+
+    std::vector<std::string> command;
+    command.push_back(GetExecutablePath());
+    command.push_back("--width");
+    command.push_back(std::to_string(Settings.width));
+    command.push_back("--height");
+    command.push_back(std::to_string(Settings.height));
+    command.push_back("--radius");
+    command.push_back(std::to_string(Settings.occlusionRadius));
+    command.push_back("--harshness");
+    command.push_back(std::to_string(Settings.harshness));
+    command.push_back("--samples");
+    command.push_back(std::to_string(Settings.samplesCount));
+    command.push_back("--threads");
+    command.push_back(std::to_string(Settings.farmThreadsCount));
+
+    std::vector<std::vector<std::string> > workerCommands(Settings.farmWorkers, command);
+
+    if(Settings.farmCrashAfterJobs > 0){
+        workerCommands[0].push_back("--farm-crash-after");
+        workerCommands[0].push_back(std::to_string(Settings.farmCrashAfterJobs));
+    }
+
+    //the coordinator appends the port
+    for(std::vector<std::string> &workerCommand : workerCommands){
+        workerCommand.push_back("--farm-worker");
+        workerCommand.push_back(meshCachePath);
+    }
+
+    RenderFarmParams params;
+    params.tileSize = Settings.farmTileSize;
+
+    RenderFarmCoordinator coordinator;
+    OutputQueue output(Settings.farmWorkers * 2);
+
+    try{
+        coordinator.Render(views, Settings.width, Settings.height, params, workerCommands, [&](size_t ViewIndex, const std::shared_ptr<OcclusionImage> &Occlusion)
+        {
+            PushAOImage(output, Settings, ViewIndex, Occlusion);
+        });
+    }catch(...){
+        remove(meshCachePath.c_str());
+        throw;
+    }
+
+    remove(meshCachePath.c_str());
+
+    Stopwatch stopwatch;
+    output.Finish();
+    double drainMs = stopwatch.GetSeconds() * 1000.0;
+
+    const RenderFarmCounters &counters = coordinator.GetCounters();
+
+    printf("%s %dx%d, %u views, %d samples, radius %.2f, harshness %.2f, %u of %d workers connected, %u threads each\n",
+           Settings.meshPath.c_str(), Settings.width, Settings.height, (unsigned int)counters.views, Settings.samplesCount,
+           Settings.occlusionRadius, Settings.harshness, (unsigned int)counters.connectedWorkers, Settings.farmWorkers,
+           (unsigned int)Settings.farmThreadsCount);
+    printf("  %-10s %10s\n", "stage", "ms");
+    printf("  %-10s %10.2f\n", "load", LoadMs);
+    printf("  %-10s %10.2f\n", "farm", counters.seconds * 1000.0);
+    printf("  %-10s %10.2f\n", "drain", drainMs);
+    printf("\n  %.2f views/s, %u jobs of %s, %u requeued, %u workers lost, %.2f MB of R8 tiles\n", counters.GetViewsPerSecond(),
+           (unsigned int)counters.jobs, (Settings.farmTileSize > 0) ? "tiles" : "views", (unsigned int)counters.requeued,
+           (unsigned int)counters.lostWorkers, counters.resultBytes / (1024.0 * 1024.0));
+}
+
+int main(int argc, char *argv[])
+{
+    RenderSettings settings;
+
+    if(!ParseSettings(argc, argv, settings)){
+        PrintUsage();
+        return 1;
+    }
+
+    try{
+        ThreadPool pool;
+        pool.Init(settings.threadsCount);
+
+        if(!settings.workerMeshCache.empty()){
+            MappedMeshCache meshCache;
+            meshCache.Open(settings.workerMeshCache);
+
+            RunRenderFarmWorker(settings.workerPort, meshCache.GetMesh(), CreateBatchParams(settings), &pool, settings.farmCrashAfterJobs);
+            return 0;
+        }
+
+        Stopwatch stopwatch;
+        TriangleMesh mesh = LoadColladaBinaryMesh(settings.meshPath);
+        double loadMs = stopwatch.GetSeconds() * 1000.0;
+
+        if(settings.farmWorkers > 0)
+            RenderWithFarm(settings, mesh, loadMs);
+        else if(settings.viewsPath.empty())
+            Render(settings, mesh, loadMs, pool);
+        else
+            RenderBatch(settings, mesh, loadMs, pool);
+    }catch(const Exception &ex){
+        fprintf(stderr, "%s\n", ex.What().c_str());
+        return 1;
+    }
+
+    return 0;
+}